@@ -30,8 +30,15 @@
 #include "early.h"
 #include "debug.h"
 
+#include <string.h>
+
 #define SS_STACK_SIZE	0x02000
 
+/* Default for managing Fast RAM MemHeaders with TLSF, see usetlsf() */
+#ifndef AMIGA_TLSF_MEMHEADERS
+#define AMIGA_TLSF_MEMHEADERS 0
+#endif
+
  #ifndef DEFKRN_CMDLINE
 #if AROS_SERIAL_DEBUG
 #define DEFKRN_CMDLINE      "sysdebug=InitCode"
@@ -40,6 +47,25 @@
 #endif
 #endif
 
+/*
+ * TLSF can be enabled with "tlsf" and disabled with "notlsf"
+ * on the kernel command line.
+ */
+static BOOL usetlsf(struct TagItem *bootmsg)
+{
+    CONST_STRPTR args = NULL;
+
+    if (bootmsg[0].ti_Tag == KRN_CmdLine)
+        args = (CONST_STRPTR)bootmsg[0].ti_Data;
+    if (args) {
+        if (strstr(args, "notlsf"))
+            return FALSE;
+        if (strstr(args, "tlsf"))
+            return TRUE;
+    }
+    return AMIGA_TLSF_MEMHEADERS;
+}
+
 static BOOL iseven(APTR p)
 {
     return (((ULONG)p) & 1) == 0;
@@ -663,7 +689,7 @@ void exec_boot(ULONG *membanks, ULONG *cpupcr)
     struct TagItem *bootmsgptr = bootmsg;
     volatile APTR *trap;
     int i;
-    BOOL wasvalid, arosbootstrapmode;
+    BOOL wasvalid, arosbootstrapmode, tlsf;
     UWORD *kickrom[8];
     struct MemHeader *mh;
     LONG oldLastAlert[4];
@@ -901,11 +927,25 @@ void exec_boot(ULONG *membanks, ULONG *cpupcr)
     krnCreateROMHeader("Kickstart ROM", (APTR)0x00e00000, (APTR)0x00e7ffff);
 
     /* Add remaining memory regions */
+    tlsf = usetlsf(bootmsgptr);
     for (i = 2; membanks[i + 1]; i += 2) {
         IPTR  addr = membanks[i];
         ULONG size = membanks[i + 1];
 
         mh = addmemoryregion(addr, size, BootS, FALSE);
+
+        /*
+         * Nothing but KickMem, which is never freed, has been allocated
+         * from the region yet, so it can still be handed over to TLSF.
+         */
+        if (tlsf && (mh->mh_Attributes & MEMF_FAST) && mh->mh_First) {
+            struct MemHeader *tlsfmh = krnConvertMemHeaderToTLSF(mh);
+
+            if (tlsfmh) {
+                DEBUGPUTHEX(("TLSF memory header", (ULONG)tlsfmh));
+                mh = tlsfmh;
+            }
+        }
         Enqueue(&SysBase->MemList, &mh->mh_Node);
 
         /* Adjust MaxLocMem and MaxExtMem as needed */
@@ -71,6 +71,8 @@ struct ColorRegister
 #define PDTA_SourceMode		(DTA_Dummy + 250) /* Set the interface mode for the sub datatype. See below. */
 #define PDTA_DestMode		(DTA_Dummy + 251) /* Set the interface mode for the app datatype. See below. */
 #define PDTA_UseFriendBitMap	(DTA_Dummy + 255) /* Make the allocated bitmap be a "friend" bitmap (BOOL) */
+#define PDTA_MaxDecodeWidth	(DTA_Dummy + 270) /* Subclasses may decode at a reduced size to fit (ULONG, I) */
+#define PDTA_MaxDecodeHeight	(DTA_Dummy + 271) /* Subclasses may decode at a reduced size to fit (ULONG, I) */
 
 /* Interface modes */
 #define PMODE_V42 (0)	/* Mode used for backward compatibility */
@@ -9,10 +9,12 @@
     Lang: english
 */
 
+#include <exec/types.h>
 #include <devices/smart.h>
 
 #define HD_SMARTCMD				(CMD_NONSTD + 22)
 #define HD_TRIMCMD				(CMD_NONSTD + 23)
+#define HD_IOSTATSCMD			(CMD_NONSTD + 24)
 
 /* Commands (io_Offset) */
 #define ATAFEATURE_TEST_AVAIL	0x54535446              /* TSTF */
@@ -20,4 +22,16 @@
 #define SMART_MAGIC_ID 			0x534D5254				/* SMRT */
 #define TRIM_MAGIC_ID 			0x5452494D				/* TRIM */
 
+/* I/O scheduler statistics of a unit, HD_IOSTATSCMD copies up to io_Length bytes */
+struct ATAIOStats
+{
+    ULONG	ios_Requests;		/* Reads and writes served */
+    ULONG	ios_Commands;		/* Read and write commands sent to the drive */
+    ULONG	ios_Merged;		/* Requests served by the command of another one */
+    ULONG	ios_QueueDepth;		/* Requests queued now */
+    ULONG	ios_MaxQueueDepth;	/* Most requests queued at once */
+    ULONG	ios_ServiceTime;	/* Average time from leaving the queue until the reply, in microseconds */
+    ULONG	ios_MaxServiceTime;	/* Longest time from leaving the queue until the reply, in microseconds */
+};
+
 #endif /* DEVICES_ATA_H */
@@ -0,0 +1,34 @@
+#ifndef ___MALLOC_H
+#define ___MALLOC_H
+
+/*
+    Copyright © 2018, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Private definitions shared by the malloc() family.
+*/
+
+/*
+ * Every block is preceded by a size_t holding its capacity, i.e. the
+ * number of usable bytes. This is the requested size rounded up to the
+ * block's size class, or more if realloc() reserved room for growth.
+ */
+#define MALLOC_HEADER           AROS_ALIGN(sizeof(size_t))
+
+/*
+ * Small blocks freed by the task which opened the library are kept in
+ * per size class caches, which only that task touches, so they can be
+ * reused without taking the pool semaphore.
+ */
+#define MALLOC_CACHE_GRAIN      16
+#define MALLOC_CACHE_CLASSES    16
+#define MALLOC_CACHE_MAXSIZE    (MALLOC_CACHE_GRAIN * MALLOC_CACHE_CLASSES)
+#define MALLOC_CACHE_MAXBLOCKS  64      /* Cached blocks per class before half of them are flushed */
+
+#define MALLOC_CACHE_CLASS(size) ((size) ? ((size) - 1) / MALLOC_CACHE_GRAIN : 0)
+
+struct StdCIntBase;
+
+void __malloc_flushcache(struct StdCIntBase *StdCBase, int class, int keep);
+
+#endif
@@ -0,0 +1,48 @@
+/*
+    Copyright © 2026, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Internal stdc function to get the statistics of the malloc() family
+*/
+
+#include "__stdc_intbase.h"
+
+/*****************************************************************************
+
+    NAME */
+#include <libraries/stdc.h>
+
+	void __stdc_get_mallocstats (
+
+/*  SYNOPSIS */
+        struct __stdc_mallocstats *stats)
+
+/*  FUNCTION
+        Get the allocation statistics of the calling program.
+
+    INPUTS
+        stats - The structure to fill in.
+
+    RESULT
+
+    NOTES
+        The counters are not protected against concurrent updates from
+        several tasks sharing the library base, so they are only meant
+        to assess cache hit rates.
+
+    EXAMPLE
+
+    BUGS
+
+    SEE ALSO
+        malloc(), free(), realloc()
+
+    INTERNALS
+
+******************************************************************************/
+{
+    struct StdCIntBase *StdCBase =
+        (struct StdCIntBase *)__aros_getbase_StdCBase();
+
+    *stats = StdCBase->malloc_stats;
+}
@@ -19,6 +19,8 @@
 #include <time.h>
 
 #include <aros/types/clock_t.h>
+
+#include "__malloc.h"
 /* Some structs that are defined privately */
 struct signal_func_data;
 
@@ -39,6 +41,10 @@ struct StdCIntBase
 
     /* stdlib.h */
     APTR                        mempool;
+    struct Task                 *malloc_owner;
+    APTR                        malloc_cache[MALLOC_CACHE_CLASSES];
+    UWORD                       malloc_cachecnt[MALLOC_CACHE_CLASSES];
+    struct __stdc_mallocstats   malloc_stats;
     unsigned int                srand_seed;
 
     /* time.h and it's functions */
@@ -52,13 +52,32 @@
 	unsigned char *mem;
 	size_t         size;
 
-        mem = ((UBYTE *)memory) - AROS_ALIGN(sizeof(size_t));
+        mem = ((UBYTE *)memory) - MALLOC_HEADER;
 
         size = *((size_t *) mem);
         if (size == MEMALIGN_MAGIC)
             free(((void **) mem)[-1]);
         else {
-            size += AROS_ALIGN(sizeof(size_t));
+            StdCBase->malloc_stats.ms_Frees++;
+
+            /* Only the owner of the task cache may put blocks into it */
+            if ((size <= MALLOC_CACHE_MAXSIZE) &&
+                (FindTask(NULL) == StdCBase->malloc_owner))
+            {
+                int class = MALLOC_CACHE_CLASS(size);
+
+                *((APTR *)memory) = StdCBase->malloc_cache[class];
+                StdCBase->malloc_cache[class] = memory;
+                StdCBase->malloc_stats.ms_CacheFrees++;
+
+                /* Give a batch back to the pool when the cache grows too large */
+                if (++StdCBase->malloc_cachecnt[class] > MALLOC_CACHE_MAXBLOCKS)
+                    __malloc_flushcache(StdCBase, class, MALLOC_CACHE_MAXBLOCKS / 2);
+
+                return;
+            }
+
+            size += MALLOC_HEADER;
 	    FreePooled (StdCBase->mempool, mem, size);
         }
     }
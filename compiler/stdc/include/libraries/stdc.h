@@ -35,6 +35,18 @@ struct StdCBase
     unsigned char sigrunning, sigpending;
 };
 
+/* Statistics of the malloc() family, see __stdc_get_mallocstats() */
+struct __stdc_mallocstats
+{
+    unsigned long ms_Allocs;            /* Blocks allocated by malloc() */
+    unsigned long ms_CacheHits;         /* ... of which were taken from the task cache */
+    unsigned long ms_Frees;             /* Blocks released by free() */
+    unsigned long ms_CacheFrees;        /* ... of which were kept in the task cache */
+    unsigned long ms_CacheFlushed;      /* Cached blocks given back to the pool */
+    unsigned long ms_ReallocInPlace;    /* realloc() calls served without moving */
+    unsigned long ms_ReallocMoved;      /* realloc() calls which had to copy */
+};
+
 __BEGIN_DECLS
 
 struct StdCBase *__aros_getbase_StdCBase(void);
@@ -48,6 +60,7 @@ void __stdc_set_exitjmp(jmp_buf exitjmp, jmp_buf previousjmp);
 void __stdc_jmp2exit(int normal, int returncode) __noreturn;
 void *__stdc_set_fpuprivate(void *fpuprivate);
 void *__stdc_get_fpuprivate(void);
+void __stdc_get_mallocstats(struct __stdc_mallocstats *stats);
 
 __END_DECLS
 
@@ -48,18 +48,44 @@
 	free()
 
     INTERNALS
+	Small requests are rounded up to a multiple of MALLOC_CACHE_GRAIN.
+	When called by the task which opened the library, they are served
+	from a per size class cache of freed blocks first, which needs no
+	locking as no other task ever touches it.
 
 ******************************************************************************/
 {
     struct StdCIntBase *StdCBase = (struct StdCIntBase *)__aros_getbase_StdCBase();
     UBYTE *mem = NULL;
+    size_t capacity = size;
+
+    StdCBase->malloc_stats.ms_Allocs++;
+
+    if (size <= MALLOC_CACHE_MAXSIZE)
+    {
+        int class = MALLOC_CACHE_CLASS(size);
+
+        capacity = (class + 1) * MALLOC_CACHE_GRAIN;
+
+        if ((StdCBase->malloc_cache[class] != NULL) &&
+            (FindTask(NULL) == StdCBase->malloc_owner))
+        {
+            /* Cached blocks are linked through their first word */
+            mem = StdCBase->malloc_cache[class];
+            StdCBase->malloc_cache[class] = *((APTR *)mem);
+            StdCBase->malloc_cachecnt[class]--;
+            StdCBase->malloc_stats.ms_CacheHits++;
+
+            return mem;
+        }
+    }
 
     /* Allocate the memory */
-    mem = AllocPooled (StdCBase->mempool, size + AROS_ALIGN(sizeof(size_t)));
+    mem = AllocPooled (StdCBase->mempool, capacity + MALLOC_HEADER);
     if (mem)
     {
-	*((size_t *)mem) = size;
-	mem += AROS_ALIGN(sizeof(size_t));
+	*((size_t *)mem) = capacity;
+	mem += MALLOC_HEADER;
     }
     else
         errno = ENOMEM;
@@ -69,13 +95,35 @@
 } /* malloc */
 
 
+/*
+ * Give cached blocks of the given class back to the pool until only
+ * 'keep' of them remain. Must be called by the owner of the cache.
+ */
+void __malloc_flushcache(struct StdCIntBase *StdCBase, int class, int keep)
+{
+    size_t size = (class + 1) * MALLOC_CACHE_GRAIN + MALLOC_HEADER;
+
+    while (StdCBase->malloc_cachecnt[class] > keep)
+    {
+        UBYTE *mem = StdCBase->malloc_cache[class];
+
+        StdCBase->malloc_cache[class] = *((APTR *)mem);
+        StdCBase->malloc_cachecnt[class]--;
+        StdCBase->malloc_stats.ms_CacheFlushed++;
+
+        FreePooled (StdCBase->mempool, mem - MALLOC_HEADER, size);
+    }
+}
+
+
 int __init_memstuff(struct StdCIntBase *StdCBase)
 {
     D(bug("__init_memstuff: task(%x), StdCBase(%x)\n",
           FindTask(NULL), StdCBase
     ));
 
-    StdCBase->mempool = CreatePool(MEMF_ANY | MEMF_SEM_PROTECTED, 65536L, 4096L);
+    StdCBase->mempool = CreatePool(MEMF_ANY | MEMF_SEM_PROTECTED | MEMF_SLAB_POOLED, 65536L, 4096L);
+    StdCBase->malloc_owner = FindTask(NULL);
 
     D(bug("__init_memstuff: StdCBase->mempool(%x)\n", StdCBase->mempool));
 
@@ -94,6 +142,7 @@ void __exit_memstuff(struct StdCIntBase *StdCBase)
           FindTask(NULL), StdCBase, StdCBase->mempool
     ));
 
+    /* The task cache is part of the pool, so it goes away with it */
     if (StdCBase->mempool)
     {
 	DeletePool(StdCBase->mempool);
@@ -8,6 +8,8 @@
 #include <aros/cpu.h>
 #include <proto/exec.h>
 
+#include "__stdc_intbase.h"
+
 /*****************************************************************************
 
     NAME */
@@ -46,43 +48,46 @@
 	calloc(), free(), malloc()
 
     INTERNALS
+	The size stored in front of a block is its capacity, so a block
+	can grow in place as long as the new size fits in it. When a block
+	has to move, some room for further growth is reserved, so that
+	repeatedly enlarging a buffer does not copy it every time.
 
 ******************************************************************************/
 {
+    struct StdCIntBase *StdCBase = (struct StdCIntBase *)__aros_getbase_StdCBase();
     UBYTE * mem, * newmem;
-    size_t oldsize;
+    size_t oldsize, headroom = 0;
 
     if (!oldmem)
 	return malloc (size);
 
-    mem = (UBYTE *)oldmem - AROS_ALIGN(sizeof(size_t));
+    mem = (UBYTE *)oldmem - MALLOC_HEADER;
     oldsize = *((size_t *)mem);
 
-    /* Reduce or enlarge the memory ? */
-    if (size < oldsize)
+    /* Keep the block if it is large enough and does not shrink by much */
+    if ((size <= oldsize) && ((oldsize - size) < 4096))
     {
-	/* Don't change anything for small changes */
-	if ((oldsize - size) < 4096)
-	    newmem = oldmem;
-	else
-	    goto copy;
+	StdCBase->malloc_stats.ms_ReallocInPlace++;
+	return oldmem;
     }
-    else if (size == oldsize) /* Keep the size ? */
-	newmem = oldmem;
-    else
-    {
-copy:
+
+    /* Reserve a quarter more for larger blocks which keep growing */
+    if (size > oldsize && size > MALLOC_CACHE_MAXSIZE)
+	headroom = size / 4;
+
+    newmem = malloc (size + headroom);
+    if (!newmem && headroom)
 	newmem = malloc (size);
 
-	if (newmem)
-	{
-	    if (size > oldsize)
-		size = oldsize;
-	    CopyMem (oldmem, newmem, size);
-	    free (oldmem);
-	}
+    if (newmem)
+    {
+	if (size > oldsize)
+	    size = oldsize;
+	CopyMem (oldmem, newmem, size);
+	free (oldmem);
+	StdCBase->malloc_stats.ms_ReallocMoved++;
     }
 
     return newmem;
 } /* realloc */
-
@@ -0,0 +1,213 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Times JPEG decoding the way jpeg.datatype does it, for every
+    DCT scaling factor it can choose with PDTA_MaxDecodeWidth and
+    PDTA_MaxDecodeHeight: 1/1 with the default DCT, and 1/2, 1/4 and
+    1/8 with the fast integer DCT. Scanlines are read in strips of one
+    MCU row, and the file is read into memory first, so only decoding
+    is timed.
+
+    The program only uses the C library and libjpeg, so it can be built
+    and run on the host as well:
+
+        cc -O2 -o jpegscale jpegscale.c -ljpeg && ./jpegscale [-r rounds] file.jpg ...
+
+    Without files, the test pictures of the jpeg.datatype are used.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/time.h>
+
+#include <jpeglib.h>
+
+#define DEFAULT_ROUNDS  10
+#define DEFAULT_FILE    "Datatypes/jpeg/tulips-1280x749.jpg"
+
+struct error_mgr
+{
+    struct jpeg_error_mgr pub;
+    jmp_buf setjmp_buffer;
+};
+
+static void error_exit(j_common_ptr cinfo)
+{
+    struct error_mgr *err = (struct error_mgr *)cinfo->err;
+
+    (*cinfo->err->output_message)(cinfo);
+    longjmp(err->setjmp_buffer, 1);
+}
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+static unsigned char *readfile(const char *name, unsigned long *size)
+{
+    unsigned char *data = NULL;
+    FILE *f;
+    long len;
+
+    if (!(f = fopen(name, "rb")))
+        return NULL;
+
+    if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) > 0 &&
+        fseek(f, 0, SEEK_SET) == 0 && (data = malloc(len)))
+    {
+        if (fread(data, 1, len, f) == (size_t)len)
+            *size = len;
+        else
+        {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(f);
+
+    return data;
+}
+
+/* Decodes the picture once, returns 0 on failure */
+static int decode(unsigned char *data, unsigned long size, unsigned int denom,
+                  unsigned int *width, unsigned int *height)
+{
+    struct jpeg_decompress_struct cinfo;
+    struct error_mgr jerr;
+    JSAMPARRAY buffer;
+    JSAMPLE *strip;
+    int row_stride, strip_height, row;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = error_exit;
+    if (setjmp(jerr.setjmp_buffer))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        return 0;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, data, size);
+    (void) jpeg_read_header(&cinfo, TRUE);
+
+    cinfo.out_color_space = JCS_RGB;
+    if (denom > 1)
+    {
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = denom;
+        cinfo.dct_method = JDCT_IFAST;
+        cinfo.do_fancy_upsampling = FALSE;
+    }
+    (void) jpeg_start_decompress(&cinfo);
+
+    row_stride = cinfo.output_width * cinfo.output_components;
+#if JPEG_LIB_VERSION >= 70
+    strip_height = cinfo.max_v_samp_factor * cinfo.min_DCT_v_scaled_size;
+#else
+    /* e.g. libjpeg-turbo on the host */
+    strip_height = cinfo.max_v_samp_factor * cinfo.min_DCT_scaled_size;
+#endif
+    if (strip_height < cinfo.rec_outbuf_height)
+        strip_height = cinfo.rec_outbuf_height;
+    strip = (JSAMPLE *)(*cinfo.mem->alloc_large)
+        ((j_common_ptr)&cinfo, JPOOL_IMAGE, (size_t)row_stride * strip_height);
+    buffer = (JSAMPARRAY)(*cinfo.mem->alloc_small)
+        ((j_common_ptr)&cinfo, JPOOL_IMAGE, strip_height * sizeof(JSAMPROW));
+    for (row = 0; row < strip_height; row++)
+        buffer[row] = strip + row * row_stride;
+
+    while (cinfo.output_scanline < cinfo.output_height)
+    {
+        row = 0;
+        while (row < strip_height && cinfo.output_scanline < cinfo.output_height)
+            row += jpeg_read_scanlines(&cinfo, buffer + row, strip_height - row);
+    }
+
+    *width = cinfo.output_width;
+    *height = cinfo.output_height;
+
+    (void) jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *defaultfiles[] = { DEFAULT_FILE };
+    const char **files = defaultfiles;
+    int nfiles = 1, rounds = DEFAULT_ROUNDS;
+    int rc = 0, i;
+
+    if (argc > 2 && !strcmp(argv[1], "-r"))
+    {
+        rounds = atoi(argv[2]);
+        if (rounds < 1)
+            rounds = 1;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc > 1)
+    {
+        files = (const char **)&argv[1];
+        nfiles = argc - 1;
+    }
+
+    printf("File                            Scale      Size     ms/decode   Speedup\n");
+
+    for (i = 0; i < nfiles; i++)
+    {
+        unsigned char *data;
+        unsigned long size;
+        unsigned int denom;
+        const char *name;
+        double full = 0.0;
+
+        if (!(data = readfile(files[i], &size)))
+        {
+            printf("%-30s  cannot read file\n", files[i]);
+            rc = 10;
+            continue;
+        }
+        name = strrchr(files[i], '/') ? strrchr(files[i], '/') + 1 : files[i];
+
+        for (denom = 1; denom <= 8; denom <<= 1)
+        {
+            struct timeval tv_start, tv_end;
+            unsigned int width = 0, height = 0;
+            double elapsed;
+            int r;
+
+            gettimeofday(&tv_start, NULL);
+            for (r = 0; r < rounds; r++)
+            {
+                if (!decode(data, size, denom, &width, &height))
+                    break;
+            }
+            gettimeofday(&tv_end, NULL);
+
+            if (r < rounds)
+            {
+                printf("%-30s  1/%u   decoding failed\n", name, denom);
+                rc = 10;
+                break;
+            }
+
+            elapsed = elapsedsecs(&tv_start, &tv_end);
+            if (denom == 1)
+                full = elapsed;
+            printf("%-30s  1/%u   %5ux%-5u   %9.3f   %7.2f\n",
+                name, denom, width, height, elapsed * 1000. / rounds,
+                elapsed > 0.0 ? full / elapsed : 0.0);
+        }
+
+        free(data);
+    }
+
+    return rc;
+}
@@ -0,0 +1,329 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Regression test and benchmark of the truecolor to colormapped
+    conversion of picture.datatype (quantize.c). For every picture and
+    number of pens it times the histogram and median cut palette, the
+    inverse color map and remapping without dithering, with ordered
+    dithering and with Floyd-Steinberg dithering, and prints the PSNR
+    of each result. The inverse color map is checked against a search
+    of the whole palette for every cell.
+
+    It is built and run on the host:
+
+        cc -O2 -I$(AROS)/workbench/classes/datatypes/picture -o remap remap.c \
+            $(AROS)/workbench/classes/datatypes/picture/quantize.c -lm
+        ./remap [-r rounds] [-o prefix] [picture.ppm ...]
+
+    Pictures are binary PPM (P6) files with 8 bits per gun. Without
+    pictures a gradient and a noisy synthetic picture are used. With -o
+    the results are written as <prefix><picture>-<pens>-<mode>.ppm.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "quantize.h"
+
+#define DEFAULT_ROUNDS  3
+#define SYNTHWIDTH      640
+#define SYNTHHEIGHT     480
+
+struct Picture
+{
+    const char  *name;
+    ULONG       width, height;
+    UBYTE       *rgb;
+};
+
+static const int penlist[] = { 256, 64, 16, 0 };
+static const char *modenames[] = { "none", "ordered", "fs" };
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+static int readppm(struct Picture *pic, const char *name)
+{
+    FILE *f;
+    unsigned long width, height;
+    int maxval;
+    size_t size;
+
+    if (!(f = fopen(name, "rb")))
+        return 0;
+    if (fscanf(f, "P6 %lu %lu %d", &width, &height, &maxval) != 3 ||
+        maxval != 255 || fgetc(f) == EOF)
+    {
+        fclose(f);
+        return 0;
+    }
+    pic->width = width;
+    pic->height = height;
+    size = (size_t)pic->width * pic->height * 3;
+    if (!(pic->rgb = malloc(size)) || fread(pic->rgb, 1, size, f) != size)
+    {
+        free(pic->rgb);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    pic->name = strrchr(name, '/') ? strrchr(name, '/') + 1 : name;
+
+    return 1;
+}
+
+static void writeppm(const char *name, struct QuantMap *qm, UBYTE *pens, ULONG width, ULONG height)
+{
+    FILE *f;
+    ULONG i;
+
+    if (!(f = fopen(name, "wb")))
+        return;
+    fprintf(f, "P6\n%lu %lu\n255\n", (unsigned long)width, (unsigned long)height);
+    for (i = 0; i < width * height; i++)
+        fwrite(qm->PenColors + pens[i] * 3, 1, 3, f);
+    fclose(f);
+}
+
+static void synthesize(struct Picture *pic, int noisy)
+{
+    ULONG seed = 12345, x, y;
+    UBYTE *p;
+
+    pic->name = noisy ? "synthetic" : "gradient";
+    pic->width = SYNTHWIDTH;
+    pic->height = SYNTHHEIGHT;
+    if (!(p = pic->rgb = malloc(SYNTHWIDTH * SYNTHHEIGHT * 3)))
+        return;
+
+    for (y = 0; y < SYNTHHEIGHT; y++)
+    {
+        for (x = 0; x < SYNTHWIDTH; x++)
+        {
+            int r = x * 256 / SYNTHWIDTH;
+            int g = y * 256 / SYNTHHEIGHT;
+            int b = ((SYNTHWIDTH - x) * 256 / SYNTHWIDTH + (SYNTHHEIGHT - y) * 256 / SYNTHHEIGHT) / 2;
+
+            if (noisy)
+            {
+                /* Some blobs of skin, sky and foliage plus noise */
+                double dx = (double)x - SYNTHWIDTH / 3, dy = (double)y - SYNTHHEIGHT / 2;
+
+                if (dx * dx + dy * dy < 120 * 120)
+                    r = 224, g = 172, b = 140;
+                else if (y < SYNTHHEIGHT / 4)
+                    r = 90, g = 150, b = 230;
+                else if (x > SYNTHWIDTH * 2 / 3)
+                    r = 40, g = 120 + (x & 31), b = 30;
+                seed = seed * 1103515245 + 12345;
+                r += (int)((seed >> 16) % 25) - 12;
+                g += (int)((seed >> 8) % 25) - 12;
+                b += (int)((seed >> 20) % 25) - 12;
+            }
+            *p++ = r < 0 ? 0 : r > 255 ? 255 : r;
+            *p++ = g < 0 ? 0 : g > 255 ? 255 : g;
+            *p++ = b < 0 ? 0 : b > 255 ? 255 : b;
+        }
+    }
+}
+
+/* Returns the number of cells which don't map to a closest pen */
+static ULONG checkmap(struct QuantMap *qm, int numcolors)
+{
+    ULONG cell, bad = 0;
+
+    for (cell = 0; cell < QUANT_CELLS; cell++)
+    {
+        int r = ((cell >> 10) << 3) + 4, g = (((cell >> 5) & 31) << 3) + 4, b = ((cell & 31) << 3) + 4;
+        const UBYTE *col = qm->PenColors + qm->InvMap[cell] * 3;
+        long got, best = -1;
+        int i;
+
+        got = 3L * (r - col[0]) * (r - col[0]) + 4L * (g - col[1]) * (g - col[1]) + 2L * (b - col[2]) * (b - col[2]);
+        for (i = 0; i < numcolors; i++)
+        {
+            const UBYTE *c = qm->Colors + i * 3;
+            long dist = 3L * (r - c[0]) * (r - c[0]) + 4L * (g - c[1]) * (g - c[1]) + 2L * (b - c[2]) * (b - c[2]);
+
+            if (best < 0 || dist < best)
+                best = dist;
+        }
+        if (got != best)
+            bad++;
+    }
+
+    return bad;
+}
+
+static double psnr(struct Picture *pic, struct QuantMap *qm, UBYTE *pens)
+{
+    double sum = 0.0;
+    ULONG i;
+
+    for (i = 0; i < pic->width * pic->height * 3; i++)
+    {
+        double d = (double)pic->rgb[i] - qm->PenColors[pens[i / 3] * 3 + i % 3];
+
+        sum += d * d;
+    }
+    sum /= pic->width * pic->height * 3;
+
+    return sum > 0.0 ? 10.0 * log10(255.0 * 255.0 / sum) : 99.0;
+}
+
+static int testpicture(struct Picture *pic, int rounds, const char *prefix)
+{
+    struct QuantHist *qh = malloc(sizeof(struct QuantHist));
+    struct QuantMap *qm = malloc(sizeof(struct QuantMap));
+    struct QuantDither qd;
+    UBYTE *pens = malloc(pic->width * pic->height);
+    WORD *errbuf = malloc(QUANT_DITHERBUF(pic->width));
+    double mpixels = (double)pic->width * pic->height * rounds / 1000000.;
+    int p, rc = 0;
+
+    if (!qh || !qm || !pens || !errbuf)
+    {
+        printf("%-16s out of memory\n", pic->name);
+        rc = 1;
+        goto out;
+    }
+
+    for (p = 0; penlist[p]; p++)
+    {
+        struct timeval tv_start, tv_end;
+        double tpalette, tmap;
+        int numcolors = 0, mode, i, r;
+        ULONG y, bad;
+
+        gettimeofday(&tv_start, NULL);
+        for (r = 0; r < rounds; r++)
+        {
+            memset(qh->Count, 0, sizeof(qh->Count));
+            QuantHistogram(qh, pic->rgb, pic->width, pic->height, pic->width * 3, 3, 0);
+            numcolors = QuantMedianCut(qh, qm->Colors, penlist[p]);
+        }
+        gettimeofday(&tv_end, NULL);
+        tpalette = elapsedsecs(&tv_start, &tv_end) / rounds;
+
+        /* Use other pens than palette entries to catch mixups */
+        for (i = 0; i < numcolors; i++)
+            qm->Pens[i] = 255 - i;
+
+        gettimeofday(&tv_start, NULL);
+        for (r = 0; r < rounds; r++)
+            QuantInitMap(qm, numcolors);
+        gettimeofday(&tv_end, NULL);
+        tmap = elapsedsecs(&tv_start, &tv_end) / rounds;
+
+        bad = checkmap(qm, numcolors);
+        printf("%-16s %4d pens  %3d colors  palette %8.3f ms  map %8.3f ms%s\n",
+            pic->name, penlist[p], numcolors, tpalette * 1000., tmap * 1000.,
+            bad ? "  INVERSE MAP MISMATCH" : "");
+        if (bad)
+            rc = 1;
+
+        for (mode = QUANT_DITHER_NONE; mode <= QUANT_DITHER_FS; mode++)
+        {
+            double elapsed;
+
+            gettimeofday(&tv_start, NULL);
+            for (r = 0; r < rounds; r++)
+            {
+                QuantInitDither(&qd, mode, 4, errbuf, pic->width);
+                for (y = 0; y < pic->height; y++)
+                    QuantRemapLine(qm, &qd, pic->rgb + y * pic->width * 3, 3, 0,
+                                   pens + y * pic->width, pic->width);
+            }
+            gettimeofday(&tv_end, NULL);
+            elapsed = elapsedsecs(&tv_start, &tv_end);
+
+            for (y = 0; y < pic->width * pic->height; y++)
+            {
+                for (i = 0; i < numcolors && qm->Pens[i] != pens[y]; i++)
+                    ;
+                if (i == numcolors)
+                {
+                    printf("%-16s    remapped to pen %d which isn't in the palette\n", pic->name, pens[y]);
+                    rc = 1;
+                    break;
+                }
+            }
+
+            printf("%-16s    %-8s %8.3f ms/MPixel  PSNR %6.2f dB\n",
+                pic->name, modenames[mode], elapsed * 1000. / mpixels, psnr(pic, qm, pens));
+
+            if (prefix)
+            {
+                char name[1024];
+
+                snprintf(name, sizeof(name), "%s%s-%d-%s.ppm", prefix, pic->name, penlist[p], modenames[mode]);
+                writeppm(name, qm, pens, pic->width, pic->height);
+            }
+        }
+    }
+
+out:
+    free(errbuf);
+    free(pens);
+    free(qm);
+    free(qh);
+
+    return rc;
+}
+
+int main(int argc, char *argv[])
+{
+    struct Picture pic;
+    const char *prefix = NULL;
+    int rounds = DEFAULT_ROUNDS;
+    int rc = 0, i;
+
+    while (argc > 2 && argv[1][0] == '-')
+    {
+        if (!strcmp(argv[1], "-r"))
+        {
+            rounds = atoi(argv[2]);
+            if (rounds < 1)
+                rounds = 1;
+        }
+        else if (!strcmp(argv[1], "-o"))
+            prefix = argv[2];
+        else
+            break;
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (argc < 2)
+    {
+        for (i = 0; i < 2; i++)
+        {
+            synthesize(&pic, i);
+            if (!pic.rgb)
+                return 20;
+            rc |= testpicture(&pic, rounds, prefix);
+            free(pic.rgb);
+        }
+    }
+    for (i = 1; i < argc; i++)
+    {
+        memset(&pic, 0, sizeof(pic));
+        if (!readppm(&pic, argv[i]))
+        {
+            printf("%s: cannot read picture\n", argv[i]);
+            rc = 1;
+            continue;
+        }
+        rc |= testpicture(&pic, rounds, prefix);
+        free(pic.rgb);
+    }
+
+    return rc ? 10 : 0;
+}
@@ -11,7 +11,56 @@
 #include <exec/memory.h>
 #include <proto/exec.h>
 
-int main()
+#define MAXLIVE 65536
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+/*
+ * Time pairs of AllocPooled()/FreePooled() on a pool which already holds
+ * 'live' blocks of mixed sizes, with every other one freed again so that
+ * the puddles are fragmented.
+ */
+static double scaling(ULONG requirements, int live, int count)
+{
+    struct timeval  tv_start,
+                    tv_end;
+    static APTR     blocks[MAXLIVE];
+    APTR            pool;
+    APTR            memory;
+    int             i;
+
+    pool = CreatePool(requirements, 4096, 4096);
+    if (!pool)
+        return 0.0;
+
+    for (i = 0; i < live; i++)
+        blocks[i] = AllocPooled(pool, 16 + (i % 29) * 24);
+
+    for (i = 0; i < live; i += 2)
+    {
+        if (blocks[i]) FreePooled(pool, blocks[i], 16 + (i % 29) * 24);
+    }
+
+    gettimeofday(&tv_start, NULL);
+
+    for (i = 0; i < count; i++)
+    {
+        memory = AllocPooled(pool, 100);
+        if (memory) FreePooled(pool, memory, 100);
+    }
+
+    gettimeofday(&tv_end, NULL);
+
+    DeletePool(pool);
+
+    return elapsedsecs(&tv_start, &tv_end);
+}
+
+int main(int argc, char **argv)
 {
     struct timeval  tv_start, 
                     tv_end;
@@ -21,6 +70,24 @@ int main()
     APTR            pool;
     APTR            memory;
     
+    if ((argc > 1) && !strcmp(argv[1], "SCALING"))
+    {
+        int live;
+
+        count = 1000000;
+
+        printf("Live blocks   Default pool (s)   Slab pool (s)\n");
+        for (live = 0; live <= MAXLIVE; live = live ? live * 2 : 256)
+        {
+            double def  = scaling(MEMF_ANY, live, count);
+            double slab = scaling(MEMF_ANY | MEMF_SLAB_POOLED, live, count);
+
+            printf("%11d   %16f   %13f\n", live, def, slab);
+        }
+
+        return 0;
+    }
+
     pool = CreatePool(MEMF_ANY, 4 * 100, 100);
     AllocPooled(pool, 100); // Avoid bad behaviour of FreePooled()
     
@@ -36,8 +103,7 @@ int main()
     
     DeletePool(pool);
     
-    elapsed = ((double)(((tv_end.tv_sec * 1000000) + tv_end.tv_usec) 
-            - ((tv_start.tv_sec * 1000000) + tv_start.tv_usec)))/1000000.;
+    elapsed = elapsedsecs(&tv_start, &tv_end);
     
     printf
     (
@@ -35,6 +35,8 @@ struct GfxBase *GfxBase;
 static struct Screen *scr;
 static struct Window *win;
 static struct Task   *task1, *task2, *maintask;
+static struct Task   **idletasks;
+static LONG          numidle;
 
 static LONG counter;
 
@@ -57,7 +59,16 @@ static void Cleanup(char *msg)
     Forbid();
     if (task1) DeleteTask(task1);
     if (task2) DeleteTask(task2);
+    if (idletasks)
+    {
+        LONG i;
+
+        for (i = 0; i < numidle; i++)
+            if (idletasks[i]) DeleteTask(idletasks[i]);
+    }
     Permit();
+
+    free(idletasks);
     
     if (win) CloseWindow(win);
     if (scr) UnlockPubScreen(0,scr);
@@ -191,6 +202,44 @@ static void MakeTasks(void)
 
 /****************************************************************************************/
 
+/*
+ * Scaling mode: tasks which never get a signal and just sit in TaskWait,
+ * plus every fourth one busy looping at a low priority so that TaskReady
+ * is populated too. A scheduler which walks these lists on every switch
+ * shows a falling result as their number grows.
+ */
+
+static void IdleTask(void)
+{
+    Wait(0);
+}
+
+static void BusyTask(void)
+{
+    for(;;);
+}
+
+static void MakeIdleTasks(void)
+{
+    LONG i;
+
+    if (!numidle) return;
+
+    if (!(idletasks = calloc(numidle, sizeof(struct Task *)))) Cleanup("Out of memory!");
+
+    for(i = 0; i < numidle; i++)
+    {
+        if (i % 4 == 3)
+            idletasks[i] = CreateTask("Busy Task", -10, BusyTask, AROS_STACKSIZE);
+        else
+            idletasks[i] = CreateTask("Idle Task", 0, IdleTask, AROS_STACKSIZE);
+
+        if (!idletasks[i]) Cleanup("Can't create idle tasks!");
+    }
+}
+
+/****************************************************************************************/
+
 static void Action(void)
 {
     struct RastPort *rp = win->RPort;
@@ -249,7 +298,7 @@ static void Action(void)
 
     SetAPen(rp, 1);
     
-    sprintf(s, "Benchmark result: %ld",counter);
+    sprintf(s, "Benchmark result: %ld (%ld idle tasks)",counter,numidle);
 
     Move(rp, x, y + rp->TxBaseline);
     Text(rp, s, strlen(s));
@@ -293,12 +342,16 @@ static void HandleAll(void)
 
 /****************************************************************************************/
 
-int main(void)
+int main(int argc, char **argv)
 {
+    /* Optional argument: number of idle tasks for the scaling mode */
+    if (argc > 1) numidle = atol(argv[1]);
+
     OpenLibs();
     GetVisual();
     MakeWin();
     MakeTasks();
+    MakeIdleTasks();
     HandleAll();
     Cleanup(0);
     return 0;
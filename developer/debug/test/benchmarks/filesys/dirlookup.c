@@ -0,0 +1,189 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Desc: Benchmark of looking up names in large directories
+*/
+
+/*
+ * Fills a directory with an increasing number of empty files and
+ * times Lock() of existing names in random order, Lock() of names
+ * which don't exist (as done before creating a file), and Open() of
+ * existing files, for every directory size. Run it on the volume to
+ * test, e.g. a PFS3 partition:
+ *
+ *     dirlookup DIR DH1:lookuptest [LOOKUPS <n>] [MAXFILES <n>]
+ *
+ * The directory is created and removed again with all files in it.
+ */
+
+#include <exec/types.h>
+#include <dos/dos.h>
+#include <proto/dos.h>
+#include <proto/exec.h>
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ARG_TEMPLATE    "DIR/A,LOOKUPS/K/N,MAXFILES/K/N"
+#define DEFAULT_LOOKUPS 10000
+#define DEFAULT_MAX     20000
+
+static ULONG seed = 12345;
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+static ULONG randomnr(ULONG max)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % max;
+}
+
+static void filename(char *buf, const char *dir, const char *prefix, ULONG nr)
+{
+    sprintf(buf, "%s/%s%06lu", dir, prefix, (unsigned long)nr);
+}
+
+static BOOL createfiles(const char *dir, ULONG *created, ULONG to)
+{
+    char name[256];
+    BPTR fh;
+
+    for (; *created < to; (*created)++)
+    {
+        filename(name, dir, "file", *created);
+        if (!(fh = Open(name, MODE_NEWFILE)))
+            return FALSE;
+        Close(fh);
+    }
+
+    return TRUE;
+}
+
+static void deletefiles(const char *dir, ULONG count)
+{
+    char name[256];
+    ULONG i;
+
+    for (i = 0; i < count; i++)
+    {
+        filename(name, dir, "file", i);
+        DeleteFile(name);
+    }
+}
+
+/* Returns the number of lookups per second, or -1 on failure */
+static double lookups(const char *dir, ULONG files, ULONG count, int what)
+{
+    struct timeval tv_start, tv_end;
+    char name[256];
+    double elapsed;
+    BPTR lock;
+    ULONG i;
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < count; i++)
+    {
+        switch (what)
+        {
+        case 0:
+            filename(name, dir, "file", randomnr(files));
+            if (!(lock = Lock(name, SHARED_LOCK)))
+                return -1;
+            UnLock(lock);
+            break;
+
+        case 1:
+            filename(name, dir, "none", randomnr(files));
+            if ((lock = Lock(name, SHARED_LOCK)))
+            {
+                UnLock(lock);
+                return -1;
+            }
+            break;
+
+        case 2:
+            filename(name, dir, "file", randomnr(files));
+            if (!(lock = Open(name, MODE_OLDFILE)))
+                return -1;
+            Close(lock);
+            break;
+        }
+    }
+    gettimeofday(&tv_end, NULL);
+
+    elapsed = elapsedsecs(&tv_start, &tv_end);
+    return elapsed > 0.0 ? count / elapsed : 0.0;
+}
+
+int main(int argc, char *argv[])
+{
+    struct RDArgs   *rda;
+    IPTR            args[3] = { 0, 0, 0 };
+    ULONG           count = DEFAULT_LOOKUPS;
+    ULONG           max = DEFAULT_MAX;
+    ULONG           files, created = 0;
+    const char      *dir;
+    BPTR            lock;
+    int             rc = RETURN_OK;
+
+    rda = ReadArgs(ARG_TEMPLATE, args, NULL);
+    if (!rda)
+    {
+        PrintFault(IoErr(), argv[0]);
+        return RETURN_ERROR;
+    }
+
+    dir = (const char *)args[0];
+    if (args[1])
+        count = *(LONG *)args[1];
+    if (args[2])
+        max = *(LONG *)args[2];
+
+    if (!(lock = CreateDir(dir)))
+    {
+        PrintFault(IoErr(), dir);
+        FreeArgs(rda);
+        return RETURN_ERROR;
+    }
+    UnLock(lock);
+
+    printf("   Files   Lock/s (found)   Lock/s (missing)   Open/s\n");
+
+    for (files = 10; files <= max; files *= 10)
+    {
+        double found, missing, open;
+
+        if (!createfiles(dir, &created, files))
+        {
+            PrintFault(IoErr(), "Cannot create files");
+            rc = RETURN_FAIL;
+            break;
+        }
+
+        found = lookups(dir, files, count, 0);
+        missing = lookups(dir, files, count, 1);
+        open = lookups(dir, files, count, 2);
+        if (found < 0 || missing < 0 || open < 0)
+        {
+            printf("%8lu   lookup failed\n", (unsigned long)files);
+            rc = RETURN_FAIL;
+            break;
+        }
+
+        printf("%8lu   %14.1f   %16.1f   %6.1f\n",
+            (unsigned long)files, found, missing, open);
+    }
+
+    deletefiles(dir, created);
+    DeleteFile(dir);
+
+    FreeArgs(rda);
+
+    return rc;
+}
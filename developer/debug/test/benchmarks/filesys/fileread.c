@@ -0,0 +1,106 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Desc: Benchmark of sequential file reads
+*/
+
+/*
+ * Reads a file from start to end with Read() calls of the given size
+ * and prints the throughput, e.g. for a large file on a CD or a disk
+ * image mounted through diskimage.device:
+ *
+ *     fileread FILE CD0:big.iso [BUFSIZE <bytes>] [PASSES <n>]
+ *
+ * Every pass after the first one shows the effect of caching.
+ */
+
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <dos/dos.h>
+#include <proto/dos.h>
+#include <proto/exec.h>
+
+#include <sys/time.h>
+#include <stdio.h>
+
+#define ARG_TEMPLATE    "FILE/A,BUFSIZE/K/N,PASSES/K/N"
+#define DEFAULT_BUFSIZE 65536
+#define DEFAULT_PASSES  2
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+int main(int argc, char *argv[])
+{
+    struct RDArgs   *rda;
+    IPTR            args[3] = { 0, 0, 0 };
+    struct timeval  tv_start, tv_end;
+    LONG            bufsize = DEFAULT_BUFSIZE;
+    LONG            passes = DEFAULT_PASSES;
+    UBYTE           *buffer;
+    int             rc = RETURN_OK;
+    LONG            pass;
+
+    rda = ReadArgs(ARG_TEMPLATE, args, NULL);
+    if (!rda)
+    {
+        PrintFault(IoErr(), argv[0]);
+        return RETURN_ERROR;
+    }
+
+    if (args[1])
+        bufsize = *(LONG *)args[1];
+    if (args[2])
+        passes = *(LONG *)args[2];
+    if (bufsize < 1)
+        bufsize = 1;
+
+    if (!(buffer = AllocVec(bufsize, MEMF_ANY)))
+    {
+        PrintFault(ERROR_NO_FREE_STORE, argv[0]);
+        FreeArgs(rda);
+        return RETURN_FAIL;
+    }
+
+    for (pass = 1; pass <= passes; pass++)
+    {
+        UQUAD total = 0;
+        double elapsed;
+        LONG len;
+        BPTR fh;
+
+        if (!(fh = Open((STRPTR)args[0], MODE_OLDFILE)))
+        {
+            PrintFault(IoErr(), (STRPTR)args[0]);
+            rc = RETURN_FAIL;
+            break;
+        }
+
+        gettimeofday(&tv_start, NULL);
+        while ((len = Read(fh, buffer, bufsize)) > 0)
+            total += len;
+        gettimeofday(&tv_end, NULL);
+        Close(fh);
+
+        if (len < 0)
+        {
+            PrintFault(IoErr(), (STRPTR)args[0]);
+            rc = RETURN_FAIL;
+            break;
+        }
+
+        elapsed = elapsedsecs(&tv_start, &tv_end);
+        printf("Pass %ld: %llu bytes in %f s, %.2f MB/s\n",
+            (long)pass, (unsigned long long)total, elapsed,
+            elapsed > 0.0 ? total / elapsed / (1024.0 * 1024.0) : 0.0);
+    }
+
+    FreeVec(buffer);
+    FreeArgs(rda);
+
+    return rc;
+}
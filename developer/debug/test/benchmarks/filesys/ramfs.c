@@ -0,0 +1,192 @@
+/*
+    Copyright  2019, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Measures the operations of a filesystem that depend on how it indexes
+    file data and directory entries: creating and looking up many files in
+    one directory, and random seeks and reads in one large file. It is
+    meant for RAM:, but any volume can be given. Run it once with the old
+    and once with the new handler to compare them.
+
+        ramfs [DIR <directory>] [FILES <n>] [SIZE <MB>] [SEEKS <n>]
+*/
+
+#include <proto/dos.h>
+#include <proto/exec.h>
+
+#include <dos/dos.h>
+#include <dos/rdargs.h>
+#include <exec/memory.h>
+#include <exec/types.h>
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ARG_TEMPLATE    "DIR/K,FILES/K/N,SIZE/K/N,SEEKS/K/N"
+#define ARG_DIR         0
+#define ARG_FILES       1
+#define ARG_SIZE        2
+#define ARG_SEEKS       3
+#define TOTAL_ARGS      4
+
+#define CHUNKSIZE       65536
+#define READSIZE        4096
+
+static ULONG seed = 1;
+
+static ULONG nextrandom(ULONG range)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % range;
+}
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+static void report(const char *what, int count, struct timeval *start)
+{
+    struct timeval  tv_end;
+    double          elapsed;
+
+    gettimeofday(&tv_end, NULL);
+    elapsed = elapsedsecs(start, &tv_end);
+
+    printf("%-24s %8d in %9f s, %10.1f per second\n",
+        what, count, elapsed, elapsed > 0.0 ? count / elapsed : 0.0);
+}
+
+static BOOL names(int files)
+{
+    struct timeval  tv_start;
+    char            name[32];
+    BPTR            file, lock;
+    int             i;
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < files; i++)
+    {
+        sprintf(name, "file%d", i);
+        if (!(file = Open(name, MODE_NEWFILE)))
+            return FALSE;
+        Close(file);
+    }
+    report("Create", files, &tv_start);
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < files; i++)
+    {
+        sprintf(name, "FILE%d", (int)nextrandom(files));
+        if (!(lock = Lock(name, ACCESS_READ)))
+            return FALSE;
+        UnLock(lock);
+    }
+    report("Lookup", files, &tv_start);
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < files; i++)
+    {
+        sprintf(name, "file%d", i);
+        if (!DeleteFile(name))
+            return FALSE;
+    }
+    report("Delete", files, &tv_start);
+
+    return TRUE;
+}
+
+static BOOL data(int size, int seeks)
+{
+    struct timeval  tv_start;
+    UBYTE           *buffer;
+    BPTR            file;
+    LONG            length = size * 1024 * 1024;
+    BOOL            success = TRUE;
+    int             i;
+
+    buffer = AllocVec(CHUNKSIZE, MEMF_ANY | MEMF_CLEAR);
+    if (!buffer)
+        return FALSE;
+
+    if ((file = Open("bigfile", MODE_NEWFILE)))
+    {
+        gettimeofday(&tv_start, NULL);
+        for (i = 0; success && i < length / CHUNKSIZE; i++)
+            success = Write(file, buffer, CHUNKSIZE) == CHUNKSIZE;
+        report("Write 64K", length / CHUNKSIZE, &tv_start);
+
+        gettimeofday(&tv_start, NULL);
+        for (i = 0; success && i < seeks; i++)
+        {
+            success = Seek(file, nextrandom(length - READSIZE), OFFSET_BEGINNING) != -1
+                && Read(file, buffer, READSIZE) == READSIZE;
+        }
+        report("Seek + read 4K", seeks, &tv_start);
+
+        gettimeofday(&tv_start, NULL);
+        for (i = 0; success && i < seeks; i++)
+        {
+            success = SetFileSize(file, length - nextrandom(length / 2), OFFSET_BEGINNING) != -1
+                && SetFileSize(file, length, OFFSET_BEGINNING) != -1;
+        }
+        report("Truncate + extend", seeks, &tv_start);
+
+        Close(file);
+        DeleteFile("bigfile");
+    }
+    else
+        success = FALSE;
+
+    FreeVec(buffer);
+
+    return success;
+}
+
+int main(int argc, char *argv[])
+{
+    struct RDArgs   *rda;
+    IPTR            args[TOTAL_ARGS] = { (IPTR)"RAM:", 0, 0, 0 };
+    int             files = 10000, size = 64, seeks = 10000;
+    BPTR            dir, olddir;
+    int             rc = RETURN_OK;
+
+    rda = ReadArgs(ARG_TEMPLATE, args, NULL);
+    if (!rda)
+    {
+        PrintFault(IoErr(), argv[0]);
+        return RETURN_ERROR;
+    }
+
+    if (args[ARG_FILES]) files = *(LONG *)args[ARG_FILES];
+    if (args[ARG_SIZE])  size  = *(LONG *)args[ARG_SIZE];
+    if (args[ARG_SEEKS]) seeks = *(LONG *)args[ARG_SEEKS];
+
+    if ((dir = Lock((STRPTR)args[ARG_DIR], ACCESS_READ)))
+    {
+        olddir = CurrentDir(dir);
+
+        printf("%d files, %d MB file, %d seeks in %s\n",
+            files, size, seeks, (STRPTR)args[ARG_DIR]);
+
+        if (!names(files) || !data(size, seeks))
+        {
+            PrintFault(IoErr(), argv[0]);
+            rc = RETURN_FAIL;
+        }
+
+        CurrentDir(olddir);
+        UnLock(dir);
+    }
+    else
+    {
+        PrintFault(IoErr(), argv[0]);
+        rc = RETURN_FAIL;
+    }
+
+    FreeArgs(rda);
+
+    return rc;
+}
@@ -0,0 +1,403 @@
+/*
+    Copyright  2019, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Replays an SFS metadata trace against two models of the SFS
+    CacheBuffer index: the old fixed table of 128 chains shared by
+    ORIGINAL and LATEST buffers, and the current table which is sized
+    to the number of buffers and keeps ORIGINAL and LATEST separate.
+
+    Both are models written for this program, the handler's own code
+    (rom/filesys/SFS/FS/cachebuffers.c) is not used. They follow its
+    chain sizing (HASHSIZE up to MAXHASHSIZE) and LRU reuse, so the
+    probe counts compare the two layouts, but they have to be kept in
+    step with the handler by hand and don't test it.
+
+    The program only uses the C library, so it can be built and run
+    on the host as well:
+
+        cc -O2 -o sfscache sfscache.c && ./sfscache [trace] [buffers]
+
+    A trace is either the debug output of SFS with DEBUG_CACHEBUFFER
+    enabled (the "readcb: block n" and "readorgcb: block n" lines are
+    used), or a file with one "R n" (read latest), "O n" (read
+    original), "W n" (modify) or "F" (flush) per line.  Without a
+    trace a synthetic metadata workload is generated.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CB_ORIGINAL (1)
+#define CB_LATEST   (2)
+
+#define FIXEDHASHSIZE (128)
+#define MAXHASHSIZE   (65536)
+#define SYNTHETIC     (2000000)
+
+enum { EV_READ, EV_ORIGINAL, EV_WRITE, EV_FLUSH };
+
+struct Event
+{
+    unsigned char type;
+    unsigned long block;
+};
+
+struct Buffer
+{
+    struct Buffer *lrunext, *lruprev;
+    struct Buffer *hashnext[2], *hashprev[2];
+    unsigned long  block;
+    unsigned char  bits;
+};
+
+struct Cache
+{
+    struct Buffer  *buffers;
+    struct Buffer   lru;            /* Sentinel, lru.lrunext is the LRU buffer */
+    struct Buffer **chains[2];
+    unsigned long   mask;
+    int             split;          /* Separate ORIGINAL and LATEST indexes? */
+    unsigned long   probes;
+    unsigned long   lookups;
+    unsigned long   misses;
+};
+
+static struct Event  *events;
+static unsigned long  eventcount;
+
+/* Index handling */
+
+static int chainof(struct Cache *c, unsigned char bit)
+{
+    return (c->split && bit == CB_LATEST) ? 1 : 0;
+}
+
+static void linkbuffer(struct Cache *c, struct Buffer *b, int i)
+{
+    struct Buffer **head = &c->chains[i][b->block & c->mask];
+
+    b->hashprev[i] = NULL;
+    b->hashnext[i] = *head;
+    if (*head)
+        (*head)->hashprev[i] = b;
+    *head = b;
+}
+
+static void unlinkbuffer(struct Cache *c, struct Buffer *b, int i)
+{
+    if (b->hashprev[i])
+        b->hashprev[i]->hashnext[i] = b->hashnext[i];
+    else
+        c->chains[i][b->block & c->mask] = b->hashnext[i];
+    if (b->hashnext[i])
+        b->hashnext[i]->hashprev[i] = b->hashprev[i];
+}
+
+static void setbits(struct Cache *c, struct Buffer *b, unsigned char bits)
+{
+    if (c->split)
+    {
+        if ((b->bits ^ bits) & CB_ORIGINAL)
+        {
+            if (bits & CB_ORIGINAL) linkbuffer(c, b, 0); else unlinkbuffer(c, b, 0);
+        }
+        if ((b->bits ^ bits) & CB_LATEST)
+        {
+            if (bits & CB_LATEST) linkbuffer(c, b, 1); else unlinkbuffer(c, b, 1);
+        }
+    }
+    else
+    {
+        /* A single chain holds the buffer as long as any bit is set */
+        if (b->bits == 0 && bits != 0) linkbuffer(c, b, 0);
+        else if (b->bits != 0 && bits == 0) unlinkbuffer(c, b, 0);
+    }
+    b->bits = bits;
+}
+
+static struct Buffer *find(struct Cache *c, unsigned long block, unsigned char bit)
+{
+    int i = chainof(c, bit);
+    struct Buffer *b = c->chains[i][block & c->mask];
+
+    c->lookups++;
+    while (b)
+    {
+        c->probes++;
+        if (b->block == block && (b->bits & bit))
+            return b;
+        b = b->hashnext[i];
+    }
+    return NULL;
+}
+
+/* LRU handling */
+
+static void mru(struct Cache *c, struct Buffer *b)
+{
+    b->lruprev->lrunext = b->lrunext;
+    b->lrunext->lruprev = b->lruprev;
+    b->lruprev = c->lru.lruprev;
+    b->lrunext = &c->lru;
+    c->lru.lruprev->lrunext = b;
+    c->lru.lruprev = b;
+}
+
+static struct Buffer *victim(struct Cache *c)
+{
+    struct Buffer *b;
+
+    /* Like getcachebuffer(), originals with a newer version in
+       the cache are skipped */
+    for (;;)
+    {
+        b = c->lru.lrunext;
+        mru(c, b);
+        if ((b->bits & (CB_ORIGINAL | CB_LATEST)) != CB_ORIGINAL
+            || !find(c, b->block, CB_LATEST))
+            break;
+    }
+    setbits(c, b, 0);
+    return b;
+}
+
+static void setup(struct Cache *c, unsigned long buffers, int split)
+{
+    unsigned long chains = FIXEDHASHSIZE, i;
+
+    if (split)
+        while (chains < buffers && chains < MAXHASHSIZE)
+            chains <<= 1;
+
+    memset(c, 0, sizeof(*c));
+    c->split = split;
+    c->mask = chains - 1;
+    c->chains[0] = calloc(chains, sizeof(struct Buffer *));
+    c->chains[1] = calloc(chains, sizeof(struct Buffer *));
+    c->buffers = calloc(buffers, sizeof(struct Buffer));
+    c->lru.lrunext = c->lru.lruprev = &c->lru;
+    for (i = 0; i < buffers; i++)
+    {
+        struct Buffer *b = &c->buffers[i];
+
+        b->lruprev = &c->lru;
+        b->lrunext = c->lru.lrunext;
+        c->lru.lrunext->lruprev = b;
+        c->lru.lrunext = b;
+    }
+}
+
+static void cleanup(struct Cache *c)
+{
+    free(c->chains[0]);
+    free(c->chains[1]);
+    free(c->buffers);
+}
+
+/* Replay, modelled after readcachebuffer() and friends */
+
+static struct Buffer *readoriginal(struct Cache *c, unsigned long block)
+{
+    struct Buffer *b;
+
+    if ((b = find(c, block, CB_ORIGINAL)) != NULL)
+    {
+        mru(c, b);
+        return b;
+    }
+    c->misses++;
+    b = victim(c);
+    b->block = block;
+    setbits(c, b, CB_ORIGINAL | CB_LATEST);
+    return b;
+}
+
+static void replay(struct Cache *c)
+{
+    unsigned long i;
+
+    for (i = 0; i < eventcount; i++)
+    {
+        struct Event  *e = &events[i];
+        struct Buffer *b, *o;
+
+        switch (e->type)
+        {
+        case EV_READ:
+            if ((b = find(c, e->block, CB_LATEST)) != NULL)
+                mru(c, b);
+            else
+                readoriginal(c, e->block);
+            break;
+
+        case EV_ORIGINAL:
+            readoriginal(c, e->block);
+            break;
+
+        case EV_WRITE:
+            /* preparecachebuffer(): keep a copy of the original */
+            if ((b = find(c, e->block, CB_LATEST)) == NULL)
+                b = readoriginal(c, e->block);
+            if (b->bits & CB_ORIGINAL)
+            {
+                setbits(c, b, CB_LATEST);
+                o = victim(c);
+                o->block = e->block;
+                setbits(c, o, CB_ORIGINAL);
+            }
+            mru(c, b);
+            break;
+
+        case EV_FLUSH:
+            /* Writing the transaction turns all latest buffers into
+               originals again */
+            for (b = c->lru.lrunext; b != &c->lru; b = b->lrunext)
+            {
+                if (b->bits == CB_LATEST)
+                {
+                    if ((o = find(c, b->block, CB_ORIGINAL)) != NULL)
+                        setbits(c, o, 0);
+                    setbits(c, b, CB_ORIGINAL | CB_LATEST);
+                }
+            }
+            break;
+        }
+    }
+}
+
+/* Trace handling */
+
+static void addevent(unsigned char type, unsigned long block)
+{
+    static unsigned long allocated;
+
+    if (eventcount == allocated)
+    {
+        allocated = allocated ? allocated * 2 : 65536;
+        events = realloc(events, allocated * sizeof(struct Event));
+        if (!events)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(20);
+        }
+    }
+    events[eventcount].type = type;
+    events[eventcount].block = block;
+    eventcount++;
+}
+
+static int loadtrace(const char *name)
+{
+    char  line[256];
+    char *s;
+    FILE *f;
+
+    if ((f = fopen(name, "r")) == NULL)
+        return 0;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        if ((s = strstr(line, "readorgcb: block ")) != NULL)
+            addevent(EV_ORIGINAL, strtoul(s + 17, NULL, 10));
+        else if ((s = strstr(line, "readcb: block ")) != NULL)
+            addevent(EV_READ, strtoul(s + 14, NULL, 10));
+        else if (line[0] == 'R' || line[0] == 'O' || line[0] == 'W')
+            addevent(line[0] == 'R' ? EV_READ : line[0] == 'O' ? EV_ORIGINAL : EV_WRITE,
+                strtoul(line + 1, NULL, 10));
+        else if (line[0] == 'F')
+            addevent(EV_FLUSH, 0);
+    }
+    fclose(f);
+
+    return 1;
+}
+
+static unsigned long seed = 1;
+
+static unsigned long random32(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) & 0xffffff;
+}
+
+/* Skewed towards small values, roughly like B-tree and directory accesses */
+static unsigned long skewed(unsigned long range)
+{
+    unsigned long r = random32() % range;
+
+    return (r * r) / range;
+}
+
+static void synthesize(void)
+{
+    unsigned long i, bitmap = 0;
+
+    /* The admin space of a large volume: a few B-tree root and index
+       nodes, many more leaf and object container blocks and a bitmap
+       which is scanned sequentially. */
+    for (i = 0; i < SYNTHETIC; i++)
+    {
+        unsigned long r = random32() % 100;
+
+        if (r < 20)
+            addevent(EV_READ, 1000 + skewed(64));
+        else if (r < 70)
+            addevent(EV_READ, 4000 + skewed(200000));
+        else if (r < 80)
+            addevent(EV_WRITE, 4000 + skewed(200000));
+        else if (r < 95)
+            addevent(EV_READ, 2000 + (bitmap++ % 1500));
+        else if (r < 99)
+            addevent(EV_ORIGINAL, 4000 + skewed(200000));
+        else if (random32() % 100 == 0)
+            addevent(EV_FLUSH, 0);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static const unsigned long sizes[] = { 150, 1000, 5000, 20000, 50000, 0 };
+    unsigned long onesize[2] = { 0, 0 };
+    const unsigned long *size = sizes;
+    int i;
+
+    if (argc > 1 && !loadtrace(argv[1]))
+    {
+        fprintf(stderr, "Couldn't open trace %s\n", argv[1]);
+        return 10;
+    }
+    if (argc > 2)
+    {
+        onesize[0] = strtoul(argv[2], NULL, 10);
+        size = onesize;
+    }
+    if (eventcount == 0)
+        synthesize();
+
+    printf("%lu events\n", eventcount);
+    printf("Buffers  Index     Probes/lookup  Misses     Seconds\n");
+
+    for (; *size != 0; size++)
+    {
+        for (i = 0; i < 2; i++)
+        {
+            struct Cache c;
+            clock_t start;
+            double elapsed;
+
+            setup(&c, *size, i);
+            start = clock();
+            replay(&c);
+            elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+            printf("%7lu  %-8s  %13.2f  %-9lu  %7.3f\n", *size, i ? "split" : "fixed",
+                c.lookups ? (double)c.probes / c.lookups : 0.0, c.misses, elapsed);
+            cleanup(&c);
+        }
+    }
+
+    return 0;
+}
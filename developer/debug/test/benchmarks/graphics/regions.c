@@ -0,0 +1,319 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Desc: Benchmark of the graphics.library region functions
+*/
+
+/*
+ * Times the region operations layers.library does for typical window
+ * stacking workloads:
+ *
+ *     STACK  - visible region of every window of a stack, its rectangle
+ *              minus the rectangles of the windows in front of it
+ *     MOVE   - damage of dragging the front window across the others
+ *     DAMAGE - damage list collected from small rectangles, top to bottom
+ *     XOR    - XorRegionRegion() of a row and a column pattern
+ *
+ *     regions [TEST <name>] [ROUNDS <n>] [WINDOWS <n>]
+ */
+
+#include <exec/types.h>
+#include <dos/dos.h>
+#include <graphics/regions.h>
+#include <proto/dos.h>
+#include <proto/exec.h>
+#include <proto/graphics.h>
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#define ARG_TEMPLATE    "TEST/K,ROUNDS/K/N,WINDOWS/K/N"
+#define DEFAULT_ROUNDS  1000
+#define DEFAULT_WINDOWS 20
+#define MAXWINDOWS      256
+
+#define SCREENWIDTH     1280
+#define SCREENHEIGHT    1024
+
+static struct Rectangle windows[MAXWINDOWS];
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+static ULONG countrects(struct Region *r)
+{
+    struct RegionRectangle *rr;
+    ULONG n = 0;
+
+    for (rr = r->RegionRectangle; rr; rr = rr->Next)
+        n++;
+
+    return n;
+}
+
+/* The same pseudo random stack of windows every time */
+static void makewindows(int count)
+{
+    ULONG seed = 12345;
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        WORD w, h;
+
+        seed = seed * 1103515245 + 12345;
+        w = 200 + (seed >> 8) % 500;
+        seed = seed * 1103515245 + 12345;
+        h = 150 + (seed >> 8) % 400;
+        seed = seed * 1103515245 + 12345;
+        windows[i].MinX = (seed >> 8) % (SCREENWIDTH - w);
+        seed = seed * 1103515245 + 12345;
+        windows[i].MinY = (seed >> 8) % (SCREENHEIGHT - h);
+        windows[i].MaxX = windows[i].MinX + w - 1;
+        windows[i].MaxY = windows[i].MinY + h - 1;
+    }
+}
+
+/* windows[0] is the front window */
+static BOOL stack(int count, int rounds, ULONG *ops, ULONG *rects)
+{
+    struct Region *vis;
+    int r, i, j;
+
+    for (r = 0; r < rounds; r++)
+    {
+        for (i = 0; i < count; i++)
+        {
+            if (!(vis = NewRegion()))
+                return FALSE;
+
+            OrRectRegion(vis, &windows[i]);
+            for (j = 0; j < i; j++)
+            {
+                if (!ClearRectRegion(vis, &windows[j]))
+                {
+                    DisposeRegion(vis);
+                    return FALSE;
+                }
+            }
+            *ops += i + 1;
+            *rects += countrects(vis);
+
+            DisposeRegion(vis);
+        }
+    }
+
+    return TRUE;
+}
+
+static BOOL move(int count, int rounds, ULONG *ops, ULONG *rects)
+{
+    struct Region *damage, *exposed;
+    struct Rectangle from, to;
+    int r, i, step;
+    BOOL success = FALSE;
+
+    damage = NewRegion();
+    exposed = NewRegion();
+    if (!damage || !exposed)
+        goto out;
+
+    for (r = 0; r < rounds; r++)
+    {
+        from = windows[0];
+        for (step = 0; step < 32; step++)
+        {
+            to = from;
+            to.MinX += 8; to.MaxX += 8;
+            to.MinY += 4; to.MaxY += 4;
+
+            /* What the front window uncovers */
+            ClearRegion(exposed);
+            if (!OrRectRegion(exposed, &from) ||
+                !ClearRectRegion(exposed, &to))
+                goto out;
+
+            /* ... has to be refreshed in each window below */
+            ClearRegion(damage);
+            for (i = 1; i < count; i++)
+            {
+                struct Region *part;
+
+                if (!(part = NewRegion()))
+                    goto out;
+                if (!OrRegionRegion(exposed, part))
+                {
+                    DisposeRegion(part);
+                    goto out;
+                }
+                AndRectRegion(part, &windows[i]);
+                if (!OrRegionRegion(part, damage))
+                {
+                    DisposeRegion(part);
+                    goto out;
+                }
+                DisposeRegion(part);
+            }
+            *ops += 2 + 3 * (count - 1);
+            *rects += countrects(damage);
+
+            from = to;
+        }
+    }
+    success = TRUE;
+
+out:
+    if (exposed) DisposeRegion(exposed);
+    if (damage) DisposeRegion(damage);
+
+    return success;
+}
+
+static BOOL damagelist(int count, int rounds, ULONG *ops, ULONG *rects)
+{
+    struct Region *damage;
+    struct Rectangle rect;
+    int r, x, y;
+
+    if (!(damage = NewRegion()))
+        return FALSE;
+
+    for (r = 0; r < rounds; r++)
+    {
+        /* Lines of text changed in every other of count columns */
+        for (y = 0; y < SCREENHEIGHT / 2; y += 16)
+        {
+            for (x = 0; x < count; x++)
+            {
+                rect.MinX = 16 * x * 2;
+                rect.MaxX = rect.MinX + 15;
+                rect.MinY = y;
+                rect.MaxY = y + 15;
+                if (!OrRectRegion(damage, &rect))
+                {
+                    DisposeRegion(damage);
+                    return FALSE;
+                }
+                (*ops)++;
+            }
+        }
+        *rects += countrects(damage);
+        ClearRegion(damage);
+    }
+
+    DisposeRegion(damage);
+
+    return TRUE;
+}
+
+static BOOL xor(int count, int rounds, ULONG *ops, ULONG *rects)
+{
+    struct Region *R1 = NewRegion();
+    struct Region *R2 = NewRegion();
+    BOOL success = FALSE;
+    int i;
+
+    if (!R1 || !R2)
+        goto out;
+
+    for (i = 0; i < count; i++)
+    {
+        struct Rectangle col = {i * 20, 0, i * 20 + 11, count * 20 + 1};
+        struct Rectangle row = {0, i * 20, count * 20 + 1, i * 20 + 11};
+
+        OrRectRegion(R1, &col);
+        OrRectRegion(R2, &row);
+    }
+
+    for (i = 0; i < rounds * 100; i++)
+    {
+        if (!XorRegionRegion(R1, R2))
+            goto out;
+        (*ops)++;
+    }
+    *rects += countrects(R2);
+    success = TRUE;
+
+out:
+    if (R2) DisposeRegion(R2);
+    if (R1) DisposeRegion(R1);
+
+    return success;
+}
+
+static const struct
+{
+    const char *name;
+    BOOL      (*func)(int count, int rounds, ULONG *ops, ULONG *rects);
+} tests[] =
+{
+    { "STACK",  stack      },
+    { "MOVE",   move       },
+    { "DAMAGE", damagelist },
+    { "XOR",    xor        },
+    { NULL,     NULL       }
+};
+
+int main(int argc, char *argv[])
+{
+    struct RDArgs   *rda;
+    IPTR            args[3] = { 0, 0, 0 };
+    struct timeval  tv_start, tv_end;
+    int             rounds = DEFAULT_ROUNDS;
+    int             count = DEFAULT_WINDOWS;
+    int             rc = RETURN_OK;
+    int             t;
+
+    rda = ReadArgs(ARG_TEMPLATE, args, NULL);
+    if (!rda)
+    {
+        PrintFault(IoErr(), argv[0]);
+        return RETURN_ERROR;
+    }
+
+    if (args[1])
+        rounds = *(LONG *)args[1];
+    if (args[2])
+        count = *(LONG *)args[2];
+    if (count < 1)
+        count = 1;
+    if (count > MAXWINDOWS)
+        count = MAXWINDOWS;
+
+    makewindows(count);
+
+    printf("Test      Operations     Time (s)     Operations/s   Rectangles\n");
+
+    for (t = 0; tests[t].name; t++)
+    {
+        ULONG ops = 0, rects = 0;
+        double elapsed;
+
+        if (args[0] && strcasecmp((char *)args[0], tests[t].name))
+            continue;
+
+        gettimeofday(&tv_start, NULL);
+        if (!tests[t].func(count, rounds, &ops, &rects))
+        {
+            printf("%-6s    out of memory\n", tests[t].name);
+            rc = RETURN_FAIL;
+            continue;
+        }
+        gettimeofday(&tv_end, NULL);
+        elapsed = elapsedsecs(&tv_start, &tv_end);
+
+        printf("%-6s    %10lu   %10f   %14.1f   %10lu\n",
+            tests[t].name, (unsigned long)ops, elapsed,
+            elapsed > 0.0 ? ops / elapsed : 0.0, (unsigned long)rects);
+    }
+
+    FreeArgs(rda);
+
+    return rc;
+}
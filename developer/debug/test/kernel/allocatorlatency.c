@@ -0,0 +1,162 @@
+/*
+    Copyright © 2019, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Stress test and latency benchmark for the system memory allocator.
+    Keeps a fragmented working set of blocks and measures every single
+    AllocMem() and FreeMem() call with the EClock.
+*/
+
+#include <devices/timer.h>
+#include <exec/execbase.h>
+#include <exec/memory.h>
+#include <proto/exec.h>
+#include <proto/timer.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOTS   4096
+#define ROUNDS  100000
+
+struct Device *TimerBase;
+
+struct Slot
+{
+    APTR  mem;
+    ULONG size;
+};
+
+static struct Slot slots[SLOTS];
+static ULONG alloctimes[ROUNDS];
+static ULONG freetimes[ROUNDS];
+
+static ULONG seed = 0x12345678;
+
+static ULONG Random(void)
+{
+    /* XorShift32, good enough and identical on all ports */
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    return seed;
+}
+
+/* Mostly small blocks, some medium ones and an occasional large one */
+static ULONG RandomSize(void)
+{
+    ULONG r = Random();
+
+    switch (r & 15)
+    {
+    case 0:
+        return 16384 + (r >> 8) % 262144;
+    case 1:
+    case 2:
+    case 3:
+        return 1024 + (r >> 8) % 16384;
+    default:
+        return 8 + (r >> 8) % 512;
+    }
+}
+
+static ULONG ElapsedTicks(struct EClockVal *start, struct EClockVal *end)
+{
+    UQUAD s = ((UQUAD)start->ev_hi << 32) | start->ev_lo;
+    UQUAD e = ((UQUAD)end->ev_hi << 32) | end->ev_lo;
+
+    return (ULONG)(e - s);
+}
+
+static int CompareTicks(const void *a, const void *b)
+{
+    ULONG ta = *(const ULONG *)a;
+    ULONG tb = *(const ULONG *)b;
+
+    return (ta > tb) - (ta < tb);
+}
+
+static void Report(const char *what, ULONG *times, ULONG count, ULONG freq)
+{
+    qsort(times, count, sizeof(ULONG), CompareTicks);
+
+    printf("%-8s p50 %8.2f us   p99 %8.2f us   max %10.2f us\n", what,
+           times[count / 2] * 1000000.0 / freq,
+           times[count - count / 100 - 1] * 1000000.0 / freq,
+           times[count - 1] * 1000000.0 / freq);
+}
+
+int main(int argc, char **argv)
+{
+    struct timerequest tr;
+    struct EClockVal start, end;
+    ULONG attrs = MEMF_ANY;
+    ULONG freq = 0, allocs = 0, frees = 0, failed = 0;
+    ULONG i;
+
+    if ((argc > 1) && !strcmp(argv[1], "fast"))
+        attrs = MEMF_FAST;
+
+    if (OpenDevice(TIMERNAME, UNIT_ECLOCK, &tr.tr_node, 0))
+    {
+        printf("Can't open timer.device\n");
+        return 20;
+    }
+    TimerBase = tr.tr_node.io_Device;
+
+    printf("Largest free block before: %lu bytes\n", (unsigned long)AvailMem(attrs | MEMF_LARGEST));
+
+    /* Fill the working set, so that the memory gets fragmented */
+    for (i = 0; i < SLOTS; i++)
+    {
+        slots[i].size = RandomSize();
+        slots[i].mem  = AllocMem(slots[i].size, attrs);
+    }
+
+    /* Replace random blocks, timing every call */
+    for (i = 0; i < ROUNDS; i++)
+    {
+        struct Slot *slot = &slots[Random() % SLOTS];
+
+        if (slot->mem)
+        {
+            freq = ReadEClock(&start);
+            FreeMem(slot->mem, slot->size);
+            ReadEClock(&end);
+            freetimes[frees++] = ElapsedTicks(&start, &end);
+        }
+
+        slot->size = RandomSize();
+
+        freq = ReadEClock(&start);
+        slot->mem = AllocMem(slot->size, attrs);
+        ReadEClock(&end);
+        alloctimes[allocs++] = ElapsedTicks(&start, &end);
+
+        if (!slot->mem)
+            failed++;
+    }
+
+    printf("Largest free block during: %lu bytes\n", (unsigned long)AvailMem(attrs | MEMF_LARGEST));
+
+    for (i = 0; i < SLOTS; i++)
+    {
+        if (slots[i].mem)
+            FreeMem(slots[i].mem, slots[i].size);
+    }
+
+    printf("Largest free block after: %lu bytes\n", (unsigned long)AvailMem(attrs | MEMF_LARGEST));
+    printf("%lu allocations (%lu failed), %lu frees, EClock %lu Hz\n",
+           (unsigned long)allocs, (unsigned long)failed, (unsigned long)frees, (unsigned long)freq);
+
+    if (allocs)
+        Report("AllocMem", alloctimes, allocs, freq);
+    if (frees)
+        Report("FreeMem", freetimes, frees, freq);
+
+    CloseDevice(&tr.tr_node);
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+*/
+
+/*
+ * Resolver cache test.
+ *
+ * Resolves a host name a number of times and reports how long the
+ * first lookup took against the rest, which the resolver cache of
+ * bsdsocket.library should answer without asking a name server.
+ * The cache statistics are printed before and after.
+ *
+ *     dnscache [NAME <host>] [COUNT <n>]
+ */
+
+#include <exec/types.h>
+#include <dos/dos.h>
+#include <proto/dos.h>
+#include <proto/exec.h>
+#include <proto/socket.h>
+
+#include <libraries/bsdsocket.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+
+#include <sys/time.h>
+#include <stdio.h>
+
+#define ARG_TEMPLATE    "NAME,COUNT/K/N"
+#define DEFAULT_NAME    "www.aros.org"
+#define DEFAULT_COUNT   100
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+static void printstats(const char *when)
+{
+    struct resolver_cache_stats rcs;
+
+    if (GetNetworkStatistics(NETSTATUS_resolver, NETWORKSTATUS_VERSION,
+                             &rcs, sizeof(rcs)) < 0)
+    {
+        printf("Cannot get resolver statistics, errno %ld\n", (long)Errno());
+        return;
+    }
+    printf("%s: %lu entries, %lu hits (%lu negative), %lu misses, "
+           "%lu coalesced, %lu expired, %lu evicted, %lu uncacheable\n",
+        when, (unsigned long)rcs.rcs_entries, (unsigned long)rcs.rcs_hits,
+        (unsigned long)rcs.rcs_negative_hits, (unsigned long)rcs.rcs_misses,
+        (unsigned long)rcs.rcs_coalesced, (unsigned long)rcs.rcs_expired,
+        (unsigned long)rcs.rcs_evicted, (unsigned long)rcs.rcs_uncacheable);
+}
+
+int main(int argc, char *argv[])
+{
+    struct RDArgs   *rda;
+    IPTR            args[2] = { 0, 0 };
+    struct timeval  tv_start, tv_first, tv_end;
+    struct hostent  *hp;
+    char            *name = DEFAULT_NAME;
+    int             count = DEFAULT_COUNT, i;
+    double          first, rest;
+    int             rc = RETURN_OK;
+
+    rda = ReadArgs(ARG_TEMPLATE, args, NULL);
+    if (!rda)
+    {
+        PrintFault(IoErr(), argv[0]);
+        return RETURN_ERROR;
+    }
+
+    if (args[0])
+        name = (char *)args[0];
+    if (args[1])
+        count = *(LONG *)args[1];
+
+    printstats("Before");
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < count; i++)
+    {
+        if (!(hp = gethostbyname(name)))
+        {
+            printf("Cannot resolve %s\n", name);
+            rc = RETURN_FAIL;
+            break;
+        }
+        if (i == 0)
+            gettimeofday(&tv_first, NULL);
+    }
+    gettimeofday(&tv_end, NULL);
+
+    if (rc == RETURN_OK && count > 1)
+    {
+        first = elapsedsecs(&tv_start, &tv_first);
+        rest = elapsedsecs(&tv_first, &tv_end) / (count - 1);
+        printf("%s: first lookup %9f s, then %9f s per lookup\n",
+            name, first, rest);
+    }
+
+    printstats("After");
+
+    FreeArgs(rda);
+
+    return rc;
+}
@@ -0,0 +1,205 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+*/
+
+/*
+ * PCB lookup load test.
+ *
+ * Opens N TCP connections over the loopback interface, leaves as many
+ * more in TIME_WAIT and then bounces one byte over every connection in
+ * turn for a number of rounds. Each bounce is two data segments, the
+ * reported rate shows how the cost of demultiplexing an incoming
+ * segment grows with the number of PCBs in the stack.
+ *
+ *     pcbload [COUNTS <n> [<n> ...]] [ROUNDS <n>]
+ */
+
+#include <exec/types.h>
+#include <dos/dos.h>
+#include <proto/dos.h>
+#include <proto/exec.h>
+#include <proto/socket.h>
+#include <utility/tagitem.h>
+
+#include <bsdsocket/socketbasetags.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARG_TEMPLATE    "COUNTS/N/M,ROUNDS/K/N"
+#define DEFAULT_ROUNDS  20
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+static int openlistener(struct sockaddr_in *sin)
+{
+    socklen_t   len = sizeof(*sin);
+    int         s;
+
+    if ((s = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return -1;
+
+    memset(sin, 0, sizeof(*sin));
+    sin->sin_len = sizeof(*sin);
+    sin->sin_family = AF_INET;
+    sin->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(s, (struct sockaddr *)sin, sizeof(*sin)) < 0 ||
+        listen(s, 5) < 0 ||
+        getsockname(s, (struct sockaddr *)sin, &len) < 0)
+    {
+        CloseSocket(s);
+        return -1;
+    }
+    return s;
+}
+
+/* Connect a client to the listener and accept the server side */
+static BOOL openpair(int listener, struct sockaddr_in *sin, int *client, int *server)
+{
+    int one = 1;
+
+    *server = -1;
+    if ((*client = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return FALSE;
+
+    if (connect(*client, (struct sockaddr *)sin, sizeof(*sin)) < 0 ||
+        (*server = accept(listener, NULL, NULL)) < 0)
+    {
+        CloseSocket(*client);
+        *client = -1;
+        return FALSE;
+    }
+
+    setsockopt(*client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(*server, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    return TRUE;
+}
+
+static BOOL bench(int count, int rounds)
+{
+    struct sockaddr_in  sin;
+    struct timeval      tv_start, tv_end;
+    int                 *clients, *servers;
+    int                 listener, client, server, i, r, opened = 0;
+    double              elapsed;
+    char                c = 'x';
+    BOOL                success = FALSE;
+
+    /* two sockets per connection, the listener and some slack */
+    SocketBaseTags(SBTM_SETVAL(SBTC_DTABLESIZE), 2 * count + 8, TAG_DONE);
+
+    clients = malloc(count * sizeof(int));
+    servers = malloc(count * sizeof(int));
+    if (!clients || !servers)
+        goto out;
+
+    if ((listener = openlistener(&sin)) < 0)
+    {
+        printf("Cannot open listener, errno %ld\n", (long)Errno());
+        goto out;
+    }
+
+    /* Connections the client closes first stay in TIME_WAIT */
+    for (i = 0; i < count; i++)
+    {
+        if (!openpair(listener, &sin, &client, &server))
+        {
+            printf("Cannot open TIME_WAIT connection %d, errno %ld\n", i, (long)Errno());
+            goto cleanup;
+        }
+        CloseSocket(client);
+        CloseSocket(server);
+    }
+
+    for (opened = 0; opened < count; opened++)
+    {
+        if (!openpair(listener, &sin, &clients[opened], &servers[opened]))
+        {
+            printf("Cannot open connection %d, errno %ld\n", opened, (long)Errno());
+            goto cleanup;
+        }
+    }
+
+    gettimeofday(&tv_start, NULL);
+    for (r = 0; r < rounds; r++)
+    {
+        for (i = 0; i < count; i++)
+        {
+            if (send(clients[i], &c, 1, 0) != 1 ||
+                recv(servers[i], &c, 1, 0) != 1 ||
+                send(servers[i], &c, 1, 0) != 1 ||
+                recv(clients[i], &c, 1, 0) != 1)
+            {
+                printf("Transfer on connection %d failed, errno %ld\n", i, (long)Errno());
+                goto cleanup;
+            }
+        }
+    }
+    gettimeofday(&tv_end, NULL);
+    elapsed = elapsedsecs(&tv_start, &tv_end);
+
+    printf("%6d connections (+%d TIME_WAIT): %8d segments in %9f s, %10.1f segments/s\n",
+        count, count, 2 * count * rounds, elapsed,
+        elapsed > 0.0 ? 2 * count * rounds / elapsed : 0.0);
+    success = TRUE;
+
+cleanup:
+    for (i = 0; i < opened; i++)
+    {
+        CloseSocket(clients[i]);
+        CloseSocket(servers[i]);
+    }
+    CloseSocket(listener);
+out:
+    free(servers);
+    free(clients);
+
+    return success;
+}
+
+int main(int argc, char *argv[])
+{
+    struct RDArgs   *rda;
+    IPTR            args[2] = { 0, 0 };
+    LONG            **counts;
+    int             rounds = DEFAULT_ROUNDS;
+    int             rc = RETURN_OK;
+
+    rda = ReadArgs(ARG_TEMPLATE, args, NULL);
+    if (!rda)
+    {
+        PrintFault(IoErr(), argv[0]);
+        return RETURN_ERROR;
+    }
+
+    if (args[1])
+        rounds = *(LONG *)args[1];
+
+    if ((counts = (LONG **)args[0]))
+    {
+        for (; *counts && rc == RETURN_OK; counts++)
+        {
+            if (!bench(**counts, rounds))
+                rc = RETURN_FAIL;
+        }
+    }
+    else if (!bench(10, rounds) || !bench(100, rounds) ||
+             !bench(500, rounds) || !bench(1000, rounds))
+        rc = RETURN_FAIL;
+
+    FreeArgs(rda);
+
+    return rc;
+}
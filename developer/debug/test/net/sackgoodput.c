@@ -0,0 +1,267 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+*/
+
+/*
+ * SACK goodput test.
+ *
+ * Moves SIZE kilobytes over a TCP connection on the loopback interface
+ * while the interface drops DROP of every 1000 packets, once with
+ * selective acknowledgements switched off and once with them on, and
+ * reports the goodput of both runs. The stack variables are set through
+ * the ARexx port of AROSTCP and restored afterwards.
+ *
+ *     sackgoodput [DROP <n>] [SIZE <kbytes>]
+ */
+
+#include <exec/types.h>
+#include <dos/dos.h>
+#include <rexx/storage.h>
+#include <proto/dos.h>
+#include <proto/exec.h>
+#include <proto/rexxsyslib.h>
+#include <proto/socket.h>
+
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/errno.h>
+#include <netinet/in.h>
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARG_TEMPLATE    "DROP/K/N,SIZE/K/N"
+#define DEFAULT_DROP    10
+#define DEFAULT_SIZE    4096
+#define CHUNK           8192
+
+struct RxsLib *RexxSysBase;
+
+static double elapsedsecs(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.;
+}
+
+/* Send one command to the ARexx port of the stack and wait for the reply */
+static BOOL stackcommand(const char *cmd)
+{
+    struct MsgPort  *replyport, *port;
+    struct RexxMsg  *rmsg;
+    BOOL            success = FALSE;
+
+    if (!(replyport = CreateMsgPort()))
+        return FALSE;
+
+    if ((rmsg = CreateRexxMsg(replyport, NULL, NULL)))
+    {
+        rmsg->rm_Action = RXCOMM;
+        if ((rmsg->rm_Args[0] = (IPTR)CreateArgstring((STRPTR)cmd, strlen(cmd))))
+        {
+            Forbid();
+            if ((port = FindPort("AROSTCP")))
+                PutMsg(port, &rmsg->rm_Node);
+            Permit();
+
+            if (port)
+            {
+                WaitPort(replyport);
+                GetMsg(replyport);
+                success = (rmsg->rm_Result1 == 0);
+            }
+            DeleteArgstring((UBYTE *)rmsg->rm_Args[0]);
+        }
+        DeleteRexxMsg(rmsg);
+    }
+    DeleteMsgPort(replyport);
+
+    if (!success)
+        printf("Stack command \"%s\" failed\n", cmd);
+    return success;
+}
+
+static BOOL openpair(int *client, int *server)
+{
+    struct sockaddr_in  sin;
+    socklen_t           len = sizeof(sin);
+    int                 listener, one = 1;
+
+    *client = *server = -1;
+    if ((listener = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return FALSE;
+
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_len = sizeof(sin);
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listener, (struct sockaddr *)&sin, sizeof(sin)) == 0 &&
+        listen(listener, 1) == 0 &&
+        getsockname(listener, (struct sockaddr *)&sin, &len) == 0 &&
+        (*client = socket(AF_INET, SOCK_STREAM, 0)) >= 0 &&
+        connect(*client, (struct sockaddr *)&sin, sizeof(sin)) == 0)
+    {
+        *server = accept(listener, NULL, NULL);
+    }
+    CloseSocket(listener);
+
+    if (*server < 0)
+    {
+        if (*client >= 0)
+            CloseSocket(*client);
+        *client = -1;
+        return FALSE;
+    }
+
+    IoctlSocket(*client, FIONBIO, (char *)&one);
+    IoctlSocket(*server, FIONBIO, (char *)&one);
+    return TRUE;
+}
+
+/*
+ * Push size bytes from the client to the server. Both ends are non
+ * blocking, the task sleeps in WaitSelect() whenever neither of them
+ * can make progress, e.g. while the stack waits for a retransmission.
+ */
+static BOOL transfer(int client, int server, ULONG size, double *elapsed)
+{
+    struct timeval  tv_start, tv_end, tv;
+    fd_set          rfds, wfds;
+    char            *buf;
+    ULONG           sent = 0, received = 0;
+    LONG            n;
+    BOOL            progress;
+
+    if (!(buf = malloc(CHUNK)))
+        return FALSE;
+    memset(buf, 'x', CHUNK);
+
+    gettimeofday(&tv_start, NULL);
+    while (received < size)
+    {
+        progress = FALSE;
+
+        if (sent < size)
+        {
+            n = send(client, buf, sent + CHUNK > size ? size - sent : CHUNK, 0);
+            if (n > 0)
+            {
+                sent += n;
+                progress = TRUE;
+            }
+            else if (Errno() != EWOULDBLOCK)
+                break;
+        }
+
+        n = recv(server, buf, CHUNK, 0);
+        if (n > 0)
+        {
+            received += n;
+            progress = TRUE;
+        }
+        else if (n == 0 || Errno() != EWOULDBLOCK)
+            break;
+
+        if (!progress)
+        {
+            FD_ZERO(&rfds);
+            FD_ZERO(&wfds);
+            FD_SET(server, &rfds);
+            if (sent < size)
+                FD_SET(client, &wfds);
+            tv.tv_sec = 5;
+            tv.tv_usec = 0;
+            WaitSelect((server > client ? server : client) + 1,
+                &rfds, &wfds, NULL, &tv, NULL);
+        }
+    }
+    gettimeofday(&tv_end, NULL);
+    free(buf);
+
+    *elapsed = elapsedsecs(&tv_start, &tv_end);
+    if (received < size)
+    {
+        printf("Transfer failed after %lu bytes, errno %ld\n",
+            (unsigned long)received, (long)Errno());
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static BOOL bench(BOOL sack, ULONG size)
+{
+    int     client, server;
+    double  elapsed;
+    BOOL    success;
+
+    /* the option is negotiated on the SYN, set it before connecting */
+    if (!stackcommand(sack ? "SET TCP_SACK=YES" : "SET TCP_SACK=NO"))
+        return FALSE;
+
+    if (!openpair(&client, &server))
+    {
+        printf("Cannot open connection, errno %ld\n", (long)Errno());
+        return FALSE;
+    }
+
+    if ((success = transfer(client, server, size, &elapsed)))
+        printf("SACK %-3s: %8lu KB in %9f s, %10.1f KB/s\n",
+            sack ? "on" : "off", (unsigned long)(size / 1024), elapsed,
+            elapsed > 0.0 ? size / 1024 / elapsed : 0.0);
+
+    CloseSocket(client);
+    CloseSocket(server);
+
+    return success;
+}
+
+int main(int argc, char *argv[])
+{
+    struct RDArgs   *rda;
+    IPTR            args[2] = { 0, 0 };
+    LONG            drop = DEFAULT_DROP;
+    ULONG           size = DEFAULT_SIZE * 1024;
+    char            cmd[32];
+    int             rc = RETURN_OK;
+
+    rda = ReadArgs(ARG_TEMPLATE, args, NULL);
+    if (!rda)
+    {
+        PrintFault(IoErr(), argv[0]);
+        return RETURN_ERROR;
+    }
+
+    if (args[0])
+        drop = *(LONG *)args[0];
+    if (args[1])
+        size = *(LONG *)args[1] * 1024;
+
+    RexxSysBase = (struct RxsLib *)OpenLibrary("rexxsyslib.library", 0);
+    if (!RexxSysBase)
+    {
+        printf("Cannot open rexxsyslib.library\n");
+        FreeArgs(rda);
+        return RETURN_FAIL;
+    }
+
+    sprintf(cmd, "SET LOOPBACKDROP=%ld", (long)drop);
+    if (!stackcommand(cmd))
+        rc = RETURN_FAIL;
+    else
+    {
+        printf("Dropping %ld of 1000 packets on the loopback\n", (long)drop);
+        if (!bench(FALSE, size) || !bench(TRUE, size))
+            rc = RETURN_FAIL;
+
+        stackcommand("SET LOOPBACKDROP=0");
+        stackcommand("SET TCP_SACK=YES");
+    }
+
+    CloseLibrary((struct Library *)RexxSysBase);
+    FreeArgs(rda);
+
+    return rc;
+}
@@ -0,0 +1,195 @@
+/*
+    Copyright  2019, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Stress test for the timer.device request queues. Submits 10000
+    concurrent TR_ADDREQUESTs with random delays to UNIT_MICROHZ and
+    UNIT_VBLANK, aborts some of them again and checks that the rest
+    complete in deadline order and how late they are.
+*/
+
+#include <devices/timer.h>
+#include <exec/errors.h>
+#include <exec/memory.h>
+#include <proto/exec.h>
+#include <proto/timer.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REQUESTS    10000
+#define MAXDELAY    10000000    /* microseconds */
+
+struct Device *TimerBase;
+
+struct TestReq
+{
+    struct timerequest tr;
+    struct timeval     deadline;
+    ULONG              seq;
+};
+
+static ULONG seed = 0x12345678;
+
+static ULONG Random(void)
+{
+    /* XorShift32, good enough and identical on all ports */
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    return seed;
+}
+
+/* Mostly short timeouts, some long ones, and many identical ones */
+static ULONG RandomDelay(void)
+{
+    ULONG r = Random();
+
+    switch (r & 3)
+    {
+    case 0:
+        return (r >> 8) % MAXDELAY;
+    case 1:
+        return ((r >> 8) % 20) * 100000;
+    default:
+        return (r >> 8) % 500000;
+    }
+}
+
+static LONG Micros(struct timeval *later, struct timeval *earlier)
+{
+    return (LONG)(later->tv_secs - earlier->tv_secs) * 1000000
+           + (LONG)later->tv_micro - (LONG)earlier->tv_micro;
+}
+
+static int cmplong(const void *a, const void *b)
+{
+    LONG x = *(const LONG *)a, y = *(const LONG *)b;
+
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv)
+{
+    struct MsgPort *port;
+    struct TestReq *reqs;
+    LONG *latency;
+    struct TestReq *last[2] = { NULL, NULL };
+    struct timeval now;
+    ULONG tolerance;
+    ULONG i, pending = 0, done = 0, aborted = 0, early = 0, misordered = 0;
+    int ret = 20;
+
+    port = CreateMsgPort();
+    reqs = AllocVec(REQUESTS * sizeof(struct TestReq), MEMF_ANY | MEMF_CLEAR);
+    latency = AllocVec(REQUESTS * sizeof(LONG), MEMF_ANY);
+
+    if (port && reqs && latency)
+    {
+        if (!OpenDevice(TIMERNAME, UNIT_MICROHZ, &reqs[0].tr.tr_node, 0))
+        {
+            TimerBase = reqs[0].tr.tr_node.io_Device;
+
+            /* Allow one VBlank of jitter, this is the resolution of UNIT_VBLANK */
+            tolerance = 1000000 / (SysBase->VBlankFrequency ? SysBase->VBlankFrequency : 50);
+
+            printf("Submitting %u requests...\n", REQUESTS);
+
+            for (i = 0; i < REQUESTS; i++)
+            {
+                struct TestReq *r = &reqs[i];
+                ULONG delay = RandomDelay();
+
+                r->tr = reqs[0].tr;
+                r->tr.tr_node.io_Message.mn_ReplyPort = port;
+                r->tr.tr_node.io_Message.mn_Length = sizeof(struct timerequest);
+                r->tr.tr_node.io_Unit = (struct Unit *)(IPTR)((i & 1) ? UNIT_VBLANK : UNIT_MICROHZ);
+                r->tr.tr_node.io_Command = TR_ADDREQUEST;
+                r->tr.tr_time.tv_secs = delay / 1000000;
+                r->tr.tr_time.tv_micro = delay % 1000000;
+                r->seq = i;
+
+                GetSysTime(&r->deadline);
+                AddTime(&r->deadline, &r->tr.tr_time);
+
+                SendIO(&r->tr.tr_node);
+                pending++;
+
+                /* Abort every 16th request right away, unless it is already done */
+                if ((i & 15) == 15)
+                {
+                    AbortIO(&r->tr.tr_node);
+                    WaitIO(&r->tr.tr_node);
+                    if (r->tr.tr_node.io_Error == IOERR_ABORTED)
+                        aborted++;
+                    pending--;
+                }
+            }
+
+            printf("Waiting for %u requests...\n", (unsigned int)pending);
+
+            while (pending)
+            {
+                struct TestReq *r;
+
+                WaitPort(port);
+                while ((r = (struct TestReq *)GetMsg(port)))
+                {
+                    ULONG unit = (IPTR)r->tr.tr_node.io_Unit;
+                    LONG late;
+
+                    GetSysTime(&now);
+                    late = Micros(&now, &r->deadline);
+                    latency[done++] = late;
+                    pending--;
+
+                    if (late < -(LONG)tolerance)
+                        early++;
+
+                    /* Within one unit, completion must follow the deadlines */
+                    if (last[unit] && (Micros(&r->deadline, &last[unit]->deadline) < -(LONG)tolerance))
+                    {
+                        if (misordered++ < 10)
+                            printf("Request %u (due %u.%06u) completed after request %u (due %u.%06u)\n",
+                                   (unsigned int)r->seq,
+                                   (unsigned int)r->deadline.tv_secs, (unsigned int)r->deadline.tv_micro,
+                                   (unsigned int)last[unit]->seq,
+                                   (unsigned int)last[unit]->deadline.tv_secs, (unsigned int)last[unit]->deadline.tv_micro);
+                    }
+                    last[unit] = r;
+                }
+            }
+
+            qsort(latency, done, sizeof(LONG), cmplong);
+
+            printf("Completed %u, aborted %u\n", (unsigned int)done, (unsigned int)aborted);
+            printf("Latency (us): min %d p50 %d p99 %d max %d\n",
+                   (int)latency[0], (int)latency[done / 2],
+                   (int)latency[(done * 99) / 100], (int)latency[done - 1]);
+            printf("Early completions: %u, out of order: %u\n",
+                   (unsigned int)early, (unsigned int)misordered);
+
+            if (!early && !misordered)
+            {
+                printf("OK\n");
+                ret = 0;
+            }
+            else
+                printf("FAILED\n");
+
+            CloseDevice(&reqs[0].tr.tr_node);
+        }
+        else
+            printf("Can't open %s\n", TIMERNAME);
+    }
+    else
+        printf("Out of memory\n");
+
+    FreeVec(latency);
+    FreeVec(reqs);
+    DeleteMsgPort(port);
+
+    return ret;
+}
@@ -14,6 +14,7 @@
 #define __NOLIBBASE__
 
 #include <proto/oop.h>
+#include <proto/timer.h>
 
 #include <exec/exec.h>
 #include <exec/resident.h>
@@ -789,6 +790,28 @@ static void cmd_TRIM(struct IORequest *io, LIBBASETYPEPTR LIBBASE)
         io->io_Error = IOERR_NOCMD;
 }
 
+/* Statistics of the I/O scheduler of the unit */
+static void cmd_IOStats(struct IORequest *io, LIBBASETYPEPTR LIBBASE)
+{
+    struct ata_Unit *unit = (struct ata_Unit *)io->io_Unit;
+    struct ATAIOStats stats = unit->au_IOStats;
+    ULONG length = IOStdReq(io)->io_Length;
+
+    if (!IOStdReq(io)->io_Data)
+    {
+        io->io_Error = IOERR_BADADDRESS;
+        return;
+    }
+
+    if (stats.ios_Requests)
+        stats.ios_ServiceTime = unit->au_ServiceTotal / stats.ios_Requests;
+
+    if (length > sizeof(stats))
+        length = sizeof(stats);
+    CopyMem(&stats, IOStdReq(io)->io_Data, length);
+    IOStdReq(io)->io_Actual = length;
+}
+
 //-----------------------------------------------------------------------------
 
 /*
@@ -840,7 +863,8 @@ static mapfunc const map32[] = {
     [HD_SCSICMD]    = cmd_DirectScsi,
     [HD_SCSICMD+1]  = cmd_TestChanged,
     [HD_SMARTCMD]    = cmd_SMART,
-    [HD_TRIMCMD]    = cmd_TRIM
+    [HD_TRIMCMD]    = cmd_TRIM,
+    [HD_IOSTATSCMD] = cmd_IOStats
 };
 
 static UWORD const NSDSupported[] = {
@@ -877,6 +901,7 @@ static UWORD const NSDSupported[] = {
     NSCMD_TD_FORMAT64,
     HD_SMARTCMD,
     HD_TRIMCMD,
+    HD_IOSTATSCMD,
     0
 };
 
@@ -922,7 +947,7 @@ static void HandleIO(struct IORequest *io, LIBBASETYPEPTR LIBBASE)
             make the function cmd_Invalid.
         */
         default:
-            if ((io->io_Command <= (HD_SCSICMD+1)) || (io->io_Command >= HD_SMARTCMD && io->io_Command <= HD_TRIMCMD))
+            if ((io->io_Command <= (HD_SCSICMD+1)) || (io->io_Command >= HD_SMARTCMD && io->io_Command <= HD_IOSTATSCMD))
             {
                 if (map32[io->io_Command])
                     map32[io->io_Command](io, LIBBASE);
@@ -954,7 +979,8 @@ static BOOL isSlow(struct IORequest *io)
     {
         if (IMMEDIATE_COMMANDS & (1 << io->io_Command)) slow = FALSE;
     }
-    else if (io->io_Command == NSCMD_TD_SEEK64 || io->io_Command == NSCMD_DEVICEQUERY) slow = FALSE;
+    else if (io->io_Command == NSCMD_TD_SEEK64 || io->io_Command == NSCMD_DEVICEQUERY ||
+             io->io_Command == HD_IOSTATSCMD) slow = FALSE;
 
     return slow;
 }
@@ -1142,6 +1168,317 @@ void DaemonCode(struct ataBase *ATABase, struct ata_Controller *ataNode)
 }
 
 
+//---------------------------IO Scheduler--------------------------------------
+
+/*
+    Reads and writes taken from the bus port are not done in the order they
+    arrived in. They are queued per unit, sorted by block, and served in one
+    ascending sweep starting where the last transfer ended (C-LOOK).
+    Requests continuing each other in the same direction are done with one
+    command. Requests arriving meanwhile wait for the next sweep, so none of
+    them can starve. Any other command, and a request overlapping a queued
+    one when either is a write, first has the queue of its unit served, so
+    that their order is kept.
+*/
+
+#define MAX_MERGESECTORS    256     /* Sectors of one 28-bit LBA command */
+
+#define IONode(io)          (&(io)->io_Message.mn_Node)
+#define IONext(io)          ((struct IORequest *)IONode(io)->ln_Succ)
+
+static BOOL ata_IsWrite(struct IORequest *io)
+{
+    return (io->io_Command == CMD_WRITE || io->io_Command == TD_WRITE64 ||
+            io->io_Command == NSCMD_TD_WRITE64);
+}
+
+/* First sector of a queued request */
+static UQUAD ata_IOBlock(struct IORequest *io)
+{
+    UQUAD offset = IOStdReq(io)->io_Offset;
+
+    if (io->io_Command != CMD_READ && io->io_Command != CMD_WRITE)
+        offset |= (UQUAD)(IOStdReq(io)->io_Actual) << 32;
+
+    return offset >> Unit(io)->au_SectorShift;
+}
+
+static ULONG ata_IOCount(struct IORequest *io)
+{
+    return IOStdReq(io)->io_Length >> Unit(io)->au_SectorShift;
+}
+
+/* Can the request go through the queue? */
+static BOOL ata_IsQueueable(struct IORequest *io)
+{
+    struct ata_Unit *unit = (struct ata_Unit *)io->io_Unit;
+    ULONG mask = (1 << unit->au_SectorShift) - 1;
+
+    switch (io->io_Command)
+    {
+        case CMD_READ:
+        case CMD_WRITE:
+        case TD_READ64:
+        case TD_WRITE64:
+        case NSCMD_TD_READ64:
+        case NSCMD_TD_WRITE64:
+            break;
+
+        default:
+            return FALSE;
+    }
+
+    if (unit->au_XferModes & AF_XFER_PACKET)
+        return FALSE;
+
+    /* Leave bad requests for the command functions to complain about */
+    return (IOStdReq(io)->io_Length != 0) &&
+           !((IOStdReq(io)->io_Offset | IOStdReq(io)->io_Length) & mask);
+}
+
+/* Service time is counted from here, when requests leave the unit's queue */
+static void ata_StartService(struct ata_Unit *unit)
+{
+    struct ata_Bus *bus = unit->au_Bus;
+
+    if (bus->ab_Timer)
+    {
+        struct Device *TimerBase = bus->ab_Timer->io_Device;
+
+        GetUpTime(&unit->au_ServiceStart);
+    }
+}
+
+static void ata_ReplyIO(struct ata_Unit *unit, struct IORequest *io)
+{
+    struct ata_Bus *bus = unit->au_Bus;
+    struct ATAIOStats *stats = &unit->au_IOStats;
+
+    if (bus->ab_Timer)
+    {
+        struct Device *TimerBase = bus->ab_Timer->io_Device;
+        struct timeval now;
+        ULONG time;
+
+        GetUpTime(&now);
+        SubTime(&now, &unit->au_ServiceStart);
+        time = now.tv_secs * 1000000 + now.tv_micro;
+
+        unit->au_ServiceTotal += time;
+        if (stats->ios_MaxServiceTime < time)
+            stats->ios_MaxServiceTime = time;
+    }
+    stats->ios_Requests++;
+    stats->ios_QueueDepth--;
+
+    ReplyMsg((struct Message *)io);
+}
+
+/*
+    Do the requests in run, which follow each other on the disk, with one
+    command if possible. Otherwise, or if it fails, do them one by one.
+*/
+static void ata_DoRun(struct ata_Unit *unit, struct MinList *run, ULONG n,
+                      UQUAD block, ULONG count, BOOL write, LIBBASETYPEPTR LIBBASE)
+{
+    APTR pool = unit->au_Bus->ab_BounceBufferPool;
+    ULONG shift = unit->au_SectorShift;
+    struct IORequest *io;
+    UBYTE *buffer = NULL;
+    BOOL bounce = FALSE;
+
+    if (n > 1)
+    {
+        UBYTE *data = IOStdReq(GetHead(run))->io_Data;
+
+        /* Buffers following each other need no copying */
+        buffer = data;
+        ForeachNode(run, io)
+        {
+            if (IOStdReq(io)->io_Data != data)
+            {
+                buffer = NULL;
+                break;
+            }
+            data += IOStdReq(io)->io_Length;
+        }
+
+        if (!buffer && pool && (buffer = AllocPooled(pool, count << shift)))
+            bounce = TRUE;
+    }
+
+    if (buffer)
+    {
+        struct IOStdReq req = *IOStdReq(GetHead(run));
+        UQUAD offset = block << shift;
+        ULONG pos = 0;
+
+        if (bounce && write)
+        {
+            ForeachNode(run, io)
+            {
+                CopyMem(IOStdReq(io)->io_Data, buffer + pos, IOStdReq(io)->io_Length);
+                pos += IOStdReq(io)->io_Length;
+            }
+        }
+
+        req.io_Command = write ? NSCMD_TD_WRITE64 : NSCMD_TD_READ64;
+        req.io_Offset  = (ULONG)offset;
+        req.io_Actual  = (ULONG)(offset >> 32);
+        req.io_Length  = count << shift;
+        req.io_Data    = buffer;
+
+        HandleIO((struct IORequest *)&req, LIBBASE);
+        unit->au_IOStats.ios_Commands++;
+
+        if (!req.io_Error)
+        {
+            unit->au_IOStats.ios_Merged += n - 1;
+
+            pos = 0;
+            while ((io = (struct IORequest *)REMHEAD(run)))
+            {
+                if (bounce && !write)
+                    CopyMem(buffer + pos, IOStdReq(io)->io_Data, IOStdReq(io)->io_Length);
+                pos += IOStdReq(io)->io_Length;
+
+                io->io_Error = 0;
+                IOStdReq(io)->io_Actual = IOStdReq(io)->io_Length;
+                ata_ReplyIO(unit, io);
+            }
+        }
+
+        if (bounce)
+            FreePooled(pool, buffer, count << shift);
+    }
+
+    while ((io = (struct IORequest *)REMHEAD(run)))
+    {
+        if (n > 1)
+            ata_StartService(unit);
+        HandleIO(io, LIBBASE);
+        unit->au_IOStats.ios_Commands++;
+        ata_ReplyIO(unit, io);
+    }
+}
+
+/* Serve all requests queued for the unit */
+static void ata_ServeQueue(struct ata_Unit *unit, LIBBASETYPEPTR LIBBASE)
+{
+    struct MinList run;
+    struct IORequest *io, *next;
+    UQUAD block;
+    ULONG count, n;
+    BOOL write;
+
+    NEWLIST(&run);
+
+    while (!IsListEmpty((struct List *)&unit->au_IOQueue))
+    {
+        /* Carry on from the last transfer, or start over at the lowest block */
+        ForeachNode(&unit->au_IOQueue, io)
+        {
+            if (ata_IOBlock(io) >= unit->au_HeadPos)
+                break;
+        }
+        if (!IONext(io))
+            io = (struct IORequest *)GetHead(&unit->au_IOQueue);
+
+        block = ata_IOBlock(io);
+        count = ata_IOCount(io);
+        write = ata_IsWrite(io);
+
+        /* Take the requests it's continued by along */
+        for (n = 1; (next = IONext(io)) && IONext(next); n++)
+        {
+            if (ata_IsWrite(next) != write || ata_IOBlock(next) != block + count ||
+                count + ata_IOCount(next) > MAX_MERGESECTORS)
+                break;
+
+            count += ata_IOCount(next);
+            REMOVE(IONode(io));
+            ADDTAIL(&run, IONode(io));
+            io = next;
+        }
+        REMOVE(IONode(io));
+        ADDTAIL(&run, IONode(io));
+
+        unit->au_HeadPos = block + count;
+        ata_StartService(unit);
+        ata_DoRun(unit, &run, n, block, count, write, LIBBASE);
+    }
+}
+
+static void ata_QueueIO(struct IORequest *io, LIBBASETYPEPTR LIBBASE)
+{
+    struct ata_Unit *unit = (struct ata_Unit *)io->io_Unit;
+    UQUAD block = ata_IOBlock(io);
+    UQUAD end = block + ata_IOCount(io);
+    struct IORequest *queued;
+
+    ForeachNode(&unit->au_IOQueue, queued)
+    {
+        if ((ata_IsWrite(io) || ata_IsWrite(queued)) &&
+            block < ata_IOBlock(queued) + ata_IOCount(queued) && ata_IOBlock(queued) < end)
+        {
+            ata_ServeQueue(unit, LIBBASE);
+            break;
+        }
+    }
+
+    /* Sorted by block, behind requests for the same one */
+    ForeachNode(&unit->au_IOQueue, queued)
+    {
+        if (ata_IOBlock(queued) > block)
+            break;
+    }
+    Insert((struct List *)&unit->au_IOQueue, IONode(io), IONode(queued)->ln_Pred);
+
+    if (++unit->au_IOStats.ios_QueueDepth > unit->au_IOStats.ios_MaxQueueDepth)
+        unit->au_IOStats.ios_MaxQueueDepth = unit->au_IOStats.ios_QueueDepth;
+}
+
+/*
+    Empty the port of the bus. Reads and writes are queued, everything else
+    is done at once, after the requests queued before for its unit.
+*/
+static void ata_ServePort(struct ata_Bus *bus, struct ataBase *ATABase)
+{
+    struct IORequest *msg;
+    int iter;
+
+    while (!IsMsgPortEmpty(bus->ab_MsgPort))
+    {
+        while ((msg = (struct IORequest *)GetMsg(bus->ab_MsgPort)))
+        {
+            DDD(bug("[ATA:BusTask] Received Message | Command = %u \n", msg->io_Command));
+
+            if (ata_IsQueueable(msg))
+            {
+                ata_QueueIO(msg, ATABase);
+                continue;
+            }
+
+            ata_ServeQueue(Unit(msg), ATABase);
+
+            // And do IO's 
+            HandleIO(msg, ATABase);
+            // TD_ADDCHANGEINT doesn't require reply
+            if (msg->io_Command != TD_ADDCHANGEINT)
+            {
+                ReplyMsg((struct Message *)msg);
+            }
+        }
+
+        for (iter = 0; iter < MAX_BUSUNITS; iter++)
+        {
+            if (bus->ab_Units[iter])
+                ata_ServeQueue(OOP_INST_DATA(ATABase->unitClass, bus->ab_Units[iter]), ATABase);
+        }
+    }
+}
+
+
 /*
     Bus task body. It doesn't really do much. It receives simply all IORequests
     in endless loop and calls proper handling function. The IO is Semaphore-
@@ -1151,7 +1488,6 @@ void BusTaskCode(struct ata_Bus *bus, struct ataBase *ATABase)
 {
     ULONG sig;
     int iter;
-    struct IORequest *msg;
     OOP_Object *unitObj;
     struct ata_Unit *unit;
 
@@ -1258,18 +1594,7 @@ void BusTaskCode(struct ata_Bus *bus, struct ataBase *ATABase)
             bus->ab_Flags |= UNITF_ACTIVE;
 
             // Empty the request queue 
-            while ((msg = (struct IORequest *)GetMsg(bus->ab_MsgPort)))
-            {
-                DDD(bug("[ATA:BusTask] Received Message | Command = %u \n", msg->io_Command));
-                
-                // And do IO's 
-                HandleIO(msg, ATABase);
-                // TD_ADDCHANGEINT doesn't require reply
-                if (msg->io_Command != TD_ADDCHANGEINT)
-                {
-                    ReplyMsg((struct Message *)msg);
-                }
-            }
+            ata_ServePort(bus, ATABase);
 
             bus->ab_Flags &= ~(UNITF_INTASK | UNITF_ACTIVE);
         }
@@ -1280,7 +1605,6 @@ void BusTaskCode2(struct ata_Bus *bus, struct ataBase *ATABase)
 {
     ULONG sig;
     int iter;
-    struct IORequest *msg;
     OOP_Object *unitObj;
     struct ata_Unit *unit;
 
@@ -1377,16 +1701,7 @@ void BusTaskCode2(struct ata_Bus *bus, struct ataBase *ATABase)
             bus->ab_Flags |= UNITF_ACTIVE;
 
             /* Empty the request queue */
-            while ((msg = (struct IORequest *)GetMsg(bus->ab_MsgPort)))
-            {
-                /* And do IO's */
-                HandleIO(msg, ATABase);
-                /* TD_ADDCHANGEINT doesn't require reply */
-                if (msg->io_Command != TD_ADDCHANGEINT)
-                {
-                    ReplyMsg((struct Message *)msg);
-                }
-            }
+            ata_ServePort(bus, ATABase);
 
             bus->ab_Flags &= ~(UNITF_INTASK | UNITF_ACTIVE);
         }
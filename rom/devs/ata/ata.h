@@ -28,6 +28,7 @@
 #include <devices/newstyle.h>
 #include <devices/timer.h>
 #include <devices/cd.h>
+#include <devices/ata.h>
 #include <hardware/ata.h>
 #include <hidd/ata.h>
 
@@ -400,6 +401,13 @@ struct ata_Unit
    ULONG               au_cmd_length;
    ULONG               au_cmd_total;
    ULONG               au_cmd_error;
+
+   /******* I/O scheduler ********/
+   struct MinList      au_IOQueue;     /* Queued reads and writes, sorted by block */
+   UQUAD               au_HeadPos;     /* Block following the last one transferred */
+   UQUAD               au_ServiceTotal;/* Sum of all service times, microseconds */
+   struct timeval      au_ServiceStart;/* When the requests being served left au_IOQueue */
+   struct ATAIOStats   au_IOStats;
 };
 
 #define AF_XFER_DMA_MASK (AF_XFER_MDMA(0)|AF_XFER_MDMA(1)|AF_XFER_MDMA(2)|                 \
@@ -88,6 +88,7 @@ OOP_Object *ATAUnit__Root__New(OOP_Class *cl, OOP_Object *o, struct pRoot_New *m
         unit->au_SectorShift = 9; /* this really has to be set here. */
 
         NEWLIST(&unit->au_SoftList);
+        NEWLIST(&unit->au_IOQueue);
 
         /*
          * since the stack is always handled by caller
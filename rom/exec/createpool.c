@@ -43,6 +43,12 @@
                    directly to the system. threshSize must be
                    smaller than or equal to the puddleSize.
 
+        If MEMF_SLAB_POOLED is given in requirements, blocks of up to
+        about 1KB are served from per size class slabs. Allocating and
+        freeing such blocks takes constant time regardless of the number
+        of puddles in the pool, at the cost of rounding the block size up
+        to its size class.
+
     RESULT
         A handle for the memory pool or NULL if the pool couldn't
         be created
@@ -98,6 +104,10 @@
      */
     puddleSize += MEMHEADER_TOTAL + mhac_GetCtxSize() + sizeof(struct MemHeader *);
 
+    /* Slab pools keep their slab lists in the first puddle */
+    if (requirements & MEMF_SLAB_POOLED)
+        puddleSize += POOL_SLAB_CLASSES * sizeof(struct MinList) + MEMCHUNK_TOTAL;
+
     /* If mungwall is enabled, count also size of walls, at least for one allocation */
     if (PrivExecBase(SysBase)->IntFlags & EXECF_MungWall)
         puddleSize += MUNGWALL_TOTAL_SIZE;
@@ -129,6 +139,21 @@
         pool->pool.Requirements = requirements;
         pool->pool.PuddleSize   = puddleSize;
         pool->pool.PoolMagic   = POOL_MAGIC;
+        pool->pool.SlabLists   = NULL;
+
+        if (requirements & MEMF_SLAB_POOLED)
+        {
+            /* The slab lists live in the initial puddle too */
+            pool->pool.SlabLists = Allocate(firstPuddle, POOL_SLAB_CLASSES * sizeof(struct MinList));
+            if (pool->pool.SlabLists)
+            {
+                ULONG i;
+
+                for (i = 0; i < POOL_SLAB_CLASSES; i++)
+                    NEWLIST((struct List *)&pool->pool.SlabLists[i]);
+            }
+            D(bug("[CreatePool] Slab lists 0x%p\n", pool->pool.SlabLists);)
+        }
 
         if (requirements & MEMF_SEM_PROTECTED)
         {
@@ -61,6 +61,8 @@ struct IntExecBase
     struct Exec_PlatformData    PlatformData;                   /* Platform-specific stuff                                      */
     struct SupervisorAlertTask  SAT;
     char                        AlertBuffer[ALERT_BUFFER_SIZE]; /* Buffer for alert text                                        */
+    struct Task                 *ReadyTail[256];                /* Last task queued to TaskReady per priority, see taskready.h  */
+    ULONG                       ReadyMask[8];                   /* Priorities with a ReadyTail entry                            */
 #if defined(__AROSEXEC_BROKENMEMLOCK__)
     struct SignalSemaphore      MemListSem;                     /* Memory list protection semaphore                             */
 #elif defined(__AROSEXEC_SMP__)
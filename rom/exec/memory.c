@@ -45,6 +45,17 @@ struct MemHeader *FindMem(APTR address, struct ExecBase *SysBase)
                     return mh;
                 }
             }
+
+            /*
+             * A MemHeader converted to TLSF keeps the bounds of its whole
+             * region, which also holds blocks allocated before the conversion.
+             * They aren't TLSF's to free, but they are still of this type.
+             */
+            if (address >= mh->mh_Lower && address < mh->mh_Upper)
+            {
+                if (usermode) MEM_UNLOCK;
+                return mh;
+            }
         }
         else
         {
@@ -911,49 +922,21 @@ static void EnqueueMemHeader(struct MinList *list, struct MemHeader *mh)
 }
 
 /*
- * Allocate memory with given physical properties from the given pool.
- * Our pools can be mixed. This means that different puddles from the
- * pool can have different physical flags. For example the same pool
- * can contain puddles from both CHIP and FAST memory. This is done in
- * order to provide a single system default pool for all types of memory.
+ * Allocate a raw block of memSize bytes from the puddles of the given pool,
+ * creating a new puddle if needed. The pool must already be locked.
+ * The MemHeader the block came from is returned in *mhPtr.
  */
-APTR InternalAllocPooled(APTR poolHeader, IPTR memSize, ULONG flags, struct TraceLocation *loc, struct ExecBase *SysBase)
+static APTR poolAllocPuddle(struct ProtectedPool *pool, IPTR memSize, ULONG flags, struct MemHeader **mhPtr,
+                            struct TraceLocation *loc, struct ExecBase *SysBase)
 {
-    struct ProtectedPool *pool = poolHeader + MEMHEADER_TOTAL;
-    APTR ret = NULL;
-    IPTR origSize;
+    ULONG physFlags = flags & MEMF_PHYSICAL_MASK;
     struct MemHeader *mh;
-
-    D(bug("[exec] InternalAllocPooled(0x%p, %u, 0x%08X), header 0x%p\n", poolHeader, memSize, flags, pool));
-
-    /*
-     * Memory blocks allocated from the pool store pointers to the MemHeader they were
-     * allocated from. This is done in order to avoid slow lookups in InternalFreePooled().
-     * This is done in AllocVec()-alike manner; the pointer is placed right before the block.
-     */
-    memSize += sizeof(struct MemHeader *);
-    origSize = memSize;
-
-    /* If mungwall is enabled, count also size of walls */
-    if (PrivExecBase(SysBase)->IntFlags & EXECF_MungWall)
-        memSize += MUNGWALL_TOTAL_SIZE;
-
-    if (pool->pool.PoolMagic != POOL_MAGIC)
-    {
-        PoolManagerAlert(PME_ALLOC_INV_POOL, AT_DeadEnd, memSize, NULL, NULL, poolHeader);
-    }
-
-    if (pool->pool.Requirements & MEMF_SEM_PROTECTED)
-    {
-        ObtainSemaphore(&pool->sem);
-    }
+    APTR ret = NULL;
 
     /* Follow the list of MemHeaders */
     mh = (struct MemHeader *)pool->pool.PuddleList.mlh_Head;
     for(;;)
     {
-        ULONG physFlags = flags & MEMF_PHYSICAL_MASK;
-
         /* Are there no more MemHeaders? */
         if (mh->mh_Node.ln_Succ == NULL)
         {
@@ -1047,6 +1030,218 @@ APTR InternalAllocPooled(APTR poolHeader, IPTR memSize, ULONG flags, struct Trac
         mh = (struct MemHeader *)mh->mh_Node.ln_Succ;
     }
 
+    *mhPtr = mh;
+    return ret;
+}
+
+/*
+ * Give a raw block back to the puddle it was allocated from, releasing
+ * the puddle if it becomes empty. The pool must already be locked.
+ */
+static void poolFreePuddle(struct MemHeader *mh, APTR freeStart, IPTR freeSize,
+                           struct TraceLocation *loc, struct ExecBase *SysBase)
+{
+    IPTR size = mh->mh_Upper - mh->mh_Lower;
+
+    D(bug("[FreePooled] Allocated from puddle 0x%p, size %u\n", mh, size));
+
+    /* Free the memory. */
+    stdDealloc(mh, mhac_PoolMemHeaderGetCtx(mh), freeStart, freeSize, loc, SysBase);
+    D(bug("[FreePooled] Deallocated chunk, %u free bytes in the puddle\n", mh->mh_Free));
+
+    /* Is this MemHeader completely free now? */
+    if ((mh->mh_Free + mhac_GetCtxSize()) == size)
+    {
+        D(bug("[FreePooled] Puddle is empty, giving back to the system\n"));
+
+        /* Yes. Remove it from the list. */
+        Remove(&mh->mh_Node);
+        /* And free it. */
+        FreeMemHeader(mh, loc, SysBase);
+    }
+}
+
+/*
+ * Size classes of MEMF_SLAB_POOLED pools. Sizes are multiples of 16 bytes,
+ * so that slab objects are at least as aligned as ordinary pooled blocks.
+ */
+static const UWORD poolSlabSizes[POOL_SLAB_CLASSES] =
+{
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+
+/* Maps (size - 1) / 16 to the smallest class able to hold the size */
+static const UBYTE poolSlabIndex[POOL_SLAB_MAXSIZE / 16] =
+{
+     0,  1,  2,  3,  4,  4,  5,  5,  6,  6,  6,  6,  7,  7,  7,  7,
+     8,  8,  8,  8,  8,  8,  8,  8,  9,  9,  9,  9,  9,  9,  9,  9,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11
+};
+
+static IPTR poolSlabSize(UWORD class)
+{
+    IPTR size = poolSlabSizes[class] * POOL_SLAB_MINOBJS;
+
+    return (size < POOL_SLAB_MINSIZE) ? POOL_SLAB_MINSIZE : size;
+}
+
+/*
+ * Take one object of the given size class from a slab, creating a new slab
+ * from the puddles if no partially free one exists. The pool must already be
+ * locked. Returns a pointer to the object's back pointer slot.
+ */
+static APTR poolAllocSlab(struct ProtectedPool *pool, UWORD class, ULONG flags,
+                          struct TraceLocation *loc, struct ExecBase *SysBase)
+{
+    struct MinList *list = &pool->pool.SlabLists[class];
+    struct PoolSlab *slab = (struct PoolSlab *)list->mlh_Head;
+    APTR obj;
+
+    if (slab->ps_Node.mln_Succ == NULL)
+    {
+        IPTR objSize  = poolSlabSizes[class];
+        IPTR slabSize = poolSlabSize(class);
+        IPTR hdrSize  = AROS_ROUNDUP2(sizeof(struct MemHeader *) + sizeof(struct PoolSlab), 16);
+        struct MemHeader *mh;
+        UBYTE *raw, *p;
+        UWORD i;
+
+        raw = poolAllocPuddle(pool, slabSize, flags & ~MEMF_CLEAR, &mh, loc, SysBase);
+        if (raw == NULL)
+            return NULL;
+
+        /* The slab itself is an ordinary pooled block */
+        *((struct MemHeader **)raw) = mh;
+        slab = (struct PoolSlab *)(raw + sizeof(struct MemHeader *));
+
+        slab->ps_Class    = class;
+        slab->ps_Used     = 0;
+        slab->ps_Total    = (slabSize - hdrSize) / objSize;
+        slab->ps_FreeList = NULL;
+
+        /* Chain all objects, lowest address first */
+        for (i = slab->ps_Total, p = raw + hdrSize + (slab->ps_Total - 1) * objSize; i > 0; i--, p -= objSize)
+        {
+            *((APTR *)p) = slab->ps_FreeList;
+            slab->ps_FreeList = p;
+        }
+
+        D(bug("[InternalAllocPooled] New slab 0x%p, class %u, %u objects\n", slab, class, slab->ps_Total));
+        AddHead((struct List *)list, (struct Node *)&slab->ps_Node);
+    }
+
+    obj = slab->ps_FreeList;
+    slab->ps_FreeList = *((APTR *)obj);
+
+    /* A full slab leaves the list until one of its objects is freed */
+    if (++slab->ps_Used == slab->ps_Total)
+        Remove((struct Node *)&slab->ps_Node);
+
+    if (flags & MEMF_CLEAR)
+        memset(obj, 0, poolSlabSizes[class]);
+
+    /* Tag the back pointer so that InternalFreePooled() knows where to return it */
+    *((IPTR *)obj) = (IPTR)slab | POOL_SLAB_TAG;
+
+    return obj;
+}
+
+/*
+ * Return an object to its slab. Empty slabs are given back to the puddles,
+ * unless it is the only partially free slab of its class. The pool must
+ * already be locked.
+ */
+static void poolFreeSlab(struct ProtectedPool *pool, struct PoolSlab *slab, APTR obj,
+                         struct TraceLocation *loc, struct ExecBase *SysBase)
+{
+    struct MinList *list = &pool->pool.SlabLists[slab->ps_Class];
+
+    if (slab->ps_Used-- == slab->ps_Total)
+        AddHead((struct List *)list, (struct Node *)&slab->ps_Node);
+
+    *((APTR *)obj) = slab->ps_FreeList;
+    slab->ps_FreeList = obj;
+
+    if (slab->ps_Used == 0 &&
+        (list->mlh_Head != &slab->ps_Node || slab->ps_Node.mln_Succ->mln_Succ != NULL))
+    {
+        APTR raw = (APTR)slab - sizeof(struct MemHeader *);
+
+        D(bug("[FreePooled] Slab 0x%p is empty, giving back to the puddle\n", slab));
+
+        Remove((struct Node *)&slab->ps_Node);
+        poolFreePuddle(*((struct MemHeader **)raw), raw, poolSlabSize(slab->ps_Class), loc, SysBase);
+    }
+}
+
+/*
+ * Allocate memory with given physical properties from the given pool.
+ * Our pools can be mixed. This means that different puddles from the
+ * pool can have different physical flags. For example the same pool
+ * can contain puddles from both CHIP and FAST memory. This is done in
+ * order to provide a single system default pool for all types of memory.
+ */
+APTR InternalAllocPooled(APTR poolHeader, IPTR memSize, ULONG flags, struct TraceLocation *loc, struct ExecBase *SysBase)
+{
+    struct ProtectedPool *pool = poolHeader + MEMHEADER_TOTAL;
+    APTR ret = NULL;
+    IPTR origSize;
+    struct MemHeader *mh;
+
+    D(bug("[exec] InternalAllocPooled(0x%p, %u, 0x%08X), header 0x%p\n", poolHeader, memSize, flags, pool));
+
+    /*
+     * Memory blocks allocated from the pool store pointers to the MemHeader they were
+     * allocated from. This is done in order to avoid slow lookups in InternalFreePooled().
+     * This is done in AllocVec()-alike manner; the pointer is placed right before the block.
+     */
+    memSize += sizeof(struct MemHeader *);
+    origSize = memSize;
+
+    if (pool->pool.PoolMagic != POOL_MAGIC)
+    {
+        PoolManagerAlert(PME_ALLOC_INV_POOL, AT_DeadEnd, memSize, NULL, NULL, poolHeader);
+    }
+
+    /*
+     * Small blocks of slab pools are served from per size class free lists.
+     * Mungwall needs real pooled blocks, and so do requests for memory types
+     * other than the pool's own.
+     */
+    if ((pool->pool.SlabLists != NULL) && (memSize <= POOL_SLAB_MAXSIZE) &&
+        !(PrivExecBase(SysBase)->IntFlags & EXECF_MungWall) &&
+        ((flags & MEMF_PHYSICAL_MASK) == (pool->pool.Requirements & MEMF_PHYSICAL_MASK)))
+    {
+        if (pool->pool.Requirements & MEMF_SEM_PROTECTED)
+        {
+            ObtainSemaphore(&pool->sem);
+        }
+
+        ret = poolAllocSlab(pool, poolSlabIndex[(memSize - 1) >> 4], flags, loc, SysBase);
+
+        if (pool->pool.Requirements & MEMF_SEM_PROTECTED)
+        {
+            ReleaseSemaphore(&pool->sem);
+        }
+
+        if (ret)
+            ret += sizeof(struct MemHeader *);
+
+        return ret;
+    }
+
+    /* If mungwall is enabled, count also size of walls */
+    if (PrivExecBase(SysBase)->IntFlags & EXECF_MungWall)
+        memSize += MUNGWALL_TOTAL_SIZE;
+
+    if (pool->pool.Requirements & MEMF_SEM_PROTECTED)
+    {
+        ObtainSemaphore(&pool->sem);
+    }
+
+    ret = poolAllocPuddle(pool, memSize, flags, &mh, loc, SysBase);
+
     if (pool->pool.Requirements & MEMF_SEM_PROTECTED)
     {
         ReleaseSemaphore(&pool->sem);
@@ -1089,6 +1284,43 @@ void InternalFreePooled(APTR poolHeader, APTR memory, IPTR memSize, struct Trace
     freeSize = memSize + sizeof(struct MemHeader *);
     mh = *((struct MemHeader **)freeStart);
 
+    /* Blocks living in a slab point back to the slab instead */
+    if ((IPTR)mh & POOL_SLAB_TAG)
+    {
+        struct PoolSlab *slab = (struct PoolSlab *)((IPTR)mh & ~(IPTR)POOL_SLAB_TAG);
+        APTR raw = (APTR)slab - sizeof(struct MemHeader *);
+        struct ProtectedPool *pool;
+        APTR poolHeaderMH;
+
+        mh = *((struct MemHeader **)raw);
+        pool = (struct ProtectedPool *)mhac_PoolMemHeaderGetPool(mh);
+        poolHeaderMH = (APTR)((IPTR)pool - MEMHEADER_TOTAL);
+
+        if (pool->pool.PoolMagic != POOL_MAGIC)
+        {
+            PoolManagerAlert(PME_FREE_INV_POOL, AT_DeadEnd, memSize, memory, poolHeaderMH, NULL);
+        }
+
+        if (poolHeaderMH != poolHeader)
+        {
+            PoolManagerAlert(PME_FREE_MXD_POOL, 0, memSize, memory, poolHeaderMH, poolHeader);
+        }
+
+        if (pool->pool.Requirements & MEMF_SEM_PROTECTED)
+        {
+            ObtainSemaphore(&pool->sem);
+        }
+
+        poolFreeSlab(pool, slab, freeStart, loc, SysBase);
+
+        if (pool->pool.Requirements & MEMF_SEM_PROTECTED)
+        {
+            ReleaseSemaphore(&pool->sem);
+        }
+
+        return;
+    }
+
     /* Check walls first */
     freeStart = MungWall_Check(freeStart, freeSize, loc, SysBase);
     if (PrivExecBase(SysBase)->IntFlags & EXECF_MungWall)
@@ -1104,7 +1336,6 @@ void InternalFreePooled(APTR poolHeader, APTR memory, IPTR memSize, struct Trace
     else
     {
         struct ProtectedPool *pool = (struct ProtectedPool *)mhac_PoolMemHeaderGetPool(mh);
-        IPTR size;
         APTR poolHeaderMH = (APTR)((IPTR)pool - MEMHEADER_TOTAL);
 
         if (pool->pool.PoolMagic != POOL_MAGIC)
@@ -1122,23 +1353,7 @@ void InternalFreePooled(APTR poolHeader, APTR memory, IPTR memSize, struct Trace
             ObtainSemaphore(&pool->sem);
         }
 
-        size = mh->mh_Upper - mh->mh_Lower;
-        D(bug("[FreePooled] Allocated from puddle 0x%p, size %u\n", mh, size));
-
-        /* Free the memory. */
-        stdDealloc(mh, mhac_PoolMemHeaderGetCtx(mh), freeStart, freeSize, loc, SysBase);
-        D(bug("[FreePooled] Deallocated chunk, %u free bytes in the puddle\n", mh->mh_Free));
-
-        /* Is this MemHeader completely free now? */
-        if ((mh->mh_Free + mhac_GetCtxSize()) == size)
-        {
-            D(bug("[FreePooled] Puddle is empty, giving back to the system\n"));
-
-            /* Yes. Remove it from the list. */
-            Remove(&mh->mh_Node);
-            /* And free it. */
-            FreeMemHeader(mh, loc, SysBase);
-        }
+        poolFreePuddle(mh, freeStart, freeSize, loc, SysBase);
         /* All done. */
     
         if (pool->pool.Requirements & MEMF_SEM_PROTECTED)
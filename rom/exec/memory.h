@@ -31,6 +31,18 @@
 
 #define POOL_MAGIC AROS_MAKE_ID('P','o','O','l')
 
+/*
+ * Size classes used by MEMF_SLAB_POOLED pools. Class sizes include the
+ * back pointer stored in front of every pooled block.
+ */
+#define POOL_SLAB_CLASSES       12
+#define POOL_SLAB_MAXSIZE       1024
+#define POOL_SLAB_MINOBJS       8
+#define POOL_SLAB_MINSIZE       4096
+
+/* Low bit of a block's back pointer marks blocks living in a slab */
+#define POOL_SLAB_TAG           1
+
 /* Private Pool structure */
 struct Pool 
 {
@@ -38,6 +50,17 @@ struct Pool
     ULONG Requirements;
     ULONG PuddleSize;
     ULONG PoolMagic;
+    struct MinList *SlabLists;  /* Partially free slabs per size class, MEMF_SLAB_POOLED only */
+};
+
+/* Header of a slab, allocated as an ordinary block from the puddles */
+struct PoolSlab
+{
+    struct MinNode ps_Node;
+    APTR           ps_FreeList;     /* Singly linked list of free objects */
+    UWORD          ps_Class;
+    UWORD          ps_Used;
+    UWORD          ps_Total;
 };
 
 struct ProtectedPool
@@ -17,6 +17,7 @@
 #include "exec_util.h"
 #include "exec_debug.h"
 #include "taskstorage.h"
+#include "taskready.h"
 
 #if defined(__AROSEXEC_SMP__)
 #define __KERNEL_NOLIBBASE__
@@ -223,7 +224,7 @@
     /* Add the new task to the ready list. */
 #if !defined(__AROSEXEC_SMP__)
     task->tc_State = TS_READY;
-    Enqueue(&SysBase->TaskReady, &task->tc_Node);
+    ReadyEnqueue(SysBase, task);
 #else
     task->tc_State = TS_INVALID;
     krnSysCallReschedTask(task, TS_READY);
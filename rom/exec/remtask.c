@@ -14,6 +14,7 @@
 
 #include "etask.h"
 #include "exec_intern.h"
+#include "taskready.h"
 #include "exec_util.h"
 #include "exec_debug.h"
 
@@ -97,6 +98,7 @@
              * the MemEntry list might contain the task struct itself!
             */
 #if !defined(EXEC_REMTASK_NEEDSSWITCH)
+            ReadyDropHint(SysBase, task);
             task->tc_State = TS_REMOVED;
             Remove(&task->tc_Node);
 #else
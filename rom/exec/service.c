@@ -13,6 +13,7 @@
 #include <proto/exec.h>
 
 #include "exec_intern.h"
+#include "taskready.h"
 #include "exec_util.h"
 #include "exec_debug.h"
 
@@ -103,7 +104,7 @@ void ServiceTask(struct ExecBase *SysBase)
                      */
 #if !defined(EXEC_REMTASK_NEEDSSWITCH)
                     task->tc_State = TS_READY;
-                    Enqueue(&SysBase->TaskReady, &task->tc_Node);
+                    ReadyEnqueue(SysBase, task);
 #else
                     krnSysCallReschedTask(task, TS_READY);
 #endif
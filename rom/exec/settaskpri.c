@@ -14,6 +14,7 @@
 #include <proto/exec.h>
 
 #include "exec_intern.h"
+#include "taskready.h"
 #if defined(__AROSEXEC_SMP__)
 #include "etask.h"
 #include "exec_locks.h"
@@ -95,19 +96,20 @@
     /* Get returncode */
     old = task->tc_Node.ln_Pri;
 
-    /* Set new value. */
-    task->tc_Node.ln_Pri = priority;
+    /* If it is in the ready list remove it, set new value and reinsert it. */
+    if (task->tc_State == TS_READY)
+    {
+        ReadyDropHint(SysBase, task);
+        Remove(&task->tc_Node);
+        task->tc_Node.ln_Pri = priority;
+        ReadyEnqueue(SysBase, task);
+    }
+    else
+        task->tc_Node.ln_Pri = priority;
 
     /* Check if the task is willing to run. */
     if (task->tc_State != TS_WAIT)
     {
-        /* If it is in the ready list remove and reinsert it. */
-        if (task->tc_State == TS_READY)
-        {
-            Remove(&task->tc_Node);
-            Enqueue(&SysBase->TaskReady, &task->tc_Node);
-        }
-
 #if defined(__AROSEXEC_SMP__)
         EXEC_UNLOCK(task_listlock);
 
@@ -15,6 +15,7 @@
 
 #define __AROS_KERNEL__
 #include "exec_intern.h"
+#include "taskready.h"
 
 #if defined(__AROSEXEC_SMP__)
 #include <utility/hooks.h>
@@ -228,7 +229,7 @@ AROS_UFH3(IPTR, signal_hook,
 #else
             Remove(&task->tc_Node);
             task->tc_State = TS_READY;
-            Enqueue(&SysBase->TaskReady, &task->tc_Node);
+            ReadyEnqueue(SysBase, task);
 #endif
             /* Has it a higher priority as the current one? */
             if (
@@ -0,0 +1,78 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Desc: Priority ordered insertion into TaskReady, shared by exec and
+          kernel.resource.
+*/
+#ifndef TASKREADY_H
+#define TASKREADY_H
+
+#include <exec/execbase.h>
+#include <exec/tasks.h>
+
+#include "exec_intern.h"
+
+/*
+ * TaskReady stays a single list sorted by priority, so everything that walks
+ * it under Disable() keeps working. We remember the last task queued for each
+ * priority in ReadyTail[] and keep a bitmap of these priorities in ReadyMask[].
+ * A new task is linked after the hint for its own or the nearest higher
+ * priority, which keeps the FIFO order of Enqueue() without walking the list.
+ *
+ * All insertions into TaskReady must go through ReadyEnqueue(), and every task
+ * leaving TaskReady (or changing its priority while in it) must be passed to
+ * ReadyDropHint() first, so a hint never points to a task which isn't there.
+ * Both must be called with the task lists protected.
+ */
+
+#define READY_INDEX(pri)        ((UBYTE)((pri) + 128))
+
+static inline void ReadyDropHint(struct ExecBase *SysBase, struct Task *task)
+{
+    UWORD idx = READY_INDEX(task->tc_Node.ln_Pri);
+
+    if (PrivExecBase(SysBase)->ReadyTail[idx] == task)
+    {
+        PrivExecBase(SysBase)->ReadyTail[idx] = NULL;
+        PrivExecBase(SysBase)->ReadyMask[idx >> 5] &= ~(1UL << (idx & 31));
+    }
+}
+
+static inline void ReadyEnqueue(struct ExecBase *SysBase, struct Task *task)
+{
+    struct Node *pred = (struct Node *)&SysBase->TaskReady.lh_Head;
+    UWORD idx = READY_INDEX(task->tc_Node.ln_Pri);
+    UWORD word;
+
+    for (word = idx >> 5; word < 8; word++)
+    {
+        ULONG bits = PrivExecBase(SysBase)->ReadyMask[word];
+
+        if (word == (idx >> 5))
+            bits &= ~0UL << (idx & 31);
+
+        if (bits)
+        {
+            pred = &PrivExecBase(SysBase)->ReadyTail[(word << 5) + __builtin_ffs(bits) - 1]->tc_Node;
+            break;
+        }
+    }
+
+    /*
+     * Tasks of a priority can outlive its hint (when the tail is removed
+     * first), so skip anything left with higher or equal priority.
+     */
+    while (pred->ln_Succ->ln_Succ && (pred->ln_Succ->ln_Pri >= task->tc_Node.ln_Pri))
+        pred = pred->ln_Succ;
+
+    task->tc_Node.ln_Succ  = pred->ln_Succ;
+    task->tc_Node.ln_Pred  = pred;
+    pred->ln_Succ->ln_Pred = &task->tc_Node;
+    pred->ln_Succ          = &task->tc_Node;
+
+    PrivExecBase(SysBase)->ReadyTail[idx] = task;
+    PrivExecBase(SysBase)->ReadyMask[idx >> 5] |= 1UL << (idx & 31);
+}
+
+#endif /* TASKREADY_H */
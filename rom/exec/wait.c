@@ -89,8 +89,8 @@
         thisTask->tc_State = TS_WAIT;
         // nb: on smp builds switch will move us.
 #if !defined(__AROSEXEC_SMP__)
-        /* Move current task to the waiting list. */
-        Enqueue(&SysBase->TaskWait, &thisTask->tc_Node);
+        /* Move current task to the waiting list. Its order doesn't matter. */
+        AddTail(&SysBase->TaskWait, &thisTask->tc_Node);
 #endif
 
 	/* And switch to the next ready task. */
@@ -22,21 +22,130 @@ extern void dumpcachebuffers(void);
 
 extern void setchecksum(struct CacheBuffer *);
 
+/* The ORIGINAL and LATEST indexes are sized to the number of CacheBuffers,
+   but never get more than MAXHASHSIZE chains. */
+
+#define MAXHASHSIZE (65536)
+
+#define ORIGINALHASH(blckno) (&globals->cbhashoriginal[(blckno) & globals->cbhashmask])
+#define LATESTHASH(blckno)   (&globals->cbhashlatest[(blckno) & globals->cbhashmask])
+
+static LONG resizecachebufferindexes(ULONG buffers);
+
 /* Internal globals */
 
 LONG initcachebuffers(void) {
-  WORD n=HASHSIZE;
-
   initlist((struct List *)&globals->cblrulist);
-  while(n--!=0) {
-    initlist((struct List *)&globals->cbhashlist[n]);
+
+  return(resizecachebufferindexes(HASHSIZE));
+}
+
+
+
+void cleanupcachebuffers(void) {
+
+  /* Frees the ORIGINAL and LATEST indexes allocated by
+     initcachebuffers(). */
+
+  if(globals->cbhashoriginal!=0) {
+    FreeMem(globals->cbhashoriginal, (globals->cbhashmask+1)*2*sizeof(struct MinList));
+    globals->cbhashoriginal=0;
+    globals->cbhashlatest=0;
+  }
+}
+
+
+
+static LONG resizecachebufferindexes(ULONG buffers) {
+  struct MinList *hash;
+  struct CacheBuffer *cb;
+  ULONG chains=HASHSIZE;
+  ULONG n;
+
+  /* (Re)allocates the ORIGINAL and LATEST indexes so there is about one
+     CacheBuffer per chain, and rehashes all CacheBuffers which are in
+     use.  Both indexes share a single allocation.  If there isn't enough
+     memory the current indexes are kept; they still work, but the
+     chains will be longer. */
+
+  while(chains<buffers && chains<MAXHASHSIZE) {
+    chains<<=1;
+  }
+
+  if(globals->cbhashoriginal!=0 && chains==globals->cbhashmask+1) {
+    return(0);
+  }
+
+  if((hash=AllocMem(chains*2*sizeof(struct MinList), MEMF_PUBLIC))==0) {
+    return(ERROR_NO_FREE_STORE);
+  }
+
+  for(n=0; n<chains*2; n++) {
+    initlist((struct List *)&hash[n]);
+  }
+
+  cb=(struct CacheBuffer *)globals->cblrulist.mlh_Head;
+
+  while(cb->node.mln_Succ!=0) {
+    if((cb->bits & CB_ORIGINAL)!=0) {
+      addtailm(&hash[cb->blckno & (chains-1)], &cb->hashnode);
+    }
+    if((cb->bits & CB_LATEST)!=0) {
+      addtailm(&hash[chains + (cb->blckno & (chains-1))], &cb->latestnode);
+    }
+
+    cb=(struct CacheBuffer *)(cb->node.mln_Succ);
+  }
+
+  if(globals->cbhashoriginal!=0) {
+    FreeMem(globals->cbhashoriginal, (globals->cbhashmask+1)*2*sizeof(struct MinList));
   }
 
+  globals->cbhashoriginal=hash;
+  globals->cbhashlatest=hash+chains;
+  globals->cbhashmask=chains-1;
+
+  _DEBUG("resizecachebufferindexes: %ld chains for %ld buffers\n", chains, buffers);
+
   return(0);
 }
 
 
 
+void setcachebufferbits(struct CacheBuffer *cb, UBYTE bits) {
+  UBYTE changed=cb->bits ^ bits;
+
+  /* Changes the bits of a CacheBuffer and links it into or out of
+     the ORIGINAL and LATEST indexes accordingly.  The blckno of the
+     CacheBuffer must already be set. */
+
+  if((changed & CB_ORIGINAL)!=0) {
+    if((bits & CB_ORIGINAL)!=0) {
+      addtailm(ORIGINALHASH(cb->blckno), &cb->hashnode);
+    }
+    else {
+      removem(&cb->hashnode);
+      cb->hashnode.mln_Succ=0;
+      cb->hashnode.mln_Pred=0;
+    }
+  }
+
+  if((changed & CB_LATEST)!=0) {
+    if((bits & CB_LATEST)!=0) {
+      addtailm(LATESTHASH(cb->blckno), &cb->latestnode);
+    }
+    else {
+      removem(&cb->latestnode);
+      cb->latestnode.mln_Succ=0;
+      cb->latestnode.mln_Pred=0;
+    }
+  }
+
+  cb->bits=bits;
+}
+
+
+
 static void checkcb(struct CacheBuffer *cb,UBYTE *string)
 {
 //  if(cb->id!=0x4A48 || cb->data!=&cb->attached_data[0] || (cb->bits & (CB_ORIGINAL|CB_EMPTY))==(CB_ORIGINAL|CB_EMPTY) || (cb->bits & (CB_ORIGINAL|CB_LATEST))==(CB_ORIGINAL|CB_LATEST) || (cb->bits & (CB_ORIGINAL|CB_LATEST|CB_EMPTY))==CB_EMPTY) {
@@ -58,10 +167,13 @@ static void checkcb(struct CacheBuffer *cb,UBYTE *string)
 struct CacheBuffer *findoriginalcachebuffer(BLCK blckno) {
   struct CacheBuffer *cb;
 
-  cb=(struct CacheBuffer *)(globals->cbhashlist[blckno & (HASHSIZE-1)].mlh_Head-1);
+  /* The ORIGINAL index only contains CB_ORIGINAL CacheBuffers, so
+     there is no need to check the bits. */
+
+  cb=(struct CacheBuffer *)(ORIGINALHASH(blckno)->mlh_Head-1);
 
   while(cb->hashnode.mln_Succ!=0) {
-    if(cb->blckno==blckno && (cb->bits & CB_ORIGINAL)!=0) {
+    if(cb->blckno==blckno) {
       return(cb);
     }
     cb=(struct CacheBuffer *)(cb->hashnode.mln_Succ-1);
@@ -75,13 +187,13 @@ struct CacheBuffer *findoriginalcachebuffer(BLCK blckno) {
 struct CacheBuffer *findlatestcachebuffer(BLCK blckno) {
   struct CacheBuffer *cb;
 
-  cb=(struct CacheBuffer *)(globals->cbhashlist[blckno & (HASHSIZE-1)].mlh_Head-1);
+  cb=(struct CacheBuffer *)(LATESTHASH(blckno)->mlh_Head-2);
 
-  while(cb->hashnode.mln_Succ!=0) {
-    if(cb->blckno==blckno && (cb->bits & CB_LATEST)!=0) {
+  while(cb->latestnode.mln_Succ!=0) {
+    if(cb->blckno==blckno) {
       return(cb);
     }
-    cb=(struct CacheBuffer *)(cb->hashnode.mln_Succ-1);
+    cb=(struct CacheBuffer *)(cb->latestnode.mln_Succ-2);
   }
 
   return(0);
@@ -164,13 +276,13 @@ LONG readoriginalcachebuffer(struct CacheBuffer **returned_cb,BLCK blckno) {
     }
 
     cb->blckno=blckno;
-    cb->bits=CB_ORIGINAL;
 
     if(isthereanoperationfor(blckno)==FALSE) {
-      cb->bits|=CB_LATEST;
+      setcachebufferbits(cb, CB_ORIGINAL|CB_LATEST);
+    }
+    else {
+      setcachebufferbits(cb, CB_ORIGINAL);
     }
-
-    addtailm(&globals->cbhashlist[blckno & (HASHSIZE-1)],&cb->hashnode);
   }
   else {
     return(ERROR_NO_FREE_STORE);
@@ -213,9 +325,14 @@ void resetcachebuffer(struct CacheBuffer *cb)
   if(cb->hashnode.mln_Succ!=0 && cb->hashnode.mln_Pred!=0) {
     removem(&cb->hashnode);
   }
+  if(cb->latestnode.mln_Succ!=0 && cb->latestnode.mln_Pred!=0) {
+    removem(&cb->latestnode);
+  }
 
   cb->hashnode.mln_Succ=0;
   cb->hashnode.mln_Pred=0;
+  cb->latestnode.mln_Succ=0;
+  cb->latestnode.mln_Pred=0;
   cb->locked=0;
   cb->bits=0;
   cb->blckno=0;
@@ -292,9 +409,7 @@ struct CacheBuffer *createnewcachebuffer(BLCK block) {
   cb=getcachebuffer();
 
   cb->blckno=block;
-  cb->bits=CB_LATEST|CB_EMPTY;
-
-  addtailm(&globals->cbhashlist[block & (HASHSIZE-1)],&cb->hashnode);
+  setcachebufferbits(cb, CB_LATEST|CB_EMPTY);
 
   return(cb);
 }
@@ -403,15 +518,12 @@ struct CacheBuffer *saveoriginalcachebuffer(struct CacheBuffer *cb) {
   unlockcachebuffer(cb);
 
   cb_new->blckno=cb->blckno;
-  cb_new->bits=CB_ORIGINAL;
 
-  cb->bits&=~(CB_ORIGINAL|CB_CHECKSUM);
-  cb->bits|=CB_LATEST;
+  setcachebufferbits(cb, (cb->bits & ~(CB_ORIGINAL|CB_CHECKSUM)) | CB_LATEST);
+  setcachebufferbits(cb_new, CB_ORIGINAL);
 
   CopyMemQuick(cb->data, cb_new->data, globals->bytes_block);
 
-  addtailm(&globals->cbhashlist[cb_new->blckno & (HASHSIZE-1)],&cb_new->hashnode);
-
   return(cb_new);
 }
 
@@ -728,7 +840,7 @@ void dumpcachebuffers(void) {
   _DEBUG("Blck-- Lock Bits Data---- ID------ cb-adr-- Hashed?\n");
   while(cb->node.mln_Succ!=0) {
     _DEBUG("%6ld %4ld %4ld %08lx %08lx %08lx ",cb->blckno,(LONG)cb->locked,(LONG)cb->bits,cb->data,*(ULONG *)cb->data,cb);
-    if(cb->hashnode.mln_Succ==0 && cb->hashnode.mln_Pred==0) {
+    if(cb->hashnode.mln_Succ==0 && cb->latestnode.mln_Succ==0) {
       _DEBUG("No\n");
     }
     else {
@@ -818,6 +930,10 @@ LONG addcachebuffers(LONG buffers) {
 
   globals->totalbuffers=newbuffers;
 
+  /* Failing to resize the indexes isn't fatal, the old ones remain in use. */
+
+  resizecachebufferindexes(newbuffers);
+
   return(errorcode);
 }
 
@@ -5,12 +5,13 @@
 #include <exec/types.h>
 
 struct CacheBuffer {
-  /* Keep the below two structures in this order.  There is no support for linking
-     structures in two different lists properly, so to find the start of the CacheBuffer
-     structure in the case of the 2nd MinNode we substract a few bytes from it. */
+  /* Keep the below three structures in this order.  There is no support for linking
+     structures in several lists properly, so to find the start of the CacheBuffer
+     structure in the case of the 2nd and 3rd MinNode we substract a few bytes from it. */
 
   struct MinNode node;               // LRU link
-  struct MinNode hashnode;           // Linked chain of blocks with same hash value
+  struct MinNode hashnode;           // Chain of CB_ORIGINAL blocks with same hash value
+  struct MinNode latestnode;         // Chain of CB_LATEST blocks with same hash value
 
   UBYTE locked;                      // 0 if unlocked.
   UBYTE bits;                        /* Bit 0: Set means this block is original.
@@ -43,6 +44,10 @@ struct CacheBuffer {
   Other combinations of CB_LATEST, CB_ORIGINAL and CB_EMPTY are invalid.
 
   An exception to this rule could be none set at all, which would indicate an unused cachebuffer.
+
+  A CacheBuffer is linked into the ORIGINAL index (hashnode) when CB_ORIGINAL is set and into
+  the LATEST index (latestnode) when CB_LATEST is set.  Always use setcachebufferbits() to
+  change either of these bits, so the indexes are kept up to date.
 */
 
 #endif // _CACHEBUFFERS_H
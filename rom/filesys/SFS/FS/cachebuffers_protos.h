@@ -6,6 +6,7 @@
 #include "cachebuffers.h"
 
 LONG initcachebuffers(void);
+void cleanupcachebuffers(void);
 
 LONG readcachebuffer(struct CacheBuffer **, BLCK);
 LONG writecachebuffer(struct CacheBuffer *cb);
@@ -35,6 +36,8 @@ void emptycachebuffer(struct CacheBuffer *cb);
 void clearcachebuffer(struct CacheBuffer *cb);
 void resetcachebuffer(struct CacheBuffer *cb);
 
+void setcachebufferbits(struct CacheBuffer *cb, UBYTE bits);
+
 LONG addcachebuffers(LONG buffers);
 void invalidatecachebuffers(void);
 
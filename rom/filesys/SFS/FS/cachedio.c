@@ -53,6 +53,12 @@ struct IOCache {
 
 #define IOC_DIRTY  (1)   /* IOCache contains dirty data */
 
+/* Upper limit in bytes for the read-ahead window of a single file.  The
+   window is further limited by the MaxTransfer of the device and by half
+   the number of IOCache lines, so metadata always keeps some lines. */
+
+#define IOC_MAXWINDOW (262144)
+
 /*
 
 Functions making use of the IOCache mechanism:
@@ -80,6 +86,15 @@ mode the cache operates in.  WriteThrough caching means the
 buffers are just updated and kept in memory.  Otherwise a
 buffer is simply marked invalid.
 
+File data is read using readstream and readbytesstream.
+These keep track of the access pattern of each open file.
+As long as a file is read sequentially the read-ahead window
+of that file is doubled on every read, until it reaches
+iocache_maxwindow.  The lines in the window which are not
+yet cached are then read using a single transfer.  Any
+non-sequential read resets the window, so random access only
+ever reads the single line which contains the data.
+
 */
 
 
@@ -199,6 +214,35 @@ struct MinList *allocate(ULONG size, LONG n) {
 
 
 
+static void setreadahead(void) {
+  ULONG maxwindow=(globals->iocache_lines>>1) * globals->iocache_sizeinblocks;
+
+  /* Determines the largest read-ahead window for the current IOCache
+     settings and allocates a buffer large enough to read it in one
+     go.  Read-ahead is simply disabled if there isn't enough memory. */
+
+  if(maxwindow > globals->blocks_maxtransfer) {
+    maxwindow=globals->blocks_maxtransfer;
+  }
+  if(maxwindow > IOC_MAXWINDOW>>globals->shifts_block) {
+    maxwindow=IOC_MAXWINDOW>>globals->shifts_block;
+  }
+  maxwindow&=~globals->iocache_mask;
+
+  if(globals->iocache_rabuffer!=0) {
+    FreeVec(globals->iocache_rabuffer);
+    globals->iocache_rabuffer=0;
+  }
+
+  if(maxwindow!=0 && (globals->iocache_rabuffer=AllocVec(maxwindow<<globals->shifts_block, globals->bufmemtype))==0) {
+    maxwindow=0;
+  }
+
+  globals->iocache_maxwindow=maxwindow;
+}
+
+
+
 ULONG queryiocache_lines(void) {
   return(globals->iocache_lines);
 }
@@ -278,6 +322,8 @@ LONG setiocache(ULONG lines, ULONG readahead, BYTE copyback) {
       freeIOCache(globals->iocache_lruhead);
       globals->iocache_lruhead=lruhead;
 
+      setreadahead();
+
       if(globals->iocache_readonwrite==FALSE && globals->iocache_copyback!=FALSE) {
         globals->ioc_buffer=(struct IOCache *)globals->iocache_lruhead->mlh_Head;
         globals->ioc_buffer->locked=TRUE;
@@ -328,6 +374,12 @@ void cleanupcachedio(void) {
   freeIOCache(globals->iocache_lruhead);
   globals->iocache_lruhead=0;
 
+  if(globals->iocache_rabuffer!=0) {
+    FreeVec(globals->iocache_rabuffer);
+    globals->iocache_rabuffer=0;
+  }
+  globals->iocache_maxwindow=0;
+
   globals->iocache_lines=0;
 
   cleanupdeviceio();
@@ -606,6 +658,8 @@ LONG readintocache(BLCK block, struct IOCache **returned_ioc) {
   LONG errorcode=0;
 
   if((ioc=locateiocache(block))==0) {
+    globals->statistics.cachedio_misses++;
+
     if((errorcode=lruiocache(&ioc))==0) {
       ULONG blockstart=block & ~globals->iocache_mask;
       ULONG blocklength=globals->iocache_sizeinblocks;
@@ -627,6 +681,9 @@ LONG readintocache(BLCK block, struct IOCache **returned_ioc) {
       }
     }
   }
+  else {
+    globals->statistics.cachedio_hits++;
+  }
 
   *returned_ioc=ioc;
 
@@ -801,6 +858,161 @@ LONG read(BLCK block, UBYTE *buffer, ULONG blocks) {
 
 
 
+static void prefetchiocaches(BLCK block, BLCK end, ULONG window) {
+  struct IOCache *ioc;
+  BLCK last=block+window;
+  BLCK start;
+
+  /* Makes sure the lines covering the /window/ blocks starting at /block/
+     are present in the IOCache.  Nothing is read as long as at least half
+     the window is still cached; this way the missing lines are read with
+     a few large transfers instead of one line at a time.  Errors are
+     ignored, the data will simply be read again when it is needed. */
+
+  if(end>globals->blocks_total) {
+    end=globals->blocks_total;
+  }
+  if(last>end) {
+    last=end;
+  }
+
+  start=block;
+  block&=~globals->iocache_mask;
+
+  while(block<last && findiocache(block)!=0) {
+    block+=globals->iocache_sizeinblocks;
+  }
+
+  if(block>=last || block-start >= window>>1) {
+    return;
+  }
+
+  while(block<last) {
+    ULONG blocklength;
+    BLCK b;
+
+    start=block;
+
+    while(block<last && block-start<globals->iocache_maxwindow && findiocache(block)==0) {
+      block+=globals->iocache_sizeinblocks;
+    }
+
+    if(block==start) {
+      block+=globals->iocache_sizeinblocks;
+      continue;
+    }
+
+    blocklength=(block>globals->blocks_total ? globals->blocks_total : block) - start;
+
+    _XDEBUG(DEBUG_IO, "prefetchiocaches: Reading %ld blocks at %ld\n", blocklength, start);
+
+    if(transfer(DIO_READ, globals->iocache_rabuffer, start, blocklength)!=0) {
+      return;
+    }
+
+    for(b=start; b<start+blocklength; b+=globals->iocache_sizeinblocks) {
+      ULONG lineblocks=globals->iocache_sizeinblocks;
+
+      if(b+lineblocks>start+blocklength) {
+        lineblocks=start+blocklength-b;
+      }
+
+      if(lruiocache(&ioc)!=0) {
+        return;
+      }
+
+      CopyMemQuick(globals->iocache_rabuffer + ((b-start)<<globals->shifts_block), ioc->data, lineblocks<<globals->shifts_block);
+
+      ioc->block=b;
+      ioc->blocks=lineblocks;
+
+      ioc->valid[0]=0xFFFFFFFF;
+      ioc->valid[1]=0xFFFFFFFF;
+      ioc->valid[2]=0xFFFFFFFF;
+      ioc->valid[3]=0xFFFFFFFF;
+
+      hashit(ioc);
+
+      globals->statistics.cachedio_prefetched++;
+    }
+  }
+}
+
+
+
+static void adaptreadahead(struct ReadAhead *ra, ULONG offset, ULONG bytes) {
+
+  /* A read which starts at the file offset where the previous one ended
+     grows the window, anything else is treated as random access and
+     resets it.  File offsets are used rather than block numbers so
+     that moving on to the next extent of a file is still sequential. */
+
+  if(offset==ra->offset) {
+    if(ra->window==0) {
+      ra->window=globals->iocache_sizeinblocks;
+    }
+    else if(ra->window<globals->iocache_maxwindow) {
+      ra->window<<=1;
+    }
+
+    if(ra->window>globals->iocache_maxwindow) {
+      ra->window=globals->iocache_maxwindow;
+    }
+  }
+  else {
+    ra->window=0;
+  }
+
+  ra->offset=offset+bytes;
+}
+
+
+
+LONG readstream(struct ReadAhead *ra, ULONG offset, BLCK block, UBYTE *buffer, ULONG blocks, BLCK end) {
+  LONG errorcode;
+
+  /* Reads whole blocks of a file.  This works like read(), but also
+     updates the read-ahead state of the file and reads ahead when the
+     file is being read sequentially.  /offset/ is the position in the
+     file of the data being read and /end/ is the first block which
+     doesn't belong to the data anymore (usually the end of the current
+     extent); read-ahead never goes beyond it.
+
+     Large requests still bypass the IOCache and are transferred
+     directly into the supplied buffer. */
+
+  adaptreadahead(ra, offset, blocks<<globals->shifts_block);
+
+  if((errorcode=read(block, buffer, blocks))==0) {
+    if(ra->window!=0 && globals->iocache_lines!=0 && blocks<=globals->iocache_sizeinblocks>>1) {
+      prefetchiocaches(block+blocks, end, ra->window);
+    }
+  }
+
+  return(errorcode);
+}
+
+
+
+LONG readbytesstream(struct ReadAhead *ra, ULONG offset, BLCK block, UBYTE *buffer, UWORD offsetinblock, UWORD bytes, BLCK end) {
+  LONG errorcode;
+
+  /* Like readbytes(), but keeps track of the read-ahead state of the
+     file like readstream() does. */
+
+  adaptreadahead(ra, offset, bytes);
+
+  if((errorcode=readbytes(block, buffer, offsetinblock, bytes))==0) {
+    if(ra->window!=0) {
+      prefetchiocaches(block+1, end, ra->window);
+    }
+  }
+
+  return(errorcode);
+}
+
+
+
 void writethroughoverlappingiocaches(BLCK block, ULONG blocks, UBYTE *buffer) {
   struct IOCache *ioc;
   BLCK firstblock;
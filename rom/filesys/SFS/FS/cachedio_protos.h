@@ -5,12 +5,22 @@
 #include <dos/filehandler.h>
 #include "blockstructure.h"
 
+/* Per file read-ahead state, see readstream() */
+
+struct ReadAhead {
+  ULONG offset;    /* File offset in bytes at which the next sequential read starts */
+  ULONG window;    /* Current read-ahead window in blocks, 0 means random access */
+};
+
 LONG read(BLCK block, UBYTE *buffer, ULONG blocks);
 LONG write(BLCK block, UBYTE *buffer, ULONG blocks);
 
 LONG readbytes(BLCK block, UBYTE *buffer, UWORD offsetinblock, UWORD bytes);
 LONG writebytes(BLCK block, UBYTE *buffer, UWORD offsetinblock, UWORD bytes);
 
+LONG readstream(struct ReadAhead *ra, ULONG offset, BLCK block, UBYTE *buffer, ULONG blocks, BLCK end);
+LONG readbytesstream(struct ReadAhead *ra, ULONG offset, BLCK block, UBYTE *buffer, UWORD offsetinblock, UWORD bytes, BLCK end);
+
 LONG initcachedio(UBYTE *devicename, IPTR unit, ULONG flags, struct DosEnvec *de);
 void cleanupcachedio(void);
 
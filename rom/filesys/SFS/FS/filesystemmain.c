@@ -447,6 +447,8 @@ DD(bug("[SFS] Filesystem main\n"));
 
                 CloseLibrary((struct Library *)IntuitionBase);
             }
+
+            cleanupcachebuffers();
         }
 
         DD(bug("[SFS] Returning startup packet with DOSFALSE\n"));
@@ -837,6 +839,15 @@ void mainloop(void) {
                         case ASQ_EMPTY_OPERATIONS_DECODED:
                             tag->ti_Data = globals->statistics.cache_emptyoperationdecode;
                             break;
+                        case ASQ_IOCACHE_HITS:
+                            tag->ti_Data = globals->statistics.cachedio_hits;
+                            break;
+                        case ASQ_IOCACHE_MISSES:
+                            tag->ti_Data = globals->statistics.cachedio_misses;
+                            break;
+                        case ASQ_IOCACHE_PREFETCHED:
+                            tag->ti_Data = globals->statistics.cachedio_prefetched;
+                            break;
                         case ASQ_IS_CASESENSITIVE:
                             tag->ti_Data = globals->is_casesensitive;
                             break;
@@ -2020,7 +2031,7 @@ void mainloop(void) {
                                                         bytestoread = bytesleft;
                                                     }
 
-                                                    if((errorcode = readbytes(BE2L(ebn->be_key) + (lock->extentoffset >> globals->shifts_block), buffer, offsetinblock, bytestoread)) != 0) {
+                                                    if((errorcode = readbytesstream(&lock->readahead, lock->offset, BE2L(ebn->be_key) + (lock->extentoffset >> globals->shifts_block), buffer, offsetinblock, bytestoread, BE2L(ebn->be_key) + ebn_blocks)) != 0) {
                                                         break;
                                                     }
                                                 } else {
@@ -2032,7 +2043,7 @@ void mainloop(void) {
                                                         bytestoread = bytesleft & ~globals->mask_block;
                                                     }
 
-                                                    if((errorcode = read(BE2L(ebn->be_key) + (lock->extentoffset >> globals->shifts_block), buffer, bytestoread >> globals->shifts_block)) != 0) {
+                                                    if((errorcode = readstream(&lock->readahead, lock->offset, BE2L(ebn->be_key) + (lock->extentoffset >> globals->shifts_block), buffer, bytestoread >> globals->shifts_block, BE2L(ebn->be_key) + ebn_blocks)) != 0) {
                                                         break;
                                                     }
                                                 }
@@ -86,6 +86,7 @@ struct fsStatistics {
 
   ULONG cachedio_hits;
   ULONG cachedio_misses;
+  ULONG cachedio_prefetched;
 };
 
 #endif // _FS_H
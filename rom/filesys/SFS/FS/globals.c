@@ -42,10 +42,15 @@ void initGlobals()
     globals->transactionpool = 0;
     globals->compressbuffer = 0;
     globals->transactionnestcount = 0;
+    globals->cbhashoriginal = NULL;
+    globals->cbhashlatest = NULL;
+    globals->cbhashmask = 0;
     globals->iocache_lruhead = NULL;
     globals->iocache_lines = 8;
     globals->iocache_copyback = TRUE;
     globals->iocache_readonwrite = FALSE;
+    globals->iocache_rabuffer = NULL;
+    globals->iocache_maxwindow = 0;
     globals->templockedobjectnode = 0;
     globals->internalrename = FALSE;
     globals->defrag_maxfilestoscan = 512;
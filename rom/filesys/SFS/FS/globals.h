@@ -165,9 +165,11 @@ struct SFSBase
     #define MINSAFETYBLOCKS (16)
     #define MINCACHESIZE    (MINSAFETYBLOCKS*2)
     #define HASHSHIFT       (7)
-    #define HASHSIZE        (1<<HASHSHIFT)
+    #define HASHSIZE        (1<<HASHSHIFT)    /* Minimum number of chains of the CacheBuffer indexes */
 
-    struct MinList cbhashlist[HASHSIZE];
+    struct MinList *cbhashoriginal;   /* CB_ORIGINAL CacheBuffers, hashed on block number */
+    struct MinList *cbhashlatest;     /* CB_LATEST CacheBuffers, hashed on block number */
+    ULONG cbhashmask;                 /* Number of chains in each index minus one */
     struct MinList cblrulist;
 
     void *transactionpool;
@@ -191,6 +193,8 @@ struct SFSBase
     BYTE iocache_copyback;
     // BYTE iocache_readonwrite=TRUE;       /* Determines whether a new line is read before writing to it. */
     BYTE iocache_readonwrite;       /* Determines whether a new line is read before writing to it. */
+    UBYTE *iocache_rabuffer;        /* Used for reading several lines at once during read-ahead. */
+    ULONG iocache_maxwindow;        /* Largest read-ahead window in blocks, 0 disables read-ahead. */
 
     struct EClockVal ecv;
     
@@ -4,6 +4,7 @@
 #include <dos/dos.h>
 #include <exec/types.h>
 #include "nodes.h"
+#include "cachedio_protos.h"
 
 struct ExtFileLock
 {
@@ -51,6 +52,7 @@ struct ExtFileLock
 
                           EFL_FILE     : When set, indicates that the lock refers to a file. */
 
+  struct ReadAhead readahead;  /* Access pattern of ACTION_READ on this lock */
 };
 
 #define EFL_MODIFIED  (1)
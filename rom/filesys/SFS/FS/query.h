@@ -38,6 +38,10 @@
 #define ASQ_CACHE_MISSES            (ASQBASE+3011)
 #define ASQ_OPERATIONS_DECODED      (ASQBASE+3012)
 #define ASQ_EMPTY_OPERATIONS_DECODED (ASQBASE+3013)
+#define ASQ_IOCACHE_HITS            (ASQBASE+3014)
+#define ASQ_IOCACHE_MISSES          (ASQBASE+3015)
+#define ASQ_IOCACHE_PREFETCHED      (ASQBASE+3016)  /* Number of read-ahead cache lines which were
+                                                        read before they were requested. */
 
 /* Special properties */
 
@@ -439,7 +439,7 @@ static void combineoperations(void) {
             }
 
             if((cb=findoriginalcachebuffer(onew->oi.blckno))!=0) {
-              cb->bits|=CB_LATEST;
+              setcachebufferbits(cb, cb->bits|CB_LATEST);
             }
 
             removeoperation(onew);
@@ -695,7 +695,7 @@ void deletetransaction(void) {
              no operations for this cachebuffer anymore. */
 
           if(isthereanoperationfor(cb->blckno)==FALSE) {
-            cb->bits|=CB_LATEST;
+            setcachebufferbits(cb, cb->bits|CB_LATEST);
           }
         }
       }
@@ -783,8 +783,7 @@ LONG writeoperations(void) {
     }
 
     emptyoriginalcachebuffer(cb->blckno);
-    cb->bits&=~CB_EMPTY;
-    cb->bits|=CB_ORIGINAL|CB_LATEST;
+    setcachebufferbits(cb, (cb->bits & ~CB_EMPTY) | CB_ORIGINAL|CB_LATEST);
 
     oprev=o;
     o=NextNode(o);
@@ -1044,7 +1043,7 @@ void restorecachebuffer(struct CacheBuffer *cb) {
     CopyMemQuick(cb_org->data, cb->data, globals->bytes_block);
     resetcachebuffer(cb_org);
 
-    cb->bits|=CB_ORIGINAL|CB_LATEST;
+    setcachebufferbits(cb, cb->bits|CB_ORIGINAL|CB_LATEST);
   }
 }
 
@@ -1070,8 +1069,7 @@ void restorecachebuffer(struct CacheBuffer *cb) {
     }
     uncompress(cb->data,o->oi.data,o->oi.length);
 
-    cb->bits&=~(CB_ORIGINAL);
-    cb->bits|=CB_LATEST;
+    setcachebufferbits(cb, (cb->bits & ~CB_ORIGINAL) | CB_LATEST);
   }
   else if((cb->bits & CB_EMPTY)!=0) {
     clearcachebuffer(cb);
@@ -1086,8 +1084,7 @@ void restorecachebuffer(struct CacheBuffer *cb) {
     CopyMemQuick(cb_org->data,cb->data,bytes_block);
     emptycachebuffer(cb_org);
 
-    cb->bits&=~(CB_LATEST);
-    cb->bits|=CB_ORIGINAL;
+    setcachebufferbits(cb, (cb->bits & ~CB_LATEST) | CB_ORIGINAL);
   }
 }
 #endif
@@ -64,13 +64,17 @@ LONG main() {
 
                 {ASQ_IS_CASESENSITIVE     , 0},
                 {ASQ_HAS_RECYCLED         , 0},
+
+                {ASQ_IOCACHE_HITS         , 0},
+                {ASQ_IOCACHE_MISSES       , 0},
+                {ASQ_IOCACHE_PREFETCHED   , 0},
                 {TAG_END                  , 0}
 	    };
 
 
           printf("SFSquery information for %s:\n", arglist.name);
           if((errorcode=DoPkt(msgport, ACTION_SFS_QUERY, (SIPTR)&tags, 0, 0, 0, 0))!=DOSFALSE) {
-            ULONG perc;
+            ULONG perc, ioperc;
 
             if(tags[0].ti_Data!=0) {
               perc=tags[1].ti_Data*100 / tags[0].ti_Data;
@@ -79,6 +83,13 @@ LONG main() {
               perc=0;
             }
 
+            if(tags[20].ti_Data+tags[21].ti_Data!=0) {
+              ioperc=tags[21].ti_Data*100 / (tags[20].ti_Data+tags[21].ti_Data);
+            }
+            else {
+              ioperc=0;
+            }
+
             printf("Start/end-offset : 0x%08lx:%08lx - 0x%08lx:%08lx bytes\n", tags[2].ti_Data, tags[3].ti_Data, tags[4].ti_Data, tags[5].ti_Data);
             printf("Device API       : ");
 
@@ -108,6 +119,9 @@ LONG main() {
               printf("(Write-through)\n");
             }
 
+            printf("IOCache hits     : %-8ld   Misses       : %ld (%ld%%)\n", tags[20].ti_Data, tags[21].ti_Data, (long)ioperc);
+            printf("Prefetched lines : %ld\n", tags[22].ti_Data);
+
             printf("DOS buffers      : %-8ld\n", tags[17].ti_Data);
 
             printf("SFS settings     : ");
@@ -186,7 +186,7 @@ ULONG i, blocks, maxinbitmap;
 			maxinbitmap = blocks;
 		volume->bitmapblockpointers[i] = bitmapblock->blocknum;
 		writeBlock(afsbase, volume, bitmapblock, -1);
-		bitmapblock->blocknum += 1;
+		moveCacheBlock(afsbase, volume, bitmapblock, bitmapblock->blocknum+1);
 		blocks = blocks - maxinbitmap;
 		if (blocks == 0)
 		{
@@ -202,7 +202,7 @@ ULONG i, blocks, maxinbitmap;
 		do
 		{
 			/* initialize extensionblock with zeros */
-			extensionblock->blocknum = bitmapblock->blocknum;
+			moveCacheBlock(afsbase, volume, extensionblock, bitmapblock->blocknum);
 			for (i=0;i<volume->SizeBlock;i++)
 				extensionblock->buffer[i] = 0;
 			/* fill extensionblock and write bitmapblocks */
@@ -210,7 +210,7 @@ ULONG i, blocks, maxinbitmap;
 			{
 				if (maxinbitmap > blocks)
 					maxinbitmap = blocks;
-				bitmapblock->blocknum += 1;
+				moveCacheBlock(afsbase, volume, bitmapblock, bitmapblock->blocknum+1);
 				extensionblock->buffer[i] = OS_LONG2BE(bitmapblock->blocknum);
 				writeBlock(afsbase, volume, bitmapblock, -1);
 				blocks = blocks-maxinbitmap;
@@ -223,7 +223,7 @@ ULONG i, blocks, maxinbitmap;
 				extensionblock->buffer[volume->SizeBlock-1]=OS_LONG2BE(bitmapblock->blocknum+1);
 			}
 			writeBlock(afsbase, volume, extensionblock, -1);
-			bitmapblock->blocknum += 1;
+			moveCacheBlock(afsbase, volume, bitmapblock, bitmapblock->blocknum+1);
 		} while (blocks != 0);
 	}
 	else
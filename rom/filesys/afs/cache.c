@@ -16,6 +16,9 @@
  Input : volume  - the volume to initializes cache for
          numBuffers - number of buffers for cache
  Output: first buffer (main cache pointer)
+ Note  : the buffers, the hash table, the flush list and
+         the read-ahead buffer are a single allocation, so
+         freeCache() only needs the first buffer.
 *********************************************************/
 struct BlockCache *initCache
 	(
@@ -26,27 +29,51 @@ struct BlockCache *initCache
 {
 struct BlockCache *head;
 struct BlockCache *cache;
+ULONG hashsize;
+ULONG size;
 ULONG i;
 
-	head = AllocVec
-		(
-			numBuffers*(sizeof(struct BlockCache)+BLOCK_SIZE(volume)),
-			MEMF_PUBLIC | MEMF_CLEAR
-		);
+	/* one hash chain per buffer on average, rounded up to a power of two */
+	for (hashsize = 16; hashsize < numBuffers; hashsize <<= 1);
+
+	size =
+		numBuffers*(sizeof(struct BlockCache)+BLOCK_SIZE(volume))
+		+ AFS_READAHEAD*BLOCK_SIZE(volume)
+		+ (hashsize+numBuffers)*sizeof(struct BlockCache *);
+	head = AllocVec(size, MEMF_PUBLIC | MEMF_CLEAR);
 	if (head != NULL)
 	{
 		cache = head;
-		for (i=0; i<(numBuffers-1); i++)
+		for (i=0; i<numBuffers; i++)
 		{
 			cache->buffer = (ULONG *)((char *)cache+sizeof(struct BlockCache));
 			cache->next =
 				(struct BlockCache *)((char *)cache->buffer+BLOCK_SIZE(volume));
-			cache = cache->next;
+
+			/* initial LRU order is the allocation order */
+			cache->lruprev = (i == 0) ? NULL : (struct BlockCache *)
+				((char *)cache-(sizeof(struct BlockCache)+BLOCK_SIZE(volume)));
+			cache->lrunext = (i == numBuffers-1) ? NULL : cache->next;
+			if (i == numBuffers-1)
+			{
+				volume->rabuffer = (ULONG *)cache->next;
+				cache->next = NULL;
+			}
+			else
+				cache = cache->next;
 		}
-		cache->buffer = (ULONG *)((char *)cache+sizeof(struct BlockCache));
-		cache->next = NULL;
+		volume->lruhead = head;
+		volume->lrutail = cache;
+		volume->blockhash = (struct BlockCache **)
+			((char *)volume->rabuffer+AFS_READAHEAD*BLOCK_SIZE(volume));
+		volume->hashmask = hashsize-1;
+		volume->flushlist = volume->blockhash+hashsize;
+		volume->rastart = 0;
+		volume->racount = 0;
+		volume->lastmiss = 0;
 	}
-	D(bug("[AFS] InitCache: my Mem is 0x%p size 0x%lx\n", head, numBuffers*(sizeof(struct BlockCache)+BLOCK_SIZE(volume))));
+	D(bug("[AFS] InitCache: my Mem is 0x%p size 0x%lx (%lu buffers, %lu hash chains)\n",
+		head, (unsigned long)size, (unsigned long)numBuffers, (unsigned long)hashsize));
 	return head;
 }
 
@@ -54,34 +81,255 @@ void freeCache(struct AFSBase *afsbase, struct BlockCache *cache) {
 	FreeVec(cache);
 }
 
-void clearCache(struct AFSBase *afsbase, struct BlockCache *cache) {
+/********************************************************
+ Hash chain and LRU list helpers. The LRU list runs from
+ the most recently used buffer (lruhead) to the least
+ recently used one (lrutail), which is reused first.
+*********************************************************/
+static void hashInsert(struct Volume *volume, struct BlockCache *cache) {
+struct BlockCache **chain = &volume->blockhash[cache->blocknum & volume->hashmask];
+
+	cache->hashnext = *chain;
+	*chain = cache;
+}
+
+static void hashRemove(struct Volume *volume, struct BlockCache *cache) {
+struct BlockCache **chain = &volume->blockhash[cache->blocknum & volume->hashmask];
+
+	while (*chain != NULL)
+	{
+		if (*chain == cache)
+		{
+			*chain = cache->hashnext;
+			break;
+		}
+		chain = &(*chain)->hashnext;
+	}
+	cache->hashnext = NULL;
+}
+
+static void lruRemove(struct Volume *volume, struct BlockCache *cache) {
+
+	if (cache->lruprev != NULL)
+		cache->lruprev->lrunext = cache->lrunext;
+	else
+		volume->lruhead = cache->lrunext;
+	if (cache->lrunext != NULL)
+		cache->lrunext->lruprev = cache->lruprev;
+	else
+		volume->lrutail = cache->lruprev;
+}
+
+static void lruAddHead(struct Volume *volume, struct BlockCache *cache) {
+
+	cache->lruprev = NULL;
+	cache->lrunext = volume->lruhead;
+	if (volume->lruhead != NULL)
+		volume->lruhead->lruprev = cache;
+	else
+		volume->lrutail = cache;
+	volume->lruhead = cache;
+}
+
+static void lruAddTail(struct Volume *volume, struct BlockCache *cache) {
 
-	while (cache != NULL)
+	cache->lrunext = NULL;
+	cache->lruprev = volume->lrutail;
+	if (volume->lrutail != NULL)
+		volume->lrutail->lrunext = cache;
+	else
+		volume->lruhead = cache;
+	volume->lrutail = cache;
+}
+
+/********************************************************
+ Name  : moveCacheBlock
+ Descr.: change the block a cache buffer holds
+ Input : volume   - the volume the block is on
+         block    - the cache buffer
+         blocknum - new block number (zero: empty buffer)
+*********************************************************/
+void moveCacheBlock
+	(
+		struct AFSBase *afsbase,
+		struct Volume *volume,
+		struct BlockCache *block,
+		ULONG blocknum
+	)
+{
+	if (block->blocknum != 0)
+		hashRemove(volume, block);
+	block->blocknum = blocknum;
+	if (blocknum != 0)
+		hashInsert(volume, block);
+}
+
+/********************************************************
+ Name  : demoteCacheBlock
+ Descr.: make a buffer the first candidate for reuse
+ Input : volume - the volume the block is on
+         block  - the cache buffer
+*********************************************************/
+void demoteCacheBlock
+	(struct AFSBase *afsbase, struct Volume *volume, struct BlockCache *block)
+{
+	lruRemove(volume, block);
+	lruAddTail(volume, block);
+}
+
+void clearCache(struct AFSBase *afsbase, struct Volume *volume) {
+struct BlockCache *cache;
+
+	for (cache = volume->blockcache; cache != NULL; cache = cache->next)
 	{
 		if ((cache->flags & BCF_WRITE) == 0)
 		{
-			cache->blocknum = 0;
-			cache->newness = 0;
+			moveCacheBlock(afsbase, volume, cache, 0);
+			demoteCacheBlock(afsbase, volume, cache);
 			cache->flags = 0;
 		}
 		else
 			showText(afsbase, "You MUST re-insert ejected volume");
-		cache = cache->next;
 	}
+	volume->racount = 0;
+	volume->lastmiss = 0;
 }
 
+/* write blocks and drop read-ahead data they make stale */
+static LONG writeCacheDisk
+	(
+		struct AFSBase *afsbase,
+		struct Volume *volume,
+		ULONG start,
+		ULONG count,
+		APTR data
+	)
+{
+	if
+		(
+			(volume->racount != 0) &&
+			(start < volume->rastart+volume->racount) &&
+			(start+count > volume->rastart)
+		)
+	{
+		volume->racount = 0;
+	}
+	return writeDisk(afsbase, volume, start, count, data);
+}
+
+/* read a missing block, from or into the read-ahead buffer if sequential */
+static LONG readCacheBlock
+	(
+		struct AFSBase *afsbase,
+		struct Volume *volume,
+		ULONG blocknum,
+		ULONG *buffer
+	)
+{
+ULONG count;
+BOOL sequential;
+
+	sequential = (blocknum == volume->lastmiss+1);
+	volume->lastmiss = blocknum;
+
+	if ((volume->racount == 0) || (blocknum-volume->rastart >= volume->racount))
+	{
+		if (!sequential)
+			return readDisk(afsbase, volume, blocknum, 1, buffer);
+
+		count = AFS_READAHEAD;
+		if (blocknum >= volume->countblocks)
+			count = 0;
+		else if (blocknum+count > volume->countblocks)
+			count = volume->countblocks-blocknum;
+		volume->racount = 0;
+		if (count < 2)
+			return readDisk(afsbase, volume, blocknum, 1, buffer);
+		if (readDisk(afsbase, volume, blocknum, count, volume->rabuffer) != 0)
+			return readDisk(afsbase, volume, blocknum, 1, buffer);
+		volume->rastart = blocknum;
+		volume->racount = count;
+	}
+
+	CopyMem
+		(
+			(char *)volume->rabuffer+(blocknum-volume->rastart)*BLOCK_SIZE(volume),
+			buffer,
+			BLOCK_SIZE(volume)
+		);
+	return 0;
+}
+
+/* sort dirty buffers by block number (Shell sort, no recursion) */
+static void sortBlocks(struct BlockCache **list, ULONG count) {
+struct BlockCache *block;
+ULONG gap, i, j;
+
+	for (gap = 1; gap < count/3; gap = gap*3+1);
+	for (; gap > 0; gap /= 3)
+	{
+		for (i = gap; i < count; i++)
+		{
+			block = list[i];
+			for (j = i; (j >= gap) && (list[j-gap]->blocknum > block->blocknum); j -= gap)
+				list[j] = list[j-gap];
+			list[j] = block;
+		}
+	}
+}
+
+/********************************************************
+ Name  : flushCache
+ Descr.: write all dirty, unused buffers to disk. Runs of
+         consecutive blocks are written with a single
+         request through the read-ahead buffer.
+ Input : volume - the volume to flush
+*********************************************************/
 VOID flushCache
 	(struct AFSBase *afsbase, struct Volume *volume)
 {
 struct BlockCache *block;
+struct BlockCache **list = volume->flushlist;
+ULONG count = 0;
+ULONG i, j, k;
 
 	for (block = volume->blockcache; block != NULL; block = block->next)
 	{
 		if ((block->flags & (BCF_WRITE | BCF_USED)) == BCF_WRITE)
+			list[count++] = block;
+	}
+	sortBlocks(list, count);
+
+	for (i = 0; i < count; i = j)
+	{
+		for
+			(
+				j = i+1;
+				(j < count) && (j-i < AFS_READAHEAD) &&
+				(list[j]->blocknum == list[j-1]->blocknum+1);
+				j++
+			);
+
+		if (j-i == 1)
 		{
-			writeDisk(afsbase, volume, block->blocknum, 1, block->buffer);
-			block->flags &= ~BCF_WRITE;
+			writeCacheDisk(afsbase, volume, list[i]->blocknum, 1, list[i]->buffer);
+		}
+		else
+		{
+			volume->racount = 0;
+			for (k = i; k < j; k++)
+			{
+				CopyMem
+					(
+						list[k]->buffer,
+						(char *)volume->rabuffer+(k-i)*BLOCK_SIZE(volume),
+						BLOCK_SIZE(volume)
+					);
+			}
+			writeCacheDisk(afsbase, volume, list[i]->blocknum, j-i, volume->rabuffer);
 		}
+		for (k = i; k < j; k++)
+			list[k]->flags &= ~BCF_WRITE;
 	}
 }
 
@@ -89,78 +337,56 @@ struct BlockCache *getCacheBlock
 	(struct AFSBase *afsbase, struct Volume *volume, ULONG blocknum)
 {
 struct BlockCache *cache;
-struct BlockCache *bestcache=NULL;
-BOOL found = FALSE;
 
 	/* Check if block is already cached, or else reuse least-recently-used buffer */
 	//D(bug("[AFS] GetCacheBlock: getting cacheblock %lu\n",blocknum));
-	cache = volume->blockcache;
-	while ((cache != NULL) && !found)
+	if (blocknum != 0)
 	{
-		if (cache->blocknum == blocknum)
+		for
+			(
+				cache = volume->blockhash[blocknum & volume->hashmask];
+				cache != NULL;
+				cache = cache->hashnext
+			)
 		{
-			if (!(cache->flags & BCF_USED))
+			if (cache->blocknum == blocknum)
 			{
-				//D(bug("[AFS] GetCacheBlock: already cached (counter=%lu)\n", cache->newness));
-				bestcache = cache;
-				found = TRUE;
-			}
-			else
-			{
-				if (blocknum != volume->rootblock)
+				/*	a used block other than the root block should only
+					be asked for again while using setBitmap()
+					->that's ok (see setBitmap()), use another buffer */
+				if (!(cache->flags & BCF_USED) || (blocknum == volume->rootblock))
 				{
-					/*	should only occur while using setBitmap()
-						->that's ok (see setBitmap()) */
-					//D(bug("[AFS] Concurrent access on block %lu!\n",blocknum));
-				}
-				else
-				{
-					bestcache = cache;
-					found = TRUE;
+					lruRemove(volume, cache);
+					lruAddHead(volume, cache);
+					return cache;
 				}
 			}
 		}
-		else if ((cache->flags & (BCF_USED | BCF_WRITE)) == 0)
-		{
-			if (bestcache != NULL)
-			{
-				if (bestcache->newness > cache->newness)
-					bestcache = cache;
-			}
-			else
-			{
-				bestcache = cache;
-			}
-		}
-		cache = cache->next;
 	}
 
-	if (bestcache != NULL)
+	for (cache = volume->lrutail; cache != NULL; cache = cache->lruprev)
 	{
-		if (!found)
-			bestcache->blocknum = 0;
-
-		/* Mark buffer as the most recently used */
-		bestcache->newness = ++volume->cachecounter;
-
-		/* Reset cache history if counter has overflowed */
-		if (volume->cachecounter == 0)
+		if ((cache->flags & (BCF_USED | BCF_WRITE)) == 0)
 		{
-			for (cache = volume->blockcache; cache != NULL; cache = cache->next)
-				cache->newness = 0;
+			moveCacheBlock(afsbase, volume, cache, 0);
+
+			/* Mark buffer as the most recently used */
+			lruRemove(volume, cache);
+			lruAddHead(volume, cache);
+			return cache;
 		}
 	}
-	else
+
+	/* We should only run out of cache blocks if blocks need to be
+	   written, so write them and try again */
+	flushCache(afsbase, volume);
+	for (cache = volume->lrutail; cache != NULL; cache = cache->lruprev)
 	{
-		/* We should only run out of cache blocks if blocks need to be
-		   written, so write them and try again */
-		flushCache(afsbase, volume);
-		bestcache = getCacheBlock(afsbase, volume, blocknum);
-		if (bestcache == NULL)
-			showText(afsbase, "Oh, ohhhhh, where is all the cache gone? BUG!!!");
+		if ((cache->flags & (BCF_USED | BCF_WRITE)) == 0)
+			return getCacheBlock(afsbase, volume, blocknum);
 	}
-
-	return bestcache;
+	showText(afsbase, "Oh, ohhhhh, where is all the cache gone? BUG!!!");
+	return NULL;
 }
 
 /***************************************************************************
@@ -179,8 +405,9 @@ struct BlockCache *getFreeCacheBlock
 struct BlockCache *cache;
 
 	cache = getCacheBlock(afsbase, volume, blocknum);
-	cache->blocknum = blocknum;
-	cache->newness = 0;
+	if (cache->blocknum != blocknum)
+		moveCacheBlock(afsbase, volume, cache, blocknum);
+	demoteCacheBlock(afsbase, volume, cache);
 	return cache;
 }
 
@@ -221,11 +448,12 @@ struct BlockCache *blockbuffer;
 	{
 		if (blockbuffer->blocknum == 0)
 		{
-			blockbuffer->blocknum = blocknum;
-			if (readDisk(afsbase, volume, blocknum, 1, blockbuffer->buffer) != 0)
+			if (readCacheBlock(afsbase, volume, blocknum, blockbuffer->buffer) != 0)
 			{
 				blockbuffer = NULL;
 			}
+			else
+				moveCacheBlock(afsbase, volume, blockbuffer, blocknum);
 		}
 	}
 	//D(bug("[AFS] GetBlock: using cache block with address 0x%p\n", blockbuffer));
@@ -253,7 +481,7 @@ LONG writeBlock
 		flushCache(afsbase, volume);
 
 	/* Write block to disk */
-	writeDisk(afsbase, volume, blockbuffer->blocknum, 1, blockbuffer->buffer);
+	writeCacheDisk(afsbase, volume, blockbuffer->blocknum, 1, blockbuffer->buffer);
 	blockbuffer->flags &= ~BCF_WRITE;
 	return DOSTRUE;
 }
@@ -2,16 +2,21 @@
 #define BLOCKACCESS_H
 
 /*
-    Copyright  1995-2005, The AROS Development Team. All rights reserved.
+    Copyright  1995-2020, The AROS Development Team. All rights reserved.
     $Id$
 */
 
 #include "os.h"
 #include "volumes.h"
 
+/* blocks read ahead on sequential misses, and written at once by flushCache() */
+#define AFS_READAHEAD 16
+
 struct BlockCache {
-	struct BlockCache *next;
-	ULONG newness;
+	struct BlockCache *next;        /* all buffers, in allocation order */
+	struct BlockCache *hashnext;    /* next buffer in the same hash chain */
+	struct BlockCache *lrunext;     /* less recently used buffer */
+	struct BlockCache *lruprev;     /* more recently used buffer */
 	ULONG blocknum;         /* zero means block is empty */
 	ULONG *buffer;
 	ULONG flags;
@@ -26,7 +31,9 @@ struct BlockCache *getFreeCacheBlock(struct AFSBase *, struct Volume *, ULONG);
 struct BlockCache *getBlock(struct AFSBase *, struct Volume *, ULONG);
 LONG writeBlock(struct AFSBase *, struct Volume *, struct BlockCache *, LONG);
 VOID writeBlockDeferred(struct AFSBase *, struct Volume *, struct BlockCache *, LONG);
-void clearCache(struct AFSBase *, struct BlockCache *);
+void moveCacheBlock(struct AFSBase *, struct Volume *, struct BlockCache *, ULONG);
+void demoteCacheBlock(struct AFSBase *, struct Volume *, struct BlockCache *);
+void clearCache(struct AFSBase *, struct Volume *);
 VOID flushCache(struct AFSBase *, struct Volume *);
 void checkCache(struct AFSBase *, struct Volume *);
 
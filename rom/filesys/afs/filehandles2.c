@@ -703,7 +703,7 @@ ULONG i;
 	{
 		markBlock(afsbase, volume, newblock->blocknum, -1);
 		newblock->flags &= ~BCF_USED;
-		newblock->newness = 0;
+		demoteCacheBlock(afsbase, volume, newblock);
 		validBitmap(afsbase, volume);
 		return NULL;
 	}
@@ -162,6 +162,39 @@ STRPTR string;
 }
 
 
+/*
+	Checks the name of an entry against eac_MatchString, if there is one.
+*/
+static BOOL matchEntryName
+	(
+		struct AFSBase *afsbase,
+		struct Volume *volume,
+		struct ExAllControl *eac,
+		struct BlockCache *entryblock
+	)
+{
+#ifdef __AROS__
+UBYTE cstr[MAXFILENAMELENGTH];
+STRPTR string;
+
+	if (eac->eac_MatchString == NULL)
+		return TRUE;
+	string = (char *)entryblock->buffer+(BLK_FILENAME_START(volume)*4);
+	CopyMem(string+1, cstr, string[0]);
+	cstr[(ULONG)string[0]] = 0;
+	return MatchPatternNoCase(eac->eac_MatchString, cstr);
+#else
+	return TRUE;
+#endif
+}
+
+/*
+	Fills ead with as many entries of the directory ah as fit into size.
+	eac_LastKey holds the header block of the last entry returned (zero
+	starts a new scan), which is the same key examineNext() keeps in
+	fib_DiskKey, so entries in hash chains are neither skipped nor returned
+	twice. An entry which doesn't fit any more is left for the next call.
+*/
 ULONG examineAll
 	(
 		struct AFSBase *afsbase,
@@ -172,82 +205,59 @@ ULONG examineAll
 		ULONG mode
 	)
 {
-struct BlockCache *headerblock;
 struct BlockCache *entryblock;
-struct ExAllData *last;
-ULONG error,i,block;
+struct ExAllData *last = NULL;
+STRPTR end = (STRPTR)ead+size;
+ULONG error,key,pos;
 
 	D(bug("[AFS] examineAll(%ld,ead,%ld,%ld)\n",ah->header_block,size,mode));
 	eac->eac_Entries = 0;
 	if (mode > ED_OWNER)
 		return ERROR_BAD_NUMBER;
-	headerblock = getBlock(afsbase, ah->volume, ah->header_block);
-	if (headerblock == NULL)
+	entryblock = getBlock(afsbase, ah->volume, ah->header_block);
+	if (entryblock == NULL)
 		return ERROR_UNKNOWN;
 	/* is it a file? */
-	if ((LONG)(OS_BE2LONG(headerblock->buffer[BLK_SECONDARY_TYPE(ah->volume)])) < 0)
-	{
-		error = examineEAD(afsbase, ah->volume, ead, headerblock, size, mode);
-		if (error == 0)
-			eac->eac_Entries = 1;
-		return error;
-	}
-	error = getNextExamineBlock(afsbase, ah, &ah->dirpos, &i);
-        /* FIXME: if ah->dirpos is an entry stored in a hashchain we return entries twice */
-	if (error != 0)
-		return error;
-	last = ead;
-	/*
-		the contents of headerblock may have changed
-		by getNextExamineBlock
-	*/
-	if (headerblock->blocknum != ah->header_block)
-	{
-		headerblock = getBlock(afsbase, ah->volume, ah->header_block);
-		if (headerblock == NULL)
-			return ERROR_UNKNOWN;
-	}
-	headerblock->flags |= BCF_USED;
-	for (; i<=BLK_TABLE_END(ah->volume); i++)
+	if ((LONG)(OS_BE2LONG(entryblock->buffer[BLK_SECONDARY_TYPE(ah->volume)])) < 0)
+		return ERROR_OBJECT_WRONG_TYPE;
+	key = (eac->eac_LastKey != 0) ? eac->eac_LastKey : ah->header_block;
+	while ((error = getNextExamineBlock(afsbase, ah, &key, &pos)) == 0)
 	{
-		if (headerblock->buffer[i] != 0)
+		entryblock = getBlock(afsbase, ah->volume, key);
+		if (entryblock == NULL)
 		{
-			block = OS_BE2LONG(headerblock->buffer[i]);
-			do
-			{
-				entryblock = getBlock(afsbase, ah->volume, block);
-				if (entryblock == NULL)
-				{
-					headerblock->flags &= ~BCF_USED;
-					return ERROR_UNKNOWN;
-				}
-				error = examineEAD(afsbase, ah->volume, ead, entryblock, size, mode);
-				if (error != 0)
-				{
-				    /* stegerg: CHECK CHECK CHECK CHECK CHECK */
-					if (error == ERROR_BUFFER_OVERFLOW)
-					{
-						ah->dirpos = OS_BE2LONG(headerblock->buffer[i]);
-						error = 0;
-					}
-				   /* stegerg: END CHECK CHECK CHECK CHECK CHECK */
-
-					ead->ed_Next = NULL;
-					headerblock->flags &= ~BCF_USED;
-					return error;
-				}
-				size -= (ULONG)((char *)ead->ed_Next-(char *)ead);
-				last = ead;
-				ead = ead->ed_Next;
-				ah->dirpos = OS_BE2LONG(headerblock->buffer[i]);
-				block = OS_BE2LONG(entryblock->buffer[BLK_HASHCHAIN(ah->volume)]);
-				eac->eac_Entries++;
-			} while (block != 0);
+			error = ERROR_UNKNOWN;
+			break;
+		}
+		if (!matchEntryName(afsbase, ah->volume, eac, entryblock))
+		{
+			eac->eac_LastKey = key;
+			continue;
 		}
+		if ((STRPTR)ead > end)
+			error = ERROR_BUFFER_OVERFLOW;
+		else
+			error = examineEAD(afsbase, ah->volume, ead, entryblock, end-(STRPTR)ead, mode);
+		if (error != 0)
+			break;
+		eac->eac_LastKey = key;
+#ifdef __AROS__
+		if ((eac->eac_MatchFunc != NULL) && !CallHookPkt(eac->eac_MatchFunc, &mode, ead))
+			continue;
+#endif
+		last = ead;
+		ead = ead->ed_Next;
+		eac->eac_Entries++;
+	}
+	if (last != NULL)
+	{
+		last->ed_Next = NULL;
+		/* the buffer is full, but we did return something */
+		if (error == ERROR_BUFFER_OVERFLOW)
+			error = 0;
 	}
-	last->ed_Next = NULL;
-	headerblock->flags &= ~BCF_USED;
-	return ERROR_NO_MORE_ENTRIES;
+	D(bug("[AFS] examineAll: %ld entries, last key %ld\n", eac->eac_Entries, eac->eac_LastKey));
+	return error;
 }
 
 ULONG examineNext
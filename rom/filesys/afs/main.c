@@ -627,6 +627,33 @@ LONG AFS_work(struct ExecBase *SysBase)
 		    ok = DOSTRUE;
 		    break;
 		}
+		case ACTION_EXAMINE_ALL:
+		{
+		    struct FileLock      *fl = BADDR(dp->dp_Arg1);
+		    struct AfsHandle     *ah;
+		    struct ExAllControl  *eac = (struct ExAllControl *)dp->dp_Arg5;
+
+		    if (!mediacheck(volume, &ok, &res2))
+		    	break;
+
+		    if (fl == NULL)
+			ah = &volume->ah;
+		    else
+			ah = (APTR)fl->fl_Key;
+
+		    res2 = examineAll(handler, ah, (struct ExAllData *)dp->dp_Arg2, eac, (ULONG)dp->dp_Arg3, (ULONG)dp->dp_Arg4);
+		    ok = (res2 == 0) ? DOSTRUE : DOSFALSE;
+		    break;
+		}
+		case ACTION_EXAMINE_ALL_END:
+		{
+		    struct ExAllControl  *eac = (struct ExAllControl *)dp->dp_Arg5;
+
+		    /* the scan position is all kept in eac_LastKey */
+		    eac->eac_LastKey = 0;
+		    ok = DOSTRUE;
+		    break;
+		}
 		case ACTION_PARENT:
 		case ACTION_PARENT_FH:
 		{
@@ -478,7 +478,7 @@ BOOL flush(struct AFSBase *afsbase, struct Volume *volume) {
 	flushCache(afsbase, volume);
 	volume->ioh.ioreq->iotd_Req.io_Command = CMD_UPDATE;
 	DoIO((struct IORequest *)&volume->ioh.ioreq->iotd_Req);
-	clearCache(afsbase, volume->blockcache);
+	clearCache(afsbase, volume);
 	return DOSTRUE;
 }
 
@@ -132,7 +132,7 @@ void closeBlockDevice(struct AFSBase *afsbase, struct IOHandle *ioh) {
 
 BOOL flush(struct AFSBase *afsbase, struct Volume *volume) {
         flushCache(afsbase, volume);
-        clearCache(afsbase, volume->blockcache);
+        clearCache(afsbase, volume);
         return DOSFALSE;
 }
 
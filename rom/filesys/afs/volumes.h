@@ -28,7 +28,15 @@ struct Volume {
 	struct IOHandle ioh;
 	struct BlockCache *blockcache;
 	LONG numbuffers;
-	ULONG cachecounter;           /* Keeps track of cache usage */
+	struct BlockCache **blockhash; /* hash chains of cached blocks */
+	ULONG hashmask;              /* nr of hash chains - 1 */
+	struct BlockCache *lruhead;  /* most recently used buffer */
+	struct BlockCache *lrutail;  /* least recently used buffer */
+	struct BlockCache **flushlist; /* scratch space for flushCache() */
+	ULONG *rabuffer;             /* read-ahead/write coalescing buffer */
+	ULONG rastart;               /* first block in rabuffer */
+	ULONG racount;               /* nr of valid blocks in rabuffer */
+	ULONG lastmiss;              /* last block read from disk */
 	ULONG state;                 /* Read-only, read/write or validating */
         ULONG key;                   /* Lock key */
 	ULONG inhibitcounter;
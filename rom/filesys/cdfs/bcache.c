@@ -9,6 +9,11 @@
 /* 'BCache' is a trivial write-through cache for block devices.
  *
  * Supports TD_*, CD_*, TD64_*, and NSCMD_* devices
+ *
+ * Cached blocks are found through a hash table on the block number,
+ * and replaced in least recently used order. A miss reads up to
+ * BCACHE_READAHEAD following blocks as well, through a separate
+ * buffer, since the least recently used entries are not contiguous.
  */
 
 #include <aros/debug.h>
@@ -20,31 +25,12 @@
 
 #include "bcache.h"
 
-/* From Wikipedia - XORShift RNG, by George Marsaglia
- */
-struct XorshiftRNG {
-    ULONG w, x, y, z;
-};
-
-static VOID XorshiftRNG_Init(struct XorshiftRNG *r)
-{
-    r->w = 88675123;
-    r->x = 123456789;
-    r->y = 362436069;
-    r->z = 521288629;
-}
-
-static ULONG XorshiftRNG(struct XorshiftRNG *r)
-{
-    ULONG t;
-    t = r->x ^ (r->x << 11);
-    r->x = r->y; r->y = r->z; r->z = r->w;
-    return r->w = r->w ^ (r->w >> 19) ^ (t ^ (t >> 8));
-}
-
+/* Maximum number of blocks read by a cache miss */
+#define BCACHE_READAHEAD        8
 
 struct BCacheEntry {
-    struct MinNode be_Node;
+    struct MinNode be_Node;     /* On bp_CacheValid or bp_CacheInvalid */
+    struct BCacheEntry *be_HashNext;
     UBYTE         *be_Buffer;   /* Pointer into bp_CacheBlocks */
     ULONG          be_Block;    /* Block address.
                                  * Sufficient for up to:
@@ -64,16 +50,52 @@ struct BCachePrivate {
     ULONG            bp_Blocks;
     ULONG            bp_ReadCMD;
     ULONG            bp_WriteCMD;
-    struct XorshiftRNG bp_RNG;
+    ULONG            bp_MaxTransfer;    /* In blocks */
+    IPTR             bp_Mask;           /* Addressable by the device */
 
     LONG             bp_NumBuffers;
     ULONG            bp_BufMemType;
     UBYTE           *bp_CacheBlocks;    /* Single contiguous buffer area */
     struct BCacheEntry *bp_CacheEntries;
-    struct List      bp_CacheValid;     /* Active blocks */
+    struct BCacheEntry **bp_Hash;
+    ULONG            bp_HashMask;
+    UBYTE           *bp_ReadAhead;      /* Buffer for reading runs */
+    ULONG            bp_ReadAheadBlocks;
+    struct List      bp_CacheValid;     /* Active blocks, most recently used first */
     struct List      bp_CacheInvalid;   /* Inactive entries */
 };
 
+/* Hash table entries for 'numbuffers' buffers (power of 2) */
+static ULONG BCache_HashSize(LONG numbuffers)
+{
+    ULONG size = 16;
+
+    while (size < (ULONG)numbuffers)
+        size <<= 1;
+
+    return size;
+}
+
+static ULONG BCache_ReadAheadSize(LONG numbuffers)
+{
+    if (numbuffers / 2 > BCACHE_READAHEAD)
+        return BCACHE_READAHEAD;
+    else if (numbuffers > 1)
+        return numbuffers / 2;
+    else
+        return 1;
+}
+
+/* Size of the memory allocated for 'numbuffers' buffers: blocks,
+ * read ahead blocks, entries and hash table
+ */
+static ULONG BCache_MemSize(struct BCachePrivate *bp, LONG numbuffers)
+{
+    return bp->bp_Public.bc_BlockSize * (numbuffers + BCache_ReadAheadSize(numbuffers)) +
+           sizeof(bp->bp_CacheEntries[0]) * numbuffers +
+           sizeof(bp->bp_Hash[0]) * BCache_HashSize(numbuffers);
+}
+
 /* Create a buffer cache, based off of a FileSysStartupMsg.
  * Note that:
  *  bc_BlockSize will be fsm_Environ[DE_BLOCKSIZE]*4
@@ -94,7 +116,6 @@ LONG BCache_Create(struct ExecBase *SysBase, struct FileSysStartupMsg *fssm, str
             if ((io = (struct IOStdReq*)CreateIORequest(mp, sizeof(*io)))) {
                 bp->bp_IOStdReq = io;
                 bp->bp_SysBase = SysBase;
-                XorshiftRNG_Init(&bp->bp_RNG);
 
                 D(bug("%s: Device %b.%d\n", __func__, fssm->fssm_Device, fssm->fssm_Unit));
 
@@ -189,6 +210,16 @@ LONG BCache_Create(struct ExecBase *SysBase, struct FileSysStartupMsg *fssm, str
                         bufmemtype = de->de_BufMemType;
                     }
 
+                    if (de->de_TableSize >= DE_MAXTRANSFER && de->de_MaxTransfer >= blocksize)
+                        bp->bp_MaxTransfer = de->de_MaxTransfer / blocksize;
+                    else
+                        bp->bp_MaxTransfer = 0x7fffffff / blocksize;
+
+                    if (de->de_TableSize >= DE_MASK && de->de_Mask)
+                        bp->bp_Mask = de->de_Mask;
+                    else
+                        bp->bp_Mask = ~(IPTR)0;
+
                     if (((lowcyl + cylinders) * blockspertrack) < bp->bp_Blocks) {
                         bp->bp_Public.bc_BlockSize = blocksize;
                         bp->bp_Blocks = cylinders * blockspertrack;
@@ -251,10 +282,9 @@ LONG BCache_Create(struct ExecBase *SysBase, struct FileSysStartupMsg *fssm, str
 VOID BCache_Delete(struct BCache *bcache)
 {
     struct BCachePrivate *bp = (struct BCachePrivate *)bcache;
-    ULONG size = bp->bp_Public.bc_BlockSize * bp->bp_NumBuffers +
-                 sizeof(bp->bp_CacheEntries[0]) *  bp->bp_NumBuffers;
+    ULONG size = BCache_MemSize(bp, bp->bp_NumBuffers);
    
-    CloseDevice((struct IORequest *)&bp->bp_IOStdReq);
+    CloseDevice((struct IORequest *)bp->bp_IOStdReq);
     FreeMem(bp->bp_CacheBlocks, size);
     FreeVec(bp);
 }
@@ -266,8 +296,7 @@ LONG BCache_Extend(struct BCache *bcache, LONG numbuffers)
     struct BCachePrivate *bp = (struct BCachePrivate *)bcache;
     UBYTE *newcache;
     ULONG newsize;
-    ULONG oldsize = bp->bp_Public.bc_BlockSize * bp->bp_NumBuffers +
-                 sizeof(bp->bp_CacheEntries[0]) *  bp->bp_NumBuffers;
+    ULONG oldsize = BCache_MemSize(bp, bp->bp_NumBuffers);
 
     /* Minimum size is 1 buffer */
     if (bp->bp_NumBuffers + numbuffers <= 0)
@@ -279,12 +308,12 @@ LONG BCache_Extend(struct BCache *bcache, LONG numbuffers)
     }
 
     numbuffers += bp->bp_NumBuffers;
-    newsize = bp->bp_Public.bc_BlockSize * numbuffers +
-              sizeof(bp->bp_CacheEntries[0]) * numbuffers;
+    newsize = BCache_MemSize(bp, numbuffers);
 
-    newcache = AllocMem(newsize, bp->bp_BufMemType);
+    newcache = AllocMem(newsize, bp->bp_BufMemType | MEMF_CLEAR);
     if (newcache) {
-        struct BCacheEntry *newentry = (struct BCacheEntry *)&newcache[bp->bp_Public.bc_BlockSize * numbuffers];
+        ULONG readahead = BCache_ReadAheadSize(numbuffers);
+        struct BCacheEntry *newentry = (struct BCacheEntry *)&newcache[bp->bp_Public.bc_BlockSize * (numbuffers + readahead)];
         LONG i, index;
 
         NEWLIST(&bp->bp_CacheValid);
@@ -300,6 +329,10 @@ LONG BCache_Extend(struct BCache *bcache, LONG numbuffers)
         bp->bp_NumBuffers = numbuffers;
         bp->bp_CacheBlocks = newcache;
         bp->bp_CacheEntries = newentry;
+        bp->bp_Hash = (struct BCacheEntry **)&newentry[numbuffers];
+        bp->bp_HashMask = BCache_HashSize(numbuffers) - 1;
+        bp->bp_ReadAhead = &newcache[index];
+        bp->bp_ReadAheadBlocks = readahead;
         D(bug("%s: Cache size now %d entries\n", __func__, numbuffers));
         return RETURN_OK;
     }
@@ -351,10 +384,12 @@ LONG BCache_Invalidate(struct BCache *bcache)
 {
     struct BCachePrivate *bp = (struct BCachePrivate *)bcache;
     struct BCacheEntry *be;
-    int i;
+    ULONG i;
 
     while ((be = (struct BCacheEntry *)REMHEAD(&bp->bp_CacheValid)))
         ADDHEAD(&bp->bp_CacheInvalid, be);
+    for (i = 0; i <= bp->bp_HashMask; i++)
+        bp->bp_Hash[i] = NULL;
 
     if (BCache_Present(bcache) == ERROR_NO_DISK)
         return ERROR_NO_DISK;
@@ -362,13 +397,49 @@ LONG BCache_Invalidate(struct BCache *bcache)
     /* We have a disk - mark it as 'present' for this cache */
     bp->bp_ChangeNum = bp->bp_ChangeIdx;
 
-    /* Stir the RNG */
-    for (i = 0; i < (bp->bp_ChangeNum & 0xf); i++)
-        XorshiftRNG_Init(&bp->bp_RNG);
-
     return RETURN_OK;
 }
 
+static struct BCacheEntry *BCache_Lookup(struct BCachePrivate *bp, ULONG block)
+{
+    struct BCacheEntry *be;
+
+    for (be = bp->bp_Hash[block & bp->bp_HashMask]; be; be = be->be_HashNext) {
+        if (be->be_Block == block)
+            break;
+    }
+
+    return be;
+}
+
+/* Get an entry for a new block - an unused one, or else
+ * the least recently used one
+ */
+static struct BCacheEntry *BCache_GetEntry(struct BCachePrivate *bp)
+{
+    struct BCacheEntry *be, **bep;
+
+    if ((be = (struct BCacheEntry *)REMHEAD(&bp->bp_CacheInvalid)))
+        return be;
+
+    be = (struct BCacheEntry *)REMTAIL(&bp->bp_CacheValid);
+    for (bep = &bp->bp_Hash[be->be_Block & bp->bp_HashMask]; *bep != be; bep = &(*bep)->be_HashNext)
+        ;
+    *bep = be->be_HashNext;
+
+    return be;
+}
+
+static VOID BCache_AddEntry(struct BCachePrivate *bp, struct BCacheEntry *be, ULONG block)
+{
+    struct BCacheEntry **bep = &bp->bp_Hash[block & bp->bp_HashMask];
+
+    be->be_Block = block;
+    be->be_HashNext = *bep;
+    *bep = be;
+    ADDHEAD(&bp->bp_CacheValid, &be->be_Node);
+}
+
 static LONG BCache_IO(struct BCache *bcache, ULONG cmd, ULONG block, ULONG blocks, APTR buffer)
 {
     struct BCachePrivate *bp = (struct BCachePrivate *)bcache;
@@ -405,8 +476,6 @@ static LONG BCache_IO(struct BCache *bcache, ULONG cmd, ULONG block, ULONG block
     io->io_Offset = (ULONG)offset;
     io->io_Actual = (ULONG)(offset >> 32);
     if (0 == DoIO((struct IORequest *)io)) {
-        /* Stir the RNG */
-        XorshiftRNG(&bp->bp_RNG);
         D(bug("%s: io_Error %d\n", __func__, io->io_Error));
         return io->io_Error ? RETURN_ERROR : RETURN_OK;
     }
@@ -431,97 +500,94 @@ LONG BCache_Read(struct BCache *bcache, ULONG block, UBYTE **bufferp)
     struct BCachePrivate *bp = (struct BCachePrivate *)bcache;
     struct BCacheEntry *be;
     LONG err;
-    ULONG depth = 0;
-    ULONG index, run;
+    ULONG run;
     int i;
 
     D(bug("%s: Block %d\n", __func__, block));
-    if (block > bp->bp_Blocks)
+    if (block >= bp->bp_Blocks)
         return ERROR_SEEK_ERROR;
 
-    /* Scan to see if this block was cached */
-    ForeachNode(&bp->bp_CacheValid, be) {
-        if (be->be_Block == block) {
-            /* Move to the front of the list, if it is
-             * more than 1/8th of the way into the
-             * cache.
-             */
-            D(bug("%s: Cached block found at depth %d\n", __func__, depth));
-            if (depth > (bp->bp_NumBuffers / 8)) {
-                D(bug("%s: Moving to head of Valid list..\n", __func__));
-                REMOVE(be);
-                ADDHEAD(&bp->bp_CacheValid, be);
-            }
-            *bufferp = be->be_Buffer;
-            return RETURN_OK;
-        }
-        depth++;
+    if ((be = BCache_Lookup(bp, block))) {
+        D(bug("%s: Cached block found\n", __func__));
+        REMOVE(be);
+        ADDHEAD(&bp->bp_CacheValid, be);
+        *bufferp = be->be_Buffer;
+        return RETURN_OK;
     }
 
-    /* Ok, no cached block. Let's pick a random spot
-     * and random length out of the buffer cache.
+    /* Not cached. Read the following blocks as well,
+     * up to the first one which is cached already.
      */
-    if (bp->bp_NumBuffers == 1) {
-        index = 0;
-        run = 1;
-    } else {
-        if (bp->bp_NumBuffers < 16)
-            run = 1 + (XorshiftRNG(&bp->bp_RNG) % (bp->bp_NumBuffers - 1));
-        else
-            run = 8 + (XorshiftRNG(&bp->bp_RNG) & 7);
-        index = XorshiftRNG(&bp->bp_RNG) % (bp->bp_NumBuffers - run);
+    run = bp->bp_ReadAheadBlocks;
+    if (run > bp->bp_Blocks - block)
+        run = bp->bp_Blocks - block;
+    for (i = 1; i < run; i++) {
+        if (BCache_Lookup(bp, block + i)) {
+            run = i;
+            break;
+        }
     }
 
-    ASSERT(run > 0);
-    ASSERT(index + run <= bp->bp_NumBuffers);
-    ASSERT(block + run <= bp->bp_Blocks);
-
-    /* First, shorten the run to prevent duplications in the cache */
     D(bug("%s: Caching blocks %d (%d)\n", __func__, block, run));
-    ForeachNode(&bp->bp_CacheValid, be) {
-        if (be->be_Block > block && be->be_Block < (block + run)) {
-            /* Shorten the run */
-            D(bug("%s: Shorten run: cached block %d in (%d - %d)\n",
-                        __func__, be->be_Block, block, block + run - 1));
-            run = be->be_Block - block;
+    if (run == 1) {
+        be = BCache_GetEntry(bp);
+        err = BCache_IO(bcache, bp->bp_ReadCMD, block, 1, be->be_Buffer);
+        if (err == RETURN_OK) {
+            BCache_AddEntry(bp, be, block);
+            *bufferp = be->be_Buffer;
+        } else {
+            D(bug("%s: IO failed, returning entry to Invalid list\n", __func__));
+            ADDHEAD(&bp->bp_CacheInvalid, &be->be_Node);
         }
+        return err;
     }
 
-    ASSERT(run > 0);
-
-    /* Steal the entries for these buffers */
-    D(bug("%s: Steal indexes %d (%d)\n", __func__, index, run));
-    for (i = 0, be = &bp->bp_CacheEntries[index]; i < run; i++, be++) {
-        REMOVE(&be->be_Node);
+    err = BCache_IO(bcache, bp->bp_ReadCMD, block, run, bp->bp_ReadAhead);
+    if (err == RETURN_OK) {
+        /* Last block first, so the requested one ends up most recently used */
+        for (i = run - 1; i >= 0; i--) {
+            be = BCache_GetEntry(bp);
+            CopyMem(bp->bp_ReadAhead + i * bp->bp_Public.bc_BlockSize, be->be_Buffer, bp->bp_Public.bc_BlockSize);
+            BCache_AddEntry(bp, be, block + i);
+        }
+        *bufferp = be->be_Buffer;
     }
 
-    be = &bp->bp_CacheEntries[index];
+    return err;
+}
 
-    /* Read the run */
-    err = BCache_IO(bcache, bp->bp_ReadCMD, block, run, be->be_Buffer);
-    if (err == RETURN_OK) {
-        D(bug("%s: Adding to Valid cache...\n", __func__));
-        for (i = 0; i < run; i++, be++) {
-            be->be_Block = block + i;
-            ADDHEAD(&bp->bp_CacheValid, &be->be_Node);
-        }
-        *bufferp = bp->bp_CacheEntries[index].be_Buffer;
-    } else {
-        D(bug("%s: IO failed, returning %d (%d) to Invalid list\n", __func__, index, run));
-        for (i = 0; i < run; i++, be++) {
-            ADDHEAD(&bp->bp_CacheInvalid, &be->be_Node);
+/* Read blocks from disk straight into the buffer, bypassing the cache.
+ * Large transfers are split according to the MaxTransfer of the device,
+ * buffers the device can't address are read through the cache.
+ * returns:
+ *   same as BCache_Read()
+ */
+LONG BCache_ReadBlocks(struct BCache *bcache, ULONG block, ULONG blocks, UBYTE *buffer)
+{
+    struct BCachePrivate *bp = (struct BCachePrivate *)bcache;
+    ULONG blocksize = bp->bp_Public.bc_BlockSize;
+    LONG err = RETURN_OK;
+    UBYTE *cache;
+    ULONG run;
+
+    D(bug("%s: Blocks %d (%d)\n", __func__, block, blocks));
+    if (block >= bp->bp_Blocks || blocks > bp->bp_Blocks - block)
+        return ERROR_SEEK_ERROR;
+
+    /* Both ends must be addressable, a buffer crossing the mask isn't */
+    if (((IPTR)buffer | ((IPTR)buffer + blocks * blocksize - 1)) & ~bp->bp_Mask) {
+        for (; blocks && err == RETURN_OK; blocks--, block++, buffer += blocksize) {
+            err = BCache_Read(bcache, block, &cache);
+            if (err == RETURN_OK)
+                CopyMem(cache, buffer, blocksize);
         }
+        return err;
     }
 
-    D(bug("Valid:"));
-    ForeachNode(&bp->bp_CacheValid, be) {
-        D(bug(" %d (%d)", be - bp->bp_CacheEntries, be->be_Block));
+    for (; blocks && err == RETURN_OK; blocks -= run, block += run, buffer += run * blocksize) {
+        run = (blocks > bp->bp_MaxTransfer) ? bp->bp_MaxTransfer : blocks;
+        err = BCache_IO(bcache, bp->bp_ReadCMD, block, run, buffer);
     }
-    D(bug("\nInval"));
-    ForeachNode(&bp->bp_CacheInvalid, be) {
-        D(bug(" %d", be - bp->bp_CacheEntries));
-    }
-    D(bug("\n"));
 
     return err;
 }
@@ -541,27 +607,15 @@ LONG BCache_Write(struct BCache *bcache, ULONG block, CONST UBYTE *buffer)
 {
     struct BCachePrivate *bp = (struct BCachePrivate *)bcache;
     struct BCacheEntry *be;
-    ULONG depth = 0;
 
-    if (block > bp->bp_Blocks)
+    if (block >= bp->bp_Blocks)
         return ERROR_SEEK_ERROR;
 
-    /* Scan to see if this block was cached */
-    ForeachNode(&bp->bp_CacheValid, be) {
-        if (be->be_Block == block) {
-            /* Move to the front of the list, if it is
-             * more than 1/8th of the way into the
-             * cache.
-             */
-            if (depth > (bp->bp_NumBuffers / 8)) {
-                REMOVE(be);
-                ADDHEAD(&bp->bp_CacheValid, be);
-            }
-            /* Synchronize the cache with the data to write */
-            CopyMem(buffer, be->be_Buffer, bp->bp_Public.bc_BlockSize);
-            break;
-        }
-        depth++;
+    if ((be = BCache_Lookup(bp, block))) {
+        REMOVE(be);
+        ADDHEAD(&bp->bp_CacheValid, be);
+        /* Synchronize the cache with the data to write */
+        CopyMem(buffer, be->be_Buffer, bp->bp_Public.bc_BlockSize);
     }
 
     return BCache_IO(bcache, bp->bp_WriteCMD, block, 1, (APTR)buffer);
@@ -74,6 +74,13 @@ LONG BCache_Present(struct BCache *bcache);
  */
 LONG BCache_Read(struct BCache *bcache, ULONG block, UBYTE **buffer);
 
+/* Read blocks from disk straight into the buffer, bypassing the cache.
+ * For large transfers of data which is unlikely to be read again.
+ * returns:
+ *   same as BCache_Read()
+ */
+LONG BCache_ReadBlocks(struct BCache *bcache, ULONG block, ULONG blocks, UBYTE *buffer);
+
 /* Write buffer to blocks on the disk.
  * returns:
  *   RETURN_OK     - Disk present
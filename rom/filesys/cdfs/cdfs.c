@@ -10,6 +10,9 @@
 
 #include <proto/exec.h>
 #include <proto/dos.h>
+#include <proto/utility.h>
+
+#include <dos/exall.h>
 
 #include "cdfs.h"
 #include "iso9660.h"
@@ -215,6 +218,120 @@ static struct CDFSVolume *CDFS_DevicePresent(struct CDFS *cdfs, struct CDFSDevic
     return (*res == DOSTRUE) ? dev->cd_Volume : NULL;
 }
 
+/* Fill an ExAll() buffer with as many directory entries as fit, using the
+ * volume's ExamineNext operation, so a whole buffer is produced per packet
+ * instead of one ExNext() round trip per entry. eac_LastKey is the
+ * fib_DiskKey after the last entry handed out, and zero starts a new scan.
+ */
+static LONG CDFS_ExamineAll(struct CDFS *cdfs, struct CDFSVolume *vol, struct CDFSLock *dl, struct ExAllData *ead, ULONG size, ULONG type, struct ExAllControl *eac)
+{
+    static const ULONG sizes[] = {
+        0,
+        offsetof(struct ExAllData, ed_Type),
+        offsetof(struct ExAllData, ed_Size),
+        offsetof(struct ExAllData, ed_Prot),
+        offsetof(struct ExAllData, ed_Days),
+        offsetof(struct ExAllData, ed_Comment),
+        offsetof(struct ExAllData, ed_OwnerUID),
+        sizeof(struct ExAllData)
+    };
+    struct Library *DOSBase = NULL;
+    struct FileInfoBlock fib;
+    struct ExAllData *last = NULL;
+    UBYTE *end = (UBYTE *)ead + size, *next;
+    UBYTE name[sizeof(fib.fib_FileName)];
+    ULONG namelen, commentlen;
+    LONG err;
+
+    eac->eac_Entries = 0;
+
+    if (type > ED_OWNER)
+        return ERROR_BAD_NUMBER;
+
+    if (dl->cl_FileInfoBlock.fib_DirEntryType <= 0)
+        return ERROR_OBJECT_WRONG_TYPE;
+
+    if (eac->eac_MatchString) {
+        DOSBase = TaggedOpenLibrary(TAGGEDOPEN_DOS);
+        if (DOSBase == NULL)
+            return ERROR_INVALID_RESIDENT_LIBRARY;
+    }
+
+    fib.fib_DiskKey = eac->eac_LastKey;
+    while ((err = vol->cv_Ops->op_ExamineNext(vol, dl, &fib)) == RETURN_OK) {
+        namelen = fib.fib_FileName[0];
+        commentlen = fib.fib_Comment[0];
+        CopyMem(&fib.fib_FileName[1], name, namelen);
+        name[namelen] = 0;
+
+        if (DOSBase && !MatchPatternNoCase(eac->eac_MatchString, name)) {
+            eac->eac_LastKey = fib.fib_DiskKey;
+            continue;
+        }
+
+        /* An entry that doesn't fit is left for the next call */
+        next = (UBYTE *)ead + sizes[type];
+        if (type >= ED_NAME)
+            next += namelen + 1;
+        if (type >= ED_COMMENT)
+            next += commentlen + 1;
+        if (next > end)
+            break;
+
+        switch (type) {
+        case ED_OWNER:
+            ead->ed_OwnerUID = fib.fib_OwnerUID;
+            ead->ed_OwnerGID = fib.fib_OwnerGID;
+            /* FALLTHROUGH */
+        case ED_COMMENT:
+            ead->ed_Comment = (UBYTE *)ead + sizes[type] + namelen + 1;
+            CopyMem(&fib.fib_Comment[1], ead->ed_Comment, commentlen);
+            ead->ed_Comment[commentlen] = 0;
+            /* FALLTHROUGH */
+        case ED_DATE:
+            ead->ed_Days = fib.fib_Date.ds_Days;
+            ead->ed_Mins = fib.fib_Date.ds_Minute;
+            ead->ed_Ticks = fib.fib_Date.ds_Tick;
+            /* FALLTHROUGH */
+        case ED_PROTECTION:
+            ead->ed_Prot = fib.fib_Protection;
+            /* FALLTHROUGH */
+        case ED_SIZE:
+            ead->ed_Size = fib.fib_Size;
+            /* FALLTHROUGH */
+        case ED_TYPE:
+            ead->ed_Type = fib.fib_DirEntryType;
+            /* FALLTHROUGH */
+        case ED_NAME:
+            ead->ed_Name = (UBYTE *)ead + sizes[type];
+            CopyMem(name, ead->ed_Name, namelen + 1);
+        }
+        ead->ed_Next = NULL;
+
+        eac->eac_LastKey = fib.fib_DiskKey;
+
+        if (eac->eac_MatchFunc && !CallHookPkt(eac->eac_MatchFunc, &type, ead))
+            continue;
+
+        if (last)
+            last->ed_Next = ead;
+        last = ead;
+        ead = (struct ExAllData *)(((IPTR)next + AROS_PTRALIGN - 1) & ~(AROS_PTRALIGN - 1));
+        eac->eac_Entries++;
+    }
+
+    if (DOSBase)
+        CloseLibrary(DOSBase);
+
+    D(bug("%s: %d entries, last key %d, error %d\n", __func__, eac->eac_Entries, eac->eac_LastKey, err));
+
+    /* Buffer full */
+    if (err == RETURN_OK && last == NULL)
+        err = ERROR_BUFFER_OVERFLOW;
+
+    return err;
+}
+
 #undef SysBase
 
 static struct CDFS *CDFS_Init(struct ExecBase *SysBase)
@@ -447,6 +564,29 @@ LONG CDFS_Handler(struct ExecBase *SysBase)
                     res = res2 ? DOSFALSE : DOSTRUE;
                 }
                 break;
+            case ACTION_(EXAMINE_ALL):
+                {
+                    struct CDFSLock *fl = B_LOCK(dp->dp_Arg1);
+                    struct ExAllControl *eac = (struct ExAllControl *)dp->dp_Arg5;
+                    struct CDFSVolume *vol;
+
+                    vol = CDFS_DevicePresent(cdfs, dev, &fl, &res, &res2);
+                    if (!vol) break;
+
+                    res2 = CDFS_ExamineAll(cdfs, vol, fl, (struct ExAllData *)dp->dp_Arg2, (ULONG)dp->dp_Arg3, (ULONG)dp->dp_Arg4, eac);
+                    res = res2 ? DOSFALSE : DOSTRUE;
+                }
+                break;
+            case ACTION_(EXAMINE_ALL_END):
+                {
+                    struct ExAllControl *eac = (struct ExAllControl *)dp->dp_Arg5;
+
+                    /* No scan state is kept outside the control structure */
+                    eac->eac_LastKey = 0;
+                    res = DOSTRUE;
+                    res2 = 0;
+                }
+                break;
             case ACTION_(FH_FROM_LOCK):
                 {
                     struct FileHandle *fh = BADDR(dp->dp_Arg1);
@@ -19,6 +19,9 @@
 #include "iso9660.h"
 #include "bcache.h"
 
+/* Reads of at least this many whole blocks bypass the block cache */
+#define ISO_DIRECTREAD_MIN  4
+
 struct ISOLock {
     struct CDFSLock il_Public;
     ULONG           il_Extent;
@@ -875,6 +878,24 @@ LONG ISO9660_Read(struct CDFSVolume *vol, struct CDFSLock *fl, APTR buff, SIPTR
         if (tocopy > len)
             tocopy = len;
 
+        /* Files are a single extent, so whole blocks can
+         * be read straight into the buffer at once.
+         */
+        if (offset == 0 && len >= ISO_DIRECTREAD_MIN * 2048) {
+            ULONG blocks = len / 2048;
+
+            err = BCache_ReadBlocks(bcache, il->il_Extent + block, blocks, buff);
+            if (err != RETURN_OK)
+                break;
+
+            buff += blocks * 2048;
+            len -= blocks * 2048;
+            actual += blocks * 2048;
+            il->il_Offset += blocks * 2048;
+            block += blocks;
+            continue;
+        }
+
         err = BCache_Read(bcache, il->il_Extent + block, &cache);
         if (err != RETURN_OK)
             break;
@@ -44,7 +44,17 @@
  * range is marked dirty and added to the tail of the dirty list through
  * the cache block's second node. The dirty list is flushed periodically
  * (currently once per second), and additionally whenever the free list
- * becomes empty.
+ * becomes empty or half of the cache blocks are dirty.
+ * 
+ * When flushing, dirty ranges are sorted by block number, and runs of
+ * adjacent ranges (e.g. neighbouring FAT sectors, or the clusters of a
+ * file being copied) are written with a single AccessDisk() call through
+ * a bounce buffer of up to IO_RANGES ranges.
+ * 
+ * Reads use the same buffer for read-ahead: a miss on the range following
+ * the previous read doubles the read-ahead window, up to IO_RANGES ranges,
+ * while any other miss resets it to a single range. The extra ranges are
+ * placed on the tail of the free list, so they are reused last.
  * 
  */
 
@@ -63,6 +73,8 @@
 #define RANGE_SIZE (1 << RANGE_SHIFT)
 #define RANGE_MASK (RANGE_SIZE - 1)
 
+#define IO_RANGES 4
+
 #define NODE2(A) \
    ((struct BlockRange *)(((A) != NULL) ? \
    (((BYTE *)(A)) - (IPTR)&((struct BlockRange *)NULL)->node2) : NULL))
@@ -109,20 +121,32 @@ APTR Cache_CreateCache(APTR priv, ULONG hash_size, ULONG block_count,
 
         c->blocks = AllocVec(sizeof(APTR) * block_count,
             MEMF_PUBLIC | MEMF_CLEAR);
-        if(c == NULL)
+        if(c->blocks == NULL)
             success = FALSE;
 
+        /* Allocate scratch list for sorting dirty blocks, and buffer for
+         * multi-range transfers */
+
+        c->flush_list = AllocVec(sizeof(APTR) * block_count, MEMF_PUBLIC);
+        c->io_buffer = AllocVec((c->block_size << RANGE_SHIFT) * IO_RANGES,
+            MEMF_PUBLIC);
+        if(c->flush_list == NULL || c->io_buffer == NULL)
+            success = FALSE;
+        c->ra_ranges = 1;
+
         for(i = 0; i < block_count && success; i++)
         {
             b = AllocVec(sizeof(struct BlockRange)
                 + (c->block_size << RANGE_SHIFT), MEMF_PUBLIC);
-            b->use_count = 0;
-            b->state = BS_EMPTY;
-            b->num = 0;
-            b->data = (UBYTE *)b + sizeof(struct BlockRange);
 
             if(b != NULL)
+            {
+                b->use_count = 0;
+                b->state = BS_EMPTY;
+                b->num = 0;
+                b->data = (UBYTE *)b + sizeof(struct BlockRange);
                 c->blocks[i] = b;
+            }
             else
                 success = FALSE;
 
@@ -147,23 +171,81 @@ VOID Cache_DestroyCache(APTR cache)
     struct Cache *c = cache;
     ULONG i;
 
-    Cache_Flush(c);
+    if(c->blocks != NULL && c->flush_list != NULL && c->io_buffer != NULL)
+        Cache_Flush(c);
 
-    for(i = 0; i < c->block_count; i++)
-        FreeVec(c->blocks[i]);
+    if(c->blocks != NULL)
+    {
+        for(i = 0; i < c->block_count; i++)
+            FreeVec(c->blocks[i]);
+    }
     FreeVec(c->blocks);
+    FreeVec(c->flush_list);
+    FreeVec(c->io_buffer);
     FreeVec(c->hash_table);
     FreeVec(c);
 }
 
 
+static struct BlockRange *FindRange(struct Cache *c, ULONG blockNum)
+{
+    struct MinList *l = &c->hash_table[(blockNum >> RANGE_SHIFT) & (c->hash_size - 1)];
+    struct BlockRange *b = NULL, *b2;
+
+    ForeachNode(l, b2)
+    {
+        if(b2->num == blockNum)
+            b = b2;
+    }
+
+    return b;
+}
+
+
+static VOID HashRange(struct Cache *c, struct BlockRange *b, ULONG blockNum)
+{
+    struct MinList *l = &c->hash_table[(blockNum >> RANGE_SHIFT) & (c->hash_size - 1)];
+
+    /* Remove block from its old position in the hash */
+
+    if(b->state == BS_VALID)
+        Remove((struct Node *)b);
+
+    /* Add it to the hash at the new location */
+
+    AddHead((struct List *)l, (struct Node *)&b->node1);
+    b->num = blockNum;
+    b->state = BS_VALID;
+}
+
+
+/* Read the ranges following blockNum into free blocks, after blockNum's
+ * own range has been read into io_buffer */
+static VOID ReadAhead(struct Cache *c, ULONG blockNum, ULONG count)
+{
+    struct MinNode *n;
+    struct BlockRange *b;
+    ULONG i;
+
+    for(i = 1; i < count; i++)
+    {
+        n = (struct MinNode *)RemHead((struct List *)&c->free_list);
+        b = (struct BlockRange *)NODE2(n);
+        CopyMem(c->io_buffer + (i << RANGE_SHIFT) * c->block_size, b->data,
+            c->block_size << RANGE_SHIFT);
+        HashRange(c, b, blockNum + (i << RANGE_SHIFT));
+        AddTail((struct List *)&c->free_list, (struct Node *)&b->node2);
+    }
+}
+
+
 APTR Cache_GetBlock(APTR cache, ULONG blockNum, UBYTE **data)
 {
     struct Cache *c = cache;
-    struct BlockRange *b = NULL, *b2;
+    struct BlockRange *b = NULL;
     LONG error = 0, data_offset;
-    struct MinList *l = &c->hash_table[(blockNum >> RANGE_SHIFT) & (c->hash_size - 1)];
     struct MinNode *n;
+    ULONG count, free_count;
 
     /* Change block number to the start block of a range and get byte offset
      * within range */
@@ -173,11 +255,7 @@ APTR Cache_GetBlock(APTR cache, ULONG blockNum, UBYTE **data)
 
     /* Check existing valid blocks first */
 
-    ForeachNode(l, b2)
-    {
-        if(b2->num == blockNum)
-            b = b2;
-    }
+    b = FindRange(c, blockNum);
 
     if(b != NULL)
     {
@@ -192,6 +270,12 @@ APTR Cache_GetBlock(APTR cache, ULONG blockNum, UBYTE **data)
     }
     else
     {
+        /* Write back early if too much of the cache is dirty, so that
+         * reads don't have to wait for a full flush */
+
+        if(c->dirty_count >= c->block_count / 2)
+            Cache_Flush(c);
+
         /* Get a free buffer to read block from disk */
 
         n = (struct MinNode *)RemHead((struct List *)&c->free_list);
@@ -209,26 +293,49 @@ APTR Cache_GetBlock(APTR cache, ULONG blockNum, UBYTE **data)
         {
             b = (struct BlockRange *)NODE2(n);
 
-            /* Read the block from disk */
+            /* Grow the read-ahead window on sequential access, limited by
+             * free blocks and by ranges that are already cached */
 
-            if(AccessDisk(FALSE, blockNum, RANGE_SIZE, c->block_size, b->data, c->priv) == 0)
+            if(blockNum == c->ra_next)
             {
-                /* Remove block from its old position in the hash */
+                if(c->ra_ranges < IO_RANGES)
+                    c->ra_ranges <<= 1;
+            }
+            else
+                c->ra_ranges = 1;
 
-                if(b->state == BS_VALID)
-                    Remove((struct Node *)b);
+            free_count = 0;
+            ForeachNode(&c->free_list, n)
+            {
+                if(++free_count >= c->ra_ranges)
+                    break;
+            }
+            for(count = 1; count < c->ra_ranges && count <= free_count
+                && FindRange(c, blockNum + (count << RANGE_SHIFT)) == NULL;
+                count++);
+            c->ra_next = blockNum + (count << RANGE_SHIFT);
 
-                /* Add it to the hash at the new location */
+            /* Read the block from disk */
 
-                AddHead((struct List *)l, (struct Node *)&b->node1);
-                b->num = blockNum;
-                b->state = BS_VALID;
+            if(count > 1 && AccessDisk(FALSE, blockNum, count << RANGE_SHIFT,
+                c->block_size, c->io_buffer, c->priv) == 0)
+            {
+                CopyMem(c->io_buffer, b->data, c->block_size << RANGE_SHIFT);
+                HashRange(c, b, blockNum);
+                b->use_count = 1;
+                ReadAhead(c, blockNum, count);
+            }
+            else if(AccessDisk(FALSE, blockNum, RANGE_SIZE, c->block_size, b->data, c->priv) == 0)
+            {
+                HashRange(c, b, blockNum);
                 b->use_count = 1;
             }
             else
             {
                 /* Read failed, so put the block back on the free list */
 
+                if(b->state == BS_VALID)
+                    Remove((struct Node *)b);
                 b->state = BS_EMPTY;
                 AddHead((struct List *)&c->free_list,
                     (struct Node *)&b->node2);
@@ -276,46 +383,97 @@ VOID Cache_MarkBlockDirty(APTR cache, APTR block)
     {
         b->state = BS_DIRTY;
         AddTail((struct List *)&c->dirty_list, (struct Node *)&b->node2);
+        c->dirty_count++;
     }
 
     return;
 }
 
 
+static VOID SortRanges(struct BlockRange **list, ULONG count)
+{
+    struct BlockRange *b;
+    ULONG gap, i, j;
+
+    /* Shell sort by start block number */
+
+    for(gap = 1; gap < count / 3; gap = gap * 3 + 1);
+    for(; gap > 0; gap /= 3)
+    {
+        for(i = gap; i < count; i++)
+        {
+            b = list[i];
+            for(j = i; j >= gap && list[j - gap]->num > b->num; j -= gap)
+                list[j] = list[j - gap];
+            list[j] = b;
+        }
+    }
+}
+
+
 BOOL Cache_Flush(APTR cache)
 {
     struct Cache *c = cache;
     LONG error = 0, td_error;
     struct MinNode *n;
-    struct BlockRange *b;
+    struct BlockRange *b, **list = c->flush_list;
+    ULONG count = 0, i, j, k;
+
+    /* Collect and sort the dirty block ranges */
 
     while((n = (struct MinNode *)RemHead((struct List *)&c->dirty_list))
-        != NULL && error == 0)
+        != NULL)
+        list[count++] = NODE2(n);
+    SortRanges(list, count);
+
+    for(i = 0; i < count && error == 0; i = j)
     {
-        /* Write dirty block range to disk */
+        /* Find the run of adjacent ranges starting here */
+
+        for(j = i + 1; j < count && j - i < IO_RANGES
+            && list[j]->num == list[j - 1]->num + RANGE_SIZE; j++);
 
-        b = NODE2(n);
-        td_error = AccessDisk(TRUE, b->num, RANGE_SIZE, c->block_size,
-            b->data, c->priv);
+        /* Write dirty block range(s) to disk */
 
-        /* Transfer block range to free list if unused, or put back on dirty
-         * list upon an error */
+        if(j - i == 1)
+            td_error = AccessDisk(TRUE, list[i]->num, RANGE_SIZE,
+                c->block_size, list[i]->data, c->priv);
+        else
+        {
+            for(k = i; k < j; k++)
+                CopyMem(list[k]->data,
+                    c->io_buffer + ((k - i) << RANGE_SHIFT) * c->block_size,
+                    c->block_size << RANGE_SHIFT);
+            td_error = AccessDisk(TRUE, list[i]->num, (j - i) << RANGE_SHIFT,
+                c->block_size, c->io_buffer, c->priv);
+        }
+
+        /* Transfer block ranges to free list if unused */
 
         if(td_error == 0)
         {
-            b->state = BS_VALID;
-            if(b->use_count == 0)
-                AddTail((struct List *)&c->free_list,
-                    (struct Node *)&b->node2);
+            for(k = i; k < j; k++)
+            {
+                b = list[k];
+                b->state = BS_VALID;
+                c->dirty_count--;
+                if(b->use_count == 0)
+                    AddTail((struct List *)&c->free_list,
+                        (struct Node *)&b->node2);
+            }
         }
         else
         {
-            AddHead((struct List *)&c->dirty_list, (struct Node *)&b->node2);
             error = ERROR_UNKNOWN;
+            j = i;
         }
     }
 
+    /* Put back anything not written on the dirty list upon an error */
+
+    for(; i < count; i++)
+        AddTail((struct List *)&c->dirty_list, (struct Node *)&list[i]->node2);
+
     SetIoErr(error);
     return error == 0;
 }
-
@@ -1,5 +1,5 @@
 /*
-    Copyright  2010-2015, The AROS Development Team. All rights reserved.
+    Copyright  2010-2020, The AROS Development Team. All rights reserved.
     $Id$
 
     Disk cache.
@@ -33,6 +33,11 @@ struct Cache
     struct MinList *hash_table;    /* hash table of all valid cache blocks */
     struct MinList dirty_list;    /* the dirty list */
     struct MinList free_list;    /* the free list */
+    ULONG dirty_count;  /* number of blocks on the dirty list */
+    struct BlockRange **flush_list;    /* scratch array for Cache_Flush() */
+    UBYTE *io_buffer;   /* bounce buffer for multi-range transfers */
+    ULONG ra_next;      /* range following the last range read from disk */
+    ULONG ra_ranges;    /* current read-ahead window in ranges */
 };
 
 /* Block states */
@@ -120,6 +120,9 @@ LONG OpSetProtect(struct ExtFileLock *lock, UBYTE *name, ULONG namelen,
     ULONG prot, struct Globals *glob);
 LONG OpSetDate(struct ExtFileLock *dirlock, UBYTE *name, ULONG namelen,
     struct DateStamp *ds, struct Globals *glob);
+LONG OpExamineAll(struct ExtFileLock *dirlock, struct ExAllData *buffer,
+    ULONG size, ULONG type, struct ExAllControl *control,
+    struct Globals *glob);
 LONG OpAddNotify(struct NotifyRequest *nr, struct Globals *glob);
 LONG OpRemoveNotify(struct NotifyRequest *nr, struct Globals *glob);
 
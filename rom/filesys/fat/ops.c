@@ -11,13 +11,17 @@
  */
 
 #include <proto/exec.h>
+#include <proto/dos.h>
 #include <proto/utility.h>
 
 #include <aros/macros.h>
 #include <exec/types.h>
 #include <dos/dos.h>
+#include <dos/exall.h>
 #include <dos/notify.h>
 
+#include <stddef.h>
+
 #include "fat_fs.h"
 #include "fat_protos.h"
 
@@ -1183,6 +1187,148 @@ LONG OpSetDate(struct ExtFileLock *dirlock, UBYTE *name, ULONG namelen,
     return 0;
 }
 
+/*
+ * Fills the buffer with as many ExAllData records for the entries of a
+ * directory as will fit. The directory is walked with a single dir handle and
+ * each record is built straight from its dir entry, so unlike ExNext() no
+ * lock has to be created for every entry. eac_LastKey holds the index of the
+ * last entry handed out plus one, so that zero means a fresh scan.
+ */
+LONG OpExamineAll(struct ExtFileLock *dirlock, struct ExAllData *buffer,
+    ULONG size, ULONG type, struct ExAllControl *control,
+    struct Globals *glob)
+{
+    static const ULONG sizes[] =
+    {
+        0,
+        offsetof(struct ExAllData, ed_Type),
+        offsetof(struct ExAllData, ed_Size),
+        offsetof(struct ExAllData, ed_Prot),
+        offsetof(struct ExAllData, ed_Days),
+        offsetof(struct ExAllData, ed_Comment),
+        offsetof(struct ExAllData, ed_OwnerUID),
+        sizeof(struct ExAllData)
+    };
+    struct DirHandle dh;
+    struct DirEntry de;
+    struct ExAllData *curr = buffer, *last = NULL;
+    UBYTE *end = (UBYTE *)buffer + size, *next;
+    UBYTE name[FAT_MAX_LONG_FILENAME + 1];
+    struct DateStamp ds;
+    ULONG len;
+    LONG err;
+
+    control->eac_Entries = 0;
+
+    if (type > ED_OWNER)
+        return ERROR_BAD_NUMBER;
+
+    if (dirlock != NULL && dirlock->gl != &glob->sb->info->root_lock
+        && !(dirlock->gl->attr & ATTR_DIRECTORY))
+        return ERROR_OBJECT_WRONG_TYPE;
+
+    if ((err = InitDirHandle(glob->sb,
+        dirlock != NULL ? dirlock->ioh.first_cluster : 0, &dh, FALSE,
+        glob)) != 0)
+        return err;
+
+    /* A LastKey of zero gives the 0xffffffff that a fresh handle starts at */
+    dh.cur_index = control->eac_LastKey - 1;
+
+    while ((err = GetNextDirEntry(&dh, &de, glob)) == 0)
+    {
+        /* Same naming rules as LockFile(): long name if there is one */
+        GetDirEntryShortName(&de, name, &len, glob);
+        GetDirEntryLongName(&de, name, &len);
+        name[len] = '\0';
+
+        if (control->eac_MatchString != NULL
+            && !MatchPatternNoCase(control->eac_MatchString, name))
+        {
+            control->eac_LastKey = dh.cur_index + 1;
+            continue;
+        }
+
+        /* Work out the record size, strings included, before writing
+         * anything. If it doesn't fit we stop here and leave LastKey alone,
+         * so the entry comes first in the next call */
+        next = (UBYTE *)curr + sizes[type];
+        if (type >= ED_NAME)
+            next += len + 1;
+        if (type >= ED_COMMENT)
+            next++;
+        if (next > end)
+            break;
+
+        switch (type)
+        {
+        case ED_OWNER:
+            curr->ed_OwnerUID = 0;
+            curr->ed_OwnerGID = 0;
+
+            /* Fall through */
+        case ED_COMMENT:
+            curr->ed_Comment = (UBYTE *)curr + sizes[type] + len + 1;
+            curr->ed_Comment[0] = '\0';
+
+            /* Fall through */
+        case ED_DATE:
+            ConvertFATDate(de.e.entry.write_date, de.e.entry.write_time,
+                &ds, glob);
+            curr->ed_Days = ds.ds_Days;
+            curr->ed_Mins = ds.ds_Minute;
+            curr->ed_Ticks = ds.ds_Tick;
+
+            /* Fall through */
+        case ED_PROTECTION:
+            curr->ed_Prot = 0;
+            if (de.e.entry.attr & ATTR_READ_ONLY)
+                curr->ed_Prot |= (FIBF_DELETE | FIBF_WRITE);
+            if (de.e.entry.attr & ATTR_ARCHIVE)
+                curr->ed_Prot |= FIBF_ARCHIVE;
+
+            /* Fall through */
+        case ED_SIZE:
+            curr->ed_Size = AROS_LE2LONG(de.e.entry.file_size);
+
+            /* Fall through */
+        case ED_TYPE:
+            curr->ed_Type = (de.e.entry.attr & ATTR_DIRECTORY) ?
+                ST_USERDIR : ST_FILE;
+
+            /* Fall through */
+        case ED_NAME:
+            curr->ed_Name = (UBYTE *)curr + sizes[type];
+            CopyMem(name, curr->ed_Name, len + 1);
+        }
+        curr->ed_Next = NULL;
+
+        control->eac_LastKey = dh.cur_index + 1;
+
+        if (control->eac_MatchFunc != NULL
+            && !CallHookPkt(control->eac_MatchFunc, &type, curr))
+            continue;
+
+        if (last != NULL)
+            last->ed_Next = curr;
+        last = curr;
+        curr = (struct ExAllData *)(((IPTR)next + AROS_PTRALIGN - 1)
+            & ~(AROS_PTRALIGN - 1));
+        control->eac_Entries++;
+    }
+
+    ReleaseDirHandle(&dh, glob);
+
+    D(bug("[FAT] ExAll returned %ld entries, last key %ld\n",
+        control->eac_Entries, control->eac_LastKey));
+
+    if (err == ERROR_OBJECT_NOT_FOUND)
+        return ERROR_NO_MORE_ENTRIES;
+    if (err == 0 && last == NULL)
+        return ERROR_BUFFER_OVERFLOW;
+    return err;
+}
+
 LONG OpAddNotify(struct NotifyRequest *nr, struct Globals *glob)
 {
     LONG err;
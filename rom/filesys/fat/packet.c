@@ -13,6 +13,7 @@
 #include <exec/types.h>
 #include <exec/execbase.h>
 #include <dos/dosextens.h>
+#include <dos/exall.h>
 #include <dos/filehandler.h>
 #include <dos/notify.h>
 #include <devices/inputevent.h>
@@ -199,6 +200,43 @@ void ProcessPackets(struct Globals *glob)
                 break;
             }
 
+        case ACTION_EXAMINE_ALL:
+            {
+                struct ExtFileLock *fl = BADDR(pkt->dp_Arg1);
+                struct ExAllControl *eac =
+                    (struct ExAllControl *)pkt->dp_Arg5;
+
+                D(bug("[FAT] ACTION_EXAMINE_ALL: lock = 0x%08x (dir %ld/%ld) type = %ld last key = %ld\n",
+                    pkt->dp_Arg1,
+                    fl != NULL ? fl->gl->dir_cluster : 0,
+                    fl != NULL ? fl->gl->dir_entry : 0,
+                    pkt->dp_Arg4, eac->eac_LastKey));
+
+                if ((err = TestLock(fl, glob)))
+                    break;
+
+                if ((err = OpExamineAll(fl, (struct ExAllData *)pkt->dp_Arg2,
+                    pkt->dp_Arg3, pkt->dp_Arg4, eac, glob)) == 0)
+                    res = DOSTRUE;
+
+                break;
+            }
+
+        case ACTION_EXAMINE_ALL_END:
+            {
+                struct ExAllControl *eac =
+                    (struct ExAllControl *)pkt->dp_Arg5;
+
+                D(bug("[FAT] ACTION_EXAMINE_ALL_END: lock = 0x%08x\n",
+                    pkt->dp_Arg1));
+
+                /* All scan state lives in the control structure */
+                eac->eac_LastKey = 0;
+                res = DOSTRUE;
+
+                break;
+            }
+
         case ACTION_FINDINPUT:
         case ACTION_FINDOUTPUT:
         case ACTION_FINDUPDATE:
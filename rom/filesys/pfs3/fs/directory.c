@@ -252,6 +252,7 @@
 #include "update_protos.h"
 #include "lru_protos.h"
 #include "ass_protos.h"
+#include "dirindex_protos.h"
 #include "support.c"
 
 void PFSDoNotify(struct fileinfo *object, BOOL checkparent, globaldata * g);
@@ -708,7 +709,7 @@ static BOOL SearchInDir(ULONG dirnodenr, STRPTR objectname, union objectinfo *in
 	struct canode anode;
 	struct cdirblock *dirblock;
 	struct direntry *entry = NULL;
-	BOOL found = FALSE, eod = FALSE;
+	BOOL found = FALSE, eod = FALSE, large = FALSE;
 	ULONG anodeoffset;
 	UBYTE intl_name[PATHSIZE];
 
@@ -720,6 +721,17 @@ static BOOL SearchInDir(ULONG dirnodenr, STRPTR objectname, union objectinfo *in
 		intl_name[0] = FILENAMESIZE - 1;
 
 	intltoupper(intl_name);     /* international uppercase objectname */
+
+	/* large directories have an index (see dirindex.c) */
+	switch (DirIndexLookup(dirnodenr, intl_name, info, g))
+	{
+		case DI_FOUND:
+			return TRUE;
+
+		case DI_NOTFOUND:
+			return FALSE;
+	}
+
 	GetAnode(&anode, dirnodenr, g);
 	anodeoffset = 0;
 	dirblock = LoadDirBlock(anode.blocknr, g);
@@ -741,7 +753,10 @@ static BOOL SearchInDir(ULONG dirnodenr, STRPTR objectname, union objectinfo *in
 		if (!found)
 		{
 			if (NextBlock(&anode, &anodeoffset, g))
+			{
 				dirblock = LoadDirBlock(anode.blocknr + anodeoffset, g);
+				large = TRUE;
+			}
 			else
 				eod = TRUE;
 		}
@@ -757,10 +772,13 @@ static BOOL SearchInDir(ULONG dirnodenr, STRPTR objectname, union objectinfo *in
 		info->file.direntry = entry;
 		info->file.dirblock = dirblock;
 		LOCK(dirblock);
-		return TRUE;
 	}
-	else
-		return FALSE;
+
+	/* more than one dirblock scanned: index it for the next lookups */
+	if (large)
+		BuildDirIndex(dirnodenr, g);
+
+	return found;
 }
 
 
@@ -1844,6 +1862,8 @@ static BOOL DeleteDir(union objectinfo *info, SIPTR *error, globaldata * g)
 	}
 	else
 	{
+		DiscardDirIndex(anode.nr, g);
+
 		/* check if tobefreedcache is sufficiently large,
 		 * otherwise update disk
 		 */
@@ -3162,6 +3182,7 @@ static BOOL MoveToPrevious(struct fileinfo de, struct direntry *to, struct filei
 		result->dirblock = newblock;
 	}
 
+	DirIndexAdd(result, g);
 	LOCK(result->dirblock);
 	MakeBlockDirty((struct cachedblock *)result->dirblock, g);
 
@@ -3197,10 +3218,12 @@ static void RenameInPlace(struct fileinfo from, struct direntry *to, struct file
 	start = (UBYTE *)from.direntry + from.direntry->next;
 	end = (UBYTE *)&(from.dirblock->blk) + g->rootblock->reserved_blksize;
 	movelen = (diff > 0) ? (end - dest) : (end - start);
+	DirIndexRemove(&from, diff, g);
 	memmove(dest, start, movelen);
 
 	/* fill in new entry */
 	memcpy((UBYTE *)from.direntry, to, to->next);
+	DirIndexAdd(&from, g);
 
 	/* fill in result and make block dirty */
 	*result = from;
@@ -3236,6 +3259,7 @@ static void RemoveDirEntry(struct fileinfo info, globaldata * g)
 	endofblok = (UBYTE *)&(info.dirblock->blk) + g->rootblock->reserved_blksize;
 	startofclear = endofblok - info.direntry->next;
 	clearlen = info.direntry->next;
+	DirIndexRemove(&info, -clearlen, g);
 	memmove(destofblok, startofblok, endofblok - startofblok);
 
 	/* makes info invalid!! */
@@ -3335,6 +3359,7 @@ static BOOL AddDirectoryEntry(union objectinfo *dir, struct direntry *newentry,
 	PFSUpdateNotify(blok->blk.anodenr, &entry->nlength, entry->anode, g);
 	if (blok)
 	{
+		DirIndexAdd(newinfo, g);
 		LOCK(blok);
 		MakeBlockDirty((struct cachedblock *)blok, g);
 
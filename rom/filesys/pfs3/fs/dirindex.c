@@ -0,0 +1,434 @@
+/* $Id$ */
+
+/*
+ * Directory index
+ *
+ * SearchInDir() has to compare the name with every direntry of every
+ * dirblock of a directory, which makes lookups in directories with
+ * thousands of entries expensive. A directory index hashes the
+ * international uppercase names of all entries of one directory to
+ * the dirblock and offset of their direntry.
+ *
+ * An index is built when a lookup had to read more than one dirblock,
+ * and is kept up to date by the functions changing dirblocks:
+ *
+ * - DirIndexAdd() after a direntry is copied into a dirblock
+ * - DirIndexRemove() before a direntry is shifted out or resized
+ * - DirIndexRelocate() when a dirblock gets a new blocknr (MakeBlockDirty)
+ * - DiscardDirIndex() when the directory is deleted
+ *
+ * Only the blocknr and offset are stored, so cached dirblocks can be
+ * flushed as before. The indexes of a volume share DIRINDEX_MEMORY; if
+ * that is exhausted the least recently used index is discarded. If an
+ * index turns out to be inconsistent it is discarded as well, which
+ * just means falling back to scanning the directory.
+ */
+
+#define __USE_SYSBASE
+
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <exec/lists.h>
+#include <dos/filehandler.h>
+#include <clib/alib_protos.h>
+#include "debug.h"
+
+#include "blocks.h"
+#include "struct.h"
+#include "dirindex_protos.h"
+#include "directory_protos.h"
+#include "anodes_protos.h"
+#include "ass_protos.h"
+
+/*
+ * prototypes
+ */
+
+static ULONG HashName(UBYTE *name, BOOL upper);
+static struct dirindex *FindDirIndex(struct volumedata *volume, ULONG anodenr);
+static struct dirindexentry *FindEntry(struct dirindex *di, ULONG hash, ULONG blocknr, UWORD offset);
+static BOOL ReserveMem(struct volumedata *volume, struct dirindex *di, ULONG size, globaldata *g);
+static BOOL AddEntry(struct volumedata *volume, struct dirindex *di, struct cdirblock *blk, struct direntry *de, globaldata *g);
+static void GrowTable(struct volumedata *volume, struct dirindex *di, globaldata *g);
+static void FreeDirIndex(struct volumedata *volume, struct dirindex *di, globaldata *g);
+
+#define ENTRYOFFSET(blk, de) ((UWORD)((UBYTE *)(de) - (blk)->blk.entries))
+
+/*
+ * Hash a dstr. If upper is FALSE the name is hashed as if it were
+ * international uppercase (see intltoupper)
+ */
+static ULONG HashName(UBYTE *name, BOOL upper)
+{
+  UBYTE len = *name++, c;
+  ULONG hash = len;
+
+	while (len--)
+	{
+		c = *name++;
+		if (!upper && ((c >= 0x61 && c <= 0x7a) ||
+			(c >= 0xe0 && c <= 0xf6) || (c >= 0xf8 && c <= 0xfe)))
+			c -= 0x20;
+
+		hash = hash * 31 + c;
+	}
+
+	return hash;
+}
+
+static struct dirindex *FindDirIndex(struct volumedata *volume, ULONG anodenr)
+{
+  struct dirindex *di;
+
+	for (di = HeadOf(&volume->dirindexes); di->next; di = di->next)
+		if (di->anodenr == anodenr)
+			return di;
+
+	return NULL;
+}
+
+static struct dirindexentry *FindEntry(struct dirindex *di, ULONG hash, ULONG blocknr, UWORD offset)
+{
+  struct dirindexentry *ie;
+
+	for (ie = di->table[hash & di->hashmask]; ie; ie = ie->next)
+		if (ie->hash == hash && ie->blocknr == blocknr && ie->offset == offset)
+			break;
+
+	return ie;
+}
+
+/*
+ * Account for size bytes more memory for index di, discarding least
+ * recently used other indexes if necessary.
+ */
+static BOOL ReserveMem(struct volumedata *volume, struct dirindex *di, ULONG size, globaldata *g)
+{
+  struct dirindex *lru;
+
+	while (volume->dirindexmem + size > DIRINDEX_MEMORY)
+	{
+		lru = (struct dirindex *)volume->dirindexes.mlh_TailPred;
+		if (lru == di)
+			return FALSE;
+
+		FreeDirIndex(volume, lru, g);
+	}
+
+	volume->dirindexmem += size;
+	di->memsize += size;
+	return TRUE;
+}
+
+static BOOL AddEntry(struct volumedata *volume, struct dirindex *di, struct cdirblock *blk,
+	struct direntry *de, globaldata *g)
+{
+  struct dirindexentry *ie, **chain;
+
+	if (!ReserveMem(volume, di, sizeof(struct dirindexentry) + sizeof(ULONG), g))
+		return FALSE;
+
+	if (!(ie = AllocMemP(sizeof(struct dirindexentry), g)))
+	{
+		volume->dirindexmem -= sizeof(struct dirindexentry) + sizeof(ULONG);
+		di->memsize -= sizeof(struct dirindexentry) + sizeof(ULONG);
+		return FALSE;
+	}
+
+	ie->hash = HashName(DIRENTRYNAME(de), FALSE);
+	ie->blocknr = blk->blocknr;
+	ie->offset = ENTRYOFFSET(blk, de);
+	chain = &di->table[ie->hash & di->hashmask];
+	ie->next = *chain;
+	*chain = ie;
+
+	if (++di->numentries > 2 * (di->hashmask + 1))
+		GrowTable(volume, di, g);
+
+	return TRUE;
+}
+
+/*
+ * Double the hash table. Not being able to is no problem, the chains
+ * just get longer
+ */
+static void GrowTable(struct volumedata *volume, struct dirindex *di, globaldata *g)
+{
+  struct dirindexentry **table, *ie, *next;
+  ULONG i, size, newmask = 2 * di->hashmask + 1;
+
+	size = (newmask + 1) * sizeof(struct dirindexentry *);
+	if (!ReserveMem(volume, di, size + sizeof(ULONG), g))
+		return;
+
+	if (!(table = AllocMemP(size, g)))
+	{
+		volume->dirindexmem -= size + sizeof(ULONG);
+		di->memsize -= size + sizeof(ULONG);
+		return;
+	}
+
+	memset(table, 0, size);
+	for (i = 0; i <= di->hashmask; i++)
+	{
+		for (ie = di->table[i]; ie; ie = next)
+		{
+			next = ie->next;
+			ie->next = table[ie->hash & newmask];
+			table[ie->hash & newmask] = ie;
+		}
+	}
+
+	size = (di->hashmask + 1) * sizeof(struct dirindexentry *);
+	FreeMemP(di->table, g);
+	volume->dirindexmem -= size + sizeof(ULONG);
+	di->memsize -= size + sizeof(ULONG);
+
+	di->table = table;
+	di->hashmask = newmask;
+}
+
+static void FreeDirIndex(struct volumedata *volume, struct dirindex *di, globaldata *g)
+{
+  struct dirindexentry *ie, *next;
+  ULONG i;
+
+	DB(Trace(1, "FreeDirIndex", "anodenr %lx\n", di->anodenr));
+	for (i = 0; i <= di->hashmask; i++)
+	{
+		for (ie = di->table[i]; ie; ie = next)
+		{
+			next = ie->next;
+			FreeMemP(ie, g);
+		}
+	}
+
+	MinRemove(di);
+	volume->dirindexmem -= di->memsize;
+	FreeMemP(di->table, g);
+	FreeMemP(di, g);
+}
+
+/*
+ * Build the index of directory 'dirnodenr' on the current volume.
+ * Failing (out of memory, index too large) is silent.
+ */
+void BuildDirIndex(ULONG dirnodenr, globaldata *g)
+{
+  struct volumedata *volume = g->currentvolume;
+  struct dirindex *di;
+  struct canode anode;
+  struct cdirblock *blk;
+  struct direntry *de;
+  ULONG anodeoffset = 0, size;
+
+	if (dirnodenr == volume->dirindexskip || FindDirIndex(volume, dirnodenr))
+		return;
+
+	if (!(di = AllocMemP(sizeof(struct dirindex), g)))
+		return;
+
+	size = DIRINDEX_MINHASH * sizeof(struct dirindexentry *);
+	if (!(di->table = AllocMemP(size, g)))
+	{
+		FreeMemP(di, g);
+		return;
+	}
+
+	memset(di->table, 0, size);
+	di->anodenr = dirnodenr;
+	di->numentries = 0;
+	di->memsize = 0;
+	di->hashmask = DIRINDEX_MINHASH - 1;
+	MinAddHead(&volume->dirindexes, di);
+
+	if (!ReserveMem(volume, di, sizeof(struct dirindex) + size + 2 * sizeof(ULONG), g))
+		goto toolarge;
+
+	GetAnode(&anode, dirnodenr, g);
+	do
+	{
+		if (!(blk = LoadDirBlock(anode.blocknr + anodeoffset, g)))
+			goto fail;
+
+		for (de = FIRSTENTRY(blk); de->next; de = NEXTENTRY(de))
+			if (!AddEntry(volume, di, blk, de, g))
+				goto toolarge;
+	} while (NextBlock(&anode, &anodeoffset, g));
+
+	DB(Trace(1, "BuildDirIndex", "anodenr %lx: %ld entries, %ld bytes\n",
+		dirnodenr, di->numentries, di->memsize));
+	return;
+
+  toolarge:
+	/* don't try again on every lookup */
+	volume->dirindexskip = dirnodenr;
+
+  fail:
+	FreeDirIndex(volume, di, g);
+}
+
+/*
+ * Look up 'name' (international uppercase dstr) in the index of
+ * directory 'dirnodenr'. Returns DI_NOINDEX if there is no (usable)
+ * index, DI_NOTFOUND if the directory doesn't contain the name and
+ * DI_FOUND if it does. In that case info is filled in and the dirblock
+ * locked, like SearchInDir() does.
+ */
+int DirIndexLookup(ULONG dirnodenr, UBYTE *name, union objectinfo *info, globaldata *g)
+{
+  struct volumedata *volume = g->currentvolume;
+  struct dirindex *di;
+  struct dirindexentry *ie;
+  struct cdirblock *blk;
+  struct direntry *de;
+  ULONG hash;
+
+	if (!(di = FindDirIndex(volume, dirnodenr)))
+		return DI_NOINDEX;
+
+	/* most recently used first */
+	if ((struct dirindex *)HeadOf(&volume->dirindexes) != di)
+	{
+		MinRemove(di);
+		MinAddHead(&volume->dirindexes, di);
+	}
+
+	hash = HashName(name, TRUE);
+	for (ie = di->table[hash & di->hashmask]; ie; ie = ie->next)
+	{
+		if (ie->hash != hash)
+			continue;
+
+		blk = LoadDirBlock(ie->blocknr, g);
+		if (!blk || blk->blk.anodenr != dirnodenr || ie->offset >= DB_ENTRYSPACE)
+			break;
+
+		de = (struct direntry *)(blk->blk.entries + ie->offset);
+		if (!de->next)
+			break;
+
+		if (intlcmp(name, DIRENTRYNAME(de)))
+		{
+			info->file.direntry = de;
+			info->file.dirblock = blk;
+			LOCK(blk);
+			return DI_FOUND;
+		}
+	}
+
+	if (!ie)
+		return DI_NOTFOUND;
+
+	DB(Trace(1, "DirIndexLookup", "index of %lx inconsistent\n", dirnodenr));
+	FreeDirIndex(volume, di, g);
+	return DI_NOINDEX;
+}
+
+/*
+ * Direntry 'fi' has been put in its dirblock
+ */
+void DirIndexAdd(struct fileinfo *fi, globaldata *g)
+{
+  struct volumedata *volume = fi->dirblock->volume;
+  struct dirindex *di;
+
+	if ((di = FindDirIndex(volume, fi->dirblock->blk.anodenr)))
+		if (!AddEntry(volume, di, fi->dirblock, fi->direntry, g))
+			FreeDirIndex(volume, di, g);
+}
+
+/*
+ * Direntry 'fi' is going to be removed from its dirblock, and the
+ * direntries following it will move by 'diff' bytes
+ */
+void DirIndexRemove(struct fileinfo *fi, int diff, globaldata *g)
+{
+  struct volumedata *volume = fi->dirblock->volume;
+  struct dirindex *di;
+  struct dirindexentry *ie, **chain;
+  struct direntry *de;
+  ULONG hash, blocknr = fi->dirblock->blocknr;
+
+	if (!(di = FindDirIndex(volume, fi->dirblock->blk.anodenr)))
+		return;
+
+	hash = HashName(DIRENTRYNAME(fi->direntry), FALSE);
+	chain = &di->table[hash & di->hashmask];
+	while ((ie = *chain))
+	{
+		if (ie->hash == hash && ie->blocknr == blocknr &&
+			ie->offset == ENTRYOFFSET(fi->dirblock, fi->direntry))
+			break;
+		chain = &ie->next;
+	}
+
+	if (!ie)
+		goto inconsistent;
+
+	*chain = ie->next;
+	FreeMemP(ie, g);
+	di->numentries--;
+	volume->dirindexmem -= sizeof(struct dirindexentry) + sizeof(ULONG);
+	di->memsize -= sizeof(struct dirindexentry) + sizeof(ULONG);
+
+	if (diff)
+	{
+		for (de = NEXTENTRY(fi->direntry); de->next; de = NEXTENTRY(de))
+		{
+			ie = FindEntry(di, HashName(DIRENTRYNAME(de), FALSE), blocknr,
+				ENTRYOFFSET(fi->dirblock, de));
+			if (!ie)
+				goto inconsistent;
+
+			ie->offset += diff;
+		}
+	}
+	return;
+
+  inconsistent:
+	DB(Trace(1, "DirIndexRemove", "index of %lx inconsistent\n", di->anodenr));
+	FreeDirIndex(volume, di, g);
+}
+
+/*
+ * Dirblock 'blk' has moved from 'oldblocknr' to blk->blocknr
+ */
+void DirIndexRelocate(struct cdirblock *blk, ULONG oldblocknr, globaldata *g)
+{
+  struct dirindex *di;
+  struct dirindexentry *ie;
+  struct direntry *de;
+
+	if (!(di = FindDirIndex(blk->volume, blk->blk.anodenr)))
+		return;
+
+	for (de = FIRSTENTRY(blk); de->next; de = NEXTENTRY(de))
+	{
+		ie = FindEntry(di, HashName(DIRENTRYNAME(de), FALSE), oldblocknr, ENTRYOFFSET(blk, de));
+		if (!ie)
+		{
+			FreeDirIndex(blk->volume, di, g);
+			return;
+		}
+
+		ie->blocknr = blk->blocknr;
+	}
+}
+
+/*
+ * Directory 'anodenr' has been deleted
+ */
+void DiscardDirIndex(ULONG anodenr, globaldata *g)
+{
+  struct dirindex *di;
+
+	if ((di = FindDirIndex(g->currentvolume, anodenr)))
+		FreeDirIndex(g->currentvolume, di, g);
+}
+
+void FreeDirIndexes(struct volumedata *volume, globaldata *g)
+{
+	while (!IsMinListEmpty(&volume->dirindexes))
+		FreeDirIndex(volume, HeadOf(&volume->dirindexes), g);
+}
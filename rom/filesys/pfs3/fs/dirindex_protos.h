@@ -0,0 +1,11 @@
+/* Prototypes for functions defined in
+dirindex.c
+ */
+
+void BuildDirIndex(ULONG dirnodenr, globaldata *g);
+int DirIndexLookup(ULONG dirnodenr, UBYTE *name, union objectinfo *info, globaldata *g);
+void DirIndexAdd(struct fileinfo *fi, globaldata *g);
+void DirIndexRemove(struct fileinfo *fi, int diff, globaldata *g);
+void DirIndexRelocate(struct cdirblock *blk, ULONG oldblocknr, globaldata *g);
+void DiscardDirIndex(ULONG anodenr, globaldata *g);
+void FreeDirIndexes(struct volumedata *volume, globaldata *g);
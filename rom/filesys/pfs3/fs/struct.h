@@ -433,6 +433,42 @@ struct anodechain
 /* number of reserved anodes per anodeblock */
 #define RESERVEDANODES 6
 
+/*****************************************************************************/
+/* Directory index                                                           */
+/*****************************************************************************/
+
+/* memory all directory indexes of a volume may use */
+#ifndef DIRINDEX_MEMORY
+#define DIRINDEX_MEMORY (512*1024)
+#endif
+
+/* hash table size of a new index (must be power of 2) */
+#define DIRINDEX_MINHASH 64
+
+/* results of DirIndexLookup() */
+#define DI_NOINDEX 0
+#define DI_FOUND 1
+#define DI_NOTFOUND 2
+
+struct dirindexentry
+{
+	struct dirindexentry *next;     /* hash chain                           */
+	ULONG hash;                     /* hash of international uppercase name */
+	ULONG blocknr;                  /* dirblock containing the direntry     */
+	UWORD offset;                   /* of direntry in dirblock entries      */
+};
+
+struct dirindex
+{
+	struct dirindex *next;          /* volume list, most recently used first */
+	struct dirindex *prev;
+	ULONG anodenr;                  /* anodenr of the directory             */
+	ULONG numentries;
+	ULONG memsize;                  /* memory used by index and entries     */
+	ULONG hashmask;
+	struct dirindexentry **table;
+};
+
 /*****************************************************************************/
 /* LRU data                                                                  */
 /*****************************************************************************/
@@ -682,6 +718,9 @@ struct volumedata
 	struct MinList bmindexblks;         /* cached bitmap index blocks           */
 	struct MinList anodechainlist;      /* list of cached anodechains           */
 	struct MinList notifylist;          /* list of notifications                */
+	struct MinList dirindexes;          /* directory indexes, see dirindex.c    */
+	ULONG   dirindexmem;                /* memory used by directory indexes     */
+	ULONG   dirindexskip;               /* last directory too large to index    */
 
 	BOOL    rootblockchangeflag;        /* indicates if rootblock dirty         */
 	WORD    numsofterrors;              /* number of soft errors on this disk   */
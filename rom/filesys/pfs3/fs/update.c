@@ -125,6 +125,7 @@
 #include "lru_protos.h"
 #include "ass_protos.h"
 #include "init_protos.h"
+#include "dirindex_protos.h"
 
 /*
  * prototypes
@@ -659,6 +660,7 @@ static void UpdateDBLK (struct cachedblock *blk, ULONG newblocknr, globaldata *g
 	SaveAnode(&anode, anode.nr, g);
 
 	ReHash(blk, g->currentvolume->dirblks, HASHM_DIR);
+	DirIndexRelocate(dblk, oldblocknr, g);
 }
 
 static void UpdateABLK (struct cachedblock *blk, ULONG newblocknr, globaldata *g)
@@ -591,8 +591,10 @@ struct volumedata *MakeVolumeData (struct rootblock *rootblock, globaldata *g)
 	volume->rootblockchangeflag = FALSE;
 
 	/* lijsten initieren */
-	for (list = &volume->fileentries; list <= &volume->notifylist; list++)
+	for (list = &volume->fileentries; list <= &volume->dirindexes; list++)
 		NewList((struct List *)list);
+	volume->dirindexmem = 0;
+	volume->dirindexskip = 0;
 
 	/* andere gegevens invullen */
 	volume->numsofterrors   = 0;
@@ -719,6 +721,8 @@ void FreeUnusedResources(struct volumedata *volume, globaldata *g)
 			node = next;
 		}
 	}
+
+	FreeDirIndexes(volume, g);
 }
 
 
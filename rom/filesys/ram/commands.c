@@ -126,6 +126,18 @@ BOOL CmdStartup(struct Handler *handler, STRPTR name, struct DeviceNode *dev_nod
       if(handler->public_pool == NULL)
          error = IoErr();
 
+      /* Create the table for looking up objects by name */
+
+      if(error == 0)
+      {
+         handler->name_hash = AllocPooled(handler->clear_pool,
+            MIN_HASH_SIZE * sizeof(APTR));
+         handler->hash_size = MIN_HASH_SIZE;
+         handler->block_count += MEMBLOCKS(MIN_HASH_SIZE * sizeof(APTR));
+         if(handler->name_hash == NULL)
+            error = ERROR_NO_FREE_STORE;
+      }
+
       /* Create a volume dos node */
 
       volume = MyMakeDosEntry(handler, default_vol_name, DLT_VOLUME);
@@ -679,7 +691,7 @@ UPINT CmdSeek(struct Handler *handler, struct Opening *opening, PINT offset, LON
 {
    struct Block *block;
    struct Object *file;
-   UPINT block_pos, block_length, remainder, old_pos, new_pos;
+   UPINT block_pos, old_pos, new_pos;
 
    /* Get starting point */
 
@@ -687,22 +699,11 @@ UPINT CmdSeek(struct Handler *handler, struct Opening *opening, PINT offset, LON
    old_pos = opening->pos;
 
    if(mode == OFFSET_BEGINNING)
-   {
-      block = (APTR)file->elements.mlh_Head;
-      new_pos = block_pos = 0;
-   }
+      new_pos = 0;
    else if(mode == OFFSET_CURRENT)
-   {
-      block = opening->block;
-      block_pos = opening->block_pos;
       new_pos = old_pos;
-   }
    else
-   {
-      block = (APTR)file->elements.mlh_TailPred;
-      block_pos = file->end_length;
       new_pos = file->length;
-   }
 
    /* Check new position is within file */
 
@@ -713,36 +714,9 @@ UPINT CmdSeek(struct Handler *handler, struct Opening *opening, PINT offset, LON
       return -1;
    }
 
-   if(offset >= 0)
-   {
-      /* Go forwards */
+   /* Look up the block in the file's extent index */
 
-      block_length = GetBlockLength(file, block);
-      remainder = offset + block_pos;
-      while(remainder > block_length)
-      {
-         remainder -= block_length;
-         block = (APTR)((struct MinNode *)block)->mln_Succ;
-         block_length = GetBlockLength(file, block);
-      }
-
-      block_pos = remainder;
-   }
-   else
-   {
-      /* Go backwards */
-
-      block_length = block_pos;
-      remainder = -offset;
-      while(remainder >= block_length && remainder > 0)
-      {
-         remainder -= block_length;
-         block = (APTR)((struct MinNode *)block)->mln_Pred;
-         block_length = GetBlockLength(file, block);
-      }
-
-      block_pos = block_length - remainder;
-   }
+   block = GetBlock(file, new_pos, &block_pos);
 
    /* Record new position for next access */
 
@@ -1831,13 +1805,10 @@ BOOL CmdRenameObject(struct Handler *handler, struct Lock *old_lock,
 
    if(error == 0)
    {
+      UnhashObject(handler, object);
       if(!SetName(handler, object, FilePart(new_name)))
          error = IoErr();
-   }
-
-   if(error == 0)
-   {
-      if(object->parent != parent)
+      else if(object->parent != parent)
       {
          /* Remove object from old parent and place it in new parent */
 
@@ -1846,7 +1817,11 @@ BOOL CmdRenameObject(struct Handler *handler, struct Lock *old_lock,
          object->parent = parent;
          AdjustExaminations(handler, object);
       }
+      HashObject(handler, object);
+   }
 
+   if(error == 0)
+   {
       if(object != duplicate)
       {
          /* Update notifications */
@@ -30,6 +30,11 @@ static struct Block *AddDataBlock(struct Handler *handler,
 static VOID FreeDataBlock(struct Handler *handler, struct Object *file,
    struct Block *block);
 static struct Block *GetLastBlock(struct Object *file);
+static BOOL AddExtent(struct Handler *handler, struct Object *file,
+   struct Block *block);
+static ULONG HashName(struct Handler *handler, struct Object *parent,
+   const TEXT *name);
+static VOID ResizeHash(struct Handler *handler, UPINT size);
 
 
 
@@ -190,6 +195,7 @@ struct Object *CreateObject(struct Handler *handler, const TEXT *name,
       if(parent != NULL)
       {
          AddTail((struct List *)&parent->elements, (struct Node *)object);
+         HashObject(handler, object);
          CopyMem(&object->date, &parent->date, sizeof(struct DateStamp));
       }
    }
@@ -329,7 +335,10 @@ VOID DeleteObject(struct Handler *handler, struct Object *object)
       /* Remove the object from its directory */
 
       if(object->parent != NULL)
+      {
+         UnhashObject(handler, object);
          Remove((struct Node *)object);
+      }
 
       /* Delete a hard link */
 
@@ -362,6 +371,7 @@ VOID DeleteObject(struct Handler *handler, struct Object *object)
       {
          master_link = HARDLINK(node);
          heir = HARDLINK(RemTail((APTR)&master_link->elements));
+         UnhashObject(handler, heir);
 
          /* Swap names and comments */
 
@@ -375,6 +385,7 @@ VOID DeleteObject(struct Handler *handler, struct Object *object)
 
          object->parent = heir->parent;
          AddTail((APTR)&object->parent->elements, (APTR)object);
+         HashObject(handler, object);
 
          if(heir == master_link)
          {
@@ -401,6 +412,10 @@ VOID DeleteObject(struct Handler *handler, struct Object *object)
                FreePooled(handler->muddy_pool, block,
                   sizeof(struct Block) + block->length);
          }
+
+         if(object->extents != NULL)
+            FreePooled(handler->muddy_pool, object->extents,
+               object->extent_space * sizeof(struct Extent));
       }
 
       /* Free object's memory */
@@ -537,8 +552,7 @@ struct Object *GetObject(struct Handler *handler, struct Lock *lock,
          {
             old_object = object;
             object = GetRealObject(object);
-            object = (struct Object *)
-               FindNameNoCase(handler, (struct List *)&object->elements, buffer);
+            object = FindObject(handler, object, buffer);
             if(object != NULL)
             {
                /* Check for and handle a soft link */
@@ -670,7 +684,7 @@ PINT ChangeFileSize(struct Handler *handler, struct Opening *opening,
       /* Add the required number of data bytes */
 
       remainder = new_length - full_length;
-      end_length -= remainder;
+      end_length += new_length - length;
 
       while(remainder > 0)
       {
@@ -704,6 +718,7 @@ PINT ChangeFileSize(struct Handler *handler, struct Opening *opening,
       {
          FreeDataBlock(handler, file, block);
          block = (APTR)RemTail((APTR)&file->elements);
+         file->extent_count--;
          full_length -= block->length;
       }
       end_block = (APTR)file->elements.mlh_TailPred;
@@ -722,7 +737,12 @@ PINT ChangeFileSize(struct Handler *handler, struct Opening *opening,
          FreeDataBlock(handler, file, block);
       }
       else
+      {
+         /* Can't fail: the index still has space for the block */
+
          AddTail((struct List *)&file->elements, (APTR)block);
+         AddExtent(handler, file, block);
+      }
    }
 
    /* Store new file size */
@@ -1303,15 +1323,24 @@ static struct Block *AddDataBlock(struct Handler *handler,
          alloc_size >>= 1;
    }
 
-   /* Add the block to the end of the file */
+   /* Add the block to the end of the file and its index */
 
    if(block != NULL)
    {
-      AddTail((struct List *)&file->elements, (struct Node *)block);
       block->length = alloc_size - sizeof(struct Block);
-      file->block_count += alloc_size >> MEM_BLOCKSHIFT;
+      if(AddExtent(handler, file, block))
+      {
+         AddTail((struct List *)&file->elements, (struct Node *)block);
+         file->block_count += alloc_size >> MEM_BLOCKSHIFT;
+      }
+      else
+      {
+         FreePooled(handler->muddy_pool, block, alloc_size);
+         block = NULL;
+      }
    }
-   else
+
+   if(block == NULL)
       SetIoErr(ERROR_DISK_FULL);
 
    /* Return the new block */
@@ -1500,3 +1529,408 @@ static struct Block *GetLastBlock(struct Object *file)
 
 
 
+/****i* ram.handler/GetBlock ***********************************************
+*
+*   NAME
+*	GetBlock -- Find the block holding a file position.
+*
+*   SYNOPSIS
+*	block = GetBlock(file, pos, block_pos)
+*
+*	struct Block *GetBlock(struct Object *, UPINT, UPINT *);
+*
+*   FUNCTION
+*	Looks up the block and offset within it for a file position using
+*	the file's extent index. As elsewhere, a position at a block
+*	boundary is placed at the end of the earlier block, and position
+*	zero is in the empty start block.
+*
+*   INPUTS
+*
+*   RESULT
+*
+*   EXAMPLE
+*
+*   NOTES
+*
+*   BUGS
+*
+*   SEE ALSO
+*
+****************************************************************************
+*
+*/
+
+struct Block *GetBlock(struct Object *file, UPINT pos, UPINT *block_pos)
+{
+   struct Extent *extents;
+   UPINT low = 0, high, mid;
+
+   extents = file->extents;
+   high = file->extent_count;
+
+   if(pos == 0 || high == 0)
+   {
+      *block_pos = 0;
+      return &file->start_block;
+   }
+
+   /* Find the last block that starts before the position */
+
+   while(high - low > 1)
+   {
+      mid = (low + high) / 2;
+      if(extents[mid].offset < pos)
+         low = mid;
+      else
+         high = mid;
+   }
+
+   *block_pos = pos - extents[low].offset;
+   return extents[low].block;
+}
+
+
+
+/****i* ram.handler/AddExtent **********************************************
+*
+*   NAME
+*	AddExtent --
+*
+*   SYNOPSIS
+*	success = AddExtent(handler, file, block)
+*
+*	BOOL AddExtent(struct Handler *, struct Object *, struct Block *);
+*
+*   FUNCTION
+*	Appends a block to the end of a file's extent index. The index is
+*	grown by doubling when full.
+*
+*   INPUTS
+*
+*   RESULT
+*
+*   EXAMPLE
+*
+*   NOTES
+*
+*   BUGS
+*
+*   SEE ALSO
+*
+****************************************************************************
+*
+*/
+
+static BOOL AddExtent(struct Handler *handler, struct Object *file,
+   struct Block *block)
+{
+   struct Extent *extents, *last;
+   UPINT space, count;
+
+   count = file->extent_count;
+   space = file->extent_space;
+
+   if(count == space)
+   {
+      space = (space == 0) ? MIN_EXTENT_SPACE : space * 2;
+      extents = AllocPooled(handler->muddy_pool,
+         space * sizeof(struct Extent));
+      if(extents == NULL)
+         return FALSE;
+
+      if(file->extents != NULL)
+      {
+         CopyMem(file->extents, extents, count * sizeof(struct Extent));
+         FreePooled(handler->muddy_pool, file->extents,
+            file->extent_space * sizeof(struct Extent));
+      }
+      file->block_count += MEMBLOCKS(space * sizeof(struct Extent))
+         - MEMBLOCKS(file->extent_space * sizeof(struct Extent));
+      file->extents = extents;
+      file->extent_space = space;
+   }
+
+   extents = file->extents;
+   extents[count].block = block;
+   if(count == 0)
+      extents[count].offset = 0;
+   else
+   {
+      last = &extents[count - 1];
+      extents[count].offset = last->offset + last->block->length;
+   }
+   file->extent_count = count + 1;
+
+   return TRUE;
+}
+
+
+
+/****i* ram.handler/FindObject *********************************************
+*
+*   NAME
+*	FindObject -- Find an object in a directory by name.
+*
+*   SYNOPSIS
+*	object = FindObject(handler, dir, name)
+*
+*	struct Object *FindObject(struct Handler *, struct Object *, TEXT *);
+*
+*   FUNCTION
+*	Looks up a directory entry through the name hash. The name is
+*	compared case-insensitively.
+*
+*   INPUTS
+*
+*   RESULT
+*
+*   EXAMPLE
+*
+*   NOTES
+*
+*   BUGS
+*
+*   SEE ALSO
+*
+****************************************************************************
+*
+*/
+
+struct Object *FindObject(struct Handler *handler, struct Object *dir,
+   const TEXT *name)
+{
+   struct Object *object;
+   ULONG hash;
+
+   hash = HashName(handler, dir, name);
+   object = handler->name_hash[hash & (handler->hash_size - 1)];
+
+   while(object != NULL && (object->hash_value != hash
+      || object->parent != dir
+      || Stricmp(name, ((struct Node *)object)->ln_Name) != 0))
+      object = object->hash_next;
+
+   return object;
+}
+
+
+
+/****i* ram.handler/HashObject *********************************************
+*
+*   NAME
+*	HashObject -- Add an object to the name hash.
+*
+*   SYNOPSIS
+*	HashObject(handler, object)
+*
+*	VOID HashObject(struct Handler *, struct Object *);
+*
+*   FUNCTION
+*	Makes an object findable by FindObject() under its current name and
+*	parent. Objects without a name or parent are ignored. The hash is
+*	doubled in size when it holds as many objects as it has chains.
+*
+*   INPUTS
+*
+*   RESULT
+*
+*   EXAMPLE
+*
+*   NOTES
+*	The object must be removed with UnhashObject() before it is renamed
+*	or moved to another directory.
+*
+*   BUGS
+*
+*   SEE ALSO
+*
+****************************************************************************
+*
+*/
+
+VOID HashObject(struct Handler *handler, struct Object *object)
+{
+   struct Object **chain;
+   TEXT *name;
+
+   name = ((struct Node *)object)->ln_Name;
+   if(object->parent == NULL || name == NULL)
+      return;
+
+   if(handler->hash_count >= handler->hash_size)
+      ResizeHash(handler, handler->hash_size * 2);
+
+   object->hash_value = HashName(handler, object->parent, name);
+   chain = &handler->name_hash[object->hash_value
+      & (handler->hash_size - 1)];
+   object->hash_next = *chain;
+   *chain = object;
+   handler->hash_count++;
+
+   return;
+}
+
+
+
+/****i* ram.handler/UnhashObject *******************************************
+*
+*   NAME
+*	UnhashObject -- Remove an object from the name hash.
+*
+*   SYNOPSIS
+*	UnhashObject(handler, object)
+*
+*	VOID UnhashObject(struct Handler *, struct Object *);
+*
+*   FUNCTION
+*	Nothing is done if the object isn't in the hash.
+*
+*   INPUTS
+*
+*   RESULT
+*
+*   EXAMPLE
+*
+*   NOTES
+*
+*   BUGS
+*
+*   SEE ALSO
+*
+****************************************************************************
+*
+*/
+
+VOID UnhashObject(struct Handler *handler, struct Object *object)
+{
+   struct Object **chain;
+
+   chain = &handler->name_hash[object->hash_value
+      & (handler->hash_size - 1)];
+
+   while(*chain != NULL && *chain != object)
+      chain = &(*chain)->hash_next;
+
+   if(*chain != NULL)
+   {
+      *chain = object->hash_next;
+      object->hash_next = NULL;
+      handler->hash_count--;
+   }
+
+   return;
+}
+
+
+
+/****i* ram.handler/ResizeHash *********************************************
+*
+*   NAME
+*	ResizeHash --
+*
+*   SYNOPSIS
+*	ResizeHash(handler, size)
+*
+*	VOID ResizeHash(struct Handler *, UPINT);
+*
+*   FUNCTION
+*	Moves all hashed objects to a new table with the given number of
+*	chains, which must be a power of two. The old table is kept if
+*	there isn't enough memory.
+*
+*   INPUTS
+*
+*   RESULT
+*
+*   EXAMPLE
+*
+*   NOTES
+*
+*   BUGS
+*
+*   SEE ALSO
+*
+****************************************************************************
+*
+*/
+
+static VOID ResizeHash(struct Handler *handler, UPINT size)
+{
+   struct Object **table, *object, *next_object, **chain;
+   UPINT i;
+
+   table = AllocPooled(handler->clear_pool, size * sizeof(APTR));
+   if(table == NULL)
+      return;
+
+   for(i = 0; i < handler->hash_size; i++)
+   {
+      for(object = handler->name_hash[i]; object != NULL;
+         object = next_object)
+      {
+         next_object = object->hash_next;
+         chain = &table[object->hash_value & (size - 1)];
+         object->hash_next = *chain;
+         *chain = object;
+      }
+   }
+
+   FreePooled(handler->clear_pool, handler->name_hash,
+      handler->hash_size * sizeof(APTR));
+
+   handler->block_count += MEMBLOCKS(size * sizeof(APTR))
+      - MEMBLOCKS(handler->hash_size * sizeof(APTR));
+   handler->name_hash = table;
+   handler->hash_size = size;
+
+   return;
+}
+
+
+
+/****i* ram.handler/HashName ***********************************************
+*
+*   NAME
+*	HashName --
+*
+*   SYNOPSIS
+*	hash = HashName(handler, parent, name)
+*
+*	ULONG HashName(struct Handler *, struct Object *, TEXT *);
+*
+*   FUNCTION
+*	Hashes a name case-insensitively in the same way Stricmp() compares
+*	it, together with the directory it is in.
+*
+*   INPUTS
+*
+*   RESULT
+*
+*   EXAMPLE
+*
+*   NOTES
+*
+*   BUGS
+*
+*   SEE ALSO
+*
+****************************************************************************
+*
+*/
+
+static ULONG HashName(struct Handler *handler, struct Object *parent,
+   const TEXT *name)
+{
+   ULONG hash;
+   TEXT ch;
+
+   hash = (ULONG)((UPINT)parent >> MEM_BLOCKSHIFT);
+   while((ch = *name++) != '\0')
+      hash = hash * 31 + ToLower(ch);
+
+   return hash;
+}
+
+
+
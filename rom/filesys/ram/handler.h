@@ -73,6 +73,8 @@ typedef LONG PINT;
 #define MUDDY_PUDDLE_THRESH (8 * 1024)
 #define PUBLIC_PUDDLE_SIZE (4 * 1024)
 #define PUBLIC_PUDDLE_THRESH (2 * 1024)
+#define MIN_EXTENT_SPACE 16
+#define MIN_HASH_SIZE 64
 #define DOS_VERSION 39
 #define UTILITY_VERSION 37
 #define LOCALE_VERSION 38
@@ -85,6 +87,13 @@ struct Block
 };
 
 
+struct Extent
+{
+   UPINT offset;            /* file position of block's first byte */
+   struct Block *block;
+};
+
+
 struct Lock
 {
    struct FileLock lock;
@@ -109,6 +118,11 @@ struct Object
    struct MinNode hard_link;
    struct MinList notifications;
    struct Block start_block;   /* a zero-length block */
+   struct Extent *extents;  /* a file's data blocks in order */
+   UPINT extent_count;
+   UPINT extent_space;
+   struct Object *hash_next;   /* next object in same name hash chain */
+   ULONG hash_value;
 };
 #define soft_link_target comment
 
@@ -154,6 +168,9 @@ struct Handler
    APTR clear_pool;
    APTR muddy_pool;
    APTR public_pool;
+   struct Object **name_hash;  /* all named objects by parent and name */
+   UPINT hash_size;
+   UPINT hash_count;
 
    TEXT b_buffer[256];
    TEXT b_buffer2[256];
@@ -242,63 +242,6 @@ UPINT StrSize(const TEXT *s)
 
 
 
-/****i* ram.handler/FindNameNoCase *****************************************
-*
-*   NAME
-*	FindNameNoCase --
-*
-*   SYNOPSIS
-*	node = FindNameNoCase(handler, start, name)
-*
-*	struct Node *FindNameNoCase(struct Handler *handler, struct List *, TEXT *);
-*
-*   FUNCTION
-*
-*   INPUTS
-*
-*   RESULT
-*
-*   EXAMPLE
-*
-*   NOTES
-*
-*   BUGS
-*
-*   SEE ALSO
-*
-****************************************************************************
-*
-*/
-
-struct Node *FindNameNoCase(struct Handler *handler, struct List *start, const TEXT *name)
-{
-   struct Node *node, *next_node, *matching_node;
-   TEXT *node_name;
-
-   matching_node = NULL;
-   node = start->lh_Head;
-
-   while(node != NULL)
-   {
-      next_node = node->ln_Succ;
-      if(next_node != NULL)
-      {
-         node_name = node->ln_Name;
-         if(node_name != NULL)
-            if(Stricmp(name, node_name) == 0)
-            {
-               matching_node = node;
-               next_node = NULL;
-            }
-      }
-      node = next_node;
-   }
-
-   return matching_node;
-}
-
-
-
 /****i* ram.handler/MyMakeDosEntry *****************************************
 *
 *   NAME
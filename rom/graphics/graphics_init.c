@@ -95,6 +95,7 @@ static int GfxInit(struct GfxBase *LIBBASE)
     }
 
     NEWLIST(&PrivGBase(GfxBase)->ChunkPoolList);
+    PrivGBase(GfxBase)->SpareChunkPool = NULL;
 #endif
 
     D(bug("[graphics.library] %s: Initialise ROMFont...\n", __func__));
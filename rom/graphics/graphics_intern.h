@@ -196,6 +196,7 @@ struct GfxBase_intern
     struct SignalSemaphore  	regionsem;
     APTR    	    	    	regionpool;
     struct MinList              ChunkPoolList;
+    struct ChunkPool           *SpareChunkPool;	     /* Empty pool kept for reuse */
 #endif
 
     /* Semaphores */
@@ -88,6 +88,11 @@ static inline struct RegionRectangleExtChunk *__NewRegionRectangleExtChunk
 
     REMOVE(ChunkE);
 
+    if (Pool == PrivGBase(GfxBase)->SpareChunkPool)
+    {
+        PrivGBase(GfxBase)->SpareChunkPool = NULL;
+    }
+
     if (!--Pool->NumChunkFree)
     {
         REMOVE(Pool);
@@ -114,12 +119,21 @@ void __DisposeRegionRectangleExtChunk
 
     REMOVE(Pool);
 
-    if (++Pool->NumChunkFree == SIZECHUNKBUF)
+    /*
+       Keep one empty pool around, so that a region which is repeatedly
+       built and disposed of doesn't allocate and free a whole pool each time.
+    */
+    if (++Pool->NumChunkFree == SIZECHUNKBUF && PrivGBase(GfxBase)->SpareChunkPool)
     {
         FreeMem(Pool, sizeof(struct ChunkPool));
     }
     else
     {
+        if (Pool->NumChunkFree == SIZECHUNKBUF)
+        {
+            PrivGBase(GfxBase)->SpareChunkPool = Pool;
+        }
+
 	ADDHEAD(&PrivGBase(GfxBase)->ChunkPoolList, Pool);
         ADDTAIL(&Pool->ChunkList, Chunk);
     }
@@ -388,10 +402,6 @@ if (curdst != lastdst)                                                     \
     lastdst = curdst;                                                      \
 }
 
-#if DOTEST
-#    define DEBUG 1
-#endif
-
 #if DEBUG
 void dumprect(struct Rectangle *rec)
 {
@@ -850,46 +860,3 @@ end:
 
     return res;
 }
-
-
-#if DOTEST
-
-#undef GfxBase
-#include <proto/graphics.h>
-
-
-int main(void)
-{
-    int i;
-
-    struct Region *R1 = NewRegion();
-    struct Region *R2 = NewRegion();
-
-    for (i = 0; i < 10; i++)
-    {
-        int l = i*20;
-
-	struct Rectangle r = {l, 0, l+11, 201};
-        OrRectRegion(R1, &r);
-    }
-
-    for (i = 0; i < 10; i++)
-    {
-        int u = i*20;
-
-	struct Rectangle r = {0, u, 201, u+11};
-        OrRectRegion(R2, &r);
-    }
-
-    for (i = 0; i<100000; i++)
-    {
-        XorRegionRegion(R2, R1);
-    }
-
-    DisposeRegion(R2);
-    DisposeRegion(R1);
-    return 0;
-}
-
-#endif
-
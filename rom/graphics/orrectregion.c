@@ -65,10 +65,96 @@
 
     if (Reg->RegionRectangle)
     {
-	/* Region is not empty. Do the complete algorithm. */
+	/* Region is not empty. */
     	struct Region Res;
-    	struct RegionRectangle rr;
+    	struct RegionRectangle rr, *cur, *last;
 
+	/*
+	   Is the rectangle already contained in one of the RegionRectangles?
+	   Then there's nothing to add.
+	*/
+	if (_IsRectInRect(Bounds(Reg), Rect->MinX, Rect->MinY, Rect->MaxX, Rect->MaxY))
+	{
+	    LONG x1 = Rect->MinX - MinX(Reg);
+	    LONG y1 = Rect->MinY - MinY(Reg);
+	    LONG x2 = Rect->MaxX - MinX(Reg);
+	    LONG y2 = Rect->MaxY - MinY(Reg);
+
+	    for (cur = Reg->RegionRectangle; cur && MinY(cur) <= y1; cur = cur->Next)
+	    {
+		if (_IsRectInRect(Bounds(cur), x1, y1, x2, y2))
+		    return TRUE;
+	    }
+	}
+
+	/*
+	   Does the rectangle cover the whole region? Then the region becomes
+	   the rectangle. Its first RegionRectangle is kept for it.
+	*/
+	if (_IsRectInRect(Rect, MinX(Reg), MinY(Reg), MaxX(Reg), MaxY(Reg)))
+	{
+	    cur = Reg->RegionRectangle;
+
+	    _DisposeRegionRectangleList(cur->Next, GfxBase);
+	    Chunk(cur)->Rects[SIZERECTBUF - 1].RR.Next = NULL;
+
+	    Reg->bounds = *Rect;
+
+	    MinX(cur) = 0;
+	    MinY(cur) = 0;
+	    MaxX(cur) = Rect->MaxX - Rect->MinX;
+	    MaxY(cur) = Rect->MaxY - Rect->MinY;
+
+	    return TRUE;
+	}
+
+	/*
+	   Is the rectangle below the region, like when a region is built
+	   from top to bottom? Then it becomes a new band at the end of it.
+	*/
+	if (Rect->MinY > MaxY(Reg))
+	{
+	    LONG dx = 0;
+
+	    for (last = Reg->RegionRectangle; last->Next; last = last->Next);
+
+	    if
+	    (
+		Rect->MinY == MaxY(Reg) + 1 &&
+		Rect->MinX == MinX(last) + MinX(Reg) &&
+		Rect->MaxX == MaxX(last) + MinX(Reg) &&
+		(!last->Prev || MinY(last->Prev) != MinY(last))
+	    )
+	    {
+		/* The last band is just this rectangle, stretch it */
+		cur = last;
+	    }
+	    else
+	    {
+		cur = _NewRegionRectangle(&last, GfxBase);
+		if (!cur)
+		    return FALSE;
+
+		MinX(cur) = Rect->MinX - MinX(Reg);
+		MinY(cur) = Rect->MinY - MinY(Reg);
+		MaxX(cur) = Rect->MaxX - MinX(Reg);
+	    }
+	    MaxY(cur) = Rect->MaxY - MinY(Reg);
+
+	    if (Rect->MinX < MinX(Reg))
+		dx = MinX(Reg) - Rect->MinX;
+
+	    _TranslateRegionRectangles(Reg->RegionRectangle, dx, 0);
+
+	    MinX(Reg) -= dx;
+	    if (MaxX(Reg) < Rect->MaxX)
+		MaxX(Reg) = Rect->MaxX;
+	    MaxY(Reg) = Rect->MaxY;
+
+	    return TRUE;
+	}
+
+	/* Do the complete algorithm. */
 	InitRegion(&Res);
 
 	rr.bounds = *Rect;
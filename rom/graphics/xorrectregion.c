@@ -61,7 +61,11 @@
     struct RegionRectangle rr;
 
     if (IS_RECT_EVIL(Rect)) return TRUE;
-    
+
+    /* Nothing to flip, the rectangle is simply added */
+    if (!Reg->RegionRectangle || !overlap(*Rect, Reg->bounds))
+        return OrRectRegion(Reg, Rect);
+
     InitRegion(&R);
 
     R.bounds = *Rect;
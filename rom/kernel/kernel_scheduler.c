@@ -15,6 +15,7 @@
 
 #define AROS_NO_ATOMIC_OPERATIONS
 #include "exec_platform.h"
+#include "taskready.h"
 
 #define D(x)
 
@@ -69,7 +70,10 @@ void core_Switch(void)
     D(bug("[KRN] core_Switch(): Old task = %p (%s)\n", task, task->tc_Node.ln_Name));
 
     if (task->tc_State != TS_RUN)
+    {
+        ReadyDropHint(SysBase, task);
         Remove(&task->tc_Node);
+    }
 
     if ((task->tc_State != TS_WAIT) && (task->tc_State != TS_REMOVED))
         task->tc_State = TS_READY;
@@ -97,12 +101,13 @@ void core_Switch(void)
     {
         if (task->tc_Flags & TF_SWITCH)
             AROS_UFC1NR(void, task->tc_Switch, AROS_UFCA(struct ExecBase *, SysBase, A6));
-        Enqueue(&SysBase->TaskReady, &task->tc_Node);
+        ReadyEnqueue(SysBase, task);
     }
     else if (task->tc_State != TS_REMOVED)
     {
+        /* Nothing depends on the order of TaskWait, so don't sort it */
         D(bug("[KRN] Setting '%s' @ 0x%p to wait\n", task->tc_Node.ln_Name, task));
-        Enqueue(&SysBase->TaskWait, &task->tc_Node);
+        AddTail(&SysBase->TaskWait, &task->tc_Node);
     }
     if (showAlert)
         Alert(showAlert);
@@ -133,6 +138,7 @@ struct Task *core_Dispatch(void)
 
         return NULL;
     }
+    ReadyDropHint(SysBase, task);
 
     if (task->tc_State == TS_READY)
     {
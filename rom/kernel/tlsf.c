@@ -1343,6 +1343,7 @@ struct MemHeader * krnConvertMemHeaderToTLSF(struct MemHeader * source)
     struct MemChunk * mc = source->mh_First->mc_Next;
     APTR mh = source->mh_First;
     IPTR fsize = source->mh_First->mc_Bytes;
+    APTR mhLower = source->mh_Lower;	// Cache the mh_Lower value
     APTR mhUpper = source->mh_Upper;	// Cache the mh_Upper value
     if (source->mh_Attributes & MEMF_MANAGED)
         return NULL;
@@ -1351,7 +1352,11 @@ struct MemHeader * krnConvertMemHeaderToTLSF(struct MemHeader * source)
     krnCreateTLSFMemHeader(source->mh_Node.ln_Name, source->mh_Node.ln_Pri, mh, fsize,
             source->mh_Attributes);
 
-    /* Restore cached mh_Upper value (informative field, only) */
+    /*
+     * Restore cached mh_Lower and mh_Upper values, so that TypeOfMem()
+     * keeps working for blocks allocated before the conversion
+     */
+    ((struct MemHeaderExt *)mh)->mhe_MemHeader.mh_Lower = mhLower;
     ((struct MemHeaderExt *)mh)->mhe_MemHeader.mh_Upper = mhUpper;
 
     /* source->mh_First is destroyed beyond this point */
@@ -9,6 +9,7 @@
 
 #include "security_intern.h"
 #include "security_task.h"
+#include "taskready.h"
 
 /*****************************************************************************
 
@@ -63,6 +64,7 @@
             case NT_TASK:
             case NT_PROCESS:
                     if (task->tc_State < 7) {
+                        ReadyDropHint(SysBase, task);
                         Remove((struct Node*)task);
                         AddHead((struct List *)&secBase->Frozen, (struct Node*)task);
                         task->tc_State += 7;
@@ -11,6 +11,7 @@
 
 #include "security_intern.h"
 #include "security_task.h"
+#include "taskready.h"
 
 /*****************************************************************************
 
@@ -68,6 +69,7 @@
                     break;
 
             case NT_PROCESS:
+                    ReadyDropHint(SysBase, task);
                     Remove((struct Node*)task);
                     task->tc_State = TS_READY;
                     sp = task->tc_SPReg;
@@ -92,7 +94,7 @@
                     }
 #endif
                     *(IPTR *)sp = (IPTR)CleanUpBody;
-                    AddHead((struct List*)&SysBase->TaskReady, (struct Node*)task);
+                    ReadyEnqueue(SysBase, task);
                     res = TRUE;
                     break;
         }
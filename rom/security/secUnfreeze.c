@@ -11,6 +11,7 @@
 
 #include "security_intern.h"
 #include "security_task.h"
+#include "taskready.h"
 
 /*****************************************************************************
 
@@ -65,7 +66,7 @@
                             if (task->tc_State >= 7) {
                                     Remove((struct Node*)task);
                                     if ((task->tc_State -= 7) == TS_READY)
-                                            Enqueue((struct List*)&SysBase->TaskReady, (struct Node*)task);
+                                            ReadyEnqueue(SysBase, task);
                                     else
                                             Enqueue((struct List*)&SysBase->TaskWait, (struct Node*)task);
                                     res = TRUE;
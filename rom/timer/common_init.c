@@ -13,7 +13,7 @@
 
 static int common_Init(struct TimerBase *LIBBASE)
 {
-    ULONG i;
+    ULONG i, j;
 
     /* kernel.resource is optional for some implementations, so no check */
     LIBBASE->tb_KernelBase = OpenResource("kernel.resource");
@@ -26,8 +26,14 @@ static int common_Init(struct TimerBase *LIBBASE)
 
     /* Initialise the lists */
     for (i = 0; i < NUM_LISTS; i++)
+    {
 	NEWLIST(&LIBBASE->tb_Lists[i]);
 
+	for (j = 0; j < TIMER_WHEEL_SLOTS; j++)
+	    NEWLIST(&LIBBASE->tb_Wheel[i][j]);
+	LIBBASE->tb_WheelBase[i] = 0;
+    }
+
     return TRUE;
 }
 
@@ -40,38 +40,105 @@ static const UWORD SupportedCommands[] =
 
 #endif
 
-static void addToWaitList(struct MinList *list, struct timerequest *iotr, struct ExecBase *SysBase)
+static void insertSorted(struct MinList *list, struct timerequest *iotr)
 {
-    /* We are disabled, so we should take as little time as possible. */
     struct timerequest *tr;
-    BOOL added = FALSE;
 
-    ForeachNode(list, tr)
+    /*
+     * Walk backwards, new requests usually expire after the ones already
+     * queued. Stopping at the first request which is not later than ours
+     * keeps requests with equal times in FIFO order. If there is none, we
+     * end up on the list header and Insert() adds us to the head.
+     */
+    for (tr = (struct timerequest *)list->mlh_TailPred;
+         tr->tr_node.io_Message.mn_Node.ln_Pred;
+         tr = (struct timerequest *)tr->tr_node.io_Message.mn_Node.ln_Pred)
     {
-    	/* If the time in the new request is less than the next request */
-    	if (CMPTIME(&tr->tr_time, &iotr->tr_time) < 0)
-    	{
-    	    /* Add the node before the next request */
-    	    Insert((struct List *)list, &iotr->tr_node.io_Message.mn_Node, tr->tr_node.io_Message.mn_Node.ln_Pred);
-
-    	    added = TRUE;
-    	    break;
-    	}
+        if (CMPTIME(&tr->tr_time, &iotr->tr_time) >= 0)
+            break;
     }
 
-    /*
-     * This will catch the case of either an empty list, or request is
-     * for after all other requests
-     */
-    if(!added)
-    	ADDTAIL(list, iotr);
+    Insert((struct List *)list, &iotr->tr_node.io_Message.mn_Node, &tr->tr_node.io_Message.mn_Node);
+}
 
-#if PRINT_LIST
-    bug("Current list contents:\n");
+/*
+ * Move requests of wheel slot 'slot' which are due by 'key' into the
+ * sorted queue. Requests of later wheel rounds stay where they are.
+ */
+static void drainSlot(struct TimerBase *TimerBase, ULONG list, ULONG slot, ULONG key)
+{
+    struct timerequest *tr, *next;
+
+    ForeachNodeSafe(&TimerBase->tb_Wheel[list][slot], tr, next)
+    {
+        if ((LONG)(WHEELKEY(&tr->tr_time) - key) <= 0)
+        {
+            REMOVE(tr);
+            insertSorted(&TimerBase->tb_Lists[list], tr);
+        }
+    }
+}
+
+/*
+ * Bring the sorted queue of 'list' up to date with time 'now'. Afterwards
+ * every request which may have expired by 'now' is in tb_Lists[list].
+ * If time moved by more than a full wheel turn, or backwards (e.g. by
+ * TR_SETSYSTIME), we sweep the whole wheel once and restart from 'now'.
+ */
+static void advanceWheel(struct TimerBase *TimerBase, ULONG list, struct timeval *now)
+{
+    ULONG key  = WHEELKEY(now);
+    ULONG base = TimerBase->tb_WheelBase[list];
+    LONG  diff = key - base;
+
+    if (diff == 0)
+        return;
+
+    if ((diff < 0) || (diff >= TIMER_WHEEL_SLOTS))
+    {
+        ULONG slot;
+
+        for (slot = 0; slot < TIMER_WHEEL_SLOTS; slot++)
+            drainSlot(TimerBase, list, slot, key);
+    }
+    else
+    {
+        while (base != key)
+        {
+            base++;
+            drainSlot(TimerBase, list, base & TIMER_WHEEL_MASK, base);
+        }
+    }
+
+    TimerBase->tb_WheelBase[list] = key;
+}
+
+/*
+ * Queue a request. We are disabled, so we should take as little time as
+ * possible: requests due within the current wheel slot are sorted into
+ * tb_Lists[list] right away, anything later is just appended to its wheel
+ * slot and sorted in by advanceWheel() when that slot comes up.
+ * Either way the request can be unlinked with a plain Remove() by AbortIO().
+ */
+static void addToWaitList(struct TimerBase *TimerBase, ULONG list, struct timerequest *iotr)
+{
+    ULONG key = WHEELKEY(&iotr->tr_time);
+
+    if ((LONG)(key - TimerBase->tb_WheelBase[list]) <= 0)
+        insertSorted(&TimerBase->tb_Lists[list], iotr);
+    else
+        ADDTAIL(&TimerBase->tb_Wheel[list][key & TIMER_WHEEL_MASK], iotr);
 
-    ForeachNode(list, tr)
+#if PRINT_LIST
     {
-	 bug("%u.%u\n", tr->tr_time.tv_secs, tr->tr_time.tv_micro);
+        struct timerequest *tr;
+
+        bug("Current list contents:\n");
+
+        ForeachNode(&TimerBase->tb_Lists[list], tr)
+        {
+            bug("%u.%u\n", tr->tr_time.tv_secs, tr->tr_time.tv_micro);
+        }
     }
 #endif
 }
@@ -160,8 +227,15 @@ BOOL common_BeginIO(struct timerequest *timereq, struct TimerBase *TimerBase)
                 struct ExecLockBase *ExecLockBase = TimerBase->tb_ExecLockBase;
                 if (ExecLockBase) ObtainLock(TimerBase->tb_ListLock, SPINLOCK_MODE_WRITE, 0);
 #endif
+		/* Wheel keys need a normalized time */
+		while (timereq->tr_time.tv_micro > 999999)
+		{
+		    timereq->tr_time.tv_secs++;
+		    timereq->tr_time.tv_micro -= 1000000;
+		}
+
 		/* Ok, we add this to the list */
-		addToWaitList(&TimerBase->tb_Lists[TL_WAITVBL], timereq, SysBase);
+		addToWaitList(TimerBase, TL_WAITVBL, timereq);
 		timereq->tr_node.io_Flags &= ~IOF_QUICK;
 
 		/*
@@ -205,7 +279,7 @@ BOOL common_BeginIO(struct timerequest *timereq, struct TimerBase *TimerBase)
                 if (ExecLockBase) ObtainLock(TimerBase->tb_ListLock, SPINLOCK_MODE_WRITE, 0);
 #endif
                 /* Slot it into the list. Use unit number as index. */
-                addToWaitList(&TimerBase->tb_Lists[unitNum], timereq, SysBase);
+                addToWaitList(TimerBase, unitNum, timereq);
                 timereq->tr_node.io_Flags &= ~IOF_QUICK;
 
                 /* Indicate if HW need to be reprogrammed */
@@ -274,6 +348,8 @@ void TimerProcessMicroHZ(struct TimerBase *TimerBase, struct ExecBase *SysBase,
 #if defined(__AROSEXEC_SMP__)
     if (ExecLockBase && !locked) ObtainLock(TimerBase->tb_ListLock, SPINLOCK_MODE_WRITE, 0);
 #endif
+    advanceWheel(TimerBase, TL_MICROHZ, &TimerBase->tb_Elapsed);
+
     ForeachNodeSafe(unit, tr, next)
     {
 	if (CMPTIME(&TimerBase->tb_Elapsed, &tr->tr_time) <= 0)
@@ -311,7 +387,7 @@ void TimerProcessMicroHZ(struct TimerBase *TimerBase, struct ExecBase *SysBase,
     		tr->tr_time.tv_secs  = 0;
 		tr->tr_time.tv_micro = 1000000 / SysBase->VBlankFrequency;
                 ADDTIME(&tr->tr_time, &TimerBase->tb_Elapsed);
-		addToWaitList(unit, tr, SysBase);
+		addToWaitList(TimerBase, TL_MICROHZ, tr);
 
 		continue;
 	    }
@@ -360,6 +436,8 @@ void TimerProcessVBlank(struct TimerBase *TimerBase, struct ExecBase *SysBase, B
 #if defined(__AROSEXEC_SMP__)
     if (ExecLockBase && !locked) ObtainLock(TimerBase->tb_ListLock, SPINLOCK_MODE_WRITE, 0);
 #endif
+    advanceWheel(TimerBase, TL_VBLANK, &TimerBase->tb_Elapsed);
+
     ForeachNodeSafe(&TimerBase->tb_Lists[TL_VBLANK], tr, next)
     {
 	if (CMPTIME(&TimerBase->tb_Elapsed, &tr->tr_time) <= 0)
@@ -380,6 +458,8 @@ void TimerProcessVBlank(struct TimerBase *TimerBase, struct ExecBase *SysBase, B
      * The other this is the "wait until a specified time". Here a request
      * is complete if the time we are waiting for is before the current time.
      */
+    advanceWheel(TimerBase, TL_WAITVBL, &TimerBase->tb_CurrentTime);
+
     ForeachNodeSafe(&TimerBase->tb_Lists[TL_WAITVBL], tr, next)
     {
 	if (CMPTIME(&TimerBase->tb_CurrentTime, &tr->tr_time) <= 0)
@@ -38,6 +38,20 @@
 #define TL_WAITVBL	2
 #define NUM_LISTS	3
 
+/*
+ * Requests which expire beyond the current wheel slot are parked in a
+ * hashed timing wheel instead of being sorted into tb_Lists right away.
+ * A slot covers 65536 microseconds (see WHEELKEY()), so 128 slots span
+ * about 8 seconds; later requests hash into the same slots and are simply
+ * skipped until their turn comes.
+ * The head of tb_Lists[] is still the next request to expire, as long as
+ * the queue is processed at least once per slot. Hardware which sleeps
+ * until the head request is due must therefore not sleep past the end of
+ * the current slot while the wheel is not empty.
+ */
+#define TIMER_WHEEL_SLOTS	128
+#define TIMER_WHEEL_MASK	(TIMER_WHEEL_SLOTS - 1)
+
 struct TimerBase
 {
     /* Required by the system */
@@ -54,7 +68,9 @@ struct TimerBase
     struct Interrupt	 tb_ResetHandler;	/* Stops interrupt generation before a reboot		*/
 
     /* Request queues */
-    struct MinList	 tb_Lists[NUM_LISTS];
+    struct MinList	 tb_Lists[NUM_LISTS];	/* Sorted requests due up to tb_WheelBase		*/
+    struct MinList	 tb_Wheel[NUM_LISTS][TIMER_WHEEL_SLOTS]; /* Unsorted later requests		*/
+    ULONG		 tb_WheelBase[NUM_LISTS]; /* Last wheel slot merged into tb_Lists		*/
 
     /* EClock counter */
     UQUAD                tb_ticks_total;	/* Effective EClock value				*/
@@ -57,6 +57,15 @@ static inline LONG CMPTIME(struct timeval *dest, struct timeval *src)
 	return 0;
 }
 
+/*
+ * Timing wheel slot number of a normalized timeval. Wraps around, so
+ * keys must only be compared via their signed difference.
+ */
+static inline ULONG WHEELKEY(struct timeval *tv)
+{
+    return (tv->tv_secs << 4) + (tv->tv_micro >> 16);
+}
+
 /*
  * Add 'diff' EClock ticks to timeval in 'time'.
  * Fraction of second value is stored in in 'frac'.
@@ -34,10 +34,13 @@ struct MakefileRef
     struct Makefile * makefile;
 };
    
+struct Job;
+
 struct Target
 {
     struct Node node;
     int  updated : 1;
+    struct Job * job; /* Used by the scheduler in sched.c */
 
     struct List makefiles;
 };
@@ -78,6 +78,7 @@ int verbose = 0;
 int quiet = 0;
 int debug = 0;
 int logfailed = 0;
+int parallel = 0;
 FILE *mm_faillogfh = NULL;
 
 char *mm_srcdir;    /* Location to scan for cfg files */
@@ -149,9 +150,21 @@ main (int argc, char ** argv)
 	    {
 		logfailed = 1;
 	    }
+	    else if (!strncmp (argv[t], "--parallel", 10)
+	             && (argv[t][10] == '\0' || argv[t][10] == '='))
+	    {
+#if defined(_WIN32)
+		printf ("[MMAKE] --parallel is not supported on this host\n");
+#else
+		/* -1 means as many as the jobserver or the CPUs allow */
+		parallel = argv[t][10] == '=' ? atoi (&argv[t][11]) : -1;
+		if (parallel == 0)
+		    parallel = -1;
+#endif
+	    }
 	    else if (!strcmp (argv[t], "--help"))
 	    {
-		printf ("%s [--srcdir=<directory>] [--builddir=<directory>] [--version] [-v,--verbose] [-q,--quiet] [--debug] [--help]\n", argv[0]);
+		printf ("%s [--srcdir=<directory>] [--builddir=<directory>] [--version] [-v,--verbose] [-q,--quiet] [--debug] [--logfailed] [--parallel[=<jobs>]] [--help]\n", argv[0]);
 		return 0;
 	    }
 	    else
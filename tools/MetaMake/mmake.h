@@ -5,6 +5,7 @@ extern int verbose;
 extern int quiet;
 extern int debug;
 extern int logfailed;
+extern int parallel;
 extern char ** mflags;
 extern int mflagc;
 extern char *mm_srcdir;
@@ -36,6 +36,7 @@ Boston, MA 02111-1307, USA.  */
 #include "mem.h"
 #include "dep.h"
 #include "mmake.h"
+#include "sched.h"
 
 #if defined(DEBUG_PROJECT)
 #define debug(a) a
@@ -46,6 +47,10 @@ Boston, MA 02111-1307, USA.  */
 struct List projects;
 static struct Project * defaultprj = NULL;
 
+static const char * buildcommand (struct Project * prj, const char * cmd,
+                                  const char * in, const char * out, const char * args);
+static int runcommand (const char * cmdstr);
+
 static void
 readvars (struct Project * prj)
 {
@@ -247,21 +252,16 @@ freeproject (struct Project * prj)
     xfree (prj);
 }
 
-static void
-callmake (struct Project * prj, const char * tname, struct Makefile * makefile)
+char *
+makecommand (struct Project * prj, const char * tname, struct Makefile * makefile,
+        char ** dir)
 {
     static char buffer[4096];
     const char * path = buildpath (makefile->dir);
+    const char * top = makefile->generated ? prj->buildtop : prj->srctop;
     int t;
 
-    debug(printf("MMAKE:project.c->callmake()\n"));
-
-    if (makefile->generated)
-        ASSERT(chdir (prj->buildtop) == 0);
-    else
-        ASSERT(chdir (prj->srctop) == 0);
-    if (path[0] != 0)
-        ASSERT(chdir (path) == 0);
+    debug(printf("MMAKE:project.c->makecommand()\n"));
 
     setvar (&prj->vars, "CURDIR", path);
     setvar (&prj->vars, "TARGET", tname);
@@ -286,16 +286,39 @@ callmake (struct Project * prj, const char * tname, struct Makefile * makefile)
 
     strcat (buffer, tname);
 
+    *dir = xmalloc (strlen (top) + strlen (path) + 2);
+    if (path[0] != 0)
+        sprintf (*dir, "%s/%s", top, path);
+    else
+        strcpy (*dir, top);
+
+    return xstrdup (buildcommand (prj, prj->maketool, "-", "-", buffer));
+}
+
+static void
+callmake (struct Project * prj, const char * tname, struct Makefile * makefile)
+{
+    const char * path = buildpath (makefile->dir);
+    char * cmdstr, * dir;
+
+    debug(printf("MMAKE:project.c->callmake()\n"));
+
+    cmdstr = makecommand (prj, tname, makefile, &dir);
+
+    ASSERT(chdir (dir) == 0);
+
     if (!quiet)
         printf ("[MMAKE] Making %s in %s\n", tname, path);
 
-    if (!execute (prj, prj->maketool, "-", "-", buffer))
+    if (!runcommand (cmdstr))
     {
         error ("Error while running make in %s", path);
         exit (10);
     }
-}
 
+    xfree (cmdstr);
+    xfree (dir);
+}
 
 void
 initprojects (void)
@@ -498,15 +521,11 @@ getfirstproject (void)
     return prj;
 }
 
-int
-execute (struct Project * prj, const char * cmd, const char * in,
+static const char *
+buildcommand (struct Project * prj, const char * cmd, const char * in,
         const char * out, const char * args)
 {
-    char buffer[4096];
-    char * cmdstr;
-    int rc;
-
-    debug(printf("MMAKE:project.c->execute(cmd '%s')\n", cmd));
+    static char buffer[4096];
 
     strcpy (buffer, cmd);
     strcat (buffer, " ");
@@ -527,9 +546,15 @@ execute (struct Project * prj, const char * cmd, const char * in,
 
     strcat (buffer, args);
 
-    cmdstr = substvars (&prj->vars, buffer);
+    debug(printf("MMAKE:project.c->buildcommand: cmd '%s'\n", buffer));
 
-    debug(printf("MMAKE:project.c->execute: parsed cmd '%s'\n", buffer));
+    return substvars (&prj->vars, buffer);
+}
+
+static int
+runcommand (const char * cmdstr)
+{
+    int rc;
 
     if (verbose)
         printf ("[MMAKE] Executing %s...\n", cmdstr);
@@ -544,6 +569,15 @@ execute (struct Project * prj, const char * cmd, const char * in,
     return !rc;
 }
 
+int
+execute (struct Project * prj, const char * cmd, const char * in,
+        const char * out, const char * args)
+{
+    debug(printf("MMAKE:project.c->execute(cmd '%s')\n", cmd));
+
+    return runcommand (buildcommand (prj, cmd, in, out, args));
+}
+
 void
 maketarget (struct Project * prj, char * tname)
 {
@@ -567,6 +601,14 @@ maketarget (struct Project * prj, char * tname)
     if (!*tname)
         tname = prj->defaulttarget;
 
+#if !defined(_WIN32)
+    if (parallel)
+    {
+        schedtarget (prj, tname, parallel);
+        return;
+    }
+#endif
+
     target = FindNode (&prj->cache->targets, tname);
 
     if (!target)
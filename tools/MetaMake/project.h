@@ -27,6 +27,8 @@ Boston, MA 02111-1307, USA.  */
 #include "list.h"
 #include "cache.h"
 
+struct Makefile;
+
 struct Project
 {
     struct Node node;
@@ -57,5 +59,7 @@ struct Project * getfirstproject (void);
 void maketarget (struct Project * prj, char * tname);
 int execute (struct Project * prj, const char * cmd, const char * in,
              const char * out, const char * args);
+char * makecommand (struct Project * prj, const char * tname,
+                    struct Makefile * makefile, char ** dir);
 
 #endif /* __MMAKE_PROJECT_H */
@@ -0,0 +1,743 @@
+/* MetaMake - A Make extension
+   Copyright  1995-2024, The AROS Development Team. All rights reserved.
+
+This file is part of MetaMake.
+
+MetaMake is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2, or (at your option)
+any later version.
+
+MetaMake is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GNU CC; see the file COPYING.  If not, write to
+the Free Software Foundation, 59 Temple Place - Suite 330,
+Boston, MA 02111-1307, USA.  */
+
+//#define DEBUG_SCHED
+
+#include "config.h"
+
+#if !defined(_WIN32)
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#ifdef HAVE_STRING_H
+#   include <string.h>
+#else
+#   include <strings.h>
+#endif
+
+#include "sched.h"
+#include "project.h"
+#include "cache.h"
+#include "dirnode.h"
+#include "mem.h"
+#include "mmake.h"
+
+#if defined(DEBUG_SCHED)
+#define debug(a) a
+#else
+#define debug(v)
+#endif
+
+/* The metatargets are turned into a graph of Jobs, one per metatarget,
+   and each Job into Calls, one per non-virtual makefile defining it. All
+   Calls of a Job may run as soon as every Job it depends on is done. */
+
+struct Edge
+{
+    struct Edge * next;
+    struct Job  * job;
+};
+
+enum
+{
+    JOB_VISITING,   /* Dependencies are being collected */
+    JOB_WAITING,    /* Waiting for dependencies */
+    JOB_READY,      /* Calls queued or running */
+    JOB_DONE
+};
+
+/* Results of buildjob() */
+enum
+{
+    BUILD_UNKNOWN,  /* Nothing known about the target */
+    BUILD_SKIPPED,  /* Built already, or closes a cycle */
+    BUILD_JOB       /* Wait for the Job returned */
+};
+
+struct Job
+{
+    struct Node     node;
+    struct Target * target;
+    int             state;
+    int             pending;    /* Dependencies not done yet */
+    int             calls;      /* Calls not done yet */
+    int             rank;       /* Longest chain of Jobs waiting for this one */
+    struct Edge   * users;      /* Jobs depending on this one */
+    struct Job    * critical;   /* Dependency which was done last */
+    struct List     makecalls;
+    double          ready, done, busy;
+};
+
+struct Call
+{
+    struct Node  node;          /* Name is the directory of the makefile */
+    struct Job * job;
+    char       * cmd;
+    char       * dir;
+    int          seq;
+    pid_t        pid;
+    double       start;
+};
+
+static struct Project * curprj;
+static struct List jobs;
+static int ncalls;
+static int failed;
+static struct timeval starttime;
+
+/* Calls ready to run, ordered by rank */
+static struct Call ** readyheap;
+static int nready;
+
+static struct Call ** active;
+static int running;
+
+/* Jobserver shared with make. The first running Call uses the slot
+   mmake itself was started with, every further one needs a token. */
+static int jsread = -1, jswrite = -1;
+static int jsopen;
+static char * tokens;
+static int held;
+
+static volatile sig_atomic_t deadchildren;
+static volatile int tokenfd = -1;
+
+static double
+elapsed (void)
+{
+    struct timeval tv;
+
+    gettimeofday (&tv, NULL);
+
+    return (tv.tv_sec - starttime.tv_sec) + (tv.tv_usec - starttime.tv_usec) / 1000000.0;
+}
+
+static int
+before (struct Call * a, struct Call * b)
+{
+    if (a->job->rank != b->job->rank)
+        return a->job->rank > b->job->rank;
+
+    return a->seq < b->seq;
+}
+
+static void
+pushcall (struct Call * call)
+{
+    int t = nready++, parent;
+
+    while (t > 0)
+    {
+        parent = (t - 1) / 2;
+        if (!before (call, readyheap[parent]))
+            break;
+        readyheap[t] = readyheap[parent];
+        t = parent;
+    }
+
+    readyheap[t] = call;
+}
+
+static struct Call *
+popcall (void)
+{
+    struct Call * call = readyheap[0], * last = readyheap[--nready];
+    int t = 0, child;
+
+    while ((child = 2 * t + 1) < nready)
+    {
+        if (child + 1 < nready && before (readyheap[child + 1], readyheap[child]))
+            child ++;
+        if (!before (readyheap[child], last))
+            break;
+        readyheap[t] = readyheap[child];
+        t = child;
+    }
+
+    readyheap[t] = last;
+
+    return call;
+}
+
+static int
+buildjob (struct Project * prj, const char * tname, int sub, struct Job ** jobp)
+{
+    struct Target * target;
+    struct Job * job, * dep;
+    struct Node * node;
+    struct MakefileRef * mfref;
+    struct MakefileTarget * mftarget;
+    struct Call * call;
+    struct Edge * edge;
+    struct List deps;
+
+    target = FindNode (&prj->cache->targets, tname);
+
+    if (!target)
+    {
+        if ((!strcmp(mm_envtarget, tname)) || (verbose))
+            printf ("[MMAKE] Nothing known about %s %s in project %s\n",
+                    sub ? "subtarget" : "target", tname, prj->node.name);
+        if (mm_faillogfh)
+        {
+            fputs(tname, mm_faillogfh);
+            fputs("\n", mm_faillogfh);
+        }
+        return BUILD_UNKNOWN;
+    }
+
+    /* Like maketarget() a dependency which is still being visited closes
+       a cycle and is ignored */
+    if (target->job)
+    {
+        if (target->job->state == JOB_VISITING)
+            return BUILD_SKIPPED;
+
+        *jobp = target->job;
+        return BUILD_JOB;
+    }
+
+    /* Already built for an earlier target on the command line */
+    if (target->updated)
+        return BUILD_SKIPPED;
+
+    target->updated = 1;
+
+    job = newnodesize (tname, sizeof (struct Job));
+    job->target = target;
+    job->state = JOB_VISITING;
+    NewList (&job->makecalls);
+    target->job = job;
+
+    NewList (&deps);
+
+    ForeachNode (&target->makefiles, mfref)
+    {
+        mftarget = FindNode (&mfref->makefile->targets, tname);
+
+        ForeachNode (&mftarget->deps, node)
+            addnodeonce (&deps, node->name);
+    }
+
+    ForeachNode (&deps, node)
+    {
+        if (buildjob (prj, node->name, 1, &dep) == BUILD_JOB)
+        {
+            edge = new (struct Edge);
+            edge->job = job;
+            edge->next = dep->users;
+            dep->users = edge;
+            job->pending ++;
+        }
+    }
+
+    freelist (&deps);
+
+    ForeachNode (&target->makefiles, mfref)
+    {
+        if (!mfref->virtualtarget)
+        {
+            call = newnodesize (buildpath (mfref->makefile->dir), sizeof (struct Call));
+            call->job = job;
+            call->cmd = makecommand (prj, tname, mfref->makefile, &call->dir);
+            call->seq = ncalls ++;
+            AddTail (&job->makecalls, call);
+            job->calls ++;
+        }
+    }
+
+    debug(printf("MMAKE:sched.c->buildjob: %s has %d deps, %d calls\n", tname, job->pending, job->calls));
+
+    /* jobs ends up in dependency order */
+    job->state = JOB_WAITING;
+    AddTail (&jobs, job);
+
+    *jobp = job;
+    return BUILD_JOB;
+}
+
+static void jobdone (struct Job * job);
+
+static void
+jobready (struct Job * job)
+{
+    struct Call * call;
+
+    job->state = JOB_READY;
+    job->ready = elapsed ();
+
+    if (!quiet)
+        printf ("[MMAKE] Building %s.%s\n", curprj->node.name, job->node.name);
+
+    if (!job->calls)
+        jobdone (job);
+    else
+    {
+        ForeachNode (&job->makecalls, call)
+            pushcall (call);
+    }
+}
+
+static void
+jobdone (struct Job * job)
+{
+    struct Edge * edge;
+    struct Job * user;
+
+    job->state = JOB_DONE;
+    job->done = elapsed ();
+
+    for (edge = job->users; edge; edge = edge->next)
+    {
+        user = edge->job;
+
+        user->critical = job;
+        if (--user->pending == 0)
+            jobready (user);
+    }
+}
+
+static void
+childhandler (int sig)
+{
+    deadchildren ++;
+
+    /* Interrupts a read in gettoken(), see there */
+    if (tokenfd >= 0)
+    {
+        close (tokenfd);
+        tokenfd = -1;
+    }
+}
+
+static int
+validfd (int fd)
+{
+    return fd >= 0 && fcntl (fd, F_GETFD) != -1;
+}
+
+static void
+openjobserver (int maxjobs)
+{
+    const char * flags = getenv ("MAKEFLAGS");
+    const char * opt = NULL;
+    char * env;
+    char path[1024];
+    int fds[2];
+    char c = '+';
+
+    if (jsopen)
+        return;
+    jsopen = 1;
+
+    if (flags)
+    {
+        if ((opt = strstr (flags, "--jobserver-auth=fifo:")) != NULL)
+        {
+            if (sscanf (opt + 22, "%1023s", path) == 1)
+                jsread = jswrite = open (path, O_RDWR);
+        }
+        else if ((opt = strstr (flags, "--jobserver-auth=")) != NULL
+                 || (opt = strstr (flags, "--jobserver-fds=")) != NULL)
+        {
+            if (sscanf (strchr (opt, '=') + 1, "%d,%d", &jsread, &jswrite) != 2
+                || !validfd (jsread) || !validfd (jswrite))
+            {
+                jsread = jswrite = -1;
+            }
+        }
+
+        if (jsread >= 0)
+        {
+            debug(printf("MMAKE:sched.c->openjobserver: using make's jobserver %d,%d\n", jsread, jswrite));
+            return;
+        }
+
+        if (opt)
+            printf ("[MMAKE] Warning: jobserver unavailable, mark the rule running mmake with '+'\n");
+    }
+
+    if (maxjobs <= 0)
+        maxjobs = sysconf (_SC_NPROCESSORS_ONLN);
+    if (maxjobs <= 0)
+        maxjobs = 1;
+
+    if (pipe (fds) != 0)
+    {
+        error ("Can't create jobserver pipe");
+        return;
+    }
+
+    jsread = fds[0];
+    jswrite = fds[1];
+
+    while (--maxjobs > 0)
+        if (write (jswrite, &c, 1) != 1)
+            break;
+
+    /* Let the make tool share our slots */
+    env = xmalloc ((flags ? strlen (flags) : 0) + 64);
+    sprintf (env, "%s -j --jobserver-fds=%d,%d", flags ? flags : "", jsread, jswrite);
+    setenv ("MAKEFLAGS", env, 1);
+    xfree (env);
+
+    debug(printf("MMAKE:sched.c->openjobserver: created jobserver %d,%d\n", jsread, jswrite));
+}
+
+/* Returns 1 when a token was taken, 0 when a child has died or the
+   jobserver could not be read and the caller should reap and retry.
+
+   A blocking read can't be interrupted reliably by SIGCHLD since the
+   child may die just before the read starts. Like GNU make the read is
+   done on a dup of the jobserver fd which the signal handler closes. */
+static int
+gettoken (void)
+{
+    sigset_t chld, old, wait;
+    fd_set fds;
+    char c;
+    int fd, rc;
+
+    sigemptyset (&chld);
+    sigaddset (&chld, SIGCHLD);
+
+    sigprocmask (SIG_BLOCK, &chld, &old);
+    if (deadchildren)
+    {
+        sigprocmask (SIG_SETMASK, &old, NULL);
+        return 0;
+    }
+    fd = tokenfd = dup (jsread);
+    sigprocmask (SIG_SETMASK, &old, NULL);
+
+    rc = read (fd, &c, 1);
+
+    sigprocmask (SIG_BLOCK, &chld, &old);
+    if (tokenfd >= 0)
+    {
+        close (tokenfd);
+        tokenfd = -1;
+    }
+
+    if (rc == 1)
+    {
+        sigprocmask (SIG_SETMASK, &old, NULL);
+        tokens[held++] = c;
+        return 1;
+    }
+
+    if (rc < 0 && errno == EAGAIN)
+    {
+        /* make has put the jobserver into non-blocking mode */
+        if (!deadchildren)
+        {
+            wait = old;
+            sigdelset (&wait, SIGCHLD);
+            FD_ZERO (&fds);
+            FD_SET (jsread, &fds);
+            pselect (jsread + 1, &fds, NULL, NULL, NULL, &wait);
+        }
+    }
+    else if (rc == 0 || (errno != EINTR && errno != EBADF))
+    {
+        error ("Can't read from the jobserver, continuing serially");
+        jsread = -1;
+    }
+
+    sigprocmask (SIG_SETMASK, &old, NULL);
+
+    return 0;
+}
+
+static void
+puttokens (void)
+{
+    int keep = running ? running - 1 : 0;
+
+    while (held > keep)
+    {
+        if (write (jswrite, &tokens[held - 1], 1) != 1 && errno == EINTR)
+            continue;
+        held --;
+    }
+}
+
+static void
+startcall (struct Call * call)
+{
+    pid_t pid;
+
+    if (!quiet)
+        printf ("[MMAKE] Making %s in %s\n", call->job->node.name, call->node.name);
+    if (verbose)
+        printf ("[MMAKE] Executing %s...\n", call->cmd);
+
+    fflush (NULL);
+
+    pid = fork ();
+
+    if (pid == 0)
+    {
+        signal (SIGCHLD, SIG_DFL);
+
+        if (chdir (call->dir) != 0)
+        {
+            perror (call->dir);
+            _exit (127);
+        }
+
+        execl ("/bin/sh", "sh", "-c", call->cmd, (char *)NULL);
+        _exit (127);
+    }
+    else if (pid < 0)
+    {
+        error ("Can't start make in %s", call->node.name);
+        failed = 1;
+        puttokens ();
+        return;
+    }
+
+    call->pid = pid;
+    call->start = elapsed ();
+    active[running++] = call;
+}
+
+static void
+reapcalls (int block)
+{
+    struct Call * call;
+    pid_t pid;
+    int status, t;
+
+    deadchildren = 0;
+
+    while (running)
+    {
+        pid = waitpid (-1, &status, block ? 0 : WNOHANG);
+
+        if (pid == 0)
+            break;
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        block = 0;
+
+        for (t=0; t<running && active[t]->pid != pid; t++)
+            ;
+        if (t == running)
+            continue;
+
+        call = active[t];
+        active[t] = active[--running];
+        puttokens ();
+
+        call->job->busy += elapsed () - call->start;
+
+        if (!WIFEXITED (status) || WEXITSTATUS (status))
+        {
+            printf ("[MMAKE] %s failed: %d\n", call->cmd, status);
+            errno = 0;
+            error ("Error while running make in %s", call->node.name);
+            failed = 1;
+        }
+        else if (--call->job->calls == 0)
+            jobdone (call->job);
+    }
+}
+
+static void
+report (struct Job * root, double wall)
+{
+    struct Job * job, ** path;
+    double busy = 0.0;
+    int njobs = 0, len = 0;
+
+    ForeachNode (&jobs, job)
+    {
+        busy += job->busy;
+        njobs ++;
+    }
+
+    path = xmalloc (njobs * sizeof (struct Job *));
+
+    for (job = root; job; job = job->critical)
+        path[len++] = job;
+
+    printf ("[MMAKE] Critical path of %s.%s:\n", curprj->node.name, root->node.name);
+    printf ("[MMAKE]     ready      done      busy  target\n");
+
+    while (len--)
+    {
+        job = path[len];
+        printf ("[MMAKE] %8.2fs %8.2fs %8.2fs  %s\n",
+                job->ready, job->done, job->busy, job->node.name);
+    }
+
+    printf ("[MMAKE] %d targets, %d makes: %.2fs elapsed, %.2fs in make, parallelism %.2f\n",
+            njobs, ncalls, wall, busy, wall > 0.0 ? busy / wall : 0.0);
+
+    xfree (path);
+}
+
+static void
+freejobs (void)
+{
+    struct Job * job, * nextjob;
+    struct Call * call, * nextcall;
+    struct Edge * edge;
+
+    ForeachNodeSafe (&jobs, job, nextjob)
+    {
+        ForeachNodeSafe (&job->makecalls, call, nextcall)
+        {
+            Remove (call);
+            xfree (call->cmd);
+            xfree (call->dir);
+            xfree (call->node.name);
+            xfree (call);
+        }
+
+        while ((edge = job->users) != NULL)
+        {
+            job->users = edge->next;
+            xfree (edge);
+        }
+
+        job->target->job = NULL;
+
+        Remove (job);
+        xfree (job->node.name);
+        xfree (job);
+    }
+}
+
+void
+schedtarget (struct Project * prj, const char * tname, int maxjobs)
+{
+    struct sigaction sa, oldsa;
+    struct Job * job, * user;
+    struct Edge * edge;
+    struct Job * root;
+
+    debug(printf("MMAKE:sched.c->schedtarget(%s)\n", tname));
+
+    curprj = prj;
+    NewList (&jobs);
+    ncalls = 0;
+    failed = 0;
+    gettimeofday (&starttime, NULL);
+
+    switch (buildjob (prj, tname, 0, &root))
+    {
+    case BUILD_UNKNOWN:
+        return;
+
+    case BUILD_SKIPPED:
+        if (verbose)
+            printf ("[MMAKE] %s.%s is up to date\n", prj->node.name, tname);
+        return;
+    }
+
+    /* Dependents always come after their dependencies */
+    for (job = GetTail (&jobs); job; job = GetPrev (job))
+    {
+        for (edge = job->users; edge; edge = edge->next)
+        {
+            user = edge->job;
+            if (user->rank + 1 > job->rank)
+                job->rank = user->rank + 1;
+        }
+    }
+
+    readyheap = xmalloc ((ncalls + 1) * sizeof (struct Call *));
+    active = xmalloc ((ncalls + 1) * sizeof (struct Call *));
+    tokens = xmalloc (ncalls + 1);
+    nready = running = held = 0;
+
+    openjobserver (maxjobs);
+
+    memset (&sa, 0, sizeof (sa));
+    sa.sa_handler = childhandler;
+    sigemptyset (&sa.sa_mask);
+    sa.sa_flags = SA_NOCLDSTOP;
+    sigaction (SIGCHLD, &sa, &oldsa);
+    deadchildren = 0;
+
+    ForeachNode (&jobs, job)
+    {
+        if (job->state == JOB_WAITING && !job->pending)
+            jobready (job);
+    }
+
+    for (;;)
+    {
+        reapcalls (0);
+
+        if (nready && !failed)
+        {
+            if (!running)
+                startcall (popcall ());
+            else if (jsread >= 0 && gettoken ())
+                startcall (popcall ());
+            else if (jsread < 0)
+                reapcalls (1);
+            continue;
+        }
+
+        if (!running)
+            break;
+
+        reapcalls (1);
+    }
+
+    sigaction (SIGCHLD, &oldsa, NULL);
+
+    xfree (readyheap);
+    xfree (active);
+    xfree (tokens);
+
+    if (failed)
+        exit (10);
+
+    if (root->state != JOB_DONE)
+    {
+        ForeachNode (&jobs, job)
+        {
+            if (job->state != JOB_DONE)
+                printf ("[MMAKE] %s.%s was never built\n", prj->node.name, job->node.name);
+        }
+    }
+    else if (!quiet)
+        report (root, elapsed ());
+
+    freejobs ();
+}
+
+#endif /* !_WIN32 */
@@ -0,0 +1,31 @@
+#ifndef __MMAKE_SCHED_H
+#define __MMAKE_SCHED_H
+
+/* MetaMake - A Make extension
+   Copyright  1995-2024, The AROS Development Team. All rights reserved.
+
+This file is part of MetaMake.
+
+MetaMake is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2, or (at your option)
+any later version.
+
+MetaMake is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GNU CC; see the file COPYING.  If not, write to
+the Free Software Foundation, 59 Temple Place - Suite 330,
+Boston, MA 02111-1307, USA.  */
+
+#include "project.h"
+
+/* Build tname and everything it depends on, running independent
+   metatargets concurrently. Slots are shared with GNU make through its
+   jobserver; maxjobs is only used when none is inherited. */
+void schedtarget (struct Project * prj, const char * tname, int maxjobs);
+
+#endif /* __MMAKE_SCHED_H */
@@ -81,6 +81,10 @@
     BUF=BUFFER:
     Specify the number of 512 byte buffers for copying. Default are 200 buffers
     [100KB memory]. One buffer is minimum size, but should never be used.
+    Files are copied through a ring of four parts of this buffer, reading
+    the next part while the previous one is written. A part is never larger
+    than the maximum transfer size (MaxTransfer) of the source or
+    destination device. Interactive handles are copied the old way.
 
     PAT=PATTERN:
     PATTERN allows to specify a standard dos pattern, all file have to match.
@@ -296,6 +300,10 @@
 #define USE_SOFTLINKCHECK               1
 #define USE_ALWAYSVERBOSE               1
 #define USE_BOGUSEOFWORKAROUND          0
+#define USE_PIPELINEDCOPY               1
+
+#define PIPE_BUFFERS            4       /* ring size of the pipelined copy */
+#define PIPE_MINCHUNK           512     /* smallest transfer per packet    */
 
 #include <aros/asmcall.h>
 #include <exec/devices.h>
@@ -304,6 +312,7 @@
 #include <exec/semaphores.h>
 #include <exec/types.h>
 #include <dos/exall.h>
+#include <dos/filehandler.h>
 
 #ifdef __SASC
 typedef ULONG IPTR;
@@ -316,7 +325,7 @@ typedef ULONG IPTR;
 
 #include <string.h>
 
-const TEXT version[] = "\0$VER: Copy 50.17 (30.12.2011)";
+const TEXT version[] = "\0$VER: Copy 50.18 (16.10.2026)";
 
 static const UBYTE *PARAM =
 "FROM/M,TO,PAT=PATTERN/K,BUF=BUFFER/K/N,ALL/S,"
@@ -454,6 +463,9 @@ struct CopyData
 
     STRPTR      CopyBuf;
     ULONG       CopyBufLen;
+
+    struct MsgPort   *PipePort;  /* reply port of the pipelined copy */
+    struct DosPacket *PipePkt[2];/* read and write packet            */
 };
 
 /*
@@ -527,6 +539,10 @@ const CONST_STRPTR texts[] =
     };
 
 LONG  CopyFile(BPTR, BPTR, ULONG, struct CopyData *);
+#if USE_PIPELINEDCOPY
+LONG  PipeCopy(BPTR, BPTR, STRPTR, ULONG, struct CopyData *);
+ULONG MaxTransfer(BPTR, struct CopyData *);
+#endif
 void  DoWork(STRPTR, struct CopyData *);
 LONG  IsMatchPattern(STRPTR name, struct CopyData *cd);
 LONG  IsPattern(STRPTR, struct CopyData *); /* return 0 -> NOPATTERN, return -1 --> ERROR */
@@ -1176,6 +1192,21 @@ __startup static AROS_PROCH(Start, argstr, argsize, SysBase)
             FreeMem(cd->CopyBuf, cd->CopyBufLen);
         }
 
+#if USE_PIPELINEDCOPY
+        if (cd->PipePkt[0])
+        {
+            FreeDosObject(DOS_STDPKT, cd->PipePkt[0]);
+        }
+        if (cd->PipePkt[1])
+        {
+            FreeDosObject(DOS_STDPKT, cd->PipePkt[1]);
+        }
+        if (cd->PipePort)
+        {
+            DeleteMsgPort(cd->PipePort);
+        }
+#endif
+
 #undef SysBase
 #undef DOSBase
     }
@@ -2187,7 +2218,16 @@ LONG CopyFile(BPTR from, BPTR to, ULONG bufsize, struct CopyData *cd)
         }
         else
 #endif /* USE_BOGUSEOFWORKAROUND */
+#if USE_PIPELINEDCOPY
+        if ((err = PipeCopy(from, to, buffer, bufsize, cd)) >= 0)
+        {
+            /* done by the pipeline, err is RETURN_OK or RETURN_FAIL */
+        }
+        else
+#endif /* USE_PIPELINEDCOPY */
         {
+            err = 0;
+
             /* Stream or so, copy until EOF or error */
             do
             {
@@ -2220,6 +2260,207 @@ LONG CopyFile(BPTR from, BPTR to, ULONG bufsize, struct CopyData *cd)
 }
 
 
+#if USE_PIPELINEDCOPY
+/* Returns the de_MaxTransfer of the device behind a filehandle, 0 if unknown */
+ULONG MaxTransfer(BPTR fh, struct CopyData *cd)
+{
+    struct MsgPort *port = ((struct FileHandle *) BADDR(fh))->fh_Type;
+    struct DosList *dl;
+    ULONG max = 0;
+
+    dl = LockDosList(LDF_DEVICES | LDF_READ);
+    while ((dl = NextDosEntry(dl, LDF_DEVICES)))
+    {
+        struct FileSysStartupMsg *fssm;
+        struct DosEnvec *de;
+
+        if (dl->dol_Task != port)
+        {
+            continue;
+        }
+
+        fssm = (struct FileSysStartupMsg *) BADDR(dl->dol_misc.dol_handler.dol_Startup);
+        if (fssm && TypeOfMem(fssm) && TypeOfMem(BADDR(fssm->fssm_Environ)))
+        {
+            de = (struct DosEnvec *) BADDR(fssm->fssm_Environ);
+            if (de->de_TableSize >= DE_MAXTRANSFER)
+            {
+                max = de->de_MaxTransfer;
+            }
+        }
+        break;
+    }
+    UnLockDosList(LDF_DEVICES | LDF_READ);
+
+    return max;
+}
+
+
+/*
+** Copies through a ring of PIPE_BUFFERS chunks of the copy buffer. One
+** ACTION_READ and one ACTION_WRITE packet are kept in flight, so the
+** source device fills the next chunk while the destination writes the
+** previous one. Chunks are sized to the smaller de_MaxTransfer of both
+** devices, so the handlers don't have to split the transfers again.
+**
+** Returns -1 when the handles are not suited (NIL:, interactive) or the
+** packets can't be allocated, the caller falls back to Read()/Write().
+*/
+LONG PipeCopy(BPTR from, BPTR to, STRPTR buffer, ULONG bufsize, struct CopyData *cd)
+{
+    struct FileHandle *ifh = (struct FileHandle *) BADDR(from);
+    struct FileHandle *ofh = (struct FileHandle *) BADDR(to);
+    struct DosPacket *rdp, *wdp;
+    LONG len[PIPE_BUFFERS];
+    ULONG chunk, max, rd = 0, wr = 0, filled = 0;
+    BOOL reading = FALSE, writing = FALSE, eof = FALSE;
+    LONG ioerr = 0;
+
+    if (!ifh->fh_Type || !ofh->fh_Type || IsInteractive(from) || IsInteractive(to)
+        || bufsize < PIPE_BUFFERS * PIPE_MINCHUNK)
+    {
+        return -1;
+    }
+
+    if (!cd->PipePort)
+    {
+        if (!(cd->PipePort = CreateMsgPort()))
+        {
+            return -1;
+        }
+    }
+    if (!cd->PipePkt[0])
+    {
+        cd->PipePkt[0] = AllocDosObject(DOS_STDPKT, NULL);
+    }
+    if (!cd->PipePkt[1])
+    {
+        cd->PipePkt[1] = AllocDosObject(DOS_STDPKT, NULL);
+    }
+    if (!(rdp = cd->PipePkt[0]) || !(wdp = cd->PipePkt[1]))
+    {
+        return -1;
+    }
+
+    chunk = (bufsize / PIPE_BUFFERS) & ~(PIPE_MINCHUNK - 1);
+    if ((max = MaxTransfer(from, cd)) && max < chunk)
+    {
+        chunk = max;
+    }
+    if ((max = MaxTransfer(to, cd)) && max < chunk)
+    {
+        chunk = max;
+    }
+    chunk &= ~(PIPE_MINCHUNK - 1);
+    if (chunk < PIPE_MINCHUNK)
+    {
+        chunk = PIPE_MINCHUNK;
+    }
+
+    D(bug("[Copy] PipeCopy: %lu x %lu bytes\n", PIPE_BUFFERS, chunk));
+
+    /* nothing may be left in the buffered i/o, packets bypass it */
+    Flush(from);
+    Flush(to);
+
+    for (;;)
+    {
+        struct Message *msg;
+        struct DosPacket *dp;
+
+        if (!ioerr && CTRL_C)
+        {
+            ioerr = ERROR_BREAK;
+        }
+
+        /* fill the next free chunk */
+        if (!reading && !eof && !ioerr && filled < PIPE_BUFFERS)
+        {
+            rdp->dp_Type = ACTION_READ;
+            rdp->dp_Arg1 = ifh->fh_Arg1;
+            rdp->dp_Arg2 = (SIPTR) (buffer + rd * chunk);
+            rdp->dp_Arg3 = chunk;
+            SendPkt(rdp, ifh->fh_Type, cd->PipePort);
+            reading = TRUE;
+        }
+
+        /* write the oldest filled chunk */
+        if (!writing && !ioerr && filled > 0)
+        {
+            wdp->dp_Type = ACTION_WRITE;
+            wdp->dp_Arg1 = ofh->fh_Arg1;
+            wdp->dp_Arg2 = (SIPTR) (buffer + wr * chunk);
+            wdp->dp_Arg3 = len[wr];
+            SendPkt(wdp, ofh->fh_Type, cd->PipePort);
+            writing = TRUE;
+        }
+
+        if (!reading && !writing)
+        {
+            break;
+        }
+
+        /* errors and breaks drain the packets in flight before leaving */
+        WaitPort(cd->PipePort);
+        while ((msg = GetMsg(cd->PipePort)))
+        {
+            dp = (struct DosPacket *) msg->mn_Node.ln_Name;
+
+            if (dp == rdp)
+            {
+                reading = FALSE;
+                if (dp->dp_Res1 < 0)
+                {
+                    if (!ioerr)
+                    {
+                        ioerr = dp->dp_Res2;
+                    }
+                }
+                else if (dp->dp_Res1 == 0)
+                {
+                    eof = TRUE;
+                }
+                else
+                {
+                    len[rd] = dp->dp_Res1;
+                    rd = (rd + 1) % PIPE_BUFFERS;
+                    ++filled;
+                }
+            }
+            else if (dp == wdp)
+            {
+                writing = FALSE;
+                if (dp->dp_Res1 != len[wr])
+                {
+                    if (!ioerr)
+                    {
+                        ioerr = dp->dp_Res1 < 0 ? dp->dp_Res2 : ERROR_DISK_FULL;
+                    }
+                }
+                else
+                {
+                    wr = (wr + 1) % PIPE_BUFFERS;
+                    --filled;
+                }
+            }
+        }
+    }
+
+    if (ioerr)
+    {
+        if (ioerr == ERROR_BREAK)
+        {
+            cd->IoErr = ERROR_BREAK;
+        }
+        SetIoErr(ioerr);
+        return RETURN_FAIL;
+    }
+
+    return RETURN_OK;
+}
+#endif /* USE_PIPELINEDCOPY */
+
+
 /* Softlink's path starts always with device name! f.e. "Ram Disk:T/..." */
 LONG LinkFile(BPTR from, STRPTR to, ULONG soft, struct CopyData *cd)
 {
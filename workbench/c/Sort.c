@@ -13,23 +13,28 @@
 
     SYNOPSIS
 
-        FROM/A,TO/A,COLSTART/K,CASE/S,NUMERIC/S
+        FROM/A,TO/A,COLSTART/K,CASE/S,NUMERIC/S,REVERSE/S,UNIQUE/S
 
     LOCATION
 
         C:
-	   
+
     FUNCTION
 
 	Sorts the contents of a text file
-	
+
     INPUTS
 
 	FROM      -- file to read from
 	TO        -- file to output to
-	COLSTART  -- column at which the comparison begins
+	COLSTART  -- column at which the comparison begins. Lines that are
+	             too short to reach it are output first
 	CASE      -- sort is case sensitive. Uppercase items are output first
-	NUMERIC   -- lines are interpreted as numbers
+	NUMERIC   -- lines are compared by the number they start with (at
+	             COLSTART), lines with equal numbers by their text
+	REVERSE   -- output the lines in reverse order
+	UNIQUE    -- of several lines that compare equal only output the
+	             first one
 
     RESULT
 
@@ -41,6 +46,13 @@
 
     INTERNALS
 
+	The input is read into one buffer, as large as the file or half of
+	the largest free memory block, whichever is smaller. Line records
+	are taken from an arena, the sort key of every line is worked out
+	once, and the lines are merge sorted. Input that doesn't fit into the
+	buffer is sorted in runs which are written to T: and merged
+	afterwards.
+
     HISTORY
 
 ******************************************************************************/
@@ -54,247 +66,641 @@
 #include <proto/exec.h>
 #include <proto/utility.h>
 #include <proto/locale.h>
+#include <proto/alib.h>
 #include <libraries/locale.h>
 #include <utility/tagitem.h>
 
 #define DEBUG 0
 #include <aros/debug.h>
 
-#define TEMPLATE "FROM/A,TO/A,COLSTART/K,CASE/S,NUMERIC/S"
+#define TEMPLATE "FROM/A,TO/A,COLSTART/K,CASE/S,NUMERIC/S,REVERSE/S,UNIQUE/S"
 
 #define ARG_FROM	0
 #define ARG_TO		1
 #define ARG_COLSTART	2
 #define ARG_CASE	3
 #define ARG_NUMERIC	4
+#define ARG_REVERSE	5
+#define ARG_UNIQUE	6
+
+#define ARG_NUM		7
 
-#define ARG_NUM		5
+#define LINES_PER_BLOCK	4096		/* line records per arena block */
+#define MIN_BUFFER	(64 * 1024)	/* smallest input buffer */
+#define RUN_BUFFER	(16 * 1024)	/* read buffer per run while merging */
+#define IO_BUFFER	(64 * 1024)	/* buffer for the output files */
 
-const TEXT version[] = "$VER: Sort 41.2 (3.4.2014)";
+const TEXT version[] = "$VER: Sort 41.3 (16.10.2026)";
 
 struct sorted_data
 {
   struct sorted_data * next;
   UBYTE              * data;
-  ULONG                len; // length of line including '\n'.
+  ULONG                len;     // length of line without '\n'.
+  UBYTE              * key;     // where the comparison begins.
+  ULONG                keylen;  // 0 if the line is shorter than COLSTART.
+  QUAD                 number;  // value of the key for NUMERIC.
+};
+
+/* Line records are handed out from blocks which are reused for every run */
+struct sorted_block
+{
+  struct sorted_block * next;
+  ULONG                 used;
+  struct sorted_data    lines[LINES_PER_BLOCK];
+};
+
+struct sort_options
+{
+  ULONG col;
+  BOOL  case_on;
+  BOOL  is_numeric;
+  BOOL  reverse;
+  BOOL  unique;
+};
+
+/* A sorted run on T: which is being merged */
+struct sort_run
+{
+  BPTR               file;
+  UBYTE            * buf;
+  ULONG              pos;
+  ULONG              fill;
+  UBYTE            * line;      // current line, copied out of buf.
+  ULONG              linesize;
+  struct sorted_data sd;
+  ULONG              index;     // keeps equal lines in input order.
 };
 
 struct Locale * locale;
 
-int compare(struct sorted_data * sd1, 
-            struct sorted_data * sd2, 
-            ULONG col, 
-            BOOL case_on)
+static struct sorted_block * blocks;
+static struct sorted_block * cur_block;
+
+
+void set_key(struct sorted_data * sd, struct sort_options * opts)
+{
+  UBYTE * p;
+  ULONG   n;
+  BOOL    negative = FALSE;
+
+  if (sd->len > opts->col)
+  {
+    sd->key    = sd->data + opts->col;
+    sd->keylen = sd->len - opts->col;
+  }
+  else
+  {
+    sd->key    = sd->data + sd->len;
+    sd->keylen = 0;
+  }
+
+  sd->number = 0;
+  if (!opts->is_numeric)
+    return;
+
+  p = sd->key;
+  n = sd->keylen;
+  while (n > 0 && (*p == ' ' || *p == '\t'))
+  {
+    p++;
+    n--;
+  }
+  if (n > 0 && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    p++;
+    n--;
+  }
+  while (n > 0 && *p >= '0' && *p <= '9')
+  {
+    sd->number = sd->number * 10 + *p++ - '0';
+    n--;
+  }
+  if (negative)
+    sd->number = -sd->number;
+}
+
+
+LONG compare(struct sorted_data * sd1,
+             struct sorted_data * sd2,
+             struct sort_options * opts)
 {
-  ULONG len = MIN(sd1->len, sd2->len);
- 
-  /* FIXME:  It seems like StrnCmp of locale does not work. */
-#if 1
   LONG retval = 0;
-  
-  if (case_on)
+
+  /* Lines too short to be sorted in go first, also with REVERSE */
+  if (sd1->keylen == 0 || sd2->keylen == 0)
+    return (sd1->keylen != 0) - (sd2->keylen != 0);
+
+  if (opts->is_numeric && sd1->number != sd2->number)
+  {
+    retval = (sd1->number < sd2->number) ? -1 : 1;
+  }
+  else
+  {
+    ULONG len = MIN(sd1->keylen, sd2->keylen);
+
+    if (opts->case_on)
+    {
+      /* Plain character order puts the uppercase letters first */
+      ULONG i;
+
+      for (i = 0; i < len && retval == 0; i++)
+        retval = (LONG)sd1->key[i] - (LONG)sd2->key[i];
+    }
+    else
+      retval = StrnCmp(locale, sd1->key, sd2->key, len, SC_COLLATE2);
+
+    if (retval == 0)
+      retval = (LONG)sd1->keylen - (LONG)sd2->keylen;
+  }
+
+  return opts->reverse ? -retval : retval;
+}
+
+
+struct sorted_data * new_line(void)
+{
+  if (cur_block == NULL || cur_block->used == LINES_PER_BLOCK)
+  {
+    struct sorted_block * block = cur_block ? cur_block->next : blocks;
+
+    if (block == NULL)
+    {
+      block = AllocVec(sizeof(struct sorted_block), MEMF_ANY);
+      if (block == NULL)
+        return NULL;
+
+      block->next = NULL;
+      if (cur_block)
+        cur_block->next = block;
+      else
+        blocks = block;
+    }
+    block->used = 0;
+    cur_block = block;
+  }
+
+  return &cur_block->lines[cur_block->used++];
+}
+
+
+void free_lines(void)
+{
+  while (blocks)
+  {
+    struct sorted_block * next = blocks->next;
+
+    FreeVec(blocks);
+    blocks = next;
+  }
+  cur_block = NULL;
+}
+
+
+/*
+** Stable bottom-up merge sort of a singly linked list.
+*/
+struct sorted_data * sort(struct sorted_data * list,
+                          struct sort_options * opts)
+{
+  ULONG insize = 1;
+
+  if (list == NULL)
+    return NULL;
+
+  while (1)
   {
-    int i = col;
-    
-    while (i < len)
+    struct sorted_data * p = list;
+    struct sorted_data * tail = NULL;
+    ULONG merges = 0;
+
+    list = NULL;
+
+    while (p)
     {
-      BOOL a,b;
-      a = IsUpper(locale,(ULONG)*(sd1->data+col+i));
-      b = IsUpper(locale,(ULONG)*(sd2->data+col+i));
-      
-      if (a == b)
+      struct sorted_data * q = p;
+      struct sorted_data * e;
+      ULONG psize = 0;
+      ULONG qsize = insize;
+
+      merges++;
+      while (q && psize < insize)
       {
-        if (0 != (retval = StrnCmp(locale,
-                           sd1->data+col,
-                           sd2->data+col,
-                           1,
-                           SC_COLLATE2)))
-          break;
+        psize++;
+        q = q->next;
       }
-      else
+
+      while (psize > 0 || (qsize > 0 && q))
       {
-       retval = b - a;
-       break;
+        if (psize == 0)
+        {
+          e = q; q = q->next; qsize--;
+        }
+        else if (qsize == 0 || q == NULL || compare(p, q, opts) <= 0)
+        {
+          e = p; p = p->next; psize--;
+        }
+        else
+        {
+          e = q; q = q->next; qsize--;
+        }
+
+        if (tail)
+          tail->next = e;
+        else
+          list = e;
+        tail = e;
       }
-      
-      i++;
+
+      p = q;
     }
+    tail->next = NULL;
+
+    if (merges <= 1)
+      return list;
+
+    insize *= 2;
   }
-  else
+}
+
+
+LONG write_line(struct sorted_data * sd, BPTR file_out)
+{
+  if ((sd->len && FWrite(file_out, sd->data, 1, sd->len) != sd->len) ||
+      FPutC(file_out, '\n') == ENDSTREAMCH)
+    return IoErr();
+
+  return 0;
+}
+
+
+LONG write_data(struct sorted_data * start,
+                BPTR file_out,
+                struct sort_options * opts)
+{
+  struct sorted_data * prev = NULL;
+  LONG error = 0;
+
+  for (; start && error == 0; start = start->next)
   {
+    if (opts->unique && prev && compare(prev, start, opts) == 0)
+      continue;
 
-    retval=StrnCmp(locale,
-                   sd1->data+col,
-                   sd2->data+col,
-                   len,
-                   SC_COLLATE2);  
+    error = write_line(start, file_out);
+    prev  = start;
+  }
 
-    if (0 == retval)
+  return error;
+}
+
+
+void run_name(STRPTR buffer, ULONG index)
+{
+  __sprintf(buffer, "T:Sort.%08lx.%lu", (ULONG)(IPTR)FindTask(NULL), index);
+}
+
+
+BOOL store_line(struct sort_run * run, UBYTE * data, ULONG len, ULONG at)
+{
+  if (at + len > run->linesize)
+  {
+    ULONG  size = MAX(run->linesize * 2, at + len);
+    UBYTE *line = AllocVec(size, MEMF_ANY);
+
+    if (line == NULL)
+      return FALSE;
+    if (run->line)
     {
-      if (sd1->len < sd2->len)
-        retval = -100;
-      else
-        retval = +100;
+      CopyMem(run->line, line, at);
+      FreeVec(run->line);
     }
+    run->line     = line;
+    run->linesize = size;
   }
-  
-  return retval;
+  CopyMem(data, run->line + at, len);
+
+  return TRUE;
+}
 
-#else  
-  int i = col;
-  char * str1 = sd1->data;
-  char * str2 = sd2->data;
 
-  while (i < len)
+/*
+** Reads the next line of a run. Returns FALSE at the end of the run or
+** with *error set.
+*/
+BOOL read_run(struct sort_run * run, struct sort_options * opts, LONG * error)
+{
+  ULONG len = 0;
+
+  while (1)
   {
-    if (str1[i] != str2[i])
-      return (int)(str1[i] - str2[i]);
+    ULONG end;
+
+    if (run->pos == run->fill)
+    {
+      LONG count = Read(run->file, run->buf, RUN_BUFFER);
 
-    i++;
+      if (count < 0)
+      {
+        *error = IoErr();
+        return FALSE;
+      }
+      if (count == 0)
+      {
+        if (len == 0)
+          return FALSE;
+        break;
+      }
+      run->pos  = 0;
+      run->fill = count;
+    }
+
+    for (end = run->pos; end < run->fill && run->buf[end] != 0x0a; end++);
+
+    if (!store_line(run, run->buf + run->pos, end - run->pos, len))
+    {
+      *error = ERROR_NO_FREE_STORE;
+      return FALSE;
+    }
+    len += end - run->pos;
+    run->pos = end;
+
+    if (run->pos < run->fill)
+    {
+      run->pos++;
+      break;
+    }
   }
-  
-  return (int)sd1->len - (int)sd2->len;
-#endif
-} 
 
+  run->sd.data = run->line;
+  run->sd.len  = len;
+  set_key(&run->sd, opts);
+
+  return TRUE;
+}
 
-struct sorted_data * sort(UBYTE * data,
-                          ULONG   data_len,
-                          STRPTR  colstart,
-                          BOOL    case_on,
-                          BOOL    is_numeric)
+
+BOOL run_before(struct sort_run * run1,
+                struct sort_run * run2,
+                struct sort_options * opts)
 {
-  ULONG pos = 0;
-  ULONG col = 0;
-  struct sorted_data * first = NULL;
-  struct sorted_data * cur   = NULL;
-  struct sorted_data * tooshort = NULL;
-  struct sorted_data * tooshort_last = NULL;
-  
-  if (colstart)
+  LONG retval = compare(&run1->sd, &run2->sd, opts);
+
+  return retval < 0 || (retval == 0 && run1->index < run2->index);
+}
+
+
+void sift_down(struct sort_run ** heap,
+               ULONG count,
+               ULONG i,
+               struct sort_options * opts)
+{
+  while (1)
   {
-    while (*colstart >= '0' && *colstart <= '9')
-      col = col * 10 + *colstart++ - '0';
-    if (col > 0)
-      col-=1;
+    ULONG child = 2 * i + 1;
+    struct sort_run * swap;
+
+    if (child >= count)
+      break;
+    if (child + 1 < count && run_before(heap[child + 1], heap[child], opts))
+      child++;
+    if (!run_before(heap[child], heap[i], opts))
+      break;
+
+    swap        = heap[i];
+    heap[i]     = heap[child];
+    heap[child] = swap;
+    i = child;
   }
+}
 
-  while (pos < data_len)
+
+/*
+** Merges the sorted runs on T: into the output file.
+*/
+LONG merge_runs(ULONG num_runs,
+                BPTR file_out,
+                struct sort_options * opts)
+{
+  struct sort_run  * runs;
+  struct sort_run ** heap;
+  struct sort_run    last = { 0 };
+  BOOL  have_last = FALSE;
+  ULONG count = 0;
+  ULONG i;
+  LONG  error = 0;
+  TEXT  name[32];
+
+  runs = AllocVec(num_runs * (sizeof(struct sort_run) + sizeof(APTR)),
+                  MEMF_ANY | MEMF_CLEAR);
+  if (runs == NULL)
+    return ERROR_NO_FREE_STORE;
+  heap = (struct sort_run **)&runs[num_runs];
+
+  for (i = 0; i < num_runs && error == 0; i++)
   {
-    ULONG begin = pos;
-    ULONG len;
+    run_name(name, i);
+    runs[i].index = i;
+    runs[i].buf   = AllocVec(RUN_BUFFER, MEMF_ANY);
+    runs[i].file  = Open(name, MODE_OLDFILE);
+
+    if (runs[i].buf == NULL)
+      error = ERROR_NO_FREE_STORE;
+    else if (runs[i].file == BNULL)
+      error = IoErr();
+    else if (read_run(&runs[i], opts, &error))
+      heap[count++] = &runs[i];
+  }
 
-    while (pos < data_len && data[pos] != 0x0a)
-      pos++;
+  if (error == 0)
+  {
+    for (i = count / 2; i-- > 0;)
+      sift_down(heap, count, i, opts);
+  }
 
-    if (data[pos] == 0x0a || pos == data_len)
-      len = pos++ - begin;
-    else
-      len = ++pos - begin;
+  while (count > 0 && error == 0)
+  {
+    struct sort_run * run = heap[0];
 
-    cur = AllocMem(sizeof(struct sorted_data), MEMF_ANY|MEMF_CLEAR);
-      
-    if (cur)
+    if (!opts->unique || !have_last || compare(&last.sd, &run->sd, opts) != 0)
     {
-      cur->data = data + begin;
-      cur->len  = len;
-    
-      if (len > col)
-      {
-        /*
-        ** Insert it into the list of sorted lines 
-        */
-        if (NULL != first)
-        {
-          /*
-          ** To be first in the list?
-          */
-          if (compare(cur, first, col, case_on) < 0)
-          {
-            cur->next = first;
-            first     = cur;
-          }
-          else
-          {
-            struct sorted_data * _cur = first;
-
-            while (1)
-            {
-              /*
-              ** Insert it after the current one and before the
-              ** next one?
-              */
-              if (NULL == _cur->next)
-              {
-                _cur->next = cur;
-                break;
-              }
-              if (compare(cur, _cur->next, col, case_on) < 0)
-              {
-                cur -> next = _cur->next;
-                _cur-> next = cur;
-                break;
-              }
-       
-              _cur = _cur->next;
-            }
-          }
-        } /* if (NULL != first) */
-        else
-          first = cur;
-      }
-      else
+      error = write_line(&run->sd, file_out);
+
+      if (opts->unique && error == 0)
       {
-        /* this line is too short to sort it in */
-        if (NULL == tooshort)
+        /* Keep a copy, the run's line buffer is about to be overwritten */
+        if (store_line(&last, run->sd.data, run->sd.len, 0))
         {
-          tooshort = cur;
-          tooshort_last = cur;
+          last.sd.data = last.line;
+          last.sd.len  = run->sd.len;
+          set_key(&last.sd, opts);
+          have_last = TRUE;
         }
         else
-        {
-          tooshort_last->next = cur;
-          tooshort_last = cur;
-        }
+          error = ERROR_NO_FREE_STORE;
       }
-    } /* if (cur) */
-      
+    }
+
+    if (error == 0 && !read_run(run, opts, &error))
+      heap[0] = heap[--count];
+    sift_down(heap, count, 0, opts);
   }
 
-  if (NULL != tooshort)
+  for (i = 0; i < num_runs; i++)
   {
-    tooshort_last->next = first;
-    first = tooshort;
+    if (runs[i].file)
+      Close(runs[i].file);
+    FreeVec(runs[i].buf);
+    FreeVec(runs[i].line);
   }
+  FreeVec(last.line);
+  FreeVec(runs);
 
-  return first;
+  return error;
 }
 
 
-LONG write_data(struct sorted_data * start, BPTR file_out)
+/*
+** Sorts file_in into file_out. As much of the input as fits into the
+** buffer is sorted at a time. If that is all of it, it's written out
+** directly, otherwise every buffer full becomes a run on T: and the runs
+** are merged at the end.
+*/
+LONG sort_file(BPTR file_in,
+               BPTR file_out,
+               struct sort_options * opts)
 {
-  BOOL write = TRUE;
-  LONG error = 0;
-  LONG count;
-  
-  while (start)
+  struct FileInfoBlock * fib;
+  UBYTE * data;
+  ULONG   data_len = 0;
+  ULONG   size;
+  ULONG   num_runs = 0;
+  BOOL    eof = FALSE;
+  LONG    error = 0;
+  TEXT    name[32];
+
+  /*
+  ** Size the buffer to the file if it fits into half of the
+  ** largest free block.
+  */
+  size = AvailMem(MEMF_ANY | MEMF_LARGEST) / 2;
+  if ((fib = AllocDosObject(DOS_FIB, NULL)))
   {
-    struct sorted_data * next = start->next;
+    if (ExamineFH(file_in, fib) && fib->fib_Size >= 0 &&
+        (ULONG)fib->fib_Size < size)
+      size = fib->fib_Size + 1;
+    FreeDosObject(DOS_FIB, fib);
+  }
+  size = MAX(size, MIN_BUFFER);
+
+  data = AllocVec(size, MEMF_ANY);
+  if (data == NULL)
+    return ERROR_NO_FREE_STORE;
+
+  SetVBuf(file_out, NULL, BUF_FULL, IO_BUFFER);
 
-    if (write)
+  while (error == 0)
+  {
+    struct sorted_data * first = NULL;
+    struct sorted_data ** last = &first;
+    BPTR  file_run;
+    ULONG pos = 0;
+    BOOL  no_memory = FALSE;
+
+    /* Fill up the buffer */
+    while (!eof && data_len < size)
     {
-      count = Write(file_out, start->data, start->len);
-      if (count != -1 && start->data[start->len-1] != 0x0a)
-        count = Write(file_out, "\n", 1);
-      if (count == -1)
-      {
+      LONG count = Read(file_in, data + data_len, size - data_len);
+
+      if (count < 0)
         error = IoErr();
-        write = FALSE;
+      if (count <= 0)
+        eof = TRUE;
+      else
+        data_len += count;
+    }
+    if (error)
+      break;
+
+    if (eof && data_len == 0 && num_runs > 0)
+      break;
+
+    /* Cut it into lines, leaving an incomplete last line for later */
+    cur_block = NULL;
+    while (pos < data_len)
+    {
+      struct sorted_data * cur;
+      ULONG end;
+
+      for (end = pos; end < data_len && data[end] != 0x0a; end++);
+
+      if (end == data_len && !eof)
+        break;
+      if ((cur = new_line()) == NULL)
+      {
+        no_memory = TRUE;
+        break;
       }
+
+      cur->data = data + pos;
+      cur->len  = end - pos;
+      set_key(cur, opts);
+      *last = cur;
+      last  = &cur->next;
+
+      pos = (end < data_len) ? end + 1 : end;
+    }
+    *last = NULL;
+
+    if (pos == 0 && data_len > 0)
+    {
+      /* Not even one line fits */
+      error = no_memory ? ERROR_NO_FREE_STORE : ERROR_LINE_TOO_LONG;
+      break;
     }
 
-    FreeMem(start, sizeof(struct sorted_data));
-    start = next;
+    first = sort(first, opts);
+
+    if (num_runs == 0 && eof && pos == data_len)
+    {
+      error = write_data(first, file_out, opts);
+      break;
+    }
+
+    run_name(name, num_runs);
+    D(bug("[Sort] Writing run %s\n", name));
+
+    if ((file_run = Open(name, MODE_NEWFILE)))
+    {
+      num_runs++;
+      SetVBuf(file_run, NULL, BUF_FULL, IO_BUFFER);
+      error = write_data(first, file_run, opts);
+      if (!Close(file_run) && error == 0)
+        error = IoErr();
+    }
+    else
+      error = IoErr();
+
+    /* Move what's left to the start of the buffer */
+    data_len -= pos;
+    CopyMem(data + pos, data, data_len);
+  }
+
+  FreeVec(data);
+  free_lines();
+
+  if (num_runs > 0)
+  {
+    ULONG i;
+
+    if (error == 0)
+      error = merge_runs(num_runs, file_out, opts);
+
+    for (i = 0; i < num_runs; i++)
+    {
+      run_name(name, i);
+      DeleteFile(name);
+    }
   }
 
   return error;
@@ -304,7 +710,7 @@ int __nocommandline;
 
 int main (void)
 {
-  IPTR args[ARG_NUM] = { (IPTR) NULL, (IPTR) NULL, (IPTR) NULL, FALSE, FALSE};
+  IPTR args[ARG_NUM] = { (IPTR) NULL, (IPTR) NULL, (IPTR) NULL, FALSE, FALSE, FALSE, FALSE};
   struct RDArgs *rda;
   LONG result = RETURN_OK;
   LONG error = 0;
@@ -319,59 +725,40 @@ int main (void)
   rda = ReadArgs(TEMPLATE, args, NULL);
   if (rda)
   {
-    BPTR lock_in;
-    lock_in = Lock((STRPTR)args[ARG_FROM], ACCESS_READ);
+    BPTR file_in = Open((STRPTR)args[ARG_FROM], MODE_OLDFILE);
 
-    if (lock_in)
+    if (file_in)
     {
        BPTR file_out = Open((STRPTR)args[ARG_TO], MODE_NEWFILE);
-       if (file_out == BNULL)
-         error = IoErr();
-       struct FileInfoBlock *fib = AllocDosObject(DOS_FIB, NULL);
-       if (fib == NULL)
-         error = IoErr();
 
-       if (error == 0)
+       if (file_out)
        {
-          UBYTE * data = NULL;
-          BOOL success = Examine(lock_in, fib);
+          struct sort_options opts;
+          STRPTR colstart = (STRPTR)args[ARG_COLSTART];
 
-          /*
-          ** Read the input file into memory
-          */
-          if (fib->fib_Size && success)
-            data = AllocVec(fib->fib_Size, MEMF_ANY);
+          opts.col        = 0;
+          opts.case_on    = (BOOL)args[ARG_CASE];
+          opts.is_numeric = (BOOL)args[ARG_NUMERIC];
+          opts.reverse    = (BOOL)args[ARG_REVERSE];
+          opts.unique     = (BOOL)args[ARG_UNIQUE];
 
-          if (data)
+          if (colstart)
           {
-            BPTR in;
-            if ((in = OpenFromLock(lock_in))) {
-                ULONG read = Read(in, data, fib->fib_Size);
-
-                if (-1 != read)
-                {
-                  struct sorted_data * sd;
-                  sd = sort(data, 
-                            fib->fib_Size, 
-                            (STRPTR)args[ARG_COLSTART],
-                            (BOOL)args[ARG_CASE],
-                            (BOOL)args[ARG_NUMERIC]);
-
-                  error = write_data(sd, file_out);
-                }
-                Close(in);
-                lock_in = BNULL;
-            }
-            FreeVec(data);
+            while (*colstart >= '0' && *colstart <= '9')
+              opts.col = opts.col * 10 + *colstart++ - '0';
+            if (opts.col > 0)
+              opts.col -= 1;
           }
-          else
-            error = IoErr();
 
-          Close(file_out);  
+          error = sort_file(file_in, file_out, &opts);
+
+          if (!Close(file_out) && error == 0)
+            error = IoErr();
        }
-       FreeDosObject(DOS_FIB, fib);
-       if (lock_in)
-           UnLock(lock_in);
+       else
+         error = IoErr();
+
+       Close(file_in);
     }
     else
       error = IoErr();
@@ -380,6 +767,8 @@ int main (void)
   else
     error = IoErr();
 
+  CloseLocale(locale);
+
   if (error)
   {
     PrintFault(error, "Sort");
@@ -167,7 +167,30 @@ static void JPEG_Exit(JpegHandleType *jpeghandle, LONG errorcode)
 
 /**************************************************************************************************/
 
-static BOOL LoadJPEG(struct IClass *cl, Object *o)
+/* Pick the smallest DCT scaling (1/1, 1/2, 1/4 or 1/8) which fits into maxwidth x maxheight */
+static void JPEG_SetScale(j_decompress_ptr cinfo, ULONG maxwidth, ULONG maxheight)
+{
+    unsigned int denom = 1;
+
+    while (denom < 8 &&
+	   ((maxwidth && (cinfo->image_width + denom - 1) / denom > maxwidth) ||
+	    (maxheight && (cinfo->image_height + denom - 1) / denom > maxheight)))
+	denom <<= 1;
+
+    if (denom > 1)
+    {
+	/* A reduced picture is a preview, trade some accuracy for speed */
+	cinfo->scale_num = 1;
+	cinfo->scale_denom = denom;
+	cinfo->dct_method = JDCT_IFAST;
+	cinfo->do_fancy_upsampling = FALSE;
+	D(bug("jpeg.datatype/LoadJPEG(): Scaling by 1/%d\n", denom));
+    }
+}
+
+/**************************************************************************************************/
+
+static BOOL LoadJPEG(struct IClass *cl, Object *o, ULONG maxwidth, ULONG maxheight)
 {
     JpegHandleType          *jpeghandle;
     union {
@@ -181,8 +204,11 @@ static BOOL LoadJPEG(struct IClass *cl, Object *o)
 
     struct jpeg_decompress_struct cinfo;
     struct my_error_mgr jerr;
-    JSAMPARRAY buffer;		/* Output row buffer */
+    JSAMPARRAY buffer;		/* Output strip row pointers */
+    JSAMPLE *strip;		/* Output strip */
     int row_stride;		/* physical row width in output buffer */
+    int strip_height;		/* rows per PDTM_WRITEPIXELARRAY */
+    int row, top;
     my_src_ptr src;
 
     D(bug("jpeg.datatype/LoadJPEG()\n"));
@@ -237,6 +263,8 @@ static BOOL LoadJPEG(struct IClass *cl, Object *o)
     
     D(bug("jpeg.datatype/LoadJPEG(): Read Header\n"));
     (void) jpeg_read_header(&cinfo, TRUE);
+    if (maxwidth || maxheight)
+	JPEG_SetScale(&cinfo, maxwidth, maxheight);
     D(bug("jpeg.datatype/LoadJPEG(): Starting decompression\n"));
     (void) jpeg_start_decompress(&cinfo);
     /* set BitMapHeader with image size */
@@ -251,31 +279,44 @@ static BOOL LoadJPEG(struct IClass *cl, Object *o)
 	return FALSE;
     }
 
-    /* Make a one-row-high sample array that will go away when done with image */
+    /* Make a contiguous strip of one MCU row that will go away when done with image.
+     * alloc_sarray() doesn't guarantee contiguous rows, so set up the row pointers here.
+     */
     row_stride = width * 3;
-    buffer = (*cinfo.mem->alloc_sarray)
-		((j_common_ptr) &cinfo, JPOOL_IMAGE, row_stride, 1);
-    
+    strip_height = cinfo.max_v_samp_factor * cinfo.min_DCT_v_scaled_size;
+    if (strip_height < cinfo.rec_outbuf_height)
+	strip_height = cinfo.rec_outbuf_height;
+    if (strip_height > height)
+	strip_height = height;
+    strip = (JSAMPLE *)(*cinfo.mem->alloc_large)
+		((j_common_ptr) &cinfo, JPOOL_IMAGE, (size_t)row_stride * strip_height);
+    buffer = (JSAMPARRAY)(*cinfo.mem->alloc_small)
+		((j_common_ptr) &cinfo, JPOOL_IMAGE, strip_height * sizeof(JSAMPROW));
+    for (row = 0; row < strip_height; row++)
+	buffer[row] = strip + row * row_stride;
+
     /* Here we use the library's state variable cinfo.output_scanline as the
     * loop counter, so that we don't have to keep track ourselves.
     */
     while (cinfo.output_scanline < height)
     {
-	/* jpeg_read_scanlines expects an array of pointers to scanlines.
-	 * Here the array is only one element long, but you could ask for
-	 * more than one scanline at a time if that's more convenient.
+	/* jpeg_read_scanlines returns at most one row group per call,
+	 * so fill the strip before handing it to picture.datatype.
 	 */
-	(void) jpeg_read_scanlines(&cinfo, buffer, 1);
-	// D(bug("jpeg.datatype/LoadJPEG(): Copy line %ld\n", (long)cinfo.output_scanline));
+	top = cinfo.output_scanline;
+	row = 0;
+	while (row < strip_height && cinfo.output_scanline < height)
+	    row += jpeg_read_scanlines(&cinfo, buffer + row, strip_height - row);
+	// D(bug("jpeg.datatype/LoadJPEG(): Copy lines %ld-%ld\n", (long)top, (long)cinfo.output_scanline-1));
 	if(!DoSuperMethod(cl, o,
 			PDTM_WRITEPIXELARRAY,		/* Method_ID */
-			(IPTR) buffer[0],		/* PixelData */
+			(IPTR) strip,			/* PixelData */
 			PBPAFMT_RGB,			/* PixelFormat */
 			row_stride,			/* PixelArrayMod (number of bytes per row) */
 			0,				/* Left edge */
-			cinfo.output_scanline-1,	/* Top edge */
+			top,				/* Top edge */
 			width,				/* Width */
-			1))				/* Height (here: one line) */
+			row))				/* Height */
 	{
 	    D(bug("jpeg.datatype/LoadJPEG(): WRITEPIXELARRAY failed\n"));
 	    JPEG_Exit(jpeghandle, ERROR_OBJECT_NOT_FOUND);
@@ -466,13 +507,16 @@ static BOOL SaveJPEG(struct IClass *cl, Object *o, struct dtWrite *dtw )
 
 IPTR JPEG__OM_NEW(Class *cl, Object *o, Msg msg)
 {
+    struct TagItem *tags = ((struct opSet *)msg)->ops_AttrList;
     Object *newobj;
     
     D(bug("jpeg.datatype/DT_Dispatcher: Method OM_NEW\n"));
     newobj = (Object *)DoSuperMethodA(cl, o, (Msg)msg);
     if (newobj)
     {
-	if (!LoadJPEG(cl, newobj))
+	if (!LoadJPEG(cl, newobj,
+		      GetTagData(PDTA_MaxDecodeWidth, 0, tags),
+		      GetTagData(PDTA_MaxDecodeHeight, 0, tags)))
 	{
 	    CoerceMethod(cl, newobj, OM_DISPOSE);
 	    newobj = NULL;
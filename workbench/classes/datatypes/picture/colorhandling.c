@@ -28,6 +28,7 @@
 #include "debug.h"
 #include "pictureclass.h"
 #include "colorhandling.h"
+#include "quantize.h"
 
 static void ScaleLineSimple( UBYTE *srcxptr, UBYTE *destxptr, ULONG destwidth, UWORD srcpixelbytes, ULONG xscale );
 static BOOL ScaleArraySimple( struct Picture_Data *pd, struct RastPort rp );
@@ -38,47 +39,8 @@ static BOOL RemapTC2CM( struct Picture_Data *pd );
 static int HistSort( const void *HistEntry1, const void *HistEntry2 );
 static void RemapPens( struct Picture_Data *pd, int NumColors, int DestNumColors );
 
-/**************************************************************************************************/
-/*
-static const UBYTE defcolmap[] =
-{
-    0,118,14,117,116,15,115,4,233,232,234,230,229,228,251,162,
-    30,70,29,127,114,28,79,19,149,227,246,226,225,224,223,245,
-    244,222,221,220,219,161,218,217,27,113,22,108,111,23,110,31,
-    216,215,214,213,212,134,132,143,5,109,13,106,107,17,120,7,
-    50,105,37,104,103,63,68,61,211,210,243,145,138,148,254,208,
-    58,67,2,80,81,44,82,45,242,152,207,206,205,204,235,153,
-    202,201,200,199,198,197,196,195,57,88,62,84,85,56,77,55,
-    167,255,168,169,130,248,170,165,54,66,53,86,87,52,69,51,
-    60,78,49,89,65,46,123,34,141,172,173,159,136,174,175,176,
-    41,90,47,122,124,35,121,43,177,135,163,236,178,142,179,249,
-    180,181,146,241,237,182,157,183,48,95,42,93,71,3,72,38,
-    184,158,185,186,187,155,189,190,36,94,59,119,96,40,73,39,
-    6,97,10,75,99,12,100,8,137,191,253,192,166,252,193,140,
-    18,101,26,102,98,32,126,25,194,164,156,188,239,147,250,131,
-    139,171,238,128,247,150,203,151,24,64,20,125,76,21,92,33,
-    209,129,240,144,160,133,154,231,9,91,16,83,112,11,74,1
-};
-*/
-static const UBYTE defcolmap[] =
-{
-    0,66,8,68,64,10,65,2,136,130,150,142,153,148,149,151,
-    16,72,17,76,70,18,79,20,141,131,144,162,160,168,169,164,
-    177,147,174,170,143,176,180,178,21,77,22,83,80,23,82,24,
-    140,173,181,175,182,184,172,179,3,84,9,85,86,13,88,5,
-    36,89,38,91,92,35,90,37,137,157,156,190,165,185,191,188,
-    39,93,40,75,81,33,96,43,135,128,146,171,194,196,195,193,
-    163,167,129,186,192,197,187,189,44,87,32,94,95,46,97,47,
-    183,199,198,138,201,200,203,202,45,98,49,99,100,48,102,50,
-    34,103,54,71,67,41,74,51,158,208,210,212,211,213,209,205,
-    42,107,55,108,110,52,109,53,152,155,159,207,216,218,219,221,
-    139,161,154,166,206,204,133,215,56,69,58,114,73,59,78,57,
-    145,217,214,220,222,223,224,225,60,105,61,113,101,63,106,62,
-    4,115,12,112,104,14,117,6,228,132,227,229,230,231,234,236,
-    25,119,26,121,118,27,120,28,235,237,239,238,240,241,242,243,
-    232,244,247,226,249,250,253,252,19,124,29,125,116,30,111,31,
-    134,233,246,245,255,254,248,251,7,122,11,123,126,15,127,1
-};
+/* Rows of pens per WriteChunkyPixels() when remapping truecolor */
+#define REMAP_STRIP 16
 
 /**************************************************************************************************/
 
@@ -637,205 +599,157 @@ BOOL CreateMaskPlane( struct Picture_Data *pd )
 
 static BOOL RemapTC2CM( struct Picture_Data *pd )
 {
+    struct QuantHist *hist;
+    struct QuantMap *qm;
+    struct QuantDither qd;
+    WORD *errbuf = NULL;
     unsigned int DestNumColors;
-    int i, j, k;
-    int srccnt, destcnt, index;
-    ULONG *srccolregs, *destcolregs;
-    ULONG Col7, Col3;
+    int NumColors, i, index;
+    UWORD offset;
 
-    pd->NumSparse = pd->NumColors = 256;
     DestNumColors = 1<<pd->DestDepth;
     if( pd->MaxDitherPens )
         DestNumColors = pd->MaxDitherPens;
+    if( DestNumColors > 256 )
+        DestNumColors = 256;
+
+    hist = AllocVec( sizeof(struct QuantHist), MEMF_ANY | MEMF_CLEAR );
+    qm = AllocVec( sizeof(struct QuantMap), MEMF_ANY );
+    if( !hist || !qm )
+    {
+        FreeVec( hist );
+        FreeVec( qm );
+        return FALSE;
+    }
 
     /*
-     *  Create color tables: src is (already present) in "natural" order,
-     *  dest is sorted by priority using a precalculated table;
-     *  "natural" is bits: bbrr.rggg
+     *  Create a palette for the picture by median cut of its histogram
      */
-    Col7 = 0xFFFFFFFF/7;
-    Col3 = 0xFFFFFFFF/3;
-    srccolregs = pd->SrcColRegs;
-    srccnt = 0;
-    destcolregs = pd->DestColRegs;
-    destcnt = 0;
-    for( i=0; i<4; i++ ) /* blue */
-    {
-        for( j=0; j<8; j++ ) /* red */
-        {
-            for( k=0; k<8; k++ ) /* green */
-            {
-                index = 3 * defcolmap[destcnt++];
-                destcolregs[index++] = srccolregs[srccnt++] = j*Col7;
-                destcolregs[index++] = srccolregs[srccnt++] = k*Col7;
-                destcolregs[index]   = srccolregs[srccnt++] = i*Col3;
-            }
-        }
+    offset = (pd->SrcPixelFormat==PBPAFMT_ARGB) ? 1 : 0;
+    QuantHistogram( hist, pd->SrcBuffer, pd->SrcWidth, pd->SrcHeight, pd->SrcWidthBytes, pd->SrcPixelBytes, offset );
+    NumColors = QuantMedianCut( hist, qm->Colors, DestNumColors );
+    FreeVec( hist );
+    D(bug("picture.datatype/RemapTC2CM: %d colors for %d pens\n", NumColors, (int)DestNumColors));
+    if( !NumColors )
+    {
+        FreeVec( qm );
+        return FALSE;
     }
 
     /*
-     *  Allocate Pens and create sparse table for remapping
+     *  The palette becomes the source colors, so SparseTable maps it to the pens
      */
-    RemapPens( pd, 256, DestNumColors );
+    pd->NumSparse = pd->NumColors = NumColors;
+    for( i=0; i<NumColors*3; i++ )
+        pd->SrcColRegs[i] = pd->DestColRegs[i] = (ULONG)qm->Colors[i] * 0x01010101;
 
     /*
-     *  Remap line-by-line truecolor source buffer to destination using sparse table
+     *  Allocate Pens and build the inverse color map from their real colors
+     */
+    RemapPens( pd, NumColors, NumColors );
+    for( i=0; i<NumColors; i++ )
+    {
+        index = pd->ColTable[i] * 3;
+        qm->Pens[i] = pd->ColTable[i];
+        qm->Colors[i*3+0] = pd->DestColRegs[index+0] >> 24;
+        qm->Colors[i*3+1] = pd->DestColRegs[index+1] >> 24;
+        qm->Colors[i*3+2] = pd->DestColRegs[index+2] >> 24;
+    }
+    QuantInitMap( qm, NumColors );
+
+    /*
+     *  Remap line-by-line truecolor source buffer to destination, write in strips
      */
     {
         struct RastPort DestRP;
-        ULONG x, srcy, srcyinc, srcypos;
-        ULONG desty;
-        UBYTE *srcline, *destline, *thissrc, *thisdest;
+        ULONG srcy, srcyinc, srcypos;
+        ULONG desty, striprow, destmod;
+        UBYTE *scaleline = NULL, *destbuf, *thissrc;
+        UWORD pixelbytes;
 
         UBYTE *srcbuf = pd->SrcBuffer;
-        ULONG srcwidth = pd->SrcWidth;
         ULONG destwidth = pd->DestWidth;
-        UBYTE *sparsetable = pd->SparseTable;
-        BOOL argb = pd->SrcPixelFormat==PBPAFMT_ARGB;
-        BOOL rgba = pd->SrcPixelFormat==PBPAFMT_RGBA;
         BOOL scale = pd->Scale;
 
-        srcline = AllocLineBuffer( MAX(srcwidth, destwidth) * 4, 1, 1 );
-        if( !srcline )
-            return FALSE;
+        destmod = MOD16( destwidth );
+        destbuf = AllocLineBuffer( destwidth, REMAP_STRIP, 1 );
         if( scale )
-            destline = AllocLineBuffer( destwidth, 1, 1 );
-        else
-            destline = srcline;
-        if( !destline )
+            scaleline = AllocLineBuffer( destwidth, 1, 4 );
+        if( pd->DitherQuality > 1 )
+            errbuf = AllocVec( QUANT_DITHERBUF(destwidth), MEMF_ANY );
+        if( !destbuf || (scale && !scaleline) || (pd->DitherQuality > 1 && !errbuf) )
+        {
+            FreeVec( destbuf );
+            FreeVec( scaleline );
+            FreeVec( errbuf );
+            FreeVec( qm );
             return FALSE;
+        }
+
+        /* 1 is ordered dither, 2 to 4 diffuse 2/4 to 4/4 of the error */
+        D(bug("picture.datatype/RemapTC2CM: remapping buffer with dither of %d\n", (int)pd->DitherQuality));
+        if( !pd->DitherQuality )
+            QuantInitDither( &qd, QUANT_DITHER_NONE, 0, NULL, destwidth );
+        else if( pd->DitherQuality == 1 )
+            QuantInitDither( &qd, QUANT_DITHER_ORDERED, 0, NULL, destwidth );
+        else
+            QuantInitDither( &qd, QUANT_DITHER_FS, MIN(pd->DitherQuality, 4), errbuf, destwidth );
 
         InitRastPort( &DestRP );
         DestRP.BitMap = pd->DestBM;
         srcy = 0;
         srcyinc = 1;
         srcypos = 0;
-        if( pd->DitherQuality )
+        striprow = 0;
+        pixelbytes = pd->SrcPixelBytes;
+        if( scale )
         {
-            int rval, gval, bval;
-            long rerr, gerr, berr;
-            UBYTE destindex;
-            ULONG *colregs;
-            int feedback;
-            
-            D(bug("picture.datatype/RemapTC2CM: remapping buffer with dither of %d\n", (int)pd->DitherQuality));
-            feedback = 4 - pd->DitherQuality;
-            destcolregs = pd->DestColRegs;
-            for( desty=0; desty<pd->DestHeight; desty++ )
-            {
-                if( srcyinc )	// incremented source line after last line scaling ?
-                {
-                    if( scale )
-                    {
-                        ScaleLineSimple( srcbuf, srcline, destwidth, pd->SrcPixelBytes, pd->XScale );
-                        argb = TRUE;
-                        thissrc = srcline;
-                    }
-                    else
-                    {
-                        thissrc = srcbuf;
-                    }
-                    thisdest = destline;
-                    rerr = gerr = berr = 0;
-                    x = destwidth;
-                    while( x-- )
-                    {
-                        if( argb )
-                            thissrc++;
-                        if( feedback )
-                        {
-                            rerr >>= feedback;
-                            gerr >>= feedback;
-                            berr >>= feedback;
-                        }
-                        rerr += (*thissrc++);
-                        gerr += (*thissrc++);
-                        berr += (*thissrc++);
-                        if( rgba )
-                            thissrc++;
-
-                        rval = CLIP( rerr );
-                        gval = CLIP( gerr );
-                        bval = CLIP( berr );
-                        index = (rval>>2 & 0x38) | (gval>>5 & 0x07) | (bval & 0xc0);
-                        destindex = sparsetable[index];
-                        *thisdest++ = destindex;
-                        colregs = destcolregs + destindex*3;
-                        rerr -= (*colregs++)>>24;
-                        gerr -= (*colregs++)>>24;
-                        berr -= (*colregs)>>24;
-                    }
-                }
-                if( scale )
-                {
-                    srcypos += pd->YScale;
-                    srcyinc = (srcypos >> 16) - srcy;
-                }
-                WriteChunkyPixels( &DestRP,
-                                    0,
-                                    desty,
-                                    destwidth-1,
-                                    desty,
-                                    destline,
-                                    destwidth );
-                if( srcyinc )
-                {
-                    if( srcyinc == 1 )	srcbuf += pd->SrcWidthBytes;
-                    else		srcbuf += pd->SrcWidthBytes * srcyinc;
-                    srcy += srcyinc;
-                }
-            }
+            /* ScaleLineSimple() keeps 4 byte pixels as they are and makes 0RGB of RGB */
+            pixelbytes = 4;
+            if( pd->SrcPixelBytes == 3 )
+                offset = 1;
         }
-        else
+        for( desty=0; desty<pd->DestHeight; desty++ )
         {
-            D(bug("picture.datatype/RemapTC2CM: remapping buffer without dithering\n"));
-            for( desty=0; desty<pd->DestHeight; desty++ )
+            if( scale )
             {
                 if( srcyinc )	// incremented source line after last line scaling ?
-                {
-                    thissrc = srcbuf;
-                    thisdest = srcline;
-                    x = srcwidth;
-                    while( x-- )
-                    {
-                        if( argb )
-                            thissrc++;
-                        index  = (*thissrc++)>>2 & 0x38; // red
-                        index |= (*thissrc++)>>5 & 0x07; // green
-                        index |= (*thissrc++)    & 0xc0; // blue
-                        if( rgba )
-                            thissrc++;
-
-                        *thisdest++ = sparsetable[index];
-                    }
-                    if( scale )
-                        ScaleLineSimple( srcline, destline, destwidth, 1, pd->XScale );
-                }
-                if( scale )
-                {
-                    srcypos += pd->YScale;
-                    srcyinc = (srcypos >> 16) - srcy;
-                }
+                    ScaleLineSimple( srcbuf, scaleline, destwidth, pd->SrcPixelBytes, pd->XScale );
+                thissrc = scaleline;
+                srcypos += pd->YScale;
+                srcyinc = (srcypos >> 16) - srcy;
+            }
+            else
+            {
+                thissrc = srcbuf;
+            }
+            QuantRemapLine( qm, &qd, thissrc, pixelbytes, offset, destbuf + striprow * destmod, destwidth );
+            if( ++striprow == REMAP_STRIP || desty == pd->DestHeight-1 )
+            {
                 WriteChunkyPixels( &DestRP,
                                     0,
-                                    desty,
+                                    desty+1-striprow,
                                     destwidth-1,
                                     desty,
-                                    destline,
-                                    destwidth );
-                if( srcyinc )
-                {
-                    if( srcyinc == 1 )	srcbuf += pd->SrcWidthBytes;
-                    else		srcbuf += pd->SrcWidthBytes * srcyinc;
-                    srcy += srcyinc;
-                }
+                                    destbuf,
+                                    destmod );
+                striprow = 0;
+            }
+            if( srcyinc )
+            {
+                if( srcyinc == 1 )	srcbuf += pd->SrcWidthBytes;
+                else		srcbuf += pd->SrcWidthBytes * srcyinc;
+                srcy += srcyinc;
             }
         }
 
-        FreeVec( (void *) srcline );
+        FreeVec( (void *) destbuf );
         if( scale )
-            FreeVec( (void *) destline );
+            FreeVec( (void *) scaleline );
+        if( errbuf )
+            FreeVec( (void *) errbuf );
     }
+    FreeVec( qm );
     return TRUE;
 }
 
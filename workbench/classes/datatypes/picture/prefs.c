@@ -11,9 +11,10 @@
     MAXPENS /N/K: maximum number of pens to alloc (colormapped dest only);
                   default is 256, resulting in allocating as many pens as
                   are available and needed
-    DITHERQ /N/K: Dither quality for display (colormapped dest only), 0 (worst) to 4 (best),
-                  1 to 4 have same speed and are slower than 0, choosing one of them is
-                  a matter of taste; 1 is more "blocky" and 4 is more "noisy"
+    DITHERQ /N/K: Dither quality for display (colormapped dest only), 0 (worst) to 4 (best):
+                  0 no dithering, 1 ordered dithering, 2 to 4 Floyd-Steinberg which
+                  diffuses 2/4 to 4/4 of the error; choosing one of them is a matter
+                  of taste, 1 is more "blocky" and 4 is more "noisy"
     SCALEQ /N/K:  Scale quality:
                   0 (fast): simple resampling without filtering
                   1 (slower): resampling with averaging for zoom out
@@ -0,0 +1,431 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+*/
+
+#include <string.h>
+
+#include "quantize.h"
+
+/* Weights of the squared R, G and B differences */
+#define WR 3
+#define WG 4
+#define WB 2
+
+#define QCLIP(x) ((x)>0xff ? 0xff : ((x)<0x00 ? 0x00 : (x)))
+
+/* Value of the center of a cell */
+#define CELLVAL(c) (((c)<<3) + 4)
+
+static const UBYTE bayer4[16] =
+{
+     0,  8,  2, 10,
+    12,  4, 14,  6,
+     3, 11,  1,  9,
+    15,  7, 13,  5
+};
+
+/**************************************************************************************************/
+
+/*
+ *  Adds the pixels to the histogram, which must be cleared before the first call.
+ *  offset is the number of bytes before R in a pixel, e.g. 1 for ARGB.
+ */
+void QuantHistogram( struct QuantHist *qh, const UBYTE *src, ULONG width, ULONG height,
+                     ULONG mod, UWORD pixelbytes, UWORD offset )
+{
+    ULONG *count = qh->Count;
+    const UBYTE *thissrc;
+    ULONG x;
+
+    src += offset;
+    while( height-- )
+    {
+        thissrc = src;
+        x = width;
+        while( x-- )
+        {
+            count[QUANT_CELL(thissrc[0], thissrc[1], thissrc[2])]++;
+            thissrc += pixelbytes;
+        }
+        src += mod;
+    }
+}
+
+/**************************************************************************************************/
+
+/* Shrinks the box to the cells which are in use, returns FALSE if it is empty */
+static int ShrinkBox( struct QuantHist *qh, struct QuantBox *box )
+{
+    int min[3] = { 31, 31, 31 }, max[3] = { 0, 0, 0 };
+    int r, g, b, d;
+    ULONG count = 0, n;
+
+    for( r=box->Min[0]; r<=box->Max[0]; r++ )
+    {
+        for( g=box->Min[1]; g<=box->Max[1]; g++ )
+        {
+            const ULONG *cell = qh->Count + (r<<10) + (g<<5);
+
+            for( b=box->Min[2]; b<=box->Max[2]; b++ )
+            {
+                if( (n = cell[b]) )
+                {
+                    count += n;
+                    if( r < min[0] ) min[0] = r;
+                    if( r > max[0] ) max[0] = r;
+                    if( g < min[1] ) min[1] = g;
+                    if( g > max[1] ) max[1] = g;
+                    if( b < min[2] ) min[2] = b;
+                    if( b > max[2] ) max[2] = b;
+                }
+            }
+        }
+    }
+    if( !count )
+        return 0;
+
+    box->Count = count;
+    box->Volume = 0;
+    for( d=0; d<3; d++ )
+    {
+        ULONG size = (max[d] - min[d]) << 3;
+
+        box->Min[d] = min[d];
+        box->Max[d] = max[d];
+        box->Volume += size * size * (d == 0 ? WR : d == 1 ? WG : WB);
+    }
+    return 1;
+}
+
+/* Splits the box at the median of its longest weighted side */
+static void SplitBox( struct QuantHist *qh, struct QuantBox *box, struct QuantBox *newbox )
+{
+    ULONG marginal[32];
+    ULONG size, maxsize = 0, sum, half;
+    int axis = 0, d, r, g, b, split;
+
+    for( d=0; d<3; d++ )
+    {
+        size = box->Max[d] - box->Min[d];
+        size = size * size * (d == 0 ? WR : d == 1 ? WG : WB);
+        if( size > maxsize )
+        {
+            maxsize = size;
+            axis = d;
+        }
+    }
+
+    memset( marginal, 0, sizeof(marginal) );
+    for( r=box->Min[0]; r<=box->Max[0]; r++ )
+    {
+        for( g=box->Min[1]; g<=box->Max[1]; g++ )
+        {
+            const ULONG *cell = qh->Count + (r<<10) + (g<<5);
+
+            for( b=box->Min[2]; b<=box->Max[2]; b++ )
+                marginal[axis == 0 ? r : axis == 1 ? g : b] += cell[b];
+        }
+    }
+
+    /* Both halves get at least one slice */
+    half = box->Count / 2;
+    sum = 0;
+    for( split=box->Min[axis]; split<box->Max[axis]-1; split++ )
+    {
+        sum += marginal[split];
+        if( sum >= half )
+            break;
+    }
+
+    *newbox = *box;
+    box->Max[axis] = split;
+    newbox->Min[axis] = split + 1;
+    ShrinkBox( qh, box );
+    ShrinkBox( qh, newbox );
+}
+
+/*
+ *  Creates a palette of up to maxcolors colors for the histogram,
+ *  returns the number of colors, which are stored as R G B in palette.
+ */
+int QuantMedianCut( struct QuantHist *qh, UBYTE *palette, int maxcolors )
+{
+    struct QuantBox *boxes = qh->Box;
+    int numboxes, i;
+
+    if( maxcolors > 256 )
+        maxcolors = 256;
+    if( maxcolors < 1 )
+        return 0;
+
+    boxes[0].Min[0] = boxes[0].Min[1] = boxes[0].Min[2] = 0;
+    boxes[0].Max[0] = boxes[0].Max[1] = boxes[0].Max[2] = 31;
+    if( !ShrinkBox( qh, &boxes[0] ) )
+        return 0;
+    numboxes = 1;
+
+    while( numboxes < maxcolors )
+    {
+        struct QuantBox *best = NULL;
+
+        /*
+         *  Split the most populated boxes first, then the largest ones,
+         *  so that rare but distinct colors get a pen as well.
+         */
+        for( i=0; i<numboxes; i++ )
+        {
+            if( !boxes[i].Volume )
+                continue;
+            if( numboxes * 2 <= maxcolors )
+            {
+                if( !best || boxes[i].Count > best->Count )
+                    best = &boxes[i];
+            }
+            else
+            {
+                if( !best || boxes[i].Volume > best->Volume )
+                    best = &boxes[i];
+            }
+        }
+        if( !best )
+            break;
+
+        SplitBox( qh, best, &boxes[numboxes++] );
+    }
+
+    /* The colors are the averages of the boxes */
+    for( i=0; i<numboxes; i++ )
+    {
+        struct QuantBox *box = &boxes[i];
+        UQUAD rsum = 0, gsum = 0, bsum = 0;
+        ULONG n;
+        int r, g, b;
+
+        for( r=box->Min[0]; r<=box->Max[0]; r++ )
+        {
+            for( g=box->Min[1]; g<=box->Max[1]; g++ )
+            {
+                const ULONG *cell = qh->Count + (r<<10) + (g<<5);
+
+                for( b=box->Min[2]; b<=box->Max[2]; b++ )
+                {
+                    if( (n = cell[b]) )
+                    {
+                        rsum += (UQUAD)n * CELLVAL(r);
+                        gsum += (UQUAD)n * CELLVAL(g);
+                        bsum += (UQUAD)n * CELLVAL(b);
+                    }
+                }
+            }
+        }
+        n = box->Count;
+        *palette++ = (rsum + n/2) / n;
+        *palette++ = (gsum + n/2) / n;
+        *palette++ = (bsum + n/2) / n;
+    }
+
+    return numboxes;
+}
+
+/**************************************************************************************************/
+
+/*
+ *  Builds the inverse color map from the Colors and Pens of the first numcolors
+ *  palette entries. The cells are searched in blocks of 4x4x4, and only the colors
+ *  which can be closest to some cell of a block are tried for its cells.
+ */
+void QuantInitMap( struct QuantMap *qm, int numcolors )
+{
+    int br, bg, bb, i, steps, spread;
+
+    memset( qm->PenColors, 0, sizeof(qm->PenColors) );
+    for( i=0; i<numcolors; i++ )
+    {
+        qm->PenColors[qm->Pens[i]*3+0] = qm->Colors[i*3+0];
+        qm->PenColors[qm->Pens[i]*3+1] = qm->Colors[i*3+1];
+        qm->PenColors[qm->Pens[i]*3+2] = qm->Colors[i*3+2];
+    }
+
+    for( br=0; br<32; br+=4 )
+    {
+        for( bg=0; bg<32; bg+=4 )
+        {
+            for( bb=0; bb<32; bb+=4 )
+            {
+                int lo[3], hi[3], r, g, b, d, numcand = 0;
+                ULONG minmax = 0xffffffff;
+
+                lo[0] = CELLVAL(br); hi[0] = CELLVAL(br+3);
+                lo[1] = CELLVAL(bg); hi[1] = CELLVAL(bg+3);
+                lo[2] = CELLVAL(bb); hi[2] = CELLVAL(bb+3);
+
+                /* The smallest distance within which every cell has some color */
+                for( i=0; i<numcolors; i++ )
+                {
+                    ULONG maxdist = 0;
+
+                    for( d=0; d<3; d++ )
+                    {
+                        int c = qm->Colors[i*3+d];
+                        int dist = (c - lo[d] > hi[d] - c) ? c - lo[d] : hi[d] - c;
+
+                        maxdist += dist * dist * (d == 0 ? WR : d == 1 ? WG : WB);
+                    }
+                    if( maxdist < minmax )
+                        minmax = maxdist;
+                }
+
+                /* Colors which aren't farther than that from the whole block */
+                for( i=0; i<numcolors; i++ )
+                {
+                    ULONG mindist = 0;
+
+                    for( d=0; d<3; d++ )
+                    {
+                        int c = qm->Colors[i*3+d];
+                        int dist = (c < lo[d]) ? lo[d] - c : (c > hi[d]) ? c - hi[d] : 0;
+
+                        mindist += dist * dist * (d == 0 ? WR : d == 1 ? WG : WB);
+                    }
+                    if( mindist <= minmax )
+                        qm->Candidates[numcand++] = i;
+                }
+
+                for( r=br; r<br+4; r++ )
+                {
+                    for( g=bg; g<bg+4; g++ )
+                    {
+                        for( b=bb; b<bb+4; b++ )
+                        {
+                            ULONG dist, bestdist = 0xffffffff;
+                            int j, best = 0;
+
+                            for( j=0; j<numcand; j++ )
+                            {
+                                const UBYTE *col = qm->Colors + qm->Candidates[j]*3;
+                                int dr = CELLVAL(r) - col[0];
+                                int dg = CELLVAL(g) - col[1];
+                                int db = CELLVAL(b) - col[2];
+
+                                dist = dr*dr*WR + dg*dg*WG + db*db*WB;
+                                if( dist < bestdist )
+                                {
+                                    bestdist = dist;
+                                    best = qm->Candidates[j];
+                                }
+                            }
+                            qm->InvMap[(r<<10) | (g<<5) | b] = qm->Pens[best];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* Ordered dither amplitude is about the distance of the palette colors */
+    for( steps=2; steps*steps*steps < numcolors; steps++ )
+        ;
+    spread = 256 / steps;
+    for( i=0; i<16; i++ )
+        qm->Ordered[i] = (bayer4[i] * 2 - 15) * spread / 32;
+}
+
+/**************************************************************************************************/
+
+void QuantInitDither( struct QuantDither *qd, UWORD mode, UWORD strength, WORD *errbuf, ULONG width )
+{
+    qd->Mode = mode;
+    qd->Strength = strength;
+    qd->Row = 0;
+    qd->ThisErr = errbuf;
+    qd->NextErr = errbuf ? errbuf + (width + 2) * 3 : NULL;
+    if( errbuf )
+        memset( errbuf, 0, QUANT_DITHERBUF(width) );
+    else if( mode == QUANT_DITHER_FS )
+        qd->Mode = QUANT_DITHER_NONE;
+}
+
+/* Remaps one line of pixels to pens, lines have to be passed top to bottom */
+void QuantRemapLine( struct QuantMap *qm, struct QuantDither *qd, const UBYTE *src,
+                     UWORD pixelbytes, UWORD offset, UBYTE *dest, ULONG width )
+{
+    const UBYTE *invmap = qm->InvMap;
+    ULONG x;
+
+    src += offset;
+    switch( qd->Mode )
+    {
+        case QUANT_DITHER_ORDERED:
+        {
+            const WORD *ordered = qm->Ordered + (qd->Row & 3) * 4;
+
+            for( x=0; x<width; x++ )
+            {
+                int d = ordered[x & 3];
+                int r = src[0] + d, g = src[1] + d, b = src[2] + d;
+
+                r = QCLIP( r ); g = QCLIP( g ); b = QCLIP( b );
+                *dest++ = invmap[QUANT_CELL(r, g, b)];
+                src += pixelbytes;
+            }
+            break;
+        }
+
+        case QUANT_DITHER_FS:
+        {
+            /*
+             *  Serpentine scan, errors are kept in 1/16 with one extra entry on
+             *  either side of the line. 7/16 of the error goes to the next pixel,
+             *  3/16, 5/16 and 1/16 to the ones below.
+             */
+            WORD *thiserr = qd->ThisErr, *nexterr = qd->NextErr;
+            int dir = (qd->Row & 1) ? -1 : 1;
+            int strength = qd->Strength;
+            LONG pos = (dir > 0) ? 0 : width - 1;
+
+            for( x=0; x<width; x++, pos += dir )
+            {
+                const UBYTE *pixel = src + pos * pixelbytes;
+                WORD *err = thiserr + (pos + 1) * 3;
+                WORD *below = nexterr + (pos + 1) * 3;
+                const UBYTE *pencol;
+                int val[3], c;
+                UBYTE pen;
+
+                for( c=0; c<3; c++ )
+                {
+                    val[c] = pixel[c] + ((err[c] + 8) >> 4);
+                    val[c] = QCLIP( val[c] );
+                }
+                pen = invmap[QUANT_CELL(val[0], val[1], val[2])];
+                dest[pos] = pen;
+
+                pencol = qm->PenColors + pen * 3;
+                for( c=0; c<3; c++ )
+                {
+                    int e = (val[c] - pencol[c]) * strength / 4;
+
+                    err[c + dir*3]   += e * 7;
+                    below[c - dir*3] += e * 3;
+                    below[c]         += e * 5;
+                    below[c + dir*3] += e;
+                }
+            }
+
+            qd->ThisErr = nexterr;
+            qd->NextErr = thiserr;
+            memset( thiserr, 0, (width + 2) * 3 * sizeof(WORD) );
+            break;
+        }
+
+        default:
+            for( x=0; x<width; x++ )
+            {
+                *dest++ = invmap[QUANT_CELL(src[0], src[1], src[2])];
+                src += pixelbytes;
+            }
+            break;
+    }
+    qd->Row++;
+}
@@ -0,0 +1,76 @@
+/*
+    Copyright  2026, The AROS Development Team. All rights reserved.
+    $Id$
+
+    Truecolor to colormapped conversion: median cut palette, inverse
+    color map and dithering. Only uses the C library, so it can be built
+    on the host for testing (see developer/debug/test/benchmarks/datatypes).
+*/
+
+#ifndef QUANTIZE_H
+#define QUANTIZE_H
+
+#ifdef __AROS__
+#include <exec/types.h>
+#else
+#include <stdint.h>
+typedef uint8_t  UBYTE;
+typedef int16_t  WORD;
+typedef uint16_t UWORD;
+typedef int32_t  LONG;
+typedef uint32_t ULONG;
+typedef uint64_t UQUAD;
+#endif
+
+/* Histogram and inverse color map cells have 5 bits per gun */
+#define QUANT_CELLS             (1 << 15)
+#define QUANT_CELL(r, g, b)     ((((r) & 0xf8) << 7) | (((g) & 0xf8) << 2) | ((b) >> 3))
+
+/* Size of the error buffer of QuantInitDither() */
+#define QUANT_DITHERBUF(width)  (((width) + 2) * 3 * 2 * sizeof(WORD))
+
+#define QUANT_DITHER_NONE       0
+#define QUANT_DITHER_ORDERED    1
+#define QUANT_DITHER_FS         2   /* Floyd-Steinberg */
+
+struct QuantBox
+{
+    UBYTE   Min[3], Max[3];         /* cell coordinates, R G B */
+    ULONG   Count;                  /* pixels */
+    ULONG   Volume;                 /* weighted size */
+};
+
+struct QuantHist
+{
+    ULONG           Count[QUANT_CELLS];
+    struct QuantBox Box[256];
+};
+
+struct QuantMap
+{
+    UBYTE   Colors[256 * 3];        /* palette R G B, set before QuantInitMap() */
+    UBYTE   Pens[256];              /* pen of each palette entry */
+    UBYTE   InvMap[QUANT_CELLS];    /* cell -> pen */
+    UBYTE   PenColors[256 * 3];     /* pen -> R G B */
+    UBYTE   Candidates[256];
+    WORD    Ordered[16];
+};
+
+struct QuantDither
+{
+    UWORD   Mode;
+    UWORD   Strength;               /* Floyd-Steinberg: 1/4 to 4/4 of the error */
+    ULONG   Row;
+    WORD    *ThisErr;
+    WORD    *NextErr;
+};
+
+void QuantHistogram( struct QuantHist *qh, const UBYTE *src, ULONG width, ULONG height,
+                     ULONG mod, UWORD pixelbytes, UWORD offset );
+int  QuantMedianCut( struct QuantHist *qh, UBYTE *palette, int maxcolors );
+void QuantInitMap( struct QuantMap *qm, int numcolors );
+void QuantInitDither( struct QuantDither *qd, UWORD mode, UWORD strength, WORD *errbuf, ULONG width );
+void QuantRemapLine( struct QuantMap *qm, struct QuantDither *qd, const UBYTE *src,
+                     UWORD pixelbytes, UWORD offset, UBYTE *dest, ULONG width );
+
+#endif /* QUANTIZE_H */
@@ -218,6 +218,7 @@ struct MUI_ListData
 #define LIST_SHOWDROPMARKS (1<<4)
 #define LIST_QUIET         (1<<5)
 #define LIST_CHANGED    (1<<6)
+#define LIST_SORTED     (1<<7)  /* entries are in MUIM_List_Compare order */
 
 static BOOL IncreaseColumns(struct MUI_ListData *data, int new_columns);
 
@@ -583,6 +584,149 @@ static void RemoveListEntries(struct MUI_ListData *data, int pos, int count)
         (data->entries_num - (pos + count)) * sizeof(struct ListEntry *));
 }
 
+/**************************************************************************
+ Compares two entries through MUIM_List_Compare, so that subclasses
+ overriding the method define the order. Returns > 0 if e1 sorts after e2.
+**************************************************************************/
+static LONG CompareListEntries(Object *obj, struct ListEntry *e1,
+    struct ListEntry *e2)
+{
+    struct MUIP_List_Compare cmpmsg =
+        { MUIM_List_Compare, e1->data, e2->data, 0, 0 };
+
+    return (LONG) DoMethodA(obj, (Msg) & cmpmsg);
+}
+
+/**************************************************************************
+ Stable bottom-up merge sort of count entries, using tmp (also count
+ entries) as the second buffer. Returns whichever of the two arrays holds
+ the result. Neighbouring runs that are already in order are only copied,
+ so an (almost) sorted array costs about count compares.
+**************************************************************************/
+static struct ListEntry **SortListEntries(Object *obj,
+    struct ListEntry **array, struct ListEntry **tmp, LONG count)
+{
+    struct ListEntry **src = array, **dst = tmp, **swap;
+    LONG width, lo, mid, hi, i, j, k;
+
+    for (width = 1; width < count; width *= 2)
+    {
+        for (lo = 0; lo < count; lo += 2 * width)
+        {
+            mid = MIN(lo + width, count);
+            hi = MIN(lo + 2 * width, count);
+
+            if (mid == hi
+                || CompareListEntries(obj, src[mid - 1], src[mid]) <= 0)
+            {
+                CopyMem(&src[lo], &dst[lo],
+                    (hi - lo) * sizeof(struct ListEntry *));
+                continue;
+            }
+
+            i = lo;
+            j = mid;
+            k = lo;
+            while (i < mid && j < hi)
+            {
+                /* take from the right run only if strictly smaller */
+                if (CompareListEntries(obj, src[i], src[j]) > 0)
+                    dst[k++] = src[j++];
+                else
+                    dst[k++] = src[i++];
+            }
+            while (i < mid)
+                dst[k++] = src[i++];
+            while (j < hi)
+                dst[k++] = src[j++];
+        }
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    return src;
+}
+
+/**************************************************************************
+ Binary search in a sorted array of count entries. Returns the index
+ behind the last entry that does not sort after the given one, so equal
+ entries keep their insertion order.
+**************************************************************************/
+static LONG FindSortedListPos(Object *obj, struct ListEntry **array,
+    LONG count, struct ListEntry *entry)
+{
+    LONG lo = 0, hi = count, mid;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (CompareListEntries(obj, array[mid], entry) > 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    return lo;
+}
+
+/**************************************************************************
+ Merges the count entries appended at the end of a sorted list into it.
+ The new entries are sorted among themselves first, then each one is
+ placed by a binary search in the part of the list behind its
+ predecessor. Returns FALSE if the temporary array can't be allocated,
+ the list is left unchanged then. On success *first and *last are the
+ new positions of the first and last inserted entry in list order.
+**************************************************************************/
+static BOOL MergeSortedListEntries(Object *obj, struct MUI_ListData *data,
+    LONG count, LONG *first, LONG *last)
+{
+    struct ListEntry **tmp, **added;
+    struct ListEntry **entries = data->entries;
+    LONG prefix = data->entries_num - count;
+    LONG p = 0, k = 0, i, ins;
+
+    tmp = AllocVec((data->entries_num + count) * sizeof(struct ListEntry *),
+        0);
+    if (NULL == tmp)
+        return FALSE;
+
+    added = SortListEntries(obj, &entries[prefix],
+        &tmp[data->entries_num], count);
+
+    for (i = 0; i < count; i++)
+    {
+        ins = p + FindSortedListPos(obj, &entries[p], prefix - p, added[i]);
+        CopyMem(&entries[p], &tmp[k], (ins - p) * sizeof(struct ListEntry *));
+        k += ins - p;
+        p = ins;
+
+        if (i == 0)
+            *first = k;
+        *last = k;
+        tmp[k++] = added[i];
+    }
+    CopyMem(&entries[p], &tmp[k], (prefix - p) * sizeof(struct ListEntry *));
+
+    /* the active entry keeps being active */
+    if (data->entries_active >= 0 && data->entries_active < prefix)
+    {
+        struct ListEntry *active = entries[data->entries_active];
+
+        for (i = data->entries_active; tmp[i] != active; i++)
+            ;
+        data->entries_active = i;
+    }
+
+    CopyMem(tmp, entries, data->entries_num * sizeof(struct ListEntry *));
+    FreeVec(tmp);
+
+    for (i = *first; i < data->entries_num; i++)
+        entries[i]->flags |= ENTRY_RENDER;
+
+    return TRUE;
+}
+
 /**************************************************************************
  Frees all memory allocated by ParseListFormat()
 **************************************************************************/
@@ -1130,7 +1274,7 @@ IPTR List__OM_NEW(struct IClass *cl, Object *obj, struct opSet *msg)
     data->default_compare_hook.h_Entry = (HOOKFUNC) default_compare_func;
     data->default_compare_hook.h_SubEntry = 0;
     data->compare_hook = &(data->default_compare_hook);
-    data->flags = LIST_SHOWDROPMARKS;
+    data->flags = LIST_SHOWDROPMARKS | LIST_SORTED;
     data->area_replaced = FALSE;
     data->area_connected = FALSE;
     data->vert_connected = FALSE;
@@ -1203,6 +1347,7 @@ IPTR List__OM_NEW(struct IClass *cl, Object *obj, struct opSet *msg)
             data->compare_hook = (struct Hook *)tag->ti_Data;
             if (data->compare_hook == NULL)
                 data->compare_hook = &data->default_compare_hook;
+            data->flags &= ~LIST_SORTED;
             break;
 
         case MUIA_List_ConstructHook:
@@ -1406,6 +1551,7 @@ IPTR List__OM_SET(struct IClass *cl, Object *obj, struct opSet *msg)
             data->compare_hook = (struct Hook *)tag->ti_Data;
             if (data->compare_hook == NULL)
                 data->compare_hook = &data->default_compare_hook;
+            data->flags &= ~LIST_SORTED;
             break;
 
         case MUIA_List_ConstructHook:
@@ -2259,6 +2405,7 @@ IPTR List__MUIM_Clear(struct IClass *cl, Object *obj,
     }
     /* Should never fail when shrinking */
     SetListSize(data, 0);
+    data->flags |= LIST_SORTED;
 
     if (data->confirm_entries_num != data->entries_num)
     {
@@ -2358,6 +2505,8 @@ IPTR List__MUIM_Exchange(struct IClass *cl, Object *obj,
         && pos2 < data->entries_num && pos1 != pos2)
     {
         struct ListEntry *save = data->entries[pos1];
+
+        data->flags &= ~LIST_SORTED;
         data->entries[pos1] = data->entries[pos2];
         data->entries[pos2] = save;
 
@@ -2387,6 +2536,9 @@ IPTR List__MUIM_Redraw(struct IClass *cl, Object *obj,
 
     D(bug("[Zune:List] %s()\n", __func__);)
 
+    /* The entries' contents may have changed, and with them their order */
+    data->flags &= ~LIST_SORTED;
+
     if (msg->pos == MUIV_List_Redraw_All)
     {
         CalcWidths(cl, obj);
@@ -2795,7 +2947,10 @@ IPTR List__MUIM_Select(struct IClass *cl, Object *obj,
 *           MUIV_List_Insert_Bottom: insert after all existing entries.
 *           MUIV_List_Insert_Active: insert at the index of the active entry
 *               (or at index 0 if there is no active entry).
-*           MUIV_List_Insert_Sorted: keep the list sorted.
+*           MUIV_List_Insert_Sorted: keep the list sorted. If the list
+*               is still in the order of the last MUIM_List_Sort or sorted
+*               insertion, the new entries are placed by binary search.
+*               Otherwise the whole list is sorted.
 *
 *   SEE ALSO
 *       MUIM_List_InsertSingle, MUIM_List_Remove, MUIA_List_ConstructHook.
@@ -2856,6 +3011,8 @@ IPTR List__MUIM_Insert(struct IClass *cl, Object *obj,
         break;
     }
     data->insert_position = pos;
+    if (!sort)
+        data->flags &= ~LIST_SORTED;
 
     if (!(SetListSize(data, data->entries_num + count)))
         return ~0;
@@ -2925,15 +3082,35 @@ IPTR List__MUIM_Insert(struct IClass *cl, Object *obj,
             MUIA_List_Visible, data->entries_visible, TAG_DONE);
     }
 
-    /* If the array is already sorted, we could do a simple insert
-     * sort and would be much faster than with qsort.
-     * If an array is not yet sorted, does a MUIV_List_Insert_Sorted
-     * sort the whole array?
-     *
-     * I think, we better sort the whole array:
+    /* If the list is known to be sorted, the new entries are merged into
+     * it with binary searches. Otherwise (the order was disturbed by other
+     * insertions, MUIM_List_Exchange and such), the whole list is sorted.
      */
     if (sort)
     {
+        active = data->entries_active;
+
+        if ((data->flags & LIST_SORTED)
+            && MergeSortedListEntries(obj, data, count,
+                &data->insert_position, &pos))
+        {
+            data->update = UPDATEMODE_ALL;
+            if (!(data->flags & LIST_QUIET))
+                MUI_Redraw(obj, MADF_DRAWUPDATE);
+            superset(cl, obj, MUIA_List_InsertPosition,
+                data->insert_position);
+
+            /* The active entry may have moved down, notify its new index */
+            if (data->entries_active != active)
+            {
+                LONG moved = data->entries_active;
+
+                data->entries_active = active;
+                SET(obj, MUIA_List_Active, moved);
+            }
+            return (ULONG) pos;
+        }
+
         /* TODO: which pos to return here !?        */
         DoMethod(obj, MUIM_List_Sort);
 
@@ -3357,8 +3534,14 @@ IPTR List__MUIM_Jump(struct IClass *cl, Object *obj,
 *       Sort the list's entries according to the current comparison hook
 *       (MUIA_List_CompareHook).
 *
+*       The sort is stable: entries that compare equal keep their order.
+*       It takes O(n log n) calls of MUIM_List_Compare, and about n calls
+*       if the list is already sorted.
+*
 *   NOTES
-*       The active index does not change, so the active entry may do so.
+*       The active entry stays active, so the active index may change.
+*       Later MUIV_List_Insert_Sorted insertions rely on the sorted order
+*       and only search for the place of the new entries.
 *
 *   SEE ALSO
 *       MUIA_List_CompareHook, MUIM_List_Compare.
@@ -3372,45 +3555,70 @@ IPTR List__MUIM_Sort(struct IClass *cl, Object *obj,
 {
     struct MUI_ListData *data = INST_DATA(cl, obj);
 
-    int i, j, max;
-    struct MUIP_List_Compare cmpmsg =
-        { MUIM_List_Compare, NULL, NULL, 0, 0 };
+    struct ListEntry **orig, **sorted, *active = NULL;
+    LONG i, pos, count = data->entries_num;
     BOOL changed = FALSE;
 
     D(bug("[Zune:List] %s()\n", __func__);)
 
-    if (data->entries_num > 1)
+    if (count > 1)
     {
-        /*
-           Simple sort algorithm. Feel free to improve it.
-         */
-        for (i = 0; i < data->entries_num - 1; i++)
+        if (data->entries_active >= 0 && data->entries_active < count)
+            active = data->entries[data->entries_active];
+
+        orig = AllocVec(2 * count * sizeof(struct ListEntry *), 0);
+        if (orig)
         {
-            max = i;
-            for (j = i + 1; j < data->entries_num; j++)
+            /* Merge sort, the first half keeps the old order to find the
+             * entries which have to be rendered again */
+            CopyMem(data->entries, orig, count * sizeof(struct ListEntry *));
+            sorted = SortListEntries(obj, data->entries, &orig[count], count);
+            if (sorted != data->entries)
+                CopyMem(sorted, data->entries,
+                    count * sizeof(struct ListEntry *));
+
+            for (i = 0; i < count; i++)
             {
-                cmpmsg.entry1 = data->entries[max]->data;
-                cmpmsg.entry2 = data->entries[j]->data;
-                if ((LONG) DoMethodA(obj, (Msg) & cmpmsg) > 0)
+                if (data->entries[i] != orig[i])
                 {
-                    max = j;
+                    data->entries[i]->flags |= ENTRY_RENDER;
+                    changed = TRUE;
                 }
             }
-            if (i != max)
+            FreeVec(orig);
+        }
+        else
+        {
+            /* Out of memory, binary insertion sort in place */
+            for (i = 1; i < count; i++)
+            {
+                struct ListEntry *entry = data->entries[i];
+
+                pos = FindSortedListPos(obj, data->entries, i, entry);
+                if (pos != i)
+                {
+                    memmove(&data->entries[pos + 1], &data->entries[pos],
+                        (i - pos) * sizeof(struct ListEntry *));
+                    data->entries[pos] = entry;
+                    changed = TRUE;
+                }
+            }
+            if (changed)
             {
-                APTR tmp = data->entries[i];
-                data->entries[i] = data->entries[max];
-                data->entries[i]->flags |= ENTRY_RENDER;
-                data->entries[max] = tmp;
-                data->entries[max]->flags |= ENTRY_RENDER;
-                if (data->entries_active == i)
-                    data->entries_active = max;
-                else if (data->entries_active == max)
-                    data->entries_active = i;
-                changed = TRUE;
+                for (i = 0; i < count; i++)
+                    data->entries[i]->flags |= ENTRY_RENDER;
             }
         }
+
+        /* The active entry stays active */
+        if (changed && active)
+        {
+            for (i = 0; data->entries[i] != active; i++)
+                ;
+            data->entries_active = i;
+        }
     }
+    data->flags |= LIST_SORTED;
 
     if (changed)
     {
@@ -3508,6 +3716,8 @@ IPTR List__MUIM_Move(struct IClass *cl, Object *obj,
         || to > data->entries_num - 1 || to < 0 || from == to)
         return (IPTR) FALSE;
 
+    data->flags &= ~LIST_SORTED;
+
     /* Shift all entries in the range between the 'from' and 'to' positions */
     if (from < to)
     {
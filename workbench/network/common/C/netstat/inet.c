@@ -226,6 +226,12 @@ tcp_stats(off, name)
 	p(tcps_predack, "\t%d correct ACK header prediction%s\n");
 	p(tcps_preddat, "\t%d correct data packet header prediction%s\n");
 	p3(tcps_pcbcachemiss, "\t%d PCB cache miss%s\n");
+	p(tcps_sack_recovery, "\t%d SACK recovery episode%s\n");
+	p2(tcps_sack_rexmitpack, tcps_sack_rexmitbyte,
+		"\t\t%d segment%s (%d byte%s) retransmitted from SACK holes\n");
+	p(tcps_limitedxmit, "\t%d segment%s sent by limited transmit\n");
+	p(tcps_sack_rcvblocks, "\t%d SACK block%s received\n");
+	p(tcps_sack_sndblocks, "\t%d SACK block%s sent\n");
 #undef p
 #undef p2
 #undef p3
@@ -693,6 +693,8 @@ struct PacketMonitorMessage
 					   statistics */
 #define NETSTATUS_tcp_sockets	9	/* TCP socket statistics */
 #define NETSTATUS_udp_sockets	10	/* UDP socket statistics */
+#define NETSTATUS_resolver	11	/* Name resolver cache statistics
+					   (AROSTCP extension) */
 
 /* Protocol connection data returned for each TCP/UDP socket. */
 struct protocol_connection_data
@@ -708,6 +710,23 @@ struct protocol_connection_data
 	LONG	pcd_tcp_state;		/* Socket TCP state */
 };
 
+/* Name resolver cache statistics returned for NETSTATUS_resolver. */
+struct resolver_cache_stats
+{
+	ULONG	rcs_entries;		/* Answers currently cached */
+	ULONG	rcs_hits;		/* Queries answered from the cache */
+	ULONG	rcs_negative_hits;	/* ... with a cached negative
+					   answer */
+	ULONG	rcs_misses;		/* Queries sent to a name server */
+	ULONG	rcs_coalesced;		/* Queries which waited for the
+					   same query of another task */
+	ULONG	rcs_expired;		/* Answers dropped at the end of
+					   their time to live */
+	ULONG	rcs_evicted;		/* Answers dropped to make room */
+	ULONG	rcs_uncacheable;	/* Answers which could not be
+					   cached */
+};
+
 /****************************************************************************/
 
 /*
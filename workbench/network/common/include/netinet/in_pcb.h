@@ -50,6 +50,7 @@ LIST_HEAD(inpcbhead, inpcb);
 struct inpcb {
 	LIST_ENTRY(inpcb) inp_list;		/* list for all PCBs of this proto */
 	LIST_ENTRY(inpcb) inp_hash;		/* hash list */
+	LIST_ENTRY(inpcb) inp_portlist;		/* local port hash list */
 	struct	inpcbinfo *inp_pcbinfo;
 	struct	in_addr inp_faddr;	/* foreign host table entry */
 	u_short	inp_fport;		/* foreign port */
@@ -66,11 +67,30 @@ struct inpcb {
 
 struct inpcbinfo {
 	struct inpcbhead *listhead;
-	struct inpcbhead *hashbase;
+	struct inpcbhead *hashbase;	/* by foreign address and ports */
 	unsigned long hashsize;
 	unsigned short lastport;
+	struct inpcbhead *porthashbase;	/* by local port */
+	unsigned long porthashsize;
+	unsigned long count;		/* PCBs on listhead */
 };
 
+/*
+ * Hash functions for the connection (4-tuple) and local port tables.
+ * The table sizes are prime, see phashinit().
+ */
+#define	INP_PCBHASH(faddr, lport, fport, size) \
+	(((faddr) + (lport) + (fport)) % (size))
+#define	INP_PCBPORTHASH(lport, size) \
+	((lport) % (size))
+
+/*
+ * The tables are grown when there are more than INP_HASHLOAD PCBs per
+ * chain on average, up to the largest size phashinit() can provide.
+ */
+#define	INP_HASHLOAD		2
+#define	INP_HASHMAX		32749
+
 /* flags in inp_flags: */
 #define	INP_RECVOPTS		0x01	/* receive incoming IP options */
 #define	INP_RECVRETOPTS		0x02	/* receive IP options for reply */
@@ -107,16 +127,17 @@ int	 in_pcbbind __P((struct inpcb *, struct mbuf *));
 int	 in_pcbconnect __P((struct inpcb *, struct mbuf *));
 void	 in_pcbdetach __P((struct inpcb *));
 void	 in_pcbdisconnect __P((struct inpcb *));
+void	 in_pcbinitinfo __P((struct inpcbinfo *, struct inpcbhead *, int));
 void	 in_pcbinshash __P((struct inpcb *));
 int	 in_pcbladdr __P((struct inpcb *, struct mbuf *,
 	    struct sockaddr_in **));
 struct inpcb *
-	 in_pcblookup __P((struct inpcbhead *,
+	 in_pcblookup __P((struct inpcbinfo *,
 	    struct in_addr, u_int, struct in_addr, u_int, int));
 struct inpcb *
 	 in_pcblookuphash __P((struct inpcbinfo *,
 	    struct in_addr, u_int, struct in_addr, u_int));
-void	 in_pcbnotify __P((struct inpcbhead *, struct sockaddr *,
+void	 in_pcbnotify __P((struct inpcbinfo *, struct sockaddr *,
 	    u_int, struct in_addr, u_int, int, void (*)(struct inpcb *, int)));
 void	 in_pcbrehash __P((struct inpcb *));
 void	 in_rtchange __P((struct inpcb *, int));
@@ -77,9 +77,13 @@ struct tcphdr {
 #define    TCPOLEN_MAXSEG		4
 #define TCPOPT_WINDOW		3
 #define    TCPOLEN_WINDOW		3
-#define TCPOPT_SACK_PERMITTED	4		/* Experimental */
+#define TCPOPT_SACK_PERMITTED	4		/* SACK: RFC-2018 */
 #define    TCPOLEN_SACK_PERMITTED	2
-#define TCPOPT_SACK		5		/* Experimental */
+#define TCPOPT_SACK		5
+#define	   TCPOLEN_SACK			8	/* 2*sizeof(tcp_seq) */
+#define    TCPOPT_SACK_PERMIT_HDR	\
+    (TCPOPT_NOP<<24|TCPOPT_NOP<<16|TCPOPT_SACK_PERMITTED<<8|TCPOLEN_SACK_PERMITTED)
+#define    TCPOPT_SACK_HDR		(TCPOPT_NOP<<24|TCPOPT_NOP<<16|TCPOPT_SACK<<8)
 #define TCPOPT_TIMESTAMP	8
 #define    TCPOLEN_TIMESTAMP		10
 #define    TCPOLEN_TSTAMP_APPA		(TCPOLEN_TIMESTAMP+2) /* appendix A */
@@ -107,6 +111,17 @@ struct tcphdr {
 
 #define TCP_MAX_WINSHIFT	14	/* maximum window shift */
 
+#define TCP_MAX_SACK		4	/* max # of blocks in a SACK option */
+
+/*
+ * A block of received sequence space, [start, end), as carried
+ * in the SACK option.
+ */
+struct sackblk {
+	tcp_seq	start;			/* first sequence number */
+	tcp_seq	end;			/* one past the last */
+};
+
 #define TCP_MAXHLEN	(0xf<<2)	/* max length of header in bytes */
 #define TCP_MAXOLEN	(TCP_MAXHLEN - sizeof(struct tcphdr))
 					/* max space left for options */
@@ -40,6 +40,15 @@
  * Kernel variables for tcp.
  */
 
+/*
+ * Size of the SACK scoreboard.  When the peer reports more disjoint
+ * blocks than this the highest ones are forgotten, which only makes
+ * recovery more conservative.
+ */
+#define	TCP_SACKBOARD	16
+
+#define	TCP_SACK_ENABLED(tp)	((tp)->t_flags & TF_SACK_PERMIT)
+
 /*
  * Tcp control block, one per tcp; fields:
  */
@@ -53,7 +62,7 @@ struct tcpcb {
 	u_short	t_maxseg;		/* maximum segment size */
 	u_short	t_maxopd;		/* mss plus options */
 	char	t_force;		/* 1 if forcing out a byte */
-	u_short	t_flags;
+	u_int	t_flags;
 #define	TF_ACKNOW	0x0001		/* ack peer immediately */
 #define	TF_DELACK	0x0002		/* ack, but try to delay it */
 #define	TF_NODELAY	0x0004		/* don't delay packets to coalesce */
@@ -69,6 +78,8 @@ struct tcpcb {
 #define TF_NOPUSH	0x1000		/* don't push */
 #define TF_REQ_CC	0x2000		/* have/will request CC */
 #define	TF_RCVD_CC	0x4000		/* a CC was received in SYN */
+#define	TF_REQ_SACK	0x8000		/* have/will send SACK permitted */
+#define	TF_SACKRECOVERY	0x10000		/* in SACK based loss recovery */
 
 	struct	tcpiphdr *t_template;	/* skeletal packet for transmit */
 	struct	inpcb *t_inpcb;		/* back pointer to internet pcb */
@@ -135,6 +146,19 @@ struct tcpcb {
 	tcp_cc	cc_send;		/* send connection count */
 	tcp_cc	cc_recv;		/* receive connection count */
 	u_long	t_duration;		/* connection duration */
+/* RFC 2018 and RFC 6675 variables */
+	struct	sackblk rcv_sacks[TCP_MAX_SACK]; /* blocks to report, newest
+					 * first */
+	int	rcv_numsacks;		/* # of valid rcv_sacks */
+	struct	sackblk snd_sacks[TCP_SACKBOARD]; /* scoreboard: blocks peer
+					 * has SACKed, sorted, disjoint */
+	int	snd_numsacks;		/* # of valid snd_sacks */
+	u_long	snd_sacked;		/* bytes covered by snd_sacks */
+	u_long	snd_lost;		/* hole bytes considered lost */
+	u_long	snd_rexmitted;		/* hole bytes retransmitted in this
+					 * recovery and not yet acked */
+	tcp_seq	snd_rexmitnxt;		/* next hole byte to retransmit */
+	tcp_seq	snd_recover;		/* snd_max when recovery began */
 
 /* TUBA stuff */
 	caddr_t	t_tuba_pcb;		/* next level down pcb for TCP over z */
@@ -152,10 +176,13 @@ struct tcpopt {
 #define TOF_CC		0x0002		/* CC and CCnew are exclusive */
 #define TOF_CCNEW	0x0004
 #define	TOF_CCECHO	0x0008
+#define	TOF_SACK	0x0010		/* SACK blocks, still in the header */
 	u_long	to_tsval;
 	u_long	to_tsecr;
 	tcp_cc	to_cc;		/* holds CC or CCnew */
 	tcp_cc	to_ccecho;
+	int	to_nsacks;	/* # of SACK blocks */
+	u_char	*to_sacks;	/* pointer to the first block */
 };
 
 /*
@@ -276,6 +303,12 @@ struct	tcpstat {
 	u_long	tcps_predack;		/* times hdr predict ok for acks */
 	u_long	tcps_preddat;		/* times hdr predict ok for data pkts */
 	u_long	tcps_pcbcachemiss;
+	u_long	tcps_sack_recovery;	/* SACK recovery episodes */
+	u_long	tcps_sack_rexmitpack;	/* segments retransmitted from holes */
+	u_long	tcps_sack_rexmitbyte;	/* bytes retransmitted from holes */
+	u_long	tcps_sack_rcvblocks;	/* SACK blocks received */
+	u_long	tcps_sack_sndblocks;	/* SACK blocks sent */
+	u_long	tcps_limitedxmit;	/* segments sent by limited transmit */
 };
 
 /*
@@ -290,7 +323,8 @@ struct	tcpstat {
 #define	TCPCTL_KEEPINTVL	7	/* interval to send keepalives */
 #define	TCPCTL_SENDSPACE	8	/* send buffer space */
 #define	TCPCTL_RECVSPACE	9	/* receive buffer space */
-#define TCPCTL_MAXID		10
+#define	TCPCTL_DO_SACK		10	/* use RFC-2018 selective acks */
+#define TCPCTL_MAXID		11
 
 #define TCPCTL_NAMES { \
 	{ 0, 0 }, \
@@ -303,6 +337,7 @@ struct	tcpstat {
 	{ "keepintvl", CTLTYPE_INT }, \
 	{ "sendspace", CTLTYPE_INT }, \
 	{ "recvspace", CTLTYPE_INT }, \
+	{ "sack", CTLTYPE_INT }, \
 }
 
 #ifdef KERNEL
@@ -349,6 +384,13 @@ void	 tcp_respond __P((struct tcpcb *,
 	    struct tcpiphdr *, struct mbuf *, tcp_seq, tcp_seq, int));
 struct rtentry *
 	 tcp_rtlookup __P((struct inpcb *));
+void	 tcp_sack_doack __P((struct tcpcb *, struct tcpopt *, tcp_seq));
+void	 tcp_sack_enterrecovery __P((struct tcpcb *));
+int	 tcp_sack_nextseg __P((struct tcpcb *, tcp_seq *, tcp_seq *));
+long	 tcp_sack_pipe __P((struct tcpcb *));
+void	 tcp_sack_report __P((struct tcpcb *, tcp_seq, tcp_seq));
+void	 tcp_sack_reset __P((struct tcpcb *));
+void	 tcp_sack_trim __P((struct tcpcb *));
 void	 tcp_setpersist __P((struct tcpcb *));
 void	 tcp_slowtimo __P((void));
 int	 tcp_sysctl __P((int *, u_int, void *, size_t *, void *, size_t));
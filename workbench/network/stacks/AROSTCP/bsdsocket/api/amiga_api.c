@@ -437,6 +437,7 @@ D(bug("[AROSTCP](amiga_api.c) ELL_Close()\n"));
 BOOL api_init()
 {
   extern void select_init(void);
+  extern void res_cache_init(void);
   extern f_void ExecLibraryList_funcTable[];
   extern ULONG Miami_InitFuncTable[];
 
@@ -497,6 +498,7 @@ D(bug("[AROSTCP](amiga_api.c) api_init: Created MIAMI library base: 0x%p\n", Mas
 
   InitSemaphore(&syscall_semaphore);
   select_init(); /* initializes data Select() needs */
+  res_cache_init(); /* answer cache of the resolver */
   NewList(&socketBaseList);
   NewList(&garbageSocketBaseList);
   NewList(&releasedSocketList);
@@ -621,6 +623,8 @@ D(bug("[AROSTCP](amiga_api.c) api_sendbreaktotask()\n"));
 
 VOID api_deinit()
 {
+  extern void res_cache_flush(void);
+
 #if defined(__AROS__)
 D(bug("[AROSTCP](amiga_api.c) api_deinit()\n"));
 #endif
@@ -660,6 +664,7 @@ D(bug("[AROSTCP](amiga_api.c) api_deinit: The calling task of api_deinit() was n
   while(SB_Expunged == FALSE)
     Wait(SIGBREAKF_CTRL_F);
 
+  res_cache_flush();
   api_state = API_SCRATCH;
 }
 
@@ -7,6 +7,7 @@
 #include <api/amiga_api.h>
 #include <net/if_protos.h>
 #include <netinet/in.h>
+#include <api/resolv.h>
 
 long __QueryInterfaceTagList(STRPTR name, const struct TagItem *tags, struct SocketBase * libPtr)
 {
@@ -166,4 +167,38 @@ D(bug("[AROSTCP.RS] amiga_netstat.c: QueryInterfaceTagList()\n"));
 
 	AROS_LIBFUNC_EXIT
 }
+
+AROS_LH4(LONG, GetNetworkStatistics,
+	AROS_LHA(LONG, type, D0),
+	AROS_LHA(LONG, version, D1),
+	AROS_LHA(APTR, destination, A0),
+	AROS_LHA(LONG, size, D2),
+	struct SocketBase *, libPtr, 85, UL)
+{
+	AROS_LIBFUNC_INIT
+	struct resolver_cache_stats rcs;
+
+#if defined(__AROS__)
+D(bug("[AROSTCP.RS] amiga_netstat.c: GetNetworkStatistics(%ld)\n", type));
+#endif
+
+	if (version != NETWORKSTATUS_VERSION || size < 0) {
+		writeErrnoValue(libPtr, EINVAL);
+		return -1;
+	}
+
+	switch (type) {
+	case NETSTATUS_resolver:
+		res_cache_getstats(&rcs);
+		if (size > sizeof(rcs))
+			size = sizeof(rcs);
+		CopyMem(&rcs, destination, size);
+		return size;
+	default:
+		writeErrnoValue(libPtr, ENOSYS);
+		return -1;
+	}
+
+	AROS_LIBFUNC_EXIT
+}
 #endif
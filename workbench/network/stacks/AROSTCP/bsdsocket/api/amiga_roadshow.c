@@ -265,19 +265,7 @@ AROS_LH1(void, RemoveNetMonitorHook,
     AROS_LIBFUNC_EXIT
 }
 
-AROS_LH4(LONG, GetNetworkStatistics,
-	AROS_LHA(LONG, type, D0),
-	AROS_LHA(LONG, version, D1),
-	AROS_LHA(APTR, destination, A0),
-	AROS_LHA(LONG, size, D2),
-	struct SocketBase *, libPtr, 85, UL)
-{
-    AROS_LIBFUNC_INIT
-    __log(LOG_CRIT,"GetNetworkStatistics() is not implemented");
-    writeErrnoValue(libPtr, ENOSYS);
-    return -1;
-    AROS_LIBFUNC_EXIT
-}
+// GetNetworkStatistics in amiga_netstat.c
 
 AROS_LH1(LONG, AddDomainNameServer,
 	AROS_LHA(STRPTR, address, A0),
@@ -133,16 +133,11 @@ struct hostent * _gethtbyname(struct SocketBase * libPtr,
   struct hostent * host;
 
   LOCK_R_NDB(NDB);
-
-  for (entNode = (struct HostentNode *)NDB->ndb_Hosts.mlh_Head;
-       entNode->hn_Node.mln_Succ;
-       entNode = (struct HostentNode *)entNode->hn_Node.mln_Succ)
-    if (strcasecmp(entNode->hn_Ent.h_name, (char *)name) == 0 ||
-	matchAlias(entNode->hn_Ent.h_aliases, name)) {
-      host = makehostent(libPtr, entNode);
-      UNLOCK_NDB(NDB);
-      return host;
-    }
+  if ((entNode = findHostentByName(NDB, name)) != NULL) {
+    host = makehostent(libPtr, entNode);
+    UNLOCK_NDB(NDB);
+    return host;
+  }
   UNLOCK_NDB(NDB);
   writeErrnoValue(libPtr, 0);
   return NULL;
@@ -156,15 +151,11 @@ struct hostent * _gethtbyaddr(struct SocketBase * libPtr,
   struct hostent * host;
 
   LOCK_R_NDB(NDB);
-  for (entNode = (struct HostentNode *)NDB->ndb_Hosts.mlh_Head;
-       entNode->hn_Node.mln_Succ;
-       entNode = (struct HostentNode *)entNode->hn_Node.mln_Succ)
-    if (entNode->hn_Ent.h_addrtype == type &&
-	! bcmp(entNode->hn_Ent.h_addr, addr, len)) {
-      host = makehostent(libPtr, entNode);
-      UNLOCK_NDB(NDB);
-      return host;
-    }
+  if ((entNode = findHostentByAddr(NDB, addr, len, type)) != NULL) {
+    host = makehostent(libPtr, entNode);
+    UNLOCK_NDB(NDB);
+    return host;
+  }
   UNLOCK_NDB(NDB);
   writeErrnoValue(libPtr, 0);
   return NULL;
@@ -300,6 +291,38 @@ static struct servent * makeservent(struct SocketBase * libPtr,
 }  
 
 
+/*
+ * Host lookups through the hash tables of the NetDataBase.
+ * Caller must have a lock on NDB.
+ */
+struct HostentNode * findHostentByName(struct NetDataBase * ndb,
+				       const char * name)
+{
+  struct HostHashEnt * hh;
+
+  for (hh = ndb->ndb_HostsByName[ndb_hostnamehash(name)]; hh; hh = hh->hh_Next)
+    if (strcasecmp(hh->hh_Name, (char *)name) == 0)
+      return hh->hh_Host;
+
+  return NULL;
+}
+
+struct HostentNode * findHostentByAddr(struct NetDataBase * ndb,
+				       const char * addr, int len, int type)
+{
+  struct HostHashEnt * hh;
+  struct hostent * ent;
+
+  for (hh = ndb->ndb_HostsByAddr[ndb_hostaddrhash(addr, len)]; hh; hh = hh->hh_Next) {
+    ent = &hh->hh_Host->hn_Ent;
+    if (ent->h_addrtype == type && ent->h_length == len &&
+	! bcmp(ent->h_addr, addr, len))
+      return hh->hh_Host;
+  }
+
+  return NULL;
+}
+
 /*
  * findservent is needed for external call.
  */
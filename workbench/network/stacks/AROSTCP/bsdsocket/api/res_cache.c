@@ -0,0 +1,467 @@
+/*
+ * Copyright (C) 2026 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Answer cache of the resolver, shared by all the SocketBases.
+ *
+ * res_send() looks every query up here before it goes to a name
+ * server.  Answers are kept as long as the time to live of their
+ * records allows, negative answers as long as the SOA record that
+ * comes with them allows (RFC 2308).  While a query is out, the same
+ * query from other tasks waits for its answer instead of sending
+ * another packet.
+ */
+
+#include <conf.h>
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/malloc.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/errno.h>
+#include <netinet/in.h>
+
+#include <arpa/nameser.h>
+#include <api/resolv.h>
+#include <kern/amiga_includes.h>
+#include <api/amiga_api.h>
+#include <kern/amiga_subr.h>
+#include <kern/amiga_netdb.h>
+#include <libraries/bsdsocket.h>
+
+int strcasecmp(const char *, const char *);
+
+#define RES_CACHEHASH	64		/* hash chains, a power of two */
+#define RES_CACHEMAX	256		/* answers kept at most */
+#define RES_MAXTTL	(24*60*60)	/* longest time to keep an answer */
+#define RES_MAXNEGTTL	(15*60)		/* ... and a negative answer */
+
+/* States of a cache entry */
+#define RCS_PENDING	0		/* the query is out */
+#define RCS_ANSWERED	1		/* rc_Answer or rc_Errno is valid */
+
+struct res_cent {
+  struct MinNode	 rc_Node;	/* res_lru, least recently used first */
+  struct res_cent *	 rc_Next;	/* hash chain */
+  struct SignalSemaphore rc_Lock;	/* held while the query is out */
+  UWORD			 rc_State;
+  UWORD			 rc_Linked;	/* in the hash chain and res_lru */
+  UWORD			 rc_Refs;	/* tasks waiting for the answer */
+  UWORD			 rc_Class;
+  UWORD			 rc_Type;
+  ULONG			 rc_Hash;
+  ULONG			 rc_Expires;
+  LONG			 rc_Errno;	/* why the query failed */
+  int			 rc_AnsLen;	/* -1 if it failed */
+  u_char *		 rc_Answer;
+  char			 rc_Name[MAXDNAME + 1];
+};
+
+/*
+ * Configuration variable, the cache is bypassed when FALSE.
+ */
+LONG res_cache_enable = TRUE;
+
+static struct SignalSemaphore res_cache_lock;
+static struct res_cent *res_hash[RES_CACHEHASH];
+static struct MinList res_lru;
+static ULONG res_serial;
+static struct resolver_cache_stats res_stats;
+
+void
+res_cache_init(void)
+{
+  InitSemaphore(&res_cache_lock);
+  NewList((struct List *)&res_lru);
+  res_serial = ndb_Serial;
+}
+
+static ULONG
+res_now(void)
+{
+  struct timeval tv;
+
+  GetSysTime(&tv);
+  return tv.tv_sec;
+}
+
+/*
+ * Get the question of a query.  Only standard queries for a single
+ * name are cached.
+ */
+static BOOL
+res_question(const char *buf, int buflen, char *name, UWORD *class, UWORD *type)
+{
+  HEADER *hp = (HEADER *)buf;
+  const u_char *msg = (const u_char *)buf;
+  const u_char *eom = msg + buflen;
+  const u_char *cp = msg + sizeof (HEADER);
+  int n;
+
+  if (buflen < sizeof (HEADER) || hp->qr || hp->opcode != QUERY ||
+      ntohs(hp->qdcount) != 1 || hp->ancount || hp->nscount)
+    return FALSE;
+  if ((n = dn_expand(msg, eom, cp, (u_char *)name, MAXDNAME)) < 0)
+    return FALSE;
+  cp += n;
+  if (cp + QFIXEDSZ > eom)
+    return FALSE;
+  *type = _getshort((u_char *)cp);
+  *class = _getshort((u_char *)cp + sizeof (u_short));
+  return TRUE;
+}
+
+static ULONG
+res_hashname(const char *name, UWORD class, UWORD type)
+{
+  ULONG h = (class << 16) | type;
+  UBYTE c;
+
+  while (c = *name++) {
+    if (c >= 'A' && c <= 'Z')
+      c += 'a' - 'A';
+    h = h * 31 + c;
+  }
+  return h;
+}
+
+/*
+ * Get the type and the time to live of the resource record at *cpp
+ * and advance past it.  Returns the length of its data, -1 if the
+ * message ends before the record does.
+ */
+static int
+res_skiprr(const u_char **cpp, const u_char *eom, int *type, u_long *ttl)
+{
+  const u_char *cp = *cpp;
+  int n, rdlen;
+
+  if ((n = __dn_skipname(cp, eom)) < 0 || cp + n + RRFIXEDSZ > eom)
+    return (-1);
+  cp += n;
+  /* type, class, ttl and rdlength */
+  *type = _getshort((u_char *)cp);
+  *ttl = _getlong((u_char *)cp + 4) & 0xffffffff;
+  if (*ttl & 0x80000000)	/* RFC 2181, 8 */
+    *ttl = 0;
+  rdlen = _getshort((u_char *)cp + 8);
+  cp += RRFIXEDSZ;
+  if (cp + rdlen > eom)
+    return (-1);
+  *cpp = cp + rdlen;
+  return (rdlen);
+}
+
+/*
+ * How long an answer may be cached, 0 if not at all.  A positive
+ * answer lives as long as its shortest record, a negative one as
+ * the SOA record in its authority section says (RFC 2308, 5).
+ */
+static u_long
+res_answerttl(const u_char *answer, int anslen)
+{
+  HEADER *hp = (HEADER *)answer;
+  const u_char *cp = answer + sizeof (HEADER);
+  const u_char *eom = answer + anslen;
+  int count, n, type;
+  u_long ttl, minttl = RES_MAXTTL;
+
+  if (anslen < sizeof (HEADER) || hp->tc ||
+      (hp->rcode != NOERROR && hp->rcode != NXDOMAIN))
+    return (0);
+
+  for (count = ntohs(hp->qdcount); count > 0; count--) {
+    if ((n = __dn_skipname(cp, eom)) < 0 || cp + n + QFIXEDSZ > eom)
+      return (0);
+    cp += n + QFIXEDSZ;
+  }
+  for (count = ntohs(hp->ancount); count > 0; count--) {
+    if (res_skiprr(&cp, eom, &type, &ttl) < 0)
+      return (0);
+    if (ttl < minttl)
+      minttl = ttl;
+  }
+  if (hp->rcode == NOERROR && hp->ancount != 0)
+    return (minttl);
+
+  /* Negative, look for the SOA of the zone */
+  for (count = ntohs(hp->nscount); count > 0; count--) {
+    if ((n = res_skiprr(&cp, eom, &type, &ttl)) < 0)
+      return (0);
+    if (type == T_SOA && n >= 5 * 4) {
+      /* MINIMUM is the last field of the SOA */
+      u_long soamin = _getlong((u_char *)cp - 4);
+
+      return (ulmin(ulmin(ttl, soamin), RES_MAXNEGTTL));
+    }
+  }
+  return (0);			/* no SOA, do not cache */
+}
+
+static struct res_cent *
+res_cache_find(ULONG hash, const char *name, UWORD class, UWORD type)
+{
+  struct res_cent *ce;
+
+  for (ce = res_hash[hash & (RES_CACHEHASH - 1)]; ce; ce = ce->rc_Next)
+    if (ce->rc_Hash == hash && ce->rc_Class == class &&
+	ce->rc_Type == type && strcasecmp(ce->rc_Name, name) == 0)
+      return ce;
+  return NULL;
+}
+
+static void
+res_cache_unlink(struct res_cent *ce)
+{
+  struct res_cent **cep;
+
+  for (cep = &res_hash[ce->rc_Hash & (RES_CACHEHASH - 1)]; *cep;
+       cep = &(*cep)->rc_Next)
+    if (*cep == ce) {
+      *cep = ce->rc_Next;
+      break;
+    }
+  Remove((struct Node *)ce);
+  ce->rc_Linked = FALSE;
+  res_stats.rcs_entries--;
+}
+
+/*
+ * Free an entry once it is out of the cache and no task needs it.
+ */
+static void
+res_cache_release(struct res_cent *ce)
+{
+  if (ce->rc_Linked || ce->rc_Refs || ce->rc_State == RCS_PENDING)
+    return;
+  if (ce->rc_Answer)
+    bsd_free(ce->rc_Answer, M_RESCACHE);
+  bsd_free(ce, M_RESCACHE);
+}
+
+static void
+res_cache_purge(void)
+{
+  struct res_cent *ce;
+
+  while ((ce = (struct res_cent *)res_lru.mlh_Head)->rc_Node.mln_Succ) {
+    res_cache_unlink(ce);
+    res_cache_release(ce);
+  }
+}
+
+/*
+ * Make room for one more entry.  Queries still out are not evicted,
+ * their tasks hold on to them.
+ */
+static void
+res_cache_evict(void)
+{
+  struct res_cent *ce, *next;
+
+  for (ce = (struct res_cent *)res_lru.mlh_Head;
+       res_stats.rcs_entries >= RES_CACHEMAX &&
+       (next = (struct res_cent *)ce->rc_Node.mln_Succ);
+       ce = next)
+    if (ce->rc_State != RCS_PENDING) {
+      res_stats.rcs_evicted++;
+      res_cache_unlink(ce);
+      res_cache_release(ce);
+    }
+}
+
+/*
+ * Copy a cached answer to the buffer of a query, or its error.
+ */
+static int
+res_cache_copy(struct SocketBase *libPtr, struct res_cent *ce,
+	       const char *buf, char *answer, int anslen)
+{
+  int n;
+
+  if (ce->rc_AnsLen < 0) {
+    /* An interrupted query, the task has to try itself */
+    if (ce->rc_Errno == 0)
+      return (RES_CACHE_MISS);
+    writeErrnoValue(libPtr, ce->rc_Errno);
+    return (-1);
+  }
+  if (anslen < sizeof (HEADER))
+    return (RES_CACHE_MISS);
+
+  n = imin(ce->rc_AnsLen, anslen);
+  bcopy(ce->rc_Answer, answer, n);
+  ((HEADER *)answer)->id = ((HEADER *)buf)->id;
+  if (n < ce->rc_AnsLen)
+    ((HEADER *)answer)->tc = 1;
+  return (n);
+}
+
+/*
+ * Look the query in buf up.  Returns the length of the answer copied
+ * to answer, or -1 with errno set if a query of another task for the
+ * same question failed.  Otherwise RES_CACHE_MISS is returned and the
+ * query has to be sent.  *cep then points to the entry the answer is
+ * to be given to with res_cache_enter(), or is NULL if the query
+ * cannot be cached.
+ */
+int
+res_cache_lookup(struct SocketBase *libPtr, const char *buf, int buflen,
+		 char *answer, int anslen, struct res_cent **cep)
+{
+  struct res_cent *ce;
+  char name[MAXDNAME + 1];
+  UWORD class, type;
+  ULONG hash;
+  int n;
+
+  *cep = NULL;
+  if (!res_cache_enable || !res_question(buf, buflen, name, &class, &type))
+    return (RES_CACHE_MISS);
+  hash = res_hashname(name, class, type);
+
+  ObtainSemaphore(&res_cache_lock);
+
+  /* Name servers or domains have changed */
+  if (res_serial != ndb_Serial) {
+    res_cache_purge();
+    res_serial = ndb_Serial;
+  }
+
+  ce = res_cache_find(hash, name, class, type);
+  if (ce && ce->rc_State != RCS_PENDING &&
+      (LONG)(ce->rc_Expires - res_now()) <= 0) {
+    res_stats.rcs_expired++;
+    res_cache_unlink(ce);
+    res_cache_release(ce);
+    ce = NULL;
+  }
+
+  if (ce == NULL) {
+    res_stats.rcs_misses++;
+    res_cache_evict();
+    if (ce = bsd_malloc(sizeof (*ce), M_RESCACHE, M_WAITOK)) {
+      InitSemaphore(&ce->rc_Lock);
+      ObtainSemaphore(&ce->rc_Lock);
+      ce->rc_State = RCS_PENDING;
+      ce->rc_Linked = TRUE;
+      ce->rc_Refs = 0;
+      ce->rc_Class = class;
+      ce->rc_Type = type;
+      ce->rc_Hash = hash;
+      ce->rc_Answer = NULL;
+      strcpy(ce->rc_Name, name);
+      ce->rc_Next = res_hash[hash & (RES_CACHEHASH - 1)];
+      res_hash[hash & (RES_CACHEHASH - 1)] = ce;
+      AddTail((struct List *)&res_lru, (struct Node *)ce);
+      res_stats.rcs_entries++;
+    }
+    *cep = ce;
+    ReleaseSemaphore(&res_cache_lock);
+    return (RES_CACHE_MISS);
+  }
+
+  if (ce->rc_State == RCS_PENDING) {
+    /*
+     * Another task is asking the same, wait until it holds the
+     * answer.  The reference keeps the entry around meanwhile.
+     */
+    res_stats.rcs_coalesced++;
+    ce->rc_Refs++;
+    ReleaseSemaphore(&res_cache_lock);
+    ObtainSemaphoreShared(&ce->rc_Lock);
+    ReleaseSemaphore(&ce->rc_Lock);
+    ObtainSemaphore(&res_cache_lock);
+    ce->rc_Refs--;
+  } else {
+    res_stats.rcs_hits++;
+    if (((HEADER *)ce->rc_Answer)->rcode != NOERROR ||
+	((HEADER *)ce->rc_Answer)->ancount == 0)
+      res_stats.rcs_negative_hits++;
+    Remove((struct Node *)ce);
+    AddTail((struct List *)&res_lru, (struct Node *)ce);
+  }
+
+  n = res_cache_copy(libPtr, ce, buf, answer, anslen);
+  res_cache_release(ce);
+  ReleaseSemaphore(&res_cache_lock);
+
+  return (n);
+}
+
+/*
+ * Hand the result of a query res_cache_lookup() missed to its entry:
+ * the answer of anslen bytes, or the error of the query if anslen is
+ * negative.  The tasks waiting for the entry are woken up.
+ */
+void
+res_cache_enter(struct SocketBase *libPtr, struct res_cent *ce,
+		const char *answer, int anslen)
+{
+  u_long ttl = 0;
+
+  ObtainSemaphore(&res_cache_lock);
+
+  ce->rc_AnsLen = -1;
+  ce->rc_Errno = 0;
+  if (anslen >= 0) {
+    if (ce->rc_Answer = bsd_malloc(imax(anslen, 1), M_RESCACHE, M_WAITOK)) {
+      bcopy(answer, ce->rc_Answer, anslen);
+      ce->rc_AnsLen = anslen;
+      ttl = res_answerttl(ce->rc_Answer, anslen);
+    }
+  } else if ((ce->rc_Errno = readErrnoValue(libPtr)) == EINTR)
+    ce->rc_Errno = 0;		/* the others have not been interrupted */
+  ce->rc_State = RCS_ANSWERED;
+
+  if (ce->rc_Linked) {
+    if (ttl > 0)
+      ce->rc_Expires = res_now() + ttl;
+    else {
+      if (ce->rc_AnsLen >= 0)
+	res_stats.rcs_uncacheable++;
+      res_cache_unlink(ce);
+    }
+  }
+  ReleaseSemaphore(&ce->rc_Lock);
+  res_cache_release(ce);
+
+  ReleaseSemaphore(&res_cache_lock);
+}
+
+/*
+ * Forget all answers.  Queries still out keep their entries until
+ * they are answered.
+ */
+void
+res_cache_flush(void)
+{
+  ObtainSemaphore(&res_cache_lock);
+  res_cache_purge();
+  ReleaseSemaphore(&res_cache_lock);
+}
+
+void
+res_cache_getstats(struct resolver_cache_stats *rcs)
+{
+  ObtainSemaphoreShared(&res_cache_lock);
+  *rcs = res_stats;
+  ReleaseSemaphore(&res_cache_lock);
+}
@@ -78,12 +78,38 @@ static const struct sockaddr no_addr = { sizeof(struct sockaddr), AF_INET, { 0 }
 extern const char * const __sys_errlist[];
 #define Perror(string) Printf("%s: %s\n", string, __sys_errlist[readErrnoValue(libPtr)])
 
+static int res_sendquery(struct SocketBase *, const char *, int, char *, int);
+
+/*
+ * Answer the query from the cache if possible, otherwise send it
+ * and give the answer to the cache.
+ */
 int
 res_send(struct SocketBase *	libPtr,
 	 const char *		buf,
 	 int			buflen,
 	 char *			answer,
 	 int 			anslen)
+{
+	struct res_cent *ce;
+	int n;
+
+	if ((n = res_cache_lookup(libPtr, buf, buflen, answer, anslen, &ce))
+	    != RES_CACHE_MISS)
+		return (n);
+	n = res_sendquery(libPtr, buf, buflen, answer, anslen);
+	/* a truncated answer reports its full length */
+	if (ce)
+		res_cache_enter(libPtr, ce, answer, imin(n, anslen));
+	return (n);
+}
+
+static int
+res_sendquery(struct SocketBase *	libPtr,
+	      const char *		buf,
+	      int			buflen,
+	      char *			answer,
+	      int 			anslen)
 {
 	register int n;
 	int try, v_circuit, resplen, nscount;
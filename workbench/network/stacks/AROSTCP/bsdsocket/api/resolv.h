@@ -99,6 +99,24 @@ extern int res_querydomain(struct SocketBase *, const char *, const char *,
 extern int res_send(struct SocketBase *, const char *, int, char *, int);
 extern void _res_close(struct SocketBase *);
 
+/*
+ * Answer cache of res_send(), res_cache.c
+ */
+#define RES_CACHE_MISS	(-2)	/* res_cache_lookup(): query has to be sent */
+
+struct res_cent;
+struct resolver_cache_stats;
+
+extern LONG res_cache_enable;
+
+extern void res_cache_init(void);
+extern void res_cache_flush(void);
+extern int res_cache_lookup(struct SocketBase *, const char *, int,
+			    char *, int, struct res_cent **);
+extern void res_cache_enter(struct SocketBase *, struct res_cent *,
+			    const char *, int);
+extern void res_cache_getstats(struct resolver_cache_stats *);
+
 extern u_short _getshort(u_char *);
 extern u_long _getlong(u_char *);
 extern void __putshort(u_short, u_char *);
@@ -177,10 +177,12 @@ D(bug("[AROSTCP](amiga_netdb.c) alloc_netdb()\n"));
     struct MinList *gl;
 
     for (gl = (struct MinList *)&ndb->ndb_Hosts;
-	 gl <= (struct MinList *)&ndb->ndb_Domains;        
+	 gl <= (struct MinList *)&ndb->ndb_HostIndex;
 	 gl++)
       NewList((struct List *)gl);
     
+    bzero(ndb->ndb_HostsByName, sizeof (ndb->ndb_HostsByName));
+    bzero(ndb->ndb_HostsByAddr, sizeof (ndb->ndb_HostsByAddr));
   }
   
   ndb->ndb_AccessCount = 0;
@@ -209,7 +211,7 @@ free_netdb(struct NetDataBase *ndb)
 D(bug("[AROSTCP](amiga_netdb.c) free_netdb( 0x%p )\n", ndb));
 #endif
   for (gl = (struct MinList *)&ndb->ndb_Hosts;
-       gl <= (struct MinList *)&ndb->ndb_Domains;        
+       gl <= (struct MinList *)&ndb->ndb_HostIndex;
        gl++)
     while (gn = (struct GenentNode *)RemHead((struct List *)gl)) 
       bsd_free(gn, M_NETDB);
@@ -513,6 +515,83 @@ D(bug("[AROSTCP](amiga_netdb.c) addservent()\n"));
   return retval;
 }
 
+/*
+ * Hash a host name, ignoring the case, or a host address.
+ */
+ULONG
+ndb_hostnamehash(const char *name)
+{
+  ULONG h = 0;
+  UBYTE c;
+
+  while (c = *name++) {
+    if (c >= 'A' && c <= 'Z')
+      c += 'a' - 'A';
+    h = h * 31 + c;
+  }
+  return h & (NDB_HOSTHASH - 1);
+}
+
+ULONG
+ndb_hostaddrhash(const char *addr, int len)
+{
+  ULONG h = 0;
+
+  while (len-- > 0)
+    h = h * 31 + (UBYTE)*addr++;
+  return h & (NDB_HOSTHASH - 1);
+}
+
+/*
+ * Link a hash entry to the end of its chain, so that the lookups find
+ * the hosts in the order they were added, as a search of ndb_Hosts did.
+ */
+static void
+hosthash_link(struct HostHashEnt **chain, struct HostHashEnt *hh)
+{
+  while (*chain)
+    chain = &(*chain)->hh_Next;
+  hh->hh_Next = NULL;
+  *chain = hh;
+}
+
+/*
+ * Enter a host under its name, its aliases and its address.
+ */
+static BOOL
+hostindex_add(struct NetDataBase *ndb, struct HostentNode *hn, int aliases)
+{
+  struct HostIndexNode *hi;
+  struct HostHashEnt *hh;
+  char **alias;
+
+  /* aliases counts the NULL terminator, it stands for the name here */
+  hi = bsd_malloc(sizeof (*hi) + (aliases + 1) * sizeof (*hh),
+		  M_NETDB, M_WAITOK);
+  if (hi == NULL)
+    return FALSE;
+  hi->hi_Count = aliases + 1;
+  hh = hi->hi_Ent;
+
+  hh->hh_Host = hn;
+  hh->hh_Name = hn->hn_Ent.h_name;
+  hosthash_link(&ndb->ndb_HostsByName[ndb_hostnamehash(hh->hh_Name)], hh);
+  hh++;
+  for (alias = hn->hn_Ent.h_aliases; *alias; alias++, hh++) {
+    hh->hh_Host = hn;
+    hh->hh_Name = *alias;
+    hosthash_link(&ndb->ndb_HostsByName[ndb_hostnamehash(*alias)], hh);
+  }
+  hh->hh_Host = hn;
+  hh->hh_Name = NULL;
+  hosthash_link(&ndb->ndb_HostsByAddr[ndb_hostaddrhash(hn->hn_Ent.h_addr,
+						       hn->hn_Ent.h_length)],
+		hh);
+
+  AddTail((struct List*)&ndb->ndb_HostIndex, (struct Node*)hi);
+  return TRUE;
+}
+
 /*
  * Parse a host entry.
  *
@@ -559,8 +638,13 @@ D(bug("[AROSTCP](amiga_netdb.c) addhostent()\n"));
 	/* Copy aliases */
 	aliascpy(hn->hn_Ent.h_name, (UBYTE*)Args[KNDB_DATA], 
 		 alias, (UBYTE **)Args[KNDB_ALIAS]);
-	AddTail((struct List*)&ndb->ndb_Hosts, (struct Node*)hn);
-	retval = RETURN_OK;
+	if (hostindex_add(ndb, hn, aliases)) {
+	  AddTail((struct List*)&ndb->ndb_Hosts, (struct Node*)hn);
+	  retval = RETURN_OK;
+	} else {
+	  bsd_free(hn, M_NETDB);
+	  *errstrp = ERR_MEMORY; retval = RETURN_FAIL;
+	}
       } else {
 	*errstrp = ERR_MEMORY; retval = RETURN_FAIL;
       }
@@ -51,6 +51,9 @@ struct AccessItem {
 /* AC table temporary buffer size */
 #define TMPACTSIZE	0x4000 
 
+/* Size of the host name and address hash tables, a power of two */
+#define NDB_HOSTHASH	64
+
 /* NetDataBase */
 struct NetDataBase {
   struct MinList         ndb_Hosts;
@@ -60,8 +63,11 @@ struct NetDataBase {
   struct MinList         ndb_NameServers;
   struct MinList	 ndb_Rc;
   struct MinList         ndb_Domains;
+  struct MinList	 ndb_HostIndex;   /* HostIndexNodes, for freeing */
   LONG			 ndb_AccessCount; /* tmp var, but reduces code size */
   struct AccessItem *	 ndb_AccessTable;
+  struct HostHashEnt *	 ndb_HostsByName[NDB_HOSTHASH];
+  struct HostHashEnt *	 ndb_HostsByAddr[NDB_HOSTHASH];
 };
 
 extern struct NetDataBase *NDB;
@@ -117,6 +123,23 @@ struct HostentNode {
   struct hostent hn_Ent;
 };
 
+/*
+ * The host entries are hashed by their name and each of their aliases
+ * and by their address. The hash entries of one host are allocated
+ * together in a HostIndexNode.
+ */
+struct HostHashEnt {
+  struct HostHashEnt *	hh_Next;
+  struct HostentNode *	hh_Host;
+  const char *		hh_Name;	/* NULL in the address entry */
+};
+
+struct HostIndexNode {
+  struct MinNode	hi_Node;
+  short			hi_Count;
+  struct HostHashEnt	hi_Ent[0];
+};
+
 struct NetentNode {
   struct MinNode nn_Node;
   short          nn_EntSize;
@@ -146,6 +169,12 @@ struct RcentNode {
  */
 struct ServentNode * findServentNode(struct NetDataBase * ndb,
 				     const char * name, const char * proto);
+ULONG ndb_hostnamehash(const char * name);
+ULONG ndb_hostaddrhash(const char * addr, int len);
+struct HostentNode * findHostentByName(struct NetDataBase * ndb,
+				       const char * name);
+struct HostentNode * findHostentByAddr(struct NetDataBase * ndb,
+				       const char * addr, int len, int type);
 
 /*
  * Read NetDB...
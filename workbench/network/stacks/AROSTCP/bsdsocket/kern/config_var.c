@@ -71,8 +71,10 @@ STRPTR KW_VARS =
   "MBS=MBUF_STAT,MBTS=MBUF_TYPE_STATS,MBC=MBUF_CONF,LOG,GUI,SHOW,"
   "TASKNAME,NTH=NTHBASE,DBSANA=DEBUGSANA,DBICMP=DEBUGICMP,"
   "DBIP=DEBUGIP,GTW=GATEWAY,REDIR=IPSENDREDIRECTS,"
-  "USENS=USENAMESERVER,ULO=USELOOPBACK,TCPSND=TCP_SENDSPACE,"
-  "TCPRCV=TCP_RECVSPACE,CON=CONSOLENAME,LOGF=LOGFILENAME,OPENGUI,REFRESH";
+  "USENS=USENAMESERVER,DNSCACHE=RESOLVERCACHE,ULO=USELOOPBACK,"
+  "TCPSND=TCP_SENDSPACE,TCPRCV=TCP_RECVSPACE,SACK=TCP_SACK,"
+  "LIMXMIT=TCP_LIMITEDXMIT,LODROP=LOOPBACKDROP,CON=CONSOLENAME,"
+  "LOGF=LOGFILENAME,OPENGUI,REFRESH";
 
 /* extern declarations */
 
@@ -99,9 +101,13 @@ extern LONG ipprintfs;
 extern LONG ipforwarding;
 extern LONG ipsendredirects;
 extern LONG usens;
+extern LONG res_cache_enable;
 extern LONG useloopback;
 extern ULONG tcp_sendspace;
 extern ULONG tcp_recvspace;
+extern LONG tcp_do_sack;
+extern LONG tcp_do_limitedxmit;
+extern LONG lo_droprate;
 extern STRPTR consolename ;	 int logname_changed(void *pt, IPTR new);
 extern STRPTR logfilename;
 extern LONG OpenGUIOnStartup;
@@ -134,9 +140,13 @@ struct cfg_variable variables[] = {
 { VAR_ENUM, VF_RW, NULL, &ipforwarding, boolean_enum },
 { VAR_ENUM, VF_RW, NULL, &ipsendredirects, boolean_enum },
 { VAR_ENUM, VF_RW, NULL, &usens, (notify_f)"NO,FIRST,SECOND" },
+{ VAR_ENUM, VF_RW, NULL, &res_cache_enable, boolean_enum },
 { VAR_ENUM, VF_RW, NULL, &useloopback, boolean_enum },
 { VAR_LONG, VF_RW, NULL, (LONG*)&tcp_sendspace, NULL },
 { VAR_LONG, VF_RW, NULL, (LONG*)&tcp_recvspace, NULL },
+{ VAR_ENUM, VF_RW, NULL, &tcp_do_sack, boolean_enum },
+{ VAR_ENUM, VF_RW, NULL, &tcp_do_limitedxmit, boolean_enum },
+{ VAR_LONG, VF_RW, NULL, &lo_droprate, NULL },
 { VAR_STRP, VF_RW, NULL, &consolename, logname_changed },
 { VAR_STRP, VF_RW, NULL, &logfilename, logname_changed },
 { VAR_ENUM, VF_RCONF, NULL, &OpenGUIOnStartup, boolean_enum },
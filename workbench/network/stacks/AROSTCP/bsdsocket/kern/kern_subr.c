@@ -52,6 +52,7 @@ static int primes[] = { 1, 13, 31, 61, 127, 251, 509, 761, 1021, 1531, 2039,
 
 /*
  * General routine to allocate a prime number sized hash table.
+ * Returns NULL if there is no memory for the table.
  */
 void *
 phashinit(elements, type, nentries)
@@ -72,6 +73,8 @@ phashinit(elements, type, nentries)
 	}
 	hashsize = primes[i - 1];
 	hashtbl = bsd_malloc((u_long)hashsize * sizeof(*hashtbl), type, M_WAITOK);
+	if (hashtbl == NULL)
+		return (NULL);
 	for (i = 0; i < hashsize; i++)
 		LIST_INIT(&hashtbl[i]);
 	*nentries = hashsize;
@@ -99,6 +99,13 @@
 
 struct	ifnet loif = {0};
 
+/*
+ * Drop this many of every 1000 packets sent over the loopback, to
+ * exercise the loss recovery of the protocols.  0 disables dropping.
+ */
+LONG	lo_droprate = 0;
+static	ULONG lo_dropseed = 1;
+
 void
 loattach()
 {
@@ -145,6 +152,14 @@ looutput(ifp, m, dst, rt)
 		DROUTE(log(LOG_DEBUG,"lo0: packet rejected");)
 		return (rt->rt_flags & RTF_HOST ? EHOSTUNREACH : ENETUNREACH);
 	}
+	if (lo_droprate > 0) {
+		lo_dropseed = lo_dropseed * 1103515245 + 12345;
+		if ((lo_dropseed >> 16) % 1000 < lo_droprate) {
+			ifp->if_oerrors++;
+			m_freem(m);
+			return (0);
+		}
+	}
 	ifp->if_opackets++;
 	ifp->if_obytes += m->m_pkthdr.len;
 	switch (dst->sa_family) {
@@ -59,10 +59,72 @@
 #include <netinet/in_var.h>
 #include <netinet/ip_var.h>
 
+#include <kern/kern_subr_protos.h>
+
 extern u_char inetctlerrmap[];
 
 struct	in_addr zeroin_addr;
 
+static void in_pcbgrowhash __P((struct inpcbinfo *));
+
+/*
+ * Set up the PCB list and the hash tables of a protocol.
+ */
+void
+in_pcbinitinfo(pcbinfo, listhead, hashsize)
+	struct inpcbinfo *pcbinfo;
+	struct inpcbhead *listhead;
+	int hashsize;
+{
+	LIST_INIT(listhead);
+	pcbinfo->listhead = listhead;
+	pcbinfo->count = 0;
+	pcbinfo->hashbase = phashinit(hashsize, M_PCB, &pcbinfo->hashsize);
+	pcbinfo->porthashbase = phashinit(hashsize, M_PCB,
+	    &pcbinfo->porthashsize);
+	if (pcbinfo->hashbase == NULL || pcbinfo->porthashbase == NULL)
+		panic("in_pcbinitinfo");
+}
+
+/*
+ * Move all PCBs of a protocol to larger hash tables, so that the
+ * chains stay short as connections pile up (e.g. in TIME_WAIT).
+ * If there is no memory the old tables are kept.
+ * Must be called at splnet.
+ */
+static void
+in_pcbgrowhash(pcbinfo)
+	struct inpcbinfo *pcbinfo;
+{
+	struct inpcbhead *hashbase, *porthashbase;
+	u_long hashsize, porthashsize;
+	register struct inpcb *inp;
+
+	hashbase = phashinit(pcbinfo->count, M_PCB, &hashsize);
+	if (hashbase == NULL)
+		return;
+	if (hashsize <= pcbinfo->hashsize) {
+		bsd_free(hashbase, M_PCB);
+		return;
+	}
+	porthashbase = phashinit(pcbinfo->count, M_PCB, &porthashsize);
+	if (porthashbase == NULL) {
+		bsd_free(hashbase, M_PCB);
+		return;
+	}
+
+	bsd_free(pcbinfo->hashbase, M_PCB);
+	bsd_free(pcbinfo->porthashbase, M_PCB);
+	pcbinfo->hashbase = hashbase;
+	pcbinfo->hashsize = hashsize;
+	pcbinfo->porthashbase = porthashbase;
+	pcbinfo->porthashsize = porthashsize;
+
+	for (inp = pcbinfo->listhead->lh_first; inp != NULL;
+	    inp = inp->inp_list.le_next)
+		in_pcbinshash(inp);
+}
+
 int
 in_pcballoc(so, pcbinfo)
 	struct socket *so;
@@ -80,6 +142,9 @@ in_pcballoc(so, pcbinfo)
 	s = splnet();
 	LIST_INSERT_HEAD(pcbinfo->listhead, inp, inp_list);
 	in_pcbinshash(inp);
+	if (++pcbinfo->count > pcbinfo->hashsize * INP_HASHLOAD &&
+	    pcbinfo->hashsize < INP_HASHMAX)
+		in_pcbgrowhash(pcbinfo);
 	splx(s);
 	so->so_pcb = (caddr_t)inp;
 	return (0);
@@ -91,7 +156,7 @@ in_pcbbind(inp, nam)
 	struct mbuf *nam;
 {
 	register struct socket *so = inp->inp_socket;
-	struct inpcbhead *head = inp->inp_pcbinfo->listhead;
+	struct inpcbinfo *pcbinfo = inp->inp_pcbinfo;
 	unsigned short *lastport = &inp->inp_pcbinfo->lastport;
 	struct sockaddr_in *sin;
 //	struct proc *p = curproc;		/* XXX */
@@ -142,7 +207,7 @@ in_pcbbind(inp, nam)
 /*			if (ntohs(lport) < IPPORT_RESERVED &&
 			    (error = suser(p->p_ucred, &p->p_acflag)))
 				return (error);*/
-			t = in_pcblookup(head, zeroin_addr, 0,
+			t = in_pcblookup(pcbinfo, zeroin_addr, 0,
 			    sin->sin_addr, lport, wild);
 			if (t && (reuseport & t->inp_socket->so_options) == 0)
 				return (EADDRINUSE);
@@ -156,7 +221,7 @@ in_pcbbind(inp, nam)
 			    *lastport > IPPORT_USERRESERVED)
 				*lastport = IPPORT_RESERVED;
 			lport = htons(*lastport);
-		} while (in_pcblookup(head,
+		} while (in_pcblookup(pcbinfo,
 			    zeroin_addr, 0, inp->inp_laddr, lport, wild));
 	inp->inp_lport = lport;
 	in_pcbrehash(inp);
@@ -355,7 +420,9 @@ in_pcbdetach(inp)
 #endif
 	s = splnet();
 	LIST_REMOVE(inp, inp_hash);
+	LIST_REMOVE(inp, inp_portlist);
 	LIST_REMOVE(inp, inp_list);
+	inp->inp_pcbinfo->count--;
 	splx(s);
 	FREE(inp, M_PCB);
 }
@@ -404,8 +471,8 @@ in_setpeeraddr(inp, nam)
  * Must be called at splnet.
  */
 void
-in_pcbnotify(head, dst, fport_arg, laddr, lport_arg, cmd, notify)
-	struct inpcbhead *head;
+in_pcbnotify(pcbinfo, dst, fport_arg, laddr, lport_arg, cmd, notify)
+	struct inpcbinfo *pcbinfo;
 	struct sockaddr *dst;
 	u_int fport_arg, lport_arg;
 	struct in_addr laddr;
@@ -439,10 +506,33 @@ in_pcbnotify(head, dst, fport_arg, laddr, lport_arg, cmd, notify)
 	}
 	_errno = inetctlerrmap[cmd];
 	s = splnet();
-	for (inp = head->lh_first; inp != NULL;) {
+	if (lport) {
+		/*
+		 * Only PCBs bound to the local port can match, they all
+		 * share one chain of the port hash.
+		 */
+		inp = pcbinfo->porthashbase[INP_PCBPORTHASH(lport,
+		    pcbinfo->porthashsize)].lh_first;
+		while (inp != NULL) {
+			if (inp->inp_faddr.s_addr != faddr.s_addr ||
+			    inp->inp_socket == 0 ||
+			    inp->inp_lport != lport ||
+			    (laddr.s_addr && inp->inp_laddr.s_addr != laddr.s_addr) ||
+			    (fport && inp->inp_fport != fport)) {
+				inp = inp->inp_portlist.le_next;
+				continue;
+			}
+			oinp = inp;
+			inp = inp->inp_portlist.le_next;
+			if (notify)
+				(*notify)(oinp, _errno);
+		}
+		splx(s);
+		return;
+	}
+	for (inp = pcbinfo->listhead->lh_first; inp != NULL;) {
 		if (inp->inp_faddr.s_addr != faddr.s_addr ||
 		    inp->inp_socket == 0 ||
-		    (lport && inp->inp_lport != lport) ||
 		    (laddr.s_addr && inp->inp_laddr.s_addr != laddr.s_addr) ||
 		    (fport && inp->inp_fport != fport)) {
 			inp = inp->inp_list.le_next;
@@ -505,13 +595,18 @@ in_rtchange(inp, _errno)
 	}
 }
 
+/*
+ * Lookup PCB with wildcard matching.  Only the PCBs bound to the
+ * local port are searched, through the local port hash.
+ */
 struct inpcb *
-in_pcblookup(head, faddr, fport_arg, laddr, lport_arg, flags)
-	struct inpcbhead *head;
+in_pcblookup(pcbinfo, faddr, fport_arg, laddr, lport_arg, flags)
+	struct inpcbinfo *pcbinfo;
 	struct in_addr faddr, laddr;
 	u_int fport_arg, lport_arg;
 	int flags;
 {
+	struct inpcbhead *head;
 	register struct inpcb *inp, *match = NULL;
 	int matchwild = 3, wildcard;
 	u_short fport = fport_arg, lport = lport_arg;
@@ -519,7 +614,10 @@ in_pcblookup(head, faddr, fport_arg, laddr, lport_arg, flags)
 
 	s = splnet();
 
-	for (inp = head->lh_first; inp != NULL; inp = inp->inp_list.le_next) {
+	head = &pcbinfo->porthashbase[INP_PCBPORTHASH(lport,
+	    pcbinfo->porthashsize)];
+
+	for (inp = head->lh_first; inp != NULL; inp = inp->inp_portlist.le_next) {
 		if (inp->inp_lport != lport)
 			continue;
 		wildcard = 0;
@@ -574,7 +672,8 @@ in_pcblookuphash(pcbinfo, faddr, fport_arg, laddr, lport_arg)
 	/*
 	 * First look for an exact match.
 	 */
-	head = &pcbinfo->hashbase[(faddr.s_addr + lport + fport) % pcbinfo->hashsize];
+	head = &pcbinfo->hashbase[INP_PCBHASH(faddr.s_addr, lport, fport,
+	    pcbinfo->hashsize)];
 
 	for (inp = head->lh_first; inp != NULL; inp = inp->inp_hash.le_next) {
 		if (inp->inp_faddr.s_addr != faddr.s_addr ||
@@ -597,33 +696,33 @@ in_pcblookuphash(pcbinfo, faddr, fport_arg, laddr, lport_arg)
 }
 
 /*
- * Insert PCB into hash chain. Must be called at splnet.
+ * Insert PCB into hash chains. Must be called at splnet.
  */
 void
 in_pcbinshash(inp)
 	struct inpcb *inp;
 {
+	struct inpcbinfo *pcbinfo = inp->inp_pcbinfo;
 	struct inpcbhead *head;
 
-	head = &inp->inp_pcbinfo->hashbase[(inp->inp_faddr.s_addr +
-		inp->inp_lport + inp->inp_fport) % inp->inp_pcbinfo->hashsize];
-
+	head = &pcbinfo->hashbase[INP_PCBHASH(inp->inp_faddr.s_addr,
+		inp->inp_lport, inp->inp_fport, pcbinfo->hashsize)];
 	LIST_INSERT_HEAD(head, inp, inp_hash);
+
+	head = &pcbinfo->porthashbase[INP_PCBPORTHASH(inp->inp_lport,
+		pcbinfo->porthashsize)];
+	LIST_INSERT_HEAD(head, inp, inp_portlist);
 }
 
 void
 in_pcbrehash(inp)
 	struct inpcb *inp;
 {
-	struct inpcbhead *head;
 	int s;
 
 	s = splnet();
 	LIST_REMOVE(inp, inp_hash);
-
-	head = &inp->inp_pcbinfo->hashbase[(inp->inp_faddr.s_addr +
-		inp->inp_lport + inp->inp_fport) % inp->inp_pcbinfo->hashsize];
-
-	LIST_INSERT_HEAD(head, inp, inp_hash);
+	LIST_REMOVE(inp, inp_portlist);
+	in_pcbinshash(inp);
 	splx(s);
 }
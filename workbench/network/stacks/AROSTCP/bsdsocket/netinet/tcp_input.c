@@ -36,6 +36,8 @@
  */
 
 #ifndef TUBA_INCLUDE
+#include <conf.h>
+
 #include <sys/param.h>
 #include <sys/systm.h>
 #include <sys/malloc.h>
@@ -66,6 +68,7 @@ struct	tcpiphdr tcp_saveti;
 #endif
 
 int	tcprexmtthresh = 3;
+extern LONG tcp_do_limitedxmit;
 #if defined(__AROS__)
 int	tcp_iss;
 int	tcp_ccgen;
@@ -83,6 +86,9 @@ struct inpcbinfo tcbinfo;
 #include <kern/uipc_socket2_protos.h>
 //#include <netinet/tcp_subr_protos.h>
 
+/* Largest block tcp_reass() builds, ti_len is a short */
+#define TCP_REASS_MAXLEN	32767
+
 /*
  * Insert segment ti into reassembly queue of tcp with
  * control block tp.  Return TH_FIN if reassembly now includes
@@ -137,7 +143,13 @@ tcp_reass(tp, ti, m)
         m->m_pkthdr.header = (caddr_t)ti;
 
         /*
-         * Find a segment which begins after this one does.
+         * The queue holds one entry per contiguous block of
+         * sequence space: segments which extend a block are
+         * chained to it below.  So the queue is as long as the
+         * number of holes, not the number of segments, and its
+         * entries are exactly the blocks a SACK reports.
+         *
+         * Find a block which begins after this segment does.
          */
         for (q = tp->t_segq, p = NULL; q; p = q, q = q->m_nextpkt)
                 if (SEQ_GT(GETTCP(q)->ti_seq, ti->ti_seq))
@@ -197,13 +209,47 @@ tcp_reass(tp, ti, m)
                 q = nq;
         }
 
-        if (p == NULL) {
+        /*
+         * Chain the segment to the preceding block if it continues
+         * it, else link it in as a block of its own.  ti_len limits
+         * a block to TCP_REASS_MAXLEN bytes.
+         */
+        if (p != NULL &&
+            GETTCP(p)->ti_seq + GETTCP(p)->ti_len == ti->ti_seq &&
+            GETTCP(p)->ti_len + ti->ti_len <= TCP_REASS_MAXLEN) {
+                GETTCP(p)->ti_len += ti->ti_len;
+                GETTCP(p)->ti_flags |= ti->ti_flags & TH_FIN;
+                p->m_pkthdr.len += m->m_pkthdr.len;
+                m->m_flags &= ~M_PKTHDR;
+                m_cat(p, m);
+                m = p;
+        } else if (p == NULL) {
                 m->m_nextpkt = tp->t_segq;
                 tp->t_segq = m;
         } else {
                 m->m_nextpkt = p->m_nextpkt;
                 p->m_nextpkt = m;
         }
+        ti = GETTCP(m);
+
+        /*
+         * The same for the following block, if the segment
+         * filled the gap up to it.
+         */
+        if (q != NULL &&
+            ti->ti_seq + ti->ti_len == GETTCP(q)->ti_seq &&
+            ti->ti_len + GETTCP(q)->ti_len <= TCP_REASS_MAXLEN) {
+                ti->ti_len += GETTCP(q)->ti_len;
+                ti->ti_flags |= GETTCP(q)->ti_flags & TH_FIN;
+                m->m_nextpkt = q->m_nextpkt;
+                q->m_nextpkt = NULL;
+                m->m_pkthdr.len += q->m_pkthdr.len;
+                q->m_flags &= ~M_PKTHDR;
+                m_cat(m, q);
+        }
+
+        if (TCP_SACK_ENABLED(tp))
+                tcp_sack_report(tp, ti->ti_seq, ti->ti_seq + ti->ti_len);
 
 present:
         /*
@@ -227,6 +273,8 @@ present:
                         sbappend(&so->so_rcv, q);
                 q = nq;
         } while (q && GETTCP(q)->ti_seq == tp->rcv_nxt);
+        if (tp->rcv_numsacks)
+                tcp_sack_trim(tp);
         sorwakeup(so);
         return (flags);
 
@@ -367,7 +415,7 @@ findpcb:
 	 * ...and if that fails, do a wildcard search.
 	 */
 	if (inp == NULL) {
-		inp = in_pcblookup(&tcb, ti->ti_src, ti->ti_sport,
+		inp = in_pcblookup(&tcbinfo, ti->ti_src, ti->ti_sport,
 		    ti->ti_dst, ti->ti_dport, INPLOOKUP_WILDCARD);
 	}
 
@@ -502,7 +550,10 @@ findpcb:
 		if (ti->ti_len == 0) {
 			if (SEQ_GT(ti->ti_ack, tp->snd_una) &&
 			    SEQ_LEQ(ti->ti_ack, tp->snd_max) &&
-			    tp->snd_cwnd >= tp->snd_wnd) {
+			    tp->snd_cwnd >= tp->snd_wnd &&
+			    (to.to_flag & TOF_SACK) == 0 &&
+			    tp->snd_numsacks == 0 &&
+			    (tp->t_flags & TF_SACKRECOVERY) == 0) {
 				/*
 				 * this is a pure ack for outstanding data.
 				 */
@@ -1201,6 +1252,14 @@ trimthenstep6:
 	case TCPS_LAST_ACK:
 	case TCPS_TIME_WAIT:
 
+		/*
+		 * Bring the SACK scoreboard up to date first, the
+		 * recovery decisions below are based on it.
+		 */
+		if (TCP_SACK_ENABLED(tp) &&
+		    ((to.to_flag & TOF_SACK) || tp->snd_numsacks))
+			tcp_sack_doack(tp, &to, ti->ti_ack);
+
 		if (SEQ_LEQ(ti->ti_ack, tp->snd_una)) {
 			if (ti->ti_len == 0 && tiwin == tp->snd_wnd) {
 				tcpstat.tcps_rcvdupack++;
@@ -1227,16 +1286,49 @@ trimthenstep6:
 				 * so bump cwnd by the amount in the receiver
 				 * to keep a constant cwnd packets in the
 				 * network.
+				 *
+				 * If the peer SACKs, recovery follows RFC 6675
+				 * instead: it starts as well when more than
+				 * (threshold - 1) segments have been SACKed,
+				 * and the scoreboard, not an inflated cwnd,
+				 * tells how much has left the network.
 				 */
 				if (tp->t_timer[TCPT_REXMT] == 0 ||
 				    ti->ti_ack != tp->snd_una)
 					tp->t_dupacks = 0;
-				else if (++tp->t_dupacks == tcprexmtthresh) {
+				else if (tp->t_flags & TF_SACKRECOVERY) {
+					tp->t_dupacks++;
+					(void) tcp_output(tp);
+					goto drop;
+				} else if (++tp->t_dupacks == tcprexmtthresh ||
+				    (tp->t_dupacks < tcprexmtthresh &&
+				     tp->snd_numsacks > 0 &&
+				     tp->snd_sacked > (u_long)(tcprexmtthresh - 1) *
+					tp->t_maxseg)) {
 					tcp_seq onxt = tp->snd_nxt;
-					u_int win =
-					    MIN(tp->snd_wnd, tp->snd_cwnd) / 2 /
-						tp->t_maxseg;
-
+					u_int win;
+
+					if (tp->snd_numsacks > 0) {
+						/*
+						 * Retransmit the first hole
+						 * whatever the pipe estimate
+						 * says, the acks for it and
+						 * the SACKed data clock out
+						 * the rest.
+						 */
+						u_long ocwnd;
+
+						tcp_sack_enterrecovery(tp);
+						tp->t_timer[TCPT_REXMT] = 0;
+						ocwnd = tp->snd_cwnd;
+						tp->snd_cwnd = tcp_sack_pipe(tp) +
+						    tp->t_maxseg;
+						(void) tcp_output(tp);
+						tp->snd_cwnd = ocwnd;
+						goto drop;
+					}
+					win = MIN(tp->snd_wnd, tp->snd_cwnd) /
+					    2 / tp->t_maxseg;
 					if (win < 2)
 						win = 2;
 					tp->snd_ssthresh = win * tp->t_maxseg;
@@ -1254,6 +1346,25 @@ trimthenstep6:
 					tp->snd_cwnd += tp->t_maxseg;
 					(void) tcp_output(tp);
 					goto drop;
+				} else if (tcp_do_limitedxmit &&
+				    tp->snd_nxt == tp->snd_max) {
+					/*
+					 * Limited transmit (RFC 3042): let
+					 * a new segment out for each of the
+					 * first dup acks, so that a small
+					 * window still yields enough of them
+					 * for a fast retransmit.
+					 */
+					u_long ocwnd = tp->snd_cwnd;
+					tcp_seq omax = tp->snd_max;
+
+					tp->snd_cwnd += tp->t_dupacks *
+					    tp->t_maxseg;
+					(void) tcp_output(tp);
+					tp->snd_cwnd = ocwnd;
+					tcpstat.tcps_limitedxmit +=
+					    (tp->snd_max - omax +
+					     tp->t_maxseg - 1) / tp->t_maxseg;
 				}
 			} else
 				tp->t_dupacks = 0;
@@ -1271,6 +1382,18 @@ trimthenstep6:
 			tcpstat.tcps_rcvacktoomuch++;
 			goto dropafterack;
 		}
+		/*
+		 * In SACK recovery an ack below the recovery point
+		 * leaves holes to fill: stay in recovery and have
+		 * tcp_output() go on.  Once everything that was
+		 * outstanding when recovery began is acked, it is over.
+		 */
+		if (tp->t_flags & TF_SACKRECOVERY) {
+			if (SEQ_LT(ti->ti_ack, tp->snd_recover))
+				needoutput = 1;
+			else
+				tp->t_flags &= ~TF_SACKRECOVERY;
+		}
 		/*
 		 *  If we reach this point, ACK is not a duplicate,
 		 *     i.e., it ACKs something we sent.
@@ -1329,9 +1452,10 @@ process_ACK:
 		 * If the window gives us less than ssthresh packets
 		 * in flight, open exponentially (maxseg per packet).
 		 * Otherwise open linearly: maxseg per window
-		 * (maxseg^2 / cwnd per packet).
+		 * (maxseg^2 / cwnd per packet).  During SACK
+		 * recovery the window stays at ssthresh.
 		 */
-		{
+		if ((tp->t_flags & TF_SACKRECOVERY) == 0) {
 		register u_int cw = tp->snd_cwnd;
 		register u_int incr = tp->t_maxseg;
 
@@ -1710,6 +1834,31 @@ tcp_dooptions(tp, cp, cnt, ti, to)
 			tp->requested_s_scale = MIN(cp[2], TCP_MAX_WINSHIFT);
 			break;
 
+		case TCPOPT_SACK_PERMITTED:
+			if (optlen != TCPOLEN_SACK_PERMITTED)
+				continue;
+			if (!(ti->ti_flags & TH_SYN))
+				continue;
+			/*
+			 * Only if we want it too: on a SYN,ACK the
+			 * peer has agreed to ours, on a SYN ours
+			 * goes out with the SYN,ACK.
+			 */
+			if (tp->t_flags & TF_REQ_SACK)
+				tp->t_flags |= TF_SACK_PERMIT;
+			break;
+
+		case TCPOPT_SACK:
+			if (optlen <= 2 || optlen > cnt ||
+			    (optlen - 2) % TCPOLEN_SACK != 0)
+				continue;
+			if (!TCP_SACK_ENABLED(tp) || (ti->ti_flags & TH_SYN))
+				continue;
+			to->to_flag |= TOF_SACK;
+			to->to_nsacks = (optlen - 2) / TCPOLEN_SACK;
+			to->to_sacks = cp + 2;
+			break;
+
 		case TCPOPT_TIMESTAMP:
 			if (optlen != TCPOLEN_TIMESTAMP)
 				continue;
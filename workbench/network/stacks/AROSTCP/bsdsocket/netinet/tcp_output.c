@@ -83,7 +83,9 @@ tcp_output(tp)
 	register struct tcpiphdr *ti;
 	u_char opt[TCP_MAXOLEN];
 	unsigned optlen, hdrlen;
-	int idle, sendalot;
+	int idle, sendalot, sack_rxmit;
+	tcp_seq rxmitseq, rxmitend;
+	long cwin;
 	struct rmxp_tao *taop;
 	struct rmxp_tao tao_noncached;
 
@@ -149,7 +151,28 @@ again:
 		}
 	}
 
-	len = MIN(so->so_snd.sb_cc, win) - off;
+	/*
+	 * In SACK recovery fill the lost holes first and send new
+	 * data after that, as long as the pipe estimate stays at least
+	 * a segment below cwnd (RFC 6675, section 5).
+	 */
+	sack_rxmit = 0;
+	if (tp->t_flags & TF_SACKRECOVERY) {
+		cwin = (long)tp->snd_cwnd - tcp_sack_pipe(tp);
+		if (cwin < tp->t_maxseg)
+			cwin = 0;
+		if (cwin && tcp_sack_nextseg(tp, &rxmitseq, &rxmitend)) {
+			sack_rxmit = 1;
+			sendalot = 1;
+			off = rxmitseq - tp->snd_una;
+			len = MIN((long)(rxmitend - rxmitseq), cwin);
+		} else {
+			len = (long)MIN(so->so_snd.sb_cc, tp->snd_wnd) - off;
+			if (len > cwin)
+				len = cwin;
+		}
+	} else
+		len = MIN(so->so_snd.sb_cc, win) - off;
 
 	if ((taop = tcp_gettaocache(tp->t_inpcb)) == NULL) {
 		taop = &tao_noncached;
@@ -190,7 +213,8 @@ again:
 		len = tp->t_maxseg;
 		sendalot = 1;
 	}
-	if (SEQ_LT(tp->snd_nxt + len, tp->snd_una + so->so_snd.sb_cc))
+	if (SEQ_LT((sack_rxmit ? rxmitseq : tp->snd_nxt) + len,
+	    tp->snd_una + so->so_snd.sb_cc))
 		flags &= ~TH_FIN;
 
 	win = sbspace(&so->so_rcv);
@@ -206,7 +230,7 @@ again:
 	 * to send into a small window), then must resend.
 	 */
 	if (len) {
-		if (len == tp->t_maxseg)
+		if (len == tp->t_maxseg || sack_rxmit)
 			goto send;
 		if ((idle || tp->t_flags & TF_NODELAY) &&
 		    (tp->t_flags & TF_NOPUSH) == 0 &&
@@ -326,6 +350,14 @@ send:
 					tp->request_r_scale);
 				optlen += 4;
 			}
+
+			if ((tp->t_flags & TF_REQ_SACK) &&
+			    ((flags & TH_ACK) == 0 ||
+			    (tp->t_flags & TF_SACK_PERMIT))) {
+				*((u_int32_t *) (opt + optlen)) =
+				    htonl(TCPOPT_SACK_PERMIT_HDR);
+				optlen += 4;
+			}
 		}
  	}
 
@@ -436,6 +468,31 @@ send:
 		}
  	}
 
+	/*
+	 * Report the blocks waiting in the reassembly queue, the
+	 * most recent first, as many as fit (RFC 2018).
+	 */
+	if (TCP_SACK_ENABLED(tp) && tp->rcv_numsacks > 0 &&
+	    (tp->t_flags & TF_NOOPT) == 0 &&
+	    (flags & (TH_SYN|TH_RST)) == 0) {
+		u_int32_t *lp = (u_int32_t *)(opt + optlen);
+		int i, nsacks;
+
+		nsacks = ((int)TCP_MAXOLEN - (int)optlen - 4) / TCPOLEN_SACK;
+		if (nsacks > tp->rcv_numsacks)
+			nsacks = tp->rcv_numsacks;
+		if (nsacks > 0) {
+			*lp++ = htonl(TCPOPT_SACK_HDR |
+			    (2 + nsacks * TCPOLEN_SACK));
+			for (i = 0; i < nsacks; i++) {
+				*lp++ = htonl(tp->rcv_sacks[i].start);
+				*lp++ = htonl(tp->rcv_sacks[i].end);
+			}
+			optlen += 4 + nsacks * TCPOLEN_SACK;
+			tcpstat.tcps_sack_sndblocks += nsacks;
+		}
+	}
+
  	hdrlen += optlen;
 
 	/*
@@ -467,7 +524,12 @@ send:
 	if (len) {
 		if (tp->t_force && len == 1)
 			tcpstat.tcps_sndprobe++;
-		else if (SEQ_LT(tp->snd_nxt, tp->snd_max)) {
+		else if (sack_rxmit) {
+			tcpstat.tcps_sndrexmitpack++;
+			tcpstat.tcps_sndrexmitbyte += len;
+			tcpstat.tcps_sack_rexmitpack++;
+			tcpstat.tcps_sack_rexmitbyte += len;
+		} else if (SEQ_LT(tp->snd_nxt, tp->snd_max)) {
 			tcpstat.tcps_sndrexmitpack++;
 			tcpstat.tcps_sndrexmitbyte += len;
 		} else {
@@ -556,7 +618,9 @@ send:
 	 * case, since we know we aren't doing a retransmission.
 	 * (retransmit and persist are mutually exclusive...)
 	 */
-	if (len || (flags & (TH_SYN|TH_FIN)) || tp->t_timer[TCPT_PERSIST])
+	if (sack_rxmit)
+		ti->ti_seq = htonl(rxmitseq);
+	else if (len || (flags & (TH_SYN|TH_FIN)) || tp->t_timer[TCPT_PERSIST])
 		ti->ti_seq = htonl(tp->snd_nxt);
 	else
 		ti->ti_seq = htonl(tp->snd_max);
@@ -605,6 +669,16 @@ send:
 	if (tp->t_force == 0 || tp->t_timer[TCPT_PERSIST] == 0) {
 		tcp_seq startseq = tp->snd_nxt;
 
+		/*
+		 * A retransmission from the SACK scoreboard leaves
+		 * snd_nxt alone, it only moves the hole pointer.
+		 */
+		if (sack_rxmit) {
+			tp->snd_rexmitnxt = rxmitseq + len;
+			tp->snd_rexmitted += len;
+			goto timer;
+		}
+
 		/*
 		 * Advance snd_nxt over sequence space of this segment.
 		 */
@@ -630,6 +704,7 @@ send:
 			}
 		}
 
+timer:
 		/*
 		 * Set retransmit timer if not currently set,
 		 * and not doing an ack or a keep-alive probe.
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2026 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Selective acknowledgements (RFC 2018) and the loss recovery
+ * built on them (RFC 6675).
+ *
+ * The receiver keeps the blocks it reports in tp->rcv_sacks, the
+ * reassembly queue itself holds one entry per block.  The sender
+ * keeps what the peer has reported in the scoreboard tp->snd_sacks,
+ * a small sorted array of disjoint blocks above snd_una; the holes
+ * are the gaps between them.
+ */
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/mbuf.h>
+#include <sys/socket.h>
+#include <sys/socketvar.h>
+#include <sys/protosw.h>
+#include <sys/queue.h>
+
+#include <netinet/in.h>
+#include <netinet/in_systm.h>
+#include <netinet/ip.h>
+#include <netinet/in_pcb.h>
+#include <netinet/ip_var.h>
+#include <netinet/tcp.h>
+#include <netinet/tcp_fsm.h>
+#include <netinet/tcp_seq.h>
+#include <netinet/tcp_timer.h>
+#include <netinet/tcp_var.h>
+#include <netinet/tcpip.h>
+
+extern int tcprexmtthresh;
+
+/*
+ * A hole is lost once more than (DupThresh - 1) segments worth of
+ * data above it has been SACKed.  The hole at snd_una is taken as
+ * lost as soon as recovery starts, the duplicate acks said so.
+ */
+#define	SACK_LOSTTHRESH(tp)	((u_long)(tcprexmtthresh - 1) * (tp)->t_maxseg)
+
+/*
+ * Remember that [start, end) is queued for reassembly.  The block
+ * holding the most recently received segment is reported first,
+ * followed by the blocks reported before which it does not cover
+ * (RFC 2018, section 4).
+ */
+void
+tcp_sack_report(tp, start, end)
+	struct tcpcb *tp;
+	tcp_seq start, end;
+{
+	struct sackblk sacks[TCP_MAX_SACK];
+	register struct sackblk *sb;
+	int i, n = 0;
+
+	sacks[n].start = start;
+	sacks[n++].end = end;
+	for (i = 0; i < tp->rcv_numsacks && n < TCP_MAX_SACK; i++) {
+		sb = &tp->rcv_sacks[i];
+		if (SEQ_LEQ(sb->end, tp->rcv_nxt))
+			continue;
+		if (SEQ_LT(sb->start, end) && SEQ_GT(sb->end, start))
+			continue;
+		sacks[n++] = *sb;
+	}
+	bcopy(sacks, tp->rcv_sacks, n * sizeof(sacks[0]));
+	tp->rcv_numsacks = n;
+}
+
+/*
+ * Forget the reported blocks which rcv_nxt has passed.
+ */
+void
+tcp_sack_trim(tp)
+	struct tcpcb *tp;
+{
+	int i, n;
+
+	for (i = n = 0; i < tp->rcv_numsacks; i++)
+		if (SEQ_GT(tp->rcv_sacks[i].end, tp->rcv_nxt))
+			tp->rcv_sacks[n++] = tp->rcv_sacks[i];
+	tp->rcv_numsacks = n;
+}
+
+/*
+ * Recount the bytes the scoreboard covers, the bytes of the holes
+ * considered lost and the bytes retransmitted into the holes.
+ * una is the left edge of the send window.
+ */
+static void
+tcp_sack_recount(tp, una)
+	struct tcpcb *tp;
+	tcp_seq una;
+{
+	register struct sackblk *sb;
+	tcp_seq holestart = una;
+	u_long above;
+	int i;
+
+	tp->snd_sacked = 0;
+	for (i = 0; i < tp->snd_numsacks; i++)
+		tp->snd_sacked += tp->snd_sacks[i].end - tp->snd_sacks[i].start;
+
+	tp->snd_lost = 0;
+	tp->snd_rexmitted = 0;
+	above = tp->snd_sacked;
+	for (i = 0; i < tp->snd_numsacks; i++) {
+		sb = &tp->snd_sacks[i];
+		if (holestart == una || above > SACK_LOSTTHRESH(tp))
+			tp->snd_lost += sb->start - holestart;
+		if (SEQ_GT(tp->snd_rexmitnxt, holestart))
+			tp->snd_rexmitted += (SEQ_LT(tp->snd_rexmitnxt,
+			    sb->start) ? tp->snd_rexmitnxt : sb->start) -
+			    holestart;
+		above -= sb->end - sb->start;
+		holestart = sb->end;
+	}
+}
+
+/*
+ * Update the scoreboard from an incoming segment: data up to the
+ * cumulative ack leaves it, the SACK blocks of the segment are
+ * merged in.  Blocks which are below the ack (D-SACK), above snd_max
+ * or empty are ignored.
+ */
+void
+tcp_sack_doack(tp, to, ack)
+	struct tcpcb *tp;
+	struct tcpopt *to;
+	tcp_seq ack;
+{
+	register struct sackblk *board = tp->snd_sacks;
+	tcp_seq una, start, end;
+	u_char *cp;
+	int i, j, k, n = tp->snd_numsacks;
+
+	una = tp->snd_una;
+	if (SEQ_GT(ack, una) && SEQ_LEQ(ack, tp->snd_max))
+		una = ack;
+
+	for (i = 0; i < n && SEQ_LEQ(board[i].end, una); i++)
+		;
+	if (i > 0) {
+		ovbcopy(board + i, board, (n - i) * sizeof(*board));
+		n -= i;
+	}
+	if (n > 0 && SEQ_LT(board[0].start, una))
+		board[0].start = una;
+
+	if (to->to_flag & TOF_SACK) {
+		for (k = 0, cp = to->to_sacks; k < to->to_nsacks;
+		     k++, cp += TCPOLEN_SACK) {
+			tcpstat.tcps_sack_rcvblocks++;
+			bcopy(cp, &start, sizeof(start));
+			NTOHL(start);
+			bcopy(cp + sizeof(start), &end, sizeof(end));
+			NTOHL(end);
+			if (SEQ_LEQ(end, start) || SEQ_LEQ(end, una) ||
+			    SEQ_GT(end, tp->snd_max))
+				continue;
+			if (SEQ_LT(start, una))
+				start = una;
+
+			/*
+			 * Find the first block that does not end below
+			 * the new one and swallow every block it touches.
+			 */
+			for (i = 0; i < n && SEQ_LT(board[i].end, start); i++)
+				;
+			for (j = i; j < n && SEQ_LEQ(board[j].start, end); j++) {
+				if (SEQ_LT(board[j].start, start))
+					start = board[j].start;
+				if (SEQ_GT(board[j].end, end))
+					end = board[j].end;
+			}
+			if (j == i) {
+				/*
+				 * A new block.  When the board is full the
+				 * highest block is forgotten.
+				 */
+				if (n == TCP_SACKBOARD) {
+					if (i == n)
+						continue;
+					n--;
+				}
+				ovbcopy(board + i, board + i + 1,
+				    (n - i) * sizeof(*board));
+				n++;
+			} else if (j > i + 1) {
+				ovbcopy(board + j, board + i + 1,
+				    (n - j) * sizeof(*board));
+				n -= j - i - 1;
+			}
+			board[i].start = start;
+			board[i].end = end;
+		}
+	}
+	tp->snd_numsacks = n;
+
+	if (SEQ_LT(tp->snd_rexmitnxt, una))
+		tp->snd_rexmitnxt = una;
+	tcp_sack_recount(tp, una);
+}
+
+/*
+ * Enter loss recovery (RFC 6675, section 5): halve the window and
+ * remember where recovery ends.  From now on tcp_output() retransmits
+ * the lost holes and sends new data as the pipe estimate allows.
+ */
+void
+tcp_sack_enterrecovery(tp)
+	struct tcpcb *tp;
+{
+	u_int win = MIN(tp->snd_wnd, tp->snd_cwnd) / 2 / tp->t_maxseg;
+
+	if (win < 2)
+		win = 2;
+	tp->snd_ssthresh = win * tp->t_maxseg;
+	tp->snd_cwnd = tp->snd_ssthresh;
+	tp->snd_recover = tp->snd_max;
+	tp->snd_rexmitnxt = tp->snd_una;
+	tp->t_flags |= TF_SACKRECOVERY;
+	tp->t_rtt = 0;
+	tcp_sack_recount(tp, tp->snd_una);
+	tcpstat.tcps_sack_recovery++;
+}
+
+/*
+ * Forget the scoreboard and leave recovery, after a retransmit
+ * timeout the peer may have reneged on what it SACKed (RFC 2018,
+ * section 8).
+ */
+void
+tcp_sack_reset(tp)
+	struct tcpcb *tp;
+{
+	tp->snd_numsacks = 0;
+	tp->snd_sacked = 0;
+	tp->snd_lost = 0;
+	tp->snd_rexmitted = 0;
+	tp->t_flags &= ~TF_SACKRECOVERY;
+}
+
+/*
+ * The number of bytes estimated to be in flight (RFC 6675, "pipe"):
+ * everything outstanding that is neither SACKed nor lost, plus what
+ * has been retransmitted.
+ */
+long
+tcp_sack_pipe(tp)
+	struct tcpcb *tp;
+{
+	return ((long)(tp->snd_max - tp->snd_una) - (long)tp->snd_sacked -
+	    (long)tp->snd_lost + (long)tp->snd_rexmitted);
+}
+
+/*
+ * Find what to retransmit next: the lowest part of a lost hole that
+ * has not been retransmitted yet (RFC 6675, NextSeg() rule 1).
+ * Returns 0 if there is nothing.
+ */
+int
+tcp_sack_nextseg(tp, seqp, endp)
+	struct tcpcb *tp;
+	tcp_seq *seqp, *endp;
+{
+	register struct sackblk *sb;
+	tcp_seq holestart = tp->snd_una;
+	u_long above = tp->snd_sacked;
+	int i;
+
+	for (i = 0; i < tp->snd_numsacks; i++) {
+		sb = &tp->snd_sacks[i];
+		/* the holes above this one have even less SACKed above */
+		if (holestart != tp->snd_una && above <= SACK_LOSTTHRESH(tp))
+			break;
+		if (SEQ_LT(tp->snd_rexmitnxt, sb->start)) {
+			*seqp = SEQ_GT(tp->snd_rexmitnxt, holestart) ?
+			    tp->snd_rexmitnxt : holestart;
+			*endp = sb->start;
+			return (1);
+		}
+		above -= sb->end - sb->start;
+		holestart = sb->end;
+	}
+	return (0);
+}
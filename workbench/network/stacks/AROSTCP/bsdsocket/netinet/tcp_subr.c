@@ -35,6 +35,8 @@
  * $Id$
  */
 
+#include <conf.h>
+
 #include <sys/param.h>
 #include <sys/systm.h>
 #include <sys/malloc.h>
@@ -73,14 +75,16 @@ int 	tcp_mssdflt = TCP_MSS;
 int 	tcp_rttdflt = TCPTV_SRTTDFLT / PR_SLOWHZ;
 int	tcp_do_rfc1323 = 1;
 int	tcp_do_rfc1644 = 1;
+LONG	tcp_do_sack = 1;			  /* LONG for kern/config_var.c */
+LONG	tcp_do_limitedxmit = 1;
 static	void tcp_cleartaocache(void);
 
 extern u_char inetctlerrmap[];
 extern struct in_addr zeroin_addr;
 
 /*
- * Target size of TCP PCB hash table. Will be rounded down to a prime
- * number.
+ * Initial target size of the TCP PCB hash tables. Will be rounded down
+ * to a prime number, the tables grow with the number of connections.
  */
 #ifndef TCBHASHSIZE
 #define TCBHASHSIZE	128
@@ -96,9 +100,7 @@ tcp_init()
 	tcp_iss = 1;		/* wrong */
 	tcp_ccgen = 1;
 	tcp_cleartaocache();
-	LIST_INIT(&tcb);
-	tcbinfo.listhead = &tcb;
-	tcbinfo.hashbase = phashinit(TCBHASHSIZE, M_PCB, &tcbinfo.hashsize);
+	in_pcbinitinfo(&tcbinfo, &tcb, TCBHASHSIZE);
 	if (max_protohdr < sizeof(struct tcpiphdr))
 		max_protohdr = sizeof(struct tcpiphdr);
 	if (max_linkhdr + sizeof(struct tcpiphdr) > MHLEN)
@@ -250,6 +252,8 @@ tcp_newtcpcb(inp)
 		tp->t_flags = (TF_REQ_SCALE|TF_REQ_TSTMP);
 	if (tcp_do_rfc1644)
 		tp->t_flags |= TF_REQ_CC;
+	if (tcp_do_sack)
+		tp->t_flags |= TF_REQ_SACK;
 	tp->t_inpcb = inp;
 	/*
 	 * Init srtt to TCPTV_SRTTBASE (0), so we can tell that we have no
@@ -450,10 +454,10 @@ tcp_ctlinput(cmd, sa, arg)
 		return;
 	if (ip) {
 		th = (struct tcphdr *)((caddr_t)ip + (ip->ip_hl << 2));
-		in_pcbnotify(&tcb, sa, th->th_dport, ip->ip_src, th->th_sport,
+		in_pcbnotify(&tcbinfo, sa, th->th_dport, ip->ip_src, th->th_sport,
 			cmd, notify);
 	} else
-		in_pcbnotify(&tcb, sa, 0, zeroin_addr, 0, cmd, notify);
+		in_pcbnotify(&tcbinfo, sa, 0, zeroin_addr, 0, cmd, notify);
 }
 
 /*
@@ -220,6 +220,12 @@ tcp_timers(tp, timer)
 			tp->t_srtt = 0;
 		}
 		tp->snd_nxt = tp->snd_una;
+		/*
+		 * Go back to the first unacked byte without trusting
+		 * the SACK scoreboard, the peer may have discarded
+		 * what it reported.
+		 */
+		tcp_sack_reset(tp);
 		/*
 		 * Force a segment to be sent.
 		 */
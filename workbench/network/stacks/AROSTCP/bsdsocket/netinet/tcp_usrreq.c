@@ -73,6 +73,7 @@
  * TCP protocol interface to socket abstraction.
  */
 extern	char *tcpstates[];
+extern	LONG tcp_do_sack;
 
 /*
  * Process a TCP user request for TCP tb.  If this is a send request
@@ -413,7 +414,7 @@ tcp_connect(tp, nam)
 	error = in_pcbladdr(inp, nam, &ifaddr);
 	if (error)
 		return error;
-	oinp = in_pcblookup(inp->inp_pcbinfo->listhead,
+	oinp = in_pcblookup(inp->inp_pcbinfo,
 	    sin->sin_addr, sin->sin_port,
 	    inp->inp_laddr.s_addr != INADDR_ANY ? inp->inp_laddr
 						: ifaddr->sin_addr,
@@ -714,6 +715,9 @@ tcp_sysctl(name, namelen, oldp, oldlenp, newp, newlen)
 	case TCPCTL_RECVSPACE:
 		return (sysctl_int(oldp, oldlenp, newp, newlen,
 				   (int *)&tcp_recvspace)); /* XXX */
+	case TCPCTL_DO_SACK:
+		return (sysctl_int(oldp, oldlenp, newp, newlen,
+		    (int *)&tcp_do_sack)); /* XXX */
 	default:
 		return (ENOPROTOOPT);
 	}
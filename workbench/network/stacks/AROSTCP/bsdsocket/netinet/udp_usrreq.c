@@ -98,9 +98,7 @@ static	struct mbuf *udp_saveopt __P((caddr_t, int, int));
 void
 udp_init()
 {
-	LIST_INIT(&udb);
-	udbinfo.listhead = &udb;
-	udbinfo.hashbase = phashinit(UDBHASHSIZE, M_PCB, &udbinfo.hashsize);
+	in_pcbinitinfo(&udbinfo, &udb, UDBHASHSIZE);
 }
 
 void udp_input(void *args, ...)
@@ -207,9 +205,13 @@ void udp_input(void *args, ...)
 		/*
 		 * Locate pcb(s) for datagram.
 		 * (Algorithm copied from raw_intr().)
+		 * All candidates are bound to the destination port, so
+		 * only its chain of the local port hash is searched.
 		 */
 		last = NULL;
-		for (inp = udb.lh_first; inp != NULL; inp = inp->inp_list.le_next) {
+		for (inp = udbinfo.porthashbase[INP_PCBPORTHASH(uh->uh_dport,
+		    udbinfo.porthashsize)].lh_first; inp != NULL;
+		    inp = inp->inp_portlist.le_next) {
 			if (inp->inp_lport != uh->uh_dport)
 				continue;
 			if (inp->inp_laddr.s_addr != INADDR_ANY) {
@@ -276,7 +278,7 @@ void udp_input(void *args, ...)
 	 * ...and if that fails, do a wildcard search.
 	 */
 	if (inp == NULL) {
-		inp = in_pcblookup(&udb, ip->ip_src, uh->uh_sport, ip->ip_dst,
+		inp = in_pcblookup(&udbinfo, ip->ip_src, uh->uh_sport, ip->ip_dst,
 		    uh->uh_dport, INPLOOKUP_WILDCARD);
 	}
 	if (inp == NULL) {
@@ -392,10 +394,10 @@ udp_ctlinput(cmd, sa, arg)
 		return;
 	if (ip) {
 		uh = (struct udphdr *)((caddr_t)ip + (ip->ip_hl << 2));
-		in_pcbnotify(&udb, sa, uh->uh_dport, ip->ip_src, uh->uh_sport,
+		in_pcbnotify(&udbinfo, sa, uh->uh_dport, ip->ip_src, uh->uh_sport,
 			cmd, udp_notify);
 	} else
-		in_pcbnotify(&udb, sa, 0, zeroin_addr, 0, cmd, udp_notify);
+		in_pcbnotify(&udbinfo, sa, 0, zeroin_addr, 0, cmd, udp_notify);
 }
 
 int
@@ -21,7 +21,7 @@ void in_setsockaddr(register struct inpcb * inp,
 void in_setpeeraddr(struct inpcb * inp,
                    struct mbuf * nam);
 
-void in_pcbnotify(struct inpcb * head,
+void in_pcbnotify(struct inpcbinfo * pcbinfo,
                  struct sockaddr * dst,
                  u_short fport,
                  struct in_addr laddr,
@@ -33,7 +33,7 @@ void in_losing(struct inpcb * inp);
 
 void in_rtchange(register struct inpcb * inp, int error);
 
-struct inpcb * in_pcblookup(struct inpcb * head,
+struct inpcb * in_pcblookup(struct inpcbinfo * pcbinfo,
                             struct in_addr faddr,
                             u_short fport,
                             struct in_addr laddr,
@@ -62,7 +62,8 @@
 #define M_CFGVAR 	14	/* configureable variable */
 #define M_NETDB  	15	/* netdb node */
 #define M_ARPENT        16	/* ARP entry */
-#define	M_LAST		17
+#define M_RESCACHE      17	/* resolver cache entry */
+#define	M_LAST		18
 
 #ifdef KERNEL
 
@@ -37,6 +37,7 @@ $Id$
 #include <dos/dos.h>
 #include <dos/datetime.h>
 #include <dos/filehandler.h>
+#include <dos/exall.h>
 
 #include <exec/memory.h>
 #include <graphics/gfx.h>
@@ -111,17 +112,65 @@ $Id$
 extern struct Library *MUIMasterBase;
 
 
+#define EXALL_BUFFERSIZE        16384
+
+/* ExAll() fills one of these per call, they are chained until the drawer is read */
+struct DrawerExAllBuffer
+{
+    struct DrawerExAllBuffer    *deab_Next;
+    IPTR                        deab_Data[EXALL_BUFFERSIZE / sizeof(IPTR)];
+};
+
+static int IconDrawerList__CompareExAllNames(const void *ed1, const void *ed2)
+{
+    return Stricmp((*(struct ExAllData **)ed1)->ed_Name, (*(struct ExAllData **)ed2)->ed_Name);
+}
+
+/* Without the sorted names (out of memory) the buffers are searched one entry after another */
+static struct ExAllData *IconDrawerList__FindExAllName(struct DrawerExAllBuffer *buffers, struct ExAllData **names, ULONG count, CONST_STRPTR name)
+{
+    struct ExAllData            key, *keyptr = &key, **found, *ead;
+
+    if (names == NULL)
+    {
+        for (; buffers; buffers = buffers->deab_Next)
+        {
+            for (ead = (struct ExAllData *)buffers->deab_Data; ead; ead = ead->ed_Next)
+                if (!Stricmp(ead->ed_Name, name))
+                    return ead;
+        }
+        return NULL;
+    }
+
+    key.ed_Name = (STRPTR)name;
+    found = bsearch(&keyptr, names, count, sizeof(struct ExAllData *), IconDrawerList__CompareExAllNames);
+
+    return found ? *found : NULL;
+}
+
 ///IconDrawerList__ParseContents()
 /**************************************************************************
-Read icons in
+Read icons in. The drawer is read with ExAll() into a chain of buffers,
+so that the existence of "name" and "name.info" can be checked with a
+binary search instead of locking each file. Entries whose icon would not
+be shown are created without loading their DiskObject, and the list is
+sorted once as soon as the entries read fill the visible area, so the
+first screenful appears before the whole drawer has been parsed.
 **************************************************************************/
 static int IconDrawerList__ParseContents(struct IClass *CLASS, Object *obj)
 {
     struct IconDrawerList_DATA  *data = INST_DATA(CLASS, obj);
-    BPTR                        lock = BNULL, tmplock = BNULL;
+    BPTR                        lock = BNULL;
     char                        filename[256];
     char                        namebuffer[512];
     ULONG                       list_DisplayFlags = 0;
+    struct ExAllControl         *eac;
+    struct DrawerExAllBuffer    *buffers = NULL, *buffer, **buffer_tail = &buffers;
+    struct ExAllData            *ead, **names = NULL;
+    struct FileInfoBlock        *fib;
+    ULONG                       count = 0, i, level = ED_OWNER;
+    ULONG                       visible_area = 0, shown_area = 0;
+    BOOL                        more = FALSE;
 
     D(bug("[IconDrawerList]: %s()\n", __PRETTY_FUNCTION__));
 
@@ -131,21 +180,84 @@ static int IconDrawerList__ParseContents(struct IClass *CLASS, Object *obj)
 
     if (lock)
     {
-        struct FileInfoBlock *fib = AllocDosObject(DOS_FIB, NULL);
-        if (fib)
+        fib = AllocDosObject(DOS_FIB, NULL);
+        eac = AllocDosObject(DOS_EXALLCONTROL, NULL);
+        if (fib && eac)
         {
-            if (Examine(lock, fib))
+            GET(obj, MUIA_IconList_DisplayFlags, &list_DisplayFlags);
+            D(bug("[IconDrawerList] %s: DisplayFlags = 0x%p\n", __PRETTY_FUNCTION__, list_DisplayFlags));
+
+            eac->eac_LastKey = 0;
+            eac->eac_MatchString = NULL;
+            eac->eac_MatchFunc = NULL;
+
+            do
             {
-                GET(obj, MUIA_IconList_DisplayFlags, &list_DisplayFlags);
-                D(bug("[IconDrawerList] %s: DisplayFlags = 0x%p\n", __PRETTY_FUNCTION__, list_DisplayFlags));
+                if ((buffer = AllocVec(sizeof(struct DrawerExAllBuffer), MEMF_ANY)) == NULL)
+                {
+                    IPTR endbuffer[32];
 
-                while(ExNext(lock, fib))
+                    D(bug("[IconDrawerList] %s: Failed to allocate ExAll buffer!!!\n", __PRETTY_FUNCTION__));
+                    if (more)
+                        ExAllEnd(lock, (struct ExAllData *)endbuffer, sizeof(endbuffer), level, eac);
+                    break;
+                }
+                buffer->deab_Next = NULL;
+
+                more = ExAll(lock, (struct ExAllData *)buffer->deab_Data, EXALL_BUFFERSIZE, level, eac);
+                if (!more && (IoErr() == ERROR_BAD_NUMBER) && (level > ED_COMMENT) && (buffers == NULL))
                 {
-                    int len = strlen(fib->fib_FileName);
+                    /* The filesystem has no owner information, try again without */
+                    D(bug("[IconDrawerList] %s: ExAll level %u unsupported, using ED_COMMENT\n", __PRETTY_FUNCTION__, level));
+                    level = ED_COMMENT;
+                    eac->eac_LastKey = 0;
+                    more = ExAll(lock, (struct ExAllData *)buffer->deab_Data, EXALL_BUFFERSIZE, level, eac);
+                }
+
+                if (!more && (IoErr() != ERROR_NO_MORE_ENTRIES))
+                {
+                    D(bug("[IconDrawerList] %s: ExAll failed (error %d)\n", __PRETTY_FUNCTION__, IoErr()));
+                }
+
+                if (eac->eac_Entries > 0)
+                {
+                    count += eac->eac_Entries;
+                    *buffer_tail = buffer;
+                    buffer_tail = &buffer->deab_Next;
+                }
+                else
+                    FreeVec(buffer);
+            } while (more);
+
+            D(bug("[IconDrawerList] %s: %u entries read\n", __PRETTY_FUNCTION__, count));
+
+            if ((count > 0) && ((names = AllocVec(count * sizeof(struct ExAllData *), MEMF_ANY)) != NULL))
+            {
+                i = 0;
+                for (buffer = buffers; buffer; buffer = buffer->deab_Next)
+                {
+                    for (ead = (struct ExAllData *)buffer->deab_Data; ead; ead = ead->ed_Next)
+                        names[i++] = ead;
+                }
+                count = i;
+                qsort(names, count, sizeof(struct ExAllData *), IconDrawerList__CompareExAllNames);
+            }
+
+            if (_mwidth(obj) > 0 && _mheight(obj) > 0)
+                visible_area = _mwidth(obj) * _mheight(obj);
+
+            for (buffer = buffers; buffer; buffer = buffer->deab_Next)
+            {
+                for (ead = (struct ExAllData *)buffer->deab_Data; ead; ead = ead->ed_Next)
+                {
+                    int len = strlen((char *)ead->ed_Name);
                     struct IconEntry *this_Icon;
+                    BOOL hasicon;
+
+                    if (len >= (int)sizeof(filename))
+                        continue;
 
-                    memset(namebuffer, 0, 512);
-                    strcpy(filename, fib->fib_FileName);
+                    strcpy(filename, (char *)ead->ed_Name);
 
                     D(bug("[IconDrawerList] %s: '%s', len = %d\n", __PRETTY_FUNCTION__, filename, len));
 
@@ -160,37 +272,56 @@ static int IconDrawerList__ParseContents(struct IClass *CLASS, Object *obj)
                                 continue;
                             }
 
-                            strcpy(namebuffer, data->drawer);
-                            memset((filename + len - 5), 0, 1); //Remove the .info section
-                            AddPart(namebuffer, filename, sizeof(namebuffer));
-                            D(bug("[IconDrawerList] %s: Checking for .info files real file '%s'\n", __PRETTY_FUNCTION__, namebuffer));
+                            filename[len - 5] = '\0'; //Remove the .info section
+                            D(bug("[IconDrawerList] %s: Checking for .info files real file '%s'\n", __PRETTY_FUNCTION__, filename));
 
-                            if ((tmplock = Lock(namebuffer, SHARED_LOCK)))
+                            if (IconDrawerList__FindExAllName(buffers, names, count, filename))
                             {
                                 /* We have a real file so skip it for now and let it be found seperately */
                                 D(bug("[IconDrawerList] %s: File found .. skipping\n", __PRETTY_FUNCTION__));
-                                UnLock(tmplock); 
                                 continue;
                             }
                         }
                     }
 
+                    /* Check for the entry's .info file without touching the disk */
+                    strcpy(namebuffer, filename);
+                    strcat(namebuffer, ".info");
+                    hasicon = (IconDrawerList__FindExAllName(buffers, names, count, namebuffer) != NULL);
+
+                    /* Build the FileInfoBlock the entry keeps from the ExAll data */
+                    memset(fib, 0, sizeof(struct FileInfoBlock));
+                    strncpy((char *)fib->fib_FileName, filename, sizeof(fib->fib_FileName) - 1);
+                    fib->fib_DirEntryType = ead->ed_Type;
+                    fib->fib_EntryType = ead->ed_Type;
+                    fib->fib_Size = ead->ed_Size;
+                    fib->fib_Protection = ead->ed_Prot;
+                    fib->fib_Date.ds_Days = ead->ed_Days;
+                    fib->fib_Date.ds_Minute = ead->ed_Mins;
+                    fib->fib_Date.ds_Tick = ead->ed_Ticks;
+                    if (ead->ed_Comment)
+                        strncpy((char *)fib->fib_Comment, (char *)ead->ed_Comment, sizeof(fib->fib_Comment) - 1);
+                    if (level >= ED_OWNER)
+                    {
+                        fib->fib_OwnerUID = ead->ed_OwnerUID;
+                        fib->fib_OwnerGID = ead->ed_OwnerGID;
+                    }
+
                     D(bug("[IconDrawerList] %s: Registering file '%s'\n", __PRETTY_FUNCTION__, filename));
                     strcpy(namebuffer, data->drawer);
                     AddPart(namebuffer, filename, sizeof(namebuffer));
 
                     this_Icon = NULL;
 
-                    if ((this_Icon = (struct IconEntry *)DoMethod(obj, MUIM_IconList_CreateEntry, (IPTR)namebuffer, (IPTR)filename, (IPTR)fib, (IPTR)NULL, 0, (IPTR)NULL)))
+                    if ((this_Icon = (struct IconEntry *)DoMethod(obj, MUIM_IconList_CreateEntry, (IPTR)namebuffer, (IPTR)filename, (IPTR)fib,
+                        ((list_DisplayFlags & ICONLIST_DISP_SHOWINFO) && !hasicon) ? (IPTR)MUIV_IconList_CreateEntry_DeferIcon : (IPTR)NULL, 0, (IPTR)NULL)))
                     {
                         D(bug("[IconDrawerList] %s: Icon entry allocated @ 0x%p\n", __PRETTY_FUNCTION__, this_Icon));
                         DoMethod(obj, MUIM_Family_AddTail, (struct Node*)&this_Icon->ie_IconNode);
 
-                        sprintf(namebuffer + strlen(namebuffer), ".info");
-                        if ((tmplock = Lock(namebuffer, SHARED_LOCK)))
+                        if (hasicon)
                         {
                             D(bug("[IconDrawerList] %s: File has a .info file .. updating info\n", __PRETTY_FUNCTION__));
-                            UnLock(tmplock); 
                             if (!(this_Icon->ie_Flags & ICONENTRY_FLAG_HASICON)) 
                                 this_Icon->ie_Flags |= ICONENTRY_FLAG_HASICON;
                         }
@@ -220,6 +351,18 @@ static int IconDrawerList__ParseContents(struct IClass *CLASS, Object *obj)
             {
                             D(bug("[IconDrawerList] %s: Unknown Entry Type created\n", __PRETTY_FUNCTION__));
             }
+
+                        /* Show the first screenful while the rest is being added */
+                        if ((visible_area > 0) && (this_Icon->ie_Flags & ICONENTRY_FLAG_VISIBLE))
+                        {
+                            shown_area += this_Icon->ie_AreaWidth * this_Icon->ie_AreaHeight;
+                            if (shown_area >= visible_area)
+                            {
+                                D(bug("[IconDrawerList] %s: Visible area filled, drawing first entries\n", __PRETTY_FUNCTION__));
+                                DoMethod(obj, MUIM_IconList_Sort);
+                                visible_area = 0;
+                            }
+                        }
                     }
                     else
                     {
@@ -227,9 +370,19 @@ static int IconDrawerList__ParseContents(struct IClass *CLASS, Object *obj)
                     }
                 }
             }
+        }
 
-            FreeDosObject(DOS_FIB, fib);
+        while ((buffer = buffers))
+        {
+            buffers = buffer->deab_Next;
+            FreeVec(buffer);
         }
+        if (names)
+            FreeVec(names);
+        if (eac)
+            FreeDosObject(DOS_EXALLCONTROL, eac);
+        if (fib)
+            FreeDosObject(DOS_FIB, fib);
 
         UnLock(lock);
     }
@@ -530,6 +530,15 @@ static void IconList_GetIconImageRectangle(Object *obj, struct IconList_DATA *da
     D(bug("[IconList]: %s(entry @ %p)\n", __PRETTY_FUNCTION__, entry));
 #endif
 
+    /* Deferred icon, not loaded yet - keep the last known size */
+    if (entry->ie_DiskObj == NULL)
+    {
+        rect->MinX = rect->MinY = 0;
+        rect->MaxX = (LONG)entry->ie_IconWidth - 1;
+        rect->MaxY = (LONG)entry->ie_IconHeight - 1;
+        return;
+    }
+
     /* Get basic width/height */    
     GetIconRectangleA(NULL, entry->ie_DiskObj, NULL, rect, __iconList_DrawIconStateTags);
 #if defined(DEBUG_ILC_ICONPOSITIONING)
@@ -691,6 +700,51 @@ static void IconList_GetIconAreaRectangle(Object *obj, struct IconList_DATA *dat
 }
 ///
 
+///IconList_LoadDeferredIcon()
+/**************************************************************************
+Load the DiskObject of an entry created with
+MUIV_IconList_CreateEntry_DeferIcon (or whose icon was freed while it
+was hidden), once the entry becomes visible. The first time the entry's
+position and area are taken from the icon.
+**************************************************************************/
+static BOOL IconList_LoadDeferredIcon(Object *obj, struct IconList_DATA *data, struct IconEntry *entry)
+{
+    IPTR                iconlistScreen = (IPTR)_screen(obj);
+    IPTR                geticon_error = 0;
+    struct Rectangle    rect;
+
+#if defined(DEBUG_ILC_FUNCS)
+    D(bug("[IconList]: %s('%s')\n", __PRETTY_FUNCTION__, entry->ie_IconNode.ln_Name));
+#endif
+
+    entry->ie_Flags &= ~ICONENTRY_FLAG_DEFERRED;
+
+    if (!(entry->ie_DiskObj = GetIconTags(entry->ie_IconNode.ln_Name,
+                                        (iconlistScreen) ? ICONGETA_Screen : TAG_IGNORE, iconlistScreen,
+                                        (iconlistScreen) ? ICONGETA_RemapIcon : TAG_IGNORE, TRUE,
+                                        ICONGETA_GenerateImageMasks, TRUE,
+                                        ICONGETA_FailIfUnavailable, FALSE,
+                                        ICONA_ErrorCode, &geticon_error,
+                                        TAG_DONE)))
+    {
+        D(bug("[IconList] %s: Failed to obtain Entry '%s's diskobj! (error code = 0x%p)\n", __PRETTY_FUNCTION__, entry->ie_IconNode.ln_Name, geticon_error));
+        return FALSE;
+    }
+
+    if (entry->ie_AreaWidth == 0)
+    {
+        entry->ie_IconX = entry->ie_DiskObj->do_CurrentX;
+        entry->ie_IconY = entry->ie_DiskObj->do_CurrentY;
+
+        DoMethod(obj, MUIM_IconList_PropagateEntryPos, entry);
+        IconList_GetIconAreaRectangle(obj, data, entry, &rect);
+    }
+    entry->ie_Flags |= ICONENTRY_FLAG_NEEDSUPDATE;
+
+    return TRUE;
+}
+///
+
 static LONG FirstVisibleColumnNumber(struct IconList_DATA *data)
 {
     LONG i;
@@ -3081,6 +3135,17 @@ D(bug("[IconList]: %s()\n", __PRETTY_FUNCTION__));
         {
             if (!node->ie_DiskObj)
             {
+                /* Icons of hidden entries are only loaded when they are shown */
+                if (!(node->ie_Flags & ICONENTRY_FLAG_VISIBLE))
+                {
+                    node->ie_Flags |= ICONENTRY_FLAG_DEFERRED;
+                    continue;
+                }
+                if (node->ie_Flags & ICONENTRY_FLAG_DEFERRED)
+                {
+                    IconList_LoadDeferredIcon(obj, data, node);
+                    continue;
+                }
                 if (!(node->ie_DiskObj = GetIconTags(node->ie_IconNode.ln_Name,
                                                     (iconlistScreen) ? ICONGETA_Screen : TAG_IGNORE, iconlistScreen,
                                                     (iconlistScreen) ? ICONGETA_RemapIcon : TAG_IGNORE, TRUE,
@@ -4324,7 +4389,12 @@ IPTR IconList__MUIM_IconList_CreateEntry(struct IClass *CLASS, Object *obj, stru
     }
 
     /*disk object (icon)*/
-    if (message->entry_dob == NULL)
+    if (message->entry_dob == MUIV_IconList_CreateEntry_DeferIcon)
+    {
+        /* Loaded by IconList_LoadDeferredIcon() once the entry is shown */
+        dob = NULL;
+    }
+    else if (message->entry_dob == NULL)
     {
         IPTR iconlistScreen = (IPTR)_screen(obj);
         D(bug("[IconList] %s: IconList Screen @ 0x%p)\n", __PRETTY_FUNCTION__, iconlistScreen));
@@ -4357,11 +4427,14 @@ IPTR IconList__MUIM_IconList_CreateEntry(struct IClass *CLASS, Object *obj, stru
     if ((entry = AllocPooled(data->icld_Pool, sizeof(struct IconEntry))) == NULL)
     {
         D(bug("[IconList] %s: Failed to Allocate Entry Storage!\n", __PRETTY_FUNCTION__));
-        FreeDiskObject(dob);
+        if (dob)
+            FreeDiskObject(dob);
         return (IPTR)NULL;
     }
     memset(entry, 0, sizeof(struct IconEntry));
     entry->ie_Flags |= ICONENTRY_FLAG_NEEDSUPDATE;
+    if (dob == NULL)
+        entry->ie_Flags |= ICONENTRY_FLAG_DEFERRED;
     entry->ie_IconListEntry.ile_IconEntry = entry;
 
     /* Allocate Text Buffers */
@@ -4480,8 +4553,16 @@ IPTR IconList__MUIM_IconList_CreateEntry(struct IClass *CLASS, Object *obj, stru
 
     entry->ie_IconListEntry.udata = message->udata;
 
-    entry->ie_IconX = dob->do_CurrentX;
-    entry->ie_IconY = dob->do_CurrentY;
+    if (dob)
+    {
+        entry->ie_IconX = dob->do_CurrentX;
+        entry->ie_IconY = dob->do_CurrentY;
+    }
+    else
+    {
+        entry->ie_IconX = NO_ICON_POSITION;
+        entry->ie_IconY = NO_ICON_POSITION;
+    }
 
     DoMethod(obj, MUIM_IconList_PropagateEntryPos, entry);
 
@@ -4490,7 +4571,8 @@ IPTR IconList__MUIM_IconList_CreateEntry(struct IClass *CLASS, Object *obj, stru
         entry->ie_DiskObj = dob;
 
         /* Use a geticonrectangle routine that gets textwidth! */
-        IconList_GetIconAreaRectangle(obj, data, entry, &rect);
+        if (dob)
+            IconList_GetIconAreaRectangle(obj, data, entry, &rect);
 
         return (IPTR)entry;
     }
@@ -7262,75 +7344,236 @@ IPTR IconList__MUIM_IconList_SelectAll(struct IClass *CLASS, Object *obj, Msg me
 }
 ///
 
+///IconList_SortEntries()
+typedef LONG (*IconList_CompareFunc)(struct IconList_DATA *, struct IconEntry *, struct IconEntry *);
+
+/**************************************************************************
+Stable bottom-up merge sort of a list of IconEntry nodes. The nodes are
+gathered into an array, merged in runs of doubling width and linked back
+into the list in their new order. If no array can be allocated the list
+is sorted by insertion instead, which is slower but needs no memory.
+**************************************************************************/
+static void IconList_SortEntries(struct IconList_DATA *data, struct List *list, IconList_CompareFunc compare)
+{
+    struct IconEntry            **entries, **src, **dst, **tmp;
+    struct IconEntry            *entry, *test_icon;
+    struct List                 list_Unsorted;
+    ULONG                       count = 0, width, left, mid, end, i, j, k;
+
+    ForeachNode(list, entry)
+        count++;
+
+    if (count < 2)
+        return;
+
+    if ((entries = AllocVec(sizeof(struct IconEntry *) * count * 2, MEMF_ANY)) == NULL)
+    {
+#if defined(DEBUG_ILC_ICONSORTING)
+        D(bug("[IconList] %s: No memory for %u entries, using insertion sort\n", __PRETTY_FUNCTION__, count));
+#endif
+        NewList(&list_Unsorted);
+        while ((entry = (struct IconEntry *)RemHead(list)))
+            AddTail(&list_Unsorted, (struct Node *)&entry->ie_IconNode);
+
+        while ((entry = (struct IconEntry *)RemHead(&list_Unsorted)))
+        {
+            test_icon = (struct IconEntry *)GetTail(list);
+            while ((test_icon != NULL) && (compare(data, test_icon, entry) > 0))
+                test_icon = (struct IconEntry *)GetPred(&test_icon->ie_IconNode);
+
+            if (test_icon != NULL)
+                Insert(list, (struct Node *)&entry->ie_IconNode, (struct Node *)&test_icon->ie_IconNode);
+            else
+                AddHead(list, (struct Node *)&entry->ie_IconNode);
+        }
+        return;
+    }
+
+    src = entries;
+    dst = entries + count;
+
+    for (i = 0; (entry = (struct IconEntry *)RemHead(list)); i++)
+        src[i] = entry;
+
+    for (width = 1; width < count; width <<= 1)
+    {
+        for (left = 0; left < count; left += (width << 1))
+        {
+            mid = (left + width < count) ? left + width : count;
+            end = (mid + width < count) ? mid + width : count;
+
+            /* Runs that are already in order are copied as they are */
+            if ((mid == end) || (compare(data, src[mid - 1], src[mid]) <= 0))
+            {
+                CopyMem(&src[left], &dst[left], (end - left) * sizeof(struct IconEntry *));
+                continue;
+            }
+
+            i = left;
+            j = mid;
+            k = left;
+            while ((i < mid) && (j < end))
+            {
+                if (compare(data, src[j], src[i]) < 0)
+                    dst[k++] = src[j++];
+                else
+                    dst[k++] = src[i++];
+            }
+            while (i < mid)
+                dst[k++] = src[i++];
+            while (j < end)
+                dst[k++] = src[j++];
+        }
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    for (i = 0; i < count; i++)
+        AddTail(list, (struct Node *)&src[i]->ie_IconNode);
+
+    FreeVec(entries);
+}
+///
+
+///IconList_CompareCoords()
+/**************************************************************************
+Order entries by position - column by column in vertical layouts,
+otherwise row by row.
+**************************************************************************/
+static LONG IconList_CompareCoords(struct IconList_DATA *data, struct IconEntry *icon1, struct IconEntry *icon2)
+{
+    LONG                        primary1, primary2, secondary1, secondary2;
+
+    if (data->icld_DisplayFlags & ICONLIST_DISP_VERTICAL)
+    {
+        primary1 = icon1->ie_IconX; secondary1 = icon1->ie_IconY;
+        primary2 = icon2->ie_IconX; secondary2 = icon2->ie_IconY;
+    }
+    else
+    {
+        primary1 = icon1->ie_IconY; secondary1 = icon1->ie_IconX;
+        primary2 = icon2->ie_IconY; secondary2 = icon2->ie_IconX;
+    }
+
+    if (primary1 != primary2)
+        return (primary1 < primary2) ? -1 : 1;
+    if (secondary1 != secondary2)
+        return (secondary1 < secondary2) ? -1 : 1;
+
+    return 0;
+}
+///
+
+///IconList_CompareEntries()
+/**************************************************************************
+Order entries by the sort flags of the iconlist. Unless drawers are mixed
+with files, a name sort keeps the node priorities (used by the volume
+list) as its first key, and drawers always come before files. Without
+AutoSort, entries with a snapshot position go after those without.
+**************************************************************************/
+static LONG IconList_CompareEntries(struct IconList_DATA *data, struct IconEntry *icon1, struct IconEntry *icon2)
+{
+    ULONG                       sortflags = data->icld_SortFlags;
+    BOOL                        placed1, placed2;
+    LONG                        i = 0;
+
+    if ((sortflags & MUIV_IconList_Sort_DrawersMixed) == 0)
+    {
+        if (((sortflags & (MUIV_IconList_Sort_ByDate|MUIV_IconList_Sort_BySize|MUIV_IconList_Sort_ByType)) == 0) &&
+            (icon1->ie_IconNode.ln_Pri != icon2->ie_IconNode.ln_Pri))
+            return (icon1->ie_IconNode.ln_Pri > icon2->ie_IconNode.ln_Pri) ? -1 : 1;
+
+        if ((icon1->ie_IconListEntry.type == ST_USERDIR) != (icon2->ie_IconListEntry.type == ST_USERDIR))
+            return (icon1->ie_IconListEntry.type == ST_USERDIR) ? -1 : 1;
+    }
+
+    if ((sortflags & MUIV_IconList_Sort_AutoSort) == 0)
+    {
+        placed1 = ((icon1->ie_ProvidedIconX != NO_ICON_POSITION) && (icon1->ie_ProvidedIconY != NO_ICON_POSITION));
+        placed2 = ((icon2->ie_ProvidedIconX != NO_ICON_POSITION) && (icon2->ie_ProvidedIconY != NO_ICON_POSITION));
+
+        if (placed1 || placed2)
+            return (placed1 == placed2) ? 0 : (placed1 ? 1 : -1);
+    }
+
+    if ((sortflags & (MUIV_IconList_Sort_ByDate|MUIV_IconList_Sort_BySize)) &&
+        ((icon1->ie_FileInfoBlock == NULL) || (icon2->ie_FileInfoBlock == NULL)))
+    {
+        /* Entries without file information (volumes) are sorted by name */
+        i = Stricmp(icon1->ie_IconListEntry.label, icon2->ie_IconListEntry.label);
+    }
+    else if (sortflags & MUIV_IconList_Sort_ByDate)
+    {
+        /* Sort by Date */
+        i = CompareDates((const struct DateStamp *)&icon1->ie_FileInfoBlock->fib_Date,(const struct DateStamp *)&icon2->ie_FileInfoBlock->fib_Date);
+    }
+    else if (sortflags & MUIV_IconList_Sort_BySize)
+    {
+        /* Sort by Size .. */
+        if (icon1->ie_FileInfoBlock->fib_Size != icon2->ie_FileInfoBlock->fib_Size)
+            i = (icon1->ie_FileInfoBlock->fib_Size < icon2->ie_FileInfoBlock->fib_Size) ? -1 : 1;
+    }
+    else if ((sortflags & MUIV_IconList_Sort_ByType) &&
+        ((icon1->ie_IconListEntry.type == ST_FILE) || (icon1->ie_IconListEntry.type == ST_USERDIR)) &&
+        ((icon2->ie_IconListEntry.type == ST_FILE) || (icon2->ie_IconListEntry.type == ST_USERDIR)))
+    {
+        /* Sort by Type .. */
+        /* TODO: Sort icons based on type using datatypes */
+    }
+    else
+    {
+        /* Sort by Name .. */
+        i = Stricmp(icon1->ie_IconListEntry.label, icon2->ie_IconListEntry.label);
+    }
+
+    if (sortflags & MUIV_IconList_Sort_Reverse)
+        i = -i;
+
+    return i;
+}
+///
+
 ///IconList__MUIM_IconList_CoordsSort()
 IPTR IconList__MUIM_IconList_CoordsSort(struct IClass *CLASS, Object *obj, struct MUIP_IconList_Sort *message)
 {
     struct IconList_DATA        *data = INST_DATA(CLASS, obj);
 
-    struct IconEntry            *entry = NULL,
-                                *test_icon = NULL;
+    struct IconEntry            *entry = NULL;
 
-    struct List                 list_VisibleIcons;
     struct List                 list_HiddenIcons;
-    // struct List                 list_UnplacedIcons;
 
     /*
-        perform a quick sort of the iconlist based on entry coords
+        sort the iconlist based on entry coords
         this method DOESNT cause any visual output.
     */
 #if defined(DEBUG_ILC_FUNCS) || defined(DEBUG_ILC_ICONSORTING)
     D(bug("[IconList]: %s()\n", __PRETTY_FUNCTION__));
 #endif
 
-    NewList((struct List*)&list_VisibleIcons);
     NewList((struct List*)&list_HiddenIcons);
 
-    /*move list into our local list struct(s)*/
-    while ((entry = (struct IconEntry *)RemTail((struct List*)&data->icld_IconList)))
+    /*move hidden entries out of the way, they keep their order at the end*/
+    entry = (struct IconEntry *)GetHead(&data->icld_IconList);
+    while (entry != NULL)
     {
-        if (entry->ie_Flags & ICONENTRY_FLAG_VISIBLE)
+        struct IconEntry *next_icon = (struct IconEntry *)GetSucc(&entry->ie_IconNode);
+
+        if (!(entry->ie_Flags & ICONENTRY_FLAG_VISIBLE))
         {
-            AddHead((struct List*)&list_VisibleIcons, (struct Node *)&entry->ie_IconNode);
+            Remove((struct Node *)&entry->ie_IconNode);
+            AddTail((struct List*)&list_HiddenIcons, (struct Node *)&entry->ie_IconNode);
         }
-        else
-            AddHead((struct List*)&list_HiddenIcons, (struct Node *)&entry->ie_IconNode);
+        entry = next_icon;
     }
-   
-    while ((entry = (struct IconEntry *)RemTail((struct List*)&list_VisibleIcons)))
-    {
-        if ((test_icon = (struct IconEntry *)GetTail(&data->icld_IconList)) != NULL)
-        {
-            while (test_icon != NULL)
-            {
-                if (((data->icld_DisplayFlags & ICONLIST_DISP_VERTICAL) && (test_icon->ie_IconX > entry->ie_IconX)) ||
-                    (!(data->icld_DisplayFlags & ICONLIST_DISP_VERTICAL) && (test_icon->ie_IconY > entry->ie_IconY)))
-                {
-                    test_icon = (struct IconEntry *)GetPred(&test_icon->ie_IconNode);
-                    continue;
-                }
-                else break;
-            }
 
-            while (test_icon != NULL)
-            {
-                if (((data->icld_DisplayFlags & ICONLIST_DISP_VERTICAL) && (test_icon->ie_IconY > entry->ie_IconY)) ||
-                    (!(data->icld_DisplayFlags & ICONLIST_DISP_VERTICAL) && (test_icon->ie_IconX > entry->ie_IconX)))
-                {
-                    test_icon = (struct IconEntry *)GetPred(&test_icon->ie_IconNode);
-                    continue;
-                }
-                else break;
-            }
-            Insert((struct List*)&data->icld_IconList, (struct Node *)&entry->ie_IconNode, (struct Node *)&test_icon->ie_IconNode);
-        }
-        else
-            AddTail((struct List*)&data->icld_IconList, (struct Node *)&entry->ie_IconNode);
-    }
+    IconList_SortEntries(data, (struct List*)&data->icld_IconList, IconList_CompareCoords);
+
 #if defined(DEBUG_ILC_ICONSORTING)
     D(bug("[IconList] %s: Done\n", __PRETTY_FUNCTION__));
 #endif
 
-    while ((entry = (struct IconEntry *)RemTail((struct List*)&list_HiddenIcons)))
+    while ((entry = (struct IconEntry *)RemHead((struct List*)&list_HiddenIcons)))
     {
         AddTail((struct List*)&data->icld_IconList, (struct Node *)&entry->ie_IconNode);
     }
@@ -7357,17 +7600,11 @@ MUIM_Sort - sortsort
 IPTR IconList__MUIM_IconList_Sort(struct IClass *CLASS, Object *obj, struct MUIP_IconList_Sort *message)
 {
     struct IconList_DATA        *data = INST_DATA(CLASS, obj);
-    struct IconEntry            *entry = NULL,
-                                *icon1 = NULL,
-                                *icon2 = NULL;
+    struct IconEntry            *entry = NULL;
 
     struct List                 list_VisibleIcons,
-                                list_SortedIcons,
                                 list_HiddenIcons;
 
-    BOOL                        sortme, reversable = TRUE, enqueue = FALSE;
-    int                         i, visible_count = 0;
-
 #if defined(DEBUG_ILC_FUNCS) || defined(DEBUG_ILC_ICONSORTING)
     D(bug("[IconList]: %s()\n", __PRETTY_FUNCTION__));
 #endif
@@ -7382,11 +7619,10 @@ IPTR IconList__MUIM_IconList_Sort(struct IClass *CLASS, Object *obj, struct MUIP
     D(bug("[IconList] %s: Sort-Flags : %x\n", __PRETTY_FUNCTION__, (data->icld_SortFlags & MUIV_IconList_Sort_MASK)));
 #endif
     NewList((struct List*)&list_VisibleIcons);
-    NewList((struct List*)&list_SortedIcons);
     NewList((struct List*)&list_HiddenIcons);
 
     /*move list into our local list struct(s)*/
-    while ((entry = (struct IconEntry *)RemTail((struct List*)&data->icld_IconList)))
+    while ((entry = (struct IconEntry *)RemHead((struct List*)&data->icld_IconList)))
     {
         if (!(entry->ie_Flags & ICONENTRY_FLAG_HASICON))
         {
@@ -7413,16 +7649,16 @@ IPTR IconList__MUIM_IconList_Sort(struct IClass *CLASS, Object *obj, struct MUIP
         /* Now we have fixed visibility lets dump them into the correct list for sorting */
         if (entry->ie_Flags & ICONENTRY_FLAG_VISIBLE)
         {
+            /* Entries that were hidden until now may not have their icon yet */
+            if (entry->ie_Flags & ICONENTRY_FLAG_DEFERRED)
+                IconList_LoadDeferredIcon(obj, data, entry);
+
             if(entry->ie_AreaWidth > data->icld_IconAreaLargestWidth) data->icld_IconAreaLargestWidth = entry->ie_AreaWidth;
             if(entry->ie_AreaHeight > data->icld_IconAreaLargestHeight) data->icld_IconAreaLargestHeight = entry->ie_AreaHeight;
             if(entry->ie_IconHeight > data->icld_IconLargestHeight) data->icld_IconLargestHeight = entry->ie_IconHeight;
             if((entry->ie_AreaHeight - entry->ie_IconHeight) > data->icld_LabelLargestHeight) data->icld_LabelLargestHeight = entry->ie_AreaHeight - entry->ie_IconHeight;
 
-            if (((data->icld_SortFlags & MUIV_IconList_Sort_AutoSort) == 0) && (entry->ie_ProvidedIconX == NO_ICON_POSITION))
-                AddTail((struct List*)&list_VisibleIcons, (struct Node *)&entry->ie_IconNode);
-            else
-                AddHead((struct List*)&list_VisibleIcons, (struct Node *)&entry->ie_IconNode);
-            visible_count++;
+            AddTail((struct List*)&list_VisibleIcons, (struct Node *)&entry->ie_IconNode);
         }
         else
         {
@@ -7433,139 +7669,31 @@ IPTR IconList__MUIM_IconList_Sort(struct IClass *CLASS, Object *obj, struct MUIP
             entry->ie_Flags &= ~(ICONENTRY_FLAG_SELECTED|ICONENTRY_FLAG_FOCUS);
             if (data->icld_SelectionLastClicked == entry) data->icld_SelectionLastClicked = NULL;
             if (data->icld_FocusIcon == entry) data->icld_FocusIcon = data->icld_SelectionLastClicked;
-            AddHead((struct List*)&list_HiddenIcons, (struct Node *)&entry->ie_IconNode);
+            AddTail((struct List*)&list_HiddenIcons, (struct Node *)&entry->ie_IconNode);
         }
     }
 
-    /* Copy each visible entry back to the main list, sorting as we go*/
+    /* Sort the visible entries and move them back to the main list */
+    IconList_SortEntries(data, (struct List*)&list_VisibleIcons, IconList_CompareEntries);
+
     while ((entry = (struct IconEntry *)RemHead((struct List*)&list_VisibleIcons)))
     {
-        icon1 = (struct IconEntry *)GetHead(&list_SortedIcons);
-        icon2 = NULL;
-
-        sortme = FALSE;
-
-        if (visible_count > 1)
-        {
 #if defined(DEBUG_ILC_ICONSORTING)
-            D(bug("[IconList] %s:  - %s %s %s %i\n", __PRETTY_FUNCTION__, entry->ie_IconListEntry.label, entry->ie_TxtBuf_DATE, entry->ie_TxtBuf_TIME, entry->ie_FileInfoBlock->fib_Size));
+        D(bug("[IconList] %s:  - %s %s %s\n", __PRETTY_FUNCTION__, entry->ie_IconListEntry.label, entry->ie_TxtBuf_DATE, entry->ie_TxtBuf_TIME));
 #endif
-            while (icon1)
-            {
-                if(((icon1->ie_IconListEntry.type == ST_ROOT) || (icon1->ie_IconListEntry.type == ST_LINKDIR) || (icon1->ie_IconListEntry.type == ST_LINKFILE))
-                    || (data->icld_SortFlags & MUIV_IconList_Sort_DrawersMixed))
-                {
-                    /*volume list or drawers mixed*/
-                    sortme = TRUE;
-                }
-                else
-                {
-                    /*drawers first*/
-                    if ((icon1->ie_IconListEntry.type == ST_USERDIR) && (entry->ie_IconListEntry.type == ST_USERDIR))
-                    {
-                        sortme = TRUE;
-                    }
-                    else
-                    {
-                        if ((icon1->ie_IconListEntry.type != ST_USERDIR) && (entry->ie_IconListEntry.type != ST_USERDIR))
-                            sortme = TRUE;
-                        else
-                        {
-                            /* we are the first drawer to arrive or we need to insert ourselves
-                               due to being sorted to the end of the drawers*/
-
-                            if ((!icon2 || icon2->ie_IconListEntry.type == ST_USERDIR) &&
-                                (entry->ie_IconListEntry.type == ST_USERDIR) &&
-                                (icon1->ie_IconListEntry.type != ST_USERDIR))
-                            {
-#if defined(DEBUG_ILC_ICONSORTING)
-                                D(bug("[IconList] %s: force %s\n", __PRETTY_FUNCTION__, entry->ie_IconListEntry.label));
-#endif
-                                break;
-                            }
-                        }
-                    }
-                }
-
-                if (sortme)
-                {
-                    i = 0;
-            
-                    if ((data->icld_SortFlags & MUIV_IconList_Sort_AutoSort) == 0)
-                    {
-                        if ((entry->ie_ProvidedIconX != NO_ICON_POSITION) &&  (entry->ie_ProvidedIconY != NO_ICON_POSITION))
-                        {
-                            i = 1;
-                        }
-                    }
-                    
-                    if (i == 0)
-                    {
-                        if (data->icld_SortFlags & MUIV_IconList_Sort_ByDate)
-                        {
-                            /* Sort by Date */
-                            i = CompareDates((const struct DateStamp *)&entry->ie_FileInfoBlock->fib_Date,(const struct DateStamp *)&icon1->ie_FileInfoBlock->fib_Date);
-                        }
-                        else if (data->icld_SortFlags & MUIV_IconList_Sort_BySize)
-                        {
-                            /* Sort by Size .. */
-                            i = entry->ie_FileInfoBlock->fib_Size - icon1->ie_FileInfoBlock->fib_Size;
-                        }
-                        else if ((data->icld_SortFlags & MUIV_IconList_Sort_ByType) && ((entry->ie_IconListEntry.type == ST_FILE) || (entry->ie_IconListEntry.type == ST_USERDIR)))
-                        {
-                           /* Sort by Type .. */
-                            /* TODO: Sort icons based on type using datatypes */
-                        }
-                        else
-                        {
-                            /* Sort by Name .. */
-                            i = Stricmp(entry->ie_IconListEntry.label, icon1->ie_IconListEntry.label);
-                            if ((data->icld_SortFlags & MUIV_IconList_Sort_DrawersMixed) == 0) enqueue = TRUE;
-                        }
-                    }
-
-                    if ((reversable) && data->icld_SortFlags & MUIV_IconList_Sort_Reverse)
-                    {
-                        if (i > 0)
-                            break;
-                    }
-                    else if (i < 0)
-                        break;
-                }
-                icon2 = icon1;
-                icon1 = (struct IconEntry *)GetSucc(&icon1->ie_IconNode);
-            }
-        }
-        Insert((struct List*)&list_SortedIcons, (struct Node *)&entry->ie_IconNode, (struct Node *)&icon2->ie_IconNode);
-    }
-    if (enqueue)
-    {
-        /* Quickly resort based on node priorities .. */
-        while ((entry = (struct IconEntry *)RemHead((struct List*)&list_SortedIcons)))
-        {
-            Enqueue((struct List*)&data->icld_IconList, (struct Node *)&entry->ie_IconNode);
-        }
-    }
-    else
-    {
-        while ((entry = (struct IconEntry *)RemHead((struct List*)&list_SortedIcons)))
-        {
-            AddTail((struct List*)&data->icld_IconList, (struct Node *)&entry->ie_IconNode);
-        }
+        AddTail((struct List*)&data->icld_IconList, (struct Node *)&entry->ie_IconNode);
     }
 
     DoMethod(obj, MUIM_IconList_PositionIcons);
     MUI_Redraw(obj, MADF_DRAWOBJECT);
 
     if ((data->icld_SortFlags & MUIV_IconList_Sort_Orders) != 0)
-    {
         DoMethod(obj, MUIM_IconList_CoordsSort);
 
-        /* leave hidden icons on a seperate list to speed up normal list parsing ? */
-        while ((entry = (struct IconEntry *)RemHead((struct List*)&list_HiddenIcons)))
-        {
-            AddTail((struct List*)&data->icld_IconList, (struct Node *)&entry->ie_IconNode);
-        }
+    /* leave hidden icons on a seperate list to speed up normal list parsing ? */
+    while ((entry = (struct IconEntry *)RemHead((struct List*)&list_HiddenIcons)))
+    {
+        AddTail((struct List*)&data->icld_IconList, (struct Node *)&entry->ie_IconNode);
     }
     SET(obj, MUIA_IconList_Changed, TRUE);
 
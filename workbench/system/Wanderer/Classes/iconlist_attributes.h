@@ -15,6 +15,9 @@
 #define MUIV_IconList_NextIcon_Selected    0x02
 #define MUIV_IconList_NextIcon_Visible    0x03
 
+/* entry_dob for MUIM_IconList_CreateEntry: load the icon once the entry is shown */
+#define MUIV_IconList_CreateEntry_DeferIcon ((struct DiskObject *)-1)
+
 #define MUIV_IconList_Sort_DrawersMixed (1<<0)      /* mix folders and files when sorting  */
 #define MUIV_IconList_Sort_DrawersLast  (1<<1)      /* ignored if mixed is set             */
 #define MUIV_IconList_Sort_Reverse      (1<<2)      /* reverse sort direction              */